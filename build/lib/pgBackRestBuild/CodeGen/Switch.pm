@@ -92,11 +92,15 @@ sub cgenSwitchBuild
         }
     }
 
+    # Mark params that are not used in the switch statement so there are no unused parameter warnings
+    my $strUnused = join('', map {"    (void)${_};\n"} grep {$strBestSwitch !~ /switch \(${_}\)/} @{$rstryParam});
+
     # Construct the function based on the best switch statement
     return
         cgenTypeName($strType) . "\n" .
         "${strName}(int " . join(', int ', @{$rstryParam}) . ")\n" .
         "{\n" .
+        ($strUnused ne '' ? "${strUnused}\n" : '') .
         "${strBestSwitch}\n" .
         "}\n";
 }
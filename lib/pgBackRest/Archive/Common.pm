@@ -18,6 +18,7 @@ use pgBackRest::Common::Exception;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::Wait;
 use pgBackRest::Config::Config;
+use pgBackRest::Protocol::Helper;
 use pgBackRest::Protocol::Storage::Helper;
 use pgBackRest::Storage::Helper;
 
@@ -165,6 +166,48 @@ sub lsnFileRange
 
 push @EXPORT, qw(lsnFileRange);
 
+####################################################################################################################################
+# walSegmentNext
+#
+# Get the name of the WAL segment that follows a segment on the same timeline.  Pre-9.3 databases did not generate the FF segment
+# so it is skipped.
+####################################################################################################################################
+sub walSegmentNext
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $strWalSegment,
+        $strDbVersion,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::walSegmentNext', \@_,
+            {name => 'strWalSegment', trace => true},
+            {name => 'strDbVersion', trace => true},
+        );
+
+    my $iMajor = hex(substr($strWalSegment, 8, 8));
+    my $iMinor = hex(substr($strWalSegment, 16, 8)) + 1;
+
+    if ($strDbVersion < PG_VERSION_93 && $iMinor == 255 || $iMinor == 256)
+    {
+        $iMajor++;
+        $iMinor = 0;
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'strWalSegmentNext', value => uc(sprintf('%s%08x%08x', substr($strWalSegment, 0, 8), $iMajor, $iMinor)),
+            trace => true}
+    );
+}
+
+push @EXPORT, qw(walSegmentNext);
+
 ####################################################################################################################################
 # walInfo
 #
@@ -254,11 +297,83 @@ sub walInfo
 
 push @EXPORT, qw(walInfo);
 
+####################################################################################################################################
+# walPathList
+#
+# List the WAL segments in an archive path (e.g. 0000000100000001).  Returns a hash keyed by segment name (with .partial for partial
+# segments) where each entry is the list of archive files found for the segment, so the caller can detect duplicates.
+####################################################################################################################################
+sub walPathList
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $oStorageRepo,
+        $strArchiveId,
+        $strWalPath,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::walPathList', \@_,
+            {name => 'oStorageRepo', trace => true},
+            {name => 'strArchiveId', trace => true},
+            {name => 'strWalPath', trace => true},
+        );
+
+    my $hSegment = {};
+
+    foreach my $strWalFile ($oStorageRepo->list(
+        STORAGE_REPO_ARCHIVE . "/${strArchiveId}/${strWalPath}",
+        {strExpression => '^[0-F]{24}(\.partial){0,1}-[0-f]{40}(\.' . COMPRESS_EXT . '){0,1}$', bIgnoreMissing => true}))
+    {
+        push(@{$hSegment->{substr($strWalFile, 0, index($strWalFile, '-'))}}, $strWalFile);
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'hSegment', value => $hSegment, trace => true}
+    );
+}
+
+push @EXPORT, qw(walPathList);
+
+####################################################################################################################################
+# WAL segment cache
+#
+# Segments found in the most recently listed archive path, stored by segment name.  Used by walSegmentFind() when many segments are
+# being found in order so that each archive path is listed once rather than once per segment.  Only the last path is kept since
+# segments are almost always found in order, which also keeps long-running processes from accumulating paths.
+####################################################################################################################################
+my $hWalSegmentCache;
+
+####################################################################################################################################
+# walSegmentCacheClear
+#
+# Clear the WAL segment cache so the next walSegmentFind() with bCache lists the archive path again.
+####################################################################################################################################
+sub walSegmentCacheClear
+{
+    undef($hWalSegmentCache);
+}
+
+push @EXPORT, qw(walSegmentCacheClear);
+
 ####################################################################################################################################
 # walSegmentFind
 #
 # Returns the filename of a WAL segment in the archive.  Optionally, a wait time can be specified.  In this case an error will be
 # thrown when the WAL segment is not found.  If the same WAL segment with multiple checksums is found then error.
+#
+# When bCache is set the entire archive path is listed and cached so finding the segments that follow in the same path does not
+# require another list.  A segment missing from the cache causes the path to be listed again since it may have been archived since
+# the path was cached.  Segments are never removed from the cache, so bCache should not be used when a segment may have been
+# removed (or a duplicate added) by another process since it was found, e.g. when checking for duplicates before pushing.
+#
+# When bCacheMissing is also set a segment missing from the cached path is reported as missing without listing the path again.  The
+# caller must clear the cache with walSegmentCacheClear() before the cached list could be out of date.
 ####################################################################################################################################
 sub walSegmentFind
 {
@@ -270,6 +385,8 @@ sub walSegmentFind
         $strArchiveId,
         $strWalSegment,
         $iWaitSeconds,
+        $bCache,
+        $bCacheMissing,
     ) =
         logDebugParam
         (
@@ -278,6 +395,8 @@ sub walSegmentFind
             {name => 'strArchiveId'},
             {name => 'strWalSegment'},
             {name => 'iWaitSeconds', required => false},
+            {name => 'bCache', optional => true, default => false, trace => true},
+            {name => 'bCacheMissing', optional => true, default => false, trace => true},
         );
 
     # Error if not a segment
@@ -288,17 +407,42 @@ sub walSegmentFind
 
     # Loop and wait for file to appear
     my $oWait = waitInit($iWaitSeconds);
+    my $strWalPath = STORAGE_REPO_ARCHIVE . "/${strArchiveId}/" . substr($strWalSegment, 0, 16);
+    my $strWalName = substr($strWalSegment, 0, 24) . (walIsPartial($strWalSegment) ? '.partial' : '');
     my @stryWalFileName;
 
     do
     {
-        # Get the name of the requested WAL segment (may have compression extension)
-        push(@stryWalFileName, $oStorageRepo->list(
-            STORAGE_REPO_ARCHIVE . "/${strArchiveId}/" . substr($strWalSegment, 0, 16),
-            {strExpression =>
-                '^' . substr($strWalSegment, 0, 24) . (walIsPartial($strWalSegment) ? "\\.partial" : '') .
-                "-[0-f]{40}(\\." . COMPRESS_EXT . "){0,1}\$",
-                bIgnoreMissing => true}));
+        if ($bCache)
+        {
+            my $strCacheKey = "${oStorageRepo}:${strWalPath}";
+
+            # List the path if it is not cached or the segment is not in the cache (unless missing segments are trusted)
+            if (!defined($hWalSegmentCache) || $hWalSegmentCache->{strKey} ne $strCacheKey ||
+                (!defined($hWalSegmentCache->{hSegment}{$strWalName}) && !$bCacheMissing))
+            {
+                $hWalSegmentCache =
+                {
+                    strKey => $strCacheKey,
+                    hSegment => walPathList($oStorageRepo, $strArchiveId, substr($strWalSegment, 0, 16)),
+                };
+            }
+
+            if (defined($hWalSegmentCache->{hSegment}{$strWalName}))
+            {
+                push(@stryWalFileName, @{$hWalSegmentCache->{hSegment}{$strWalName}});
+            }
+        }
+        else
+        {
+            # Get the name of the requested WAL segment (may have compression extension)
+            push(@stryWalFileName, $oStorageRepo->list(
+                $strWalPath,
+                {strExpression =>
+                    '^' . substr($strWalSegment, 0, 24) . (walIsPartial($strWalSegment) ? "\\.partial" : '') .
+                    "-[0-f]{40}(\\." . COMPRESS_EXT . "){0,1}\$",
+                    bIgnoreMissing => true}));
+        }
     }
     while (@stryWalFileName == 0 && waitMore($oWait));
 
@@ -328,6 +472,145 @@ sub walSegmentFind
 
 push @EXPORT, qw(walSegmentFind);
 
+####################################################################################################################################
+# walSegmentFindList
+#
+# Returns the filenames of a list of WAL segments in the archive, in the same order as the list (undef when a segment is missing).
+# Each archive path is listed once and all the segments in the path are checked against the list, rather than listing once per
+# segment.  When a wait time is specified the paths that still have missing segments are listed again until all segments are found,
+# else an error is thrown for the first missing segment.  Duplicates are an error just as they are in walSegmentFind().
+#
+# When a local process object is passed and more than one path needs to be listed the paths are listed in parallel by the local
+# processes.  This helps when the segments span many paths (e.g. a long backup on a busy cluster) and each list has high latency.
+####################################################################################################################################
+sub walSegmentFindList
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $oStorageRepo,
+        $strArchiveId,
+        $stryWalSegment,
+        $iWaitSeconds,
+        $oProcess,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::walSegmentFindList', \@_,
+            {name => 'oStorageRepo'},
+            {name => 'strArchiveId'},
+            {name => 'stryWalSegment'},
+            {name => 'iWaitSeconds', required => false},
+            {name => 'oProcess', optional => true, trace => true},
+        );
+
+    # Group the segments by archive path
+    my $hPathSegment = {};
+
+    foreach my $strWalSegment (@{$stryWalSegment})
+    {
+        # Error if not a segment
+        if (!walIsSegment($strWalSegment))
+        {
+            confess &log(ERROR, "${strWalSegment} is not a WAL segment", ERROR_ASSERT);
+        }
+
+        push(@{$hPathSegment->{substr($strWalSegment, 0, 16)}}, $strWalSegment);
+    }
+
+    # Loop and wait for all segments to appear
+    my $oWait = waitInit($iWaitSeconds);
+    my $hWalFileName = {};
+
+    do
+    {
+        # List the paths that still have missing segments
+        my @stryWalPath = sort(keys(%{$hPathSegment}));
+        my $hPathList = {};
+
+        if (defined($oProcess) && @stryWalPath > 1)
+        {
+            foreach my $strWalPath (@stryWalPath)
+            {
+                $oProcess->queueJob(1, 'default', $strWalPath, OP_ARCHIVE_PATH_LIST, [$strArchiveId, $strWalPath]);
+            }
+
+            while (my $hyJob = $oProcess->process())
+            {
+                foreach my $hJob (@{$hyJob})
+                {
+                    $hPathList->{$hJob->{strKey}} = $hJob->{rResult}[0];
+                }
+            }
+        }
+        else
+        {
+            foreach my $strWalPath (@stryWalPath)
+            {
+                $hPathList->{$strWalPath} = walPathList($oStorageRepo, $strArchiveId, $strWalPath);
+            }
+        }
+
+        # Check the segments in each path against the list
+        foreach my $strWalPath (@stryWalPath)
+        {
+            my $stryWalSegmentMissing = [];
+
+            foreach my $strWalSegment (@{$hPathSegment->{$strWalPath}})
+            {
+                my $stryWalFileName =
+                    $hPathList->{$strWalPath}{substr($strWalSegment, 0, 24) . (walIsPartial($strWalSegment) ? '.partial' : '')};
+
+                if (!defined($stryWalFileName))
+                {
+                    push(@{$stryWalSegmentMissing}, $strWalSegment);
+                    next;
+                }
+
+                # If there is more than one matching archive file then there is a serious issue - either a bug in the archiver or
+                # the user has copied files around or removed archive.info.
+                if (@{$stryWalFileName} > 1)
+                {
+                    confess &log(ERROR,
+                        "duplicates found in archive for WAL segment ${strWalSegment}: " . join(', ', @{$stryWalFileName}) .
+                        "\nHINT: are multiple primaries archiving to this stanza?",
+                        ERROR_ARCHIVE_DUPLICATE);
+                }
+
+                $hWalFileName->{$strWalSegment} = $stryWalFileName->[0];
+            }
+
+            if (@{$stryWalSegmentMissing} > 0)
+            {
+                $hPathSegment->{$strWalPath} = $stryWalSegmentMissing;
+            }
+            else
+            {
+                delete($hPathSegment->{$strWalPath});
+            }
+        }
+    }
+    while (keys(%{$hPathSegment}) > 0 && waitMore($oWait));
+
+    # If waiting and a WAL segment was not found then throw an error for the first missing segment
+    if (keys(%{$hPathSegment}) > 0 && defined($iWaitSeconds))
+    {
+        my ($strWalSegment) = grep {!defined($hWalFileName->{$_})} @{$stryWalSegment};
+
+        confess &log(ERROR, "could not find WAL segment ${strWalSegment} after ${iWaitSeconds} second(s)", ERROR_ARCHIVE_TIMEOUT);
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'stryWalFileName', value => [map {$hWalFileName->{$_}} @{$stryWalSegment}], ref => true}
+    );
+}
+
+push @EXPORT, qw(walSegmentFindList);
+
 ####################################################################################################################################
 # walPath
 #
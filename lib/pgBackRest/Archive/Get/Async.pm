@@ -0,0 +1,351 @@
+####################################################################################################################################
+# ARCHIVE GET ASYNC MODULE
+#
+# Prefetch WAL segments into the spool path so archive-get can return them with a rename.  Starting at the requested segment, the
+# segments that follow on the same timeline are fetched and decompressed in parallel by local processes.  Each segment is written
+# atomically to the spool path, or a status file is written instead:
+#
+# <segment>.ok      - the segment was not found in the archive
+# <segment>.error   - the segment could not be fetched, the file contains the error code and message
+####################################################################################################################################
+package pgBackRest::Archive::Get::Async;
+use parent 'pgBackRest::Archive::Get::Get';
+
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use Exporter qw(import);
+    our @EXPORT = qw();
+use POSIX qw(setsid);
+
+use pgBackRest::Archive::Common;
+use pgBackRest::Archive::Get::Get;
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Lock;
+use pgBackRest::Common::Log;
+use pgBackRest::Config::Config;
+use pgBackRest::Db;
+use pgBackRest::Protocol::Helper;
+use pgBackRest::Protocol::Local::Process;
+use pgBackRest::Storage::Helper;
+use pgBackRest::Version;
+
+####################################################################################################################################
+# constructor
+####################################################################################################################################
+sub new
+{
+    my $class = shift;          # Class name
+
+    # Init object
+    my $self = $class->SUPER::new();
+    bless $self, $class;
+
+    # Assign function parameters, defaults, and log debug info
+    (
+        my $strOperation,
+        $self->{strSpoolPath},
+        $self->{strWalSegment},
+        $self->{strBackRestBin},
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->new', \@_,
+            {name => 'strSpoolPath'},
+            {name => 'strWalSegment'},
+            {name => 'strBackRestBin', default => BACKREST_BIN},
+        );
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'self', value => $self}
+    );
+}
+
+####################################################################################################################################
+# process
+#
+# Fork and run the async process if it is not already running.
+####################################################################################################################################
+sub process
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->process');
+
+    my $bClient = true;
+
+    # This first lock request is a quick test to see if the async process is running.  If the lock is successful we need to release
+    # the lock, fork, and then let the async process acquire its own lock.  Otherwise the lock will be held by the client process
+    # which will soon exit and leave the async process unlocked.
+    if (lockAcquire(cfgCommandName(cfgCommandGet()), false))
+    {
+        lockRelease(cfgCommandName(cfgCommandGet()));
+        $bClient = fork() == 0 ? false : true;
+    }
+    else
+    {
+        logDebugMisc($strOperation, 'async archive-get process is already running');
+    }
+
+    # Run async process
+    if (!$bClient)
+    {
+        # uncoverable branch false - reacquire the lock since it was released by the client process above
+        if (lockAcquire(cfgCommandName(cfgCommandGet()), false))
+        {
+            # uncoverable branch true - chdir to /
+            chdir '/'
+                or confess &log(ERROR, "unable to chdir to /: $OS_ERROR", ERROR_PATH_MISSING);
+
+            # uncoverable branch true - close stdin
+            open(STDIN, '<', '/dev/null')
+                or confess &log(ERROR, "unable to close stdin: $OS_ERROR", ERROR_FILE_OPEN);
+            # uncoverable branch true - close stdout
+            open(STDOUT, '>', '/dev/null')
+                or confess &log(ERROR, "unable to close stdout: $OS_ERROR", ERROR_FILE_OPEN);
+            # uncoverable branch true - close stderr
+            open(STDERR, '>', '/dev/null')
+                or confess &log(ERROR, "unable to close stderr: $OS_ERROR", ERROR_FILE_OPEN);
+
+            # uncoverable branch true - create new session group
+            setsid()
+                or confess &log(ERROR, "unable to create new session group: $OS_ERROR", ERROR_ASSERT);
+
+            # Open the log file
+            logFileSet(storageLocal(), cfgOption(CFGOPT_LOG_PATH) . '/' . cfgOption(CFGOPT_STANZA) . '-archive-get-async');
+
+            # Start processing
+            $self->processServer();
+        }
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'bClient', value => $bClient, trace => true}
+    );
+}
+
+####################################################################################################################################
+# processServer
+#
+# Setup the server and process the queue.  This function is separate from processQueue() for testing purposes.
+####################################################################################################################################
+sub processServer
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->processServer');
+
+    # Create the spool path
+    storageSpool()->pathCreate($self->{strSpoolPath}, {bIgnoreExists => true, bCreateParent => true});
+
+    # Initialize the archive process
+    $self->{oArchiveProcess} = new pgBackRest::Protocol::Local::Process(
+        CFGOPTVAL_LOCAL_TYPE_BACKUP, cfgOption(CFGOPT_PROTOCOL_TIMEOUT) < 60 ? cfgOption(CFGOPT_PROTOCOL_TIMEOUT) / 2 : 30,
+        $self->{strBackRestBin}, false);
+    $self->{oArchiveProcess}->hostAdd(1, cfgOption(CFGOPT_PROCESS_MAX));
+
+    $self->processQueue();
+    $self->{oArchiveProcess}->close();
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+####################################################################################################################################
+# queueList
+#
+# Get the list of segments to fetch, starting with the requested segment.  Files in the spool path that are not in the queue are
+# removed since recovery has moved past them (or to another timeline), as are status files from previous runs so those segments are
+# checked again.  Segments already in the spool path are not fetched again.
+####################################################################################################################################
+sub queueList
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $strDbVersion,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->queueList', \@_,
+            {name => 'strDbVersion'},
+        );
+
+    # Generate the queue
+    my $hQueue = {};
+    my $strWalSegment = $self->{strWalSegment};
+
+    for (my $iQueueIdx = 0; $iQueueIdx < $self->queueTotal(); $iQueueIdx++)
+    {
+        $hQueue->{$strWalSegment} = true;
+        $strWalSegment = walSegmentNext($strWalSegment, $strDbVersion);
+    }
+
+    # Clean the spool path
+    foreach my $strFile (storageSpool()->list($self->{strSpoolPath}, {bIgnoreMissing => true}))
+    {
+        if (defined($hQueue->{$strFile}))
+        {
+            delete($hQueue->{$strFile});
+        }
+        else
+        {
+            storageSpool()->remove("$self->{strSpoolPath}/${strFile}", {bIgnoreMissing => true});
+        }
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'stryWalSegment', value => [sort(keys(%{$hQueue}))], ref => true}
+    );
+}
+
+####################################################################################################################################
+# processQueue
+#
+# Get WAL segments from the archive.
+####################################################################################################################################
+sub processQueue
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->processQueue');
+
+    my $iFoundTotal = 0;
+    my $iMissingTotal = 0;
+    my $iErrorTotal = 0;
+    my $stryWalSegment = [];
+
+    eval
+    {
+        # Check the archive once for all segments
+        my ($strDbVersion, $iControlVersion, $iCatalogVersion, $ullDbSysId) = dbMasterGet()->info();
+        my ($strArchiveId) = $self->getCheck($strDbVersion, $ullDbSysId);
+
+        # Queue the segments
+        $stryWalSegment = $self->queueList($strDbVersion);
+
+        foreach my $strWalSegment (@{$stryWalSegment})
+        {
+            $self->{oArchiveProcess}->queueJob(
+                1, 'default', $strWalSegment, OP_ARCHIVE_GET_FILE,
+                [$strArchiveId, $strWalSegment, "$self->{strSpoolPath}/${strWalSegment}"]);
+        }
+
+        if (@{$stryWalSegment} > 0)
+        {
+            &log(INFO,
+                'get ' . @{$stryWalSegment} . ' WAL file(s) from archive: ' .
+                    ${$stryWalSegment}[0] . (@{$stryWalSegment} > 1 ? "...${$stryWalSegment}[-1]" : ''));
+        }
+
+        while (my $hyJob = $self->{oArchiveProcess}->process())
+        {
+            # Send keep alives to protocol
+            protocolKeepAlive();
+
+            foreach my $hJob (@{$hyJob})
+            {
+                my $strWalSegment = @{$hJob->{rParam}}[1];
+
+                # If error then write out an error file
+                if (defined($hJob->{oException}))
+                {
+                    $self->walStatusWrite(
+                        "${strWalSegment}.error", $hJob->{oException}->code() . "\n" . $hJob->{oException}->message());
+
+                    $iErrorTotal++;
+
+                    &log(WARN,
+                        "could not get WAL file ${strWalSegment} from archive (will be retried): [" .
+                            $hJob->{oException}->code() . "] " . $hJob->{oException}->message());
+                }
+                # Else if the segment was found it is already in the spool path
+                elsif (@{$hJob->{rResult}}[0])
+                {
+                    $iFoundTotal++;
+
+                    &log(DETAIL, "got WAL file ${strWalSegment} from archive", undef, undef, undef, $hJob->{iProcessId});
+                }
+                # Else write an ok file to show that the segment is not in the archive
+                else
+                {
+                    $self->walStatusWrite("${strWalSegment}.ok");
+
+                    $iMissingTotal++;
+
+                    &log(DETAIL, "WAL file ${strWalSegment} not found in archive", undef, undef, undef, $hJob->{iProcessId});
+                }
+            }
+        }
+
+        return 1;
+    }
+    or do
+    {
+        # Get error info
+        my $iCode = exceptionCode($EVAL_ERROR);
+        my $strMessage = exceptionMessage($EVAL_ERROR);
+
+        # Error the requested segment so the client does not wait until it times out
+        $self->walStatusWrite("$self->{strWalSegment}.error", "${iCode}\n${strMessage}");
+
+        &log(WARN, "could not get WAL files from archive: [${iCode}] ${strMessage}");
+    };
+
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'iNewTotal', value => scalar(@{$stryWalSegment})},
+        {name => 'iFoundTotal', value => $iFoundTotal},
+        {name => 'iMissingTotal', value => $iMissingTotal},
+        {name => 'iErrorTotal', value => $iErrorTotal}
+    );
+}
+
+####################################################################################################################################
+# walStatusWrite
+#
+# Write a status file to the spool path.
+####################################################################################################################################
+sub walStatusWrite
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $strStatusFile,
+        $strStatus,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->walStatusWrite', \@_,
+            {name => 'strStatusFile'},
+            {name => 'strStatus', required => false},
+        );
+
+    storageSpool()->put(storageSpool()->openWrite("$self->{strSpoolPath}/${strStatusFile}", {bAtomic => true}), $strStatus);
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+1;
@@ -0,0 +1,78 @@
+####################################################################################################################################
+# ARCHIVE GET FILE MODULE
+####################################################################################################################################
+package pgBackRest::Archive::Get::File;
+
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use Exporter qw(import);
+    our @EXPORT = qw();
+
+use pgBackRest::Archive::Common;
+use pgBackRest::Common::Log;
+use pgBackRest::Protocol::Storage::Helper;
+use pgBackRest::Storage::Base;
+use pgBackRest::Storage::Filter::Gzip;
+use pgBackRest::Storage::Helper;
+
+####################################################################################################################################
+# archiveGetFile
+#
+# Copy a WAL segment from the archive to the spool path for the async archive-get process.  The segment is moved into place after
+# it has been copied so the foreground process never sees a partial file.  Returns false if the segment is not in the archive.
+####################################################################################################################################
+sub archiveGetFile
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $strArchiveId,
+        $strWalSegment,
+        $strDestinationFile,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::archiveGetFile', \@_,
+            {name => 'strArchiveId'},
+            {name => 'strWalSegment'},
+            {name => 'strDestinationFile'},
+        );
+
+    my $oStorageRepo = storageRepo();
+    my $strArchiveFile = walSegmentFind($oStorageRepo, $strArchiveId, $strWalSegment, undef, {bCache => true});
+
+    if (defined($strArchiveFile))
+    {
+        # Determine if the source file is already compressed
+        my $bSourceCompressed = $strArchiveFile =~ ('^.*\.' . COMPRESS_EXT . '$') ? true : false;
+
+        # Copy the archive file to a temp file in the spool path.  An atomic write is not used because the temp file would be moved
+        # into place when the file is closed, even when the copy fails.
+        my $strDestinationTmp = "${strDestinationFile}." . STORAGE_TEMP_EXT;
+
+        $oStorageRepo->copy(
+            $oStorageRepo->openRead(
+                STORAGE_REPO_ARCHIVE . "/${strArchiveId}/${strArchiveFile}", {bProtocolCompress => !$bSourceCompressed}),
+            storageLocal()->openWrite(
+                $strDestinationTmp,
+                {rhyFilter => $bSourceCompressed ?
+                    [{strClass => STORAGE_FILTER_GZIP, rxyParam => [{strCompressType => STORAGE_DECOMPRESS}]}] : undef}));
+
+        storageLocal()->move($strDestinationTmp, $strDestinationFile);
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'bFound', value => defined($strArchiveFile) ? true : false}
+    );
+}
+
+push @EXPORT, qw(archiveGetFile);
+
+1;
@@ -62,11 +62,17 @@ sub process
     # Info for the Postgres log
     &log(INFO, 'get WAL segment ' . $ARGV[1]);
 
+    # Get the WAL segment asynchronously when enabled.  Only full segments are prefetched so other files (e.g. history files) are
+    # always fetched directly from the archive.
+    my $iResult =
+        cfgOption(CFGOPT_ARCHIVE_ASYNC) && walIsSegment($ARGV[1]) && !walIsPartial($ARGV[1]) ?
+            $self->getAsync($ARGV[1], $ARGV[2]) : $self->get($ARGV[1], $ARGV[2]);
+
     # Return from function and log return values if any
     return logDebugReturn
     (
         $strOperation,
-        {name => 'iResult', value => $self->get($ARGV[1], $ARGV[2]), trace => true}
+        {name => 'iResult', value => $iResult, trace => true}
     );
 }
 
@@ -144,6 +150,142 @@ sub get
     );
 }
 
+####################################################################################################################################
+# getAsync
+#
+# Get a WAL segment from the spool path.  If the segment has not been prefetched then the async process is started to fetch it and
+# the segments that follow, and this process waits for the segment or a status file to appear.
+####################################################################################################################################
+sub getAsync
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $strSourceArchive,
+        $strDestinationFile
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->getAsync', \@_,
+            {name => 'strSourceArchive'},
+            {name => 'strDestinationFile'}
+        );
+
+    my $iTimeBegin = time();
+
+    lockStopTest();
+
+    # Load module dynamically
+    require pgBackRest::Archive::Get::Async;
+
+    # Construct absolute path to the WAL file when it is relative
+    $strDestinationFile = walPath($strDestinationFile, cfgOption(CFGOPT_DB_PATH, false), cfgCommandName(cfgCommandGet()));
+
+    my $strSpoolPath = storageSpool()->pathGet(STORAGE_SPOOL_ARCHIVE_IN);
+    my $strSpoolFile = "${strSpoolPath}/${strSourceArchive}";
+
+    # Loop to check for the segment and status files and launch async process
+    my $iResult;
+    my $bClient = true;
+    my $oWait = waitInit(cfgOption(CFGOPT_ARCHIVE_TIMEOUT));
+
+    do
+    {
+        # If the segment has been prefetched then move it to the destination
+        if (storageSpool()->exists($strSpoolFile))
+        {
+            # Rename when the spool path is on the same device as the destination, else copy
+            if ((stat($strSpoolFile))[0] == (stat(dirname($strDestinationFile)))[0])
+            {
+                storageLocal()->move($strSpoolFile, $strDestinationFile);
+            }
+            else
+            {
+                storageLocal()->copy($strSpoolFile, $strDestinationFile);
+                storageLocal()->remove($strSpoolFile);
+            }
+
+            &log(INFO, "got WAL segment ${strSourceArchive} asynchronously");
+            $iResult = 0;
+
+            # Start the async process to fetch more segments when less than half the queue remains so recovery does not have to
+            # wait for the queue to empty before more segments are fetched
+            my @stryQueue = storageSpool()->list($strSpoolPath, {strExpression => '^[0-F]{24}$'});
+
+            if (@stryQueue < $self->queueTotal() / 2)
+            {
+                my ($strDbVersion) = dbMasterGet()->info();
+
+                $bClient = (new pgBackRest::Archive::Get::Async(
+                    $strSpoolPath, walSegmentNext($strSourceArchive, $strDbVersion), $self->{strBackRestBin}))->process();
+            }
+        }
+        # Else the async process did not find the segment in the archive.  The segment may have been archived since the status was
+        # written (e.g. a standby that is caught up with the primary) so only trust a status written after this command started.
+        elsif (storageSpool()->exists("${strSpoolFile}.ok"))
+        {
+            my $bCurrent = (stat("${strSpoolFile}.ok"))[9] >= $iTimeBegin;
+            storageSpool()->remove("${strSpoolFile}.ok");
+
+            if ($bCurrent)
+            {
+                &log(INFO, "unable to find ${strSourceArchive} in the archive asynchronously");
+                $iResult = 1;
+            }
+        }
+        # Else the async process could not get the segment
+        elsif (storageSpool()->exists("${strSpoolFile}.error"))
+        {
+            my ($iCode, @stryMessage) = split("\n", ${storageSpool()->get("${strSpoolFile}.error")});
+            storageSpool()->remove("${strSpoolFile}.error");
+
+            confess &log(ERROR, join("\n", @stryMessage), $iCode);
+        }
+        # Else start the async process.  If it is already running then this returns immediately and the loop waits for the segment.
+        else
+        {
+            $bClient = (new pgBackRest::Archive::Get::Async(
+                $strSpoolPath, $strSourceArchive, $self->{strBackRestBin}))->process();
+        }
+    }
+    while ($bClient && !defined($iResult) && waitMore($oWait));
+
+    # The async process is done and will exit
+    if (!$bClient)
+    {
+        $iResult = 0;
+    }
+    elsif (!defined($iResult))
+    {
+        confess &log(ERROR,
+            "unable to get WAL segment ${strSourceArchive} asynchronously after " . cfgOption(CFGOPT_ARCHIVE_TIMEOUT) .
+                " second(s)",
+            ERROR_ARCHIVE_TIMEOUT);
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'iResult', value => $iResult}
+    );
+}
+
+####################################################################################################################################
+# queueTotal
+#
+# Number of segments the async process fetches ahead.  The requested segment is always fetched even if the queue is smaller.
+####################################################################################################################################
+sub queueTotal
+{
+    my $iQueueTotal = int(cfgOption(CFGOPT_ARCHIVE_GET_QUEUE_MAX) / PG_WAL_SIZE);
+
+    return $iQueueTotal > 0 ? $iQueueTotal : 1;
+}
+
 ####################################################################################################################################
 # getArchiveId
 #
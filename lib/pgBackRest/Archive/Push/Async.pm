@@ -16,6 +16,7 @@ use File::Basename qw(dirname basename);
 use IO::Socket::UNIX;
 use POSIX qw(setsid);
 use Scalar::Util qw(blessed);
+use Time::HiRes qw(gettimeofday);
 
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Lock;
@@ -28,11 +29,48 @@ use pgBackRest::Common::Wait;
 use pgBackRest::Config::Config;
 use pgBackRest::Db;
 use pgBackRest::DbVersion;
+use pgBackRest::LibCLoad;
 use pgBackRest::Protocol::Local::Process;
 use pgBackRest::Protocol::Helper;
+use pgBackRest::Protocol::Storage::Helper;
 use pgBackRest::Storage::Helper;
 use pgBackRest::Version;
 
+####################################################################################################################################
+# Seconds the async process waits for more WAL before exiting
+####################################################################################################################################
+use constant ARCHIVE_PUSH_ASYNC_LINGER                              => 10;
+
+####################################################################################################################################
+# Seconds to sleep between reads of the archive status path when it is not watched
+####################################################################################################################################
+use constant ARCHIVE_PUSH_ASYNC_POLL                                => .1;
+
+####################################################################################################################################
+# Seconds to wait for a watch event before checking the linger time and sending keep alives
+####################################################################################################################################
+use constant ARCHIVE_PUSH_ASYNC_WATCH_WAIT                          => 1;
+
+####################################################################################################################################
+# Seconds between full reads of the archive status path when it is watched, in case the watch missed a change
+####################################################################################################################################
+use constant ARCHIVE_PUSH_ASYNC_RESCAN                              => 10;
+
+####################################################################################################################################
+# Maximum WAL files pushed by a local process in one job.  Groups are smaller when there are too few files to keep all processes
+# busy.  This must not be more than PROTOCOL_COMMAND_PENDING_MAX since checks for the group are submitted to the remote together.
+####################################################################################################################################
+use constant ARCHIVE_PUSH_ASYNC_GROUP_MAX                           => 8;
+
+####################################################################################################################################
+# Load the C library if present
+####################################################################################################################################
+if (libC())
+{
+    require pgBackRest::LibC;
+    pgBackRest::LibC->import(qw(:storage));
+};
+
 ####################################################################################################################################
 # constructor
 ####################################################################################################################################
@@ -50,6 +88,7 @@ sub new
         $self->{strWalPath},
         $self->{strSpoolPath},
         $self->{strBackRestBin},
+        $self->{iLinger},
     ) =
         logDebugParam
         (
@@ -57,6 +96,7 @@ sub new
             {name => 'strWalPath'},
             {name => 'strSpoolPath'},
             {name => 'strBackRestBin', default => BACKREST_BIN},
+            {name => 'iLinger', required => false},
         );
 
     # Return from function and log return values if any
@@ -151,16 +191,171 @@ sub initServer
     # Create the spool path
     storageSpool()->pathCreate($self->{strSpoolPath}, {bIgnoreExists => true, bCreateParent => true});
 
-    # Initialize the archive process
+    # Initialize the archive process.  Local processes are kept between batches so they do not need to be started for each one.
     $self->{oArchiveProcess} = new pgBackRest::Protocol::Local::Process(
         CFGOPTVAL_LOCAL_TYPE_BACKUP, cfgOption(CFGOPT_PROTOCOL_TIMEOUT) < 60 ? cfgOption(CFGOPT_PROTOCOL_TIMEOUT) / 2 : 30,
-        $self->{strBackRestBin}, false);
+        $self->{strBackRestBin}, false, true);
     $self->{oArchiveProcess}->hostAdd(1, cfgOption(CFGOPT_PROCESS_MAX));
 
+    # Watch the archive status path for .ready files
+    $self->readyWatchInit();
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+####################################################################################################################################
+# readyWatchInit
+#
+# Start watching the archive status path so .ready files are found as soon as they are written without reading the path each time.
+# When the C library is not present or the path cannot be watched the path is read each time instead.
+####################################################################################################################################
+sub readyWatchInit
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->readyWatchInit');
+
+    $self->readyWatchFree();
+
+    if (libC())
+    {
+        eval
+        {
+            $self->{iReadyWatch} = storagePosixWatchNew(storageDb()->pathGet("$self->{strWalPath}/archive_status"));
+            return true;
+        }
+        or do
+        {
+            &log(DETAIL, 'unable to watch archive status path, path will be polled: ' . exceptionMessage($EVAL_ERROR));
+        };
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+####################################################################################################################################
+# readyWatchRead
+#
+# Wait for watch events and apply them to the .ready files found by the last full read of the archive status path.  If events were
+# lost the watch is started again and the next call to readyStatusList() reads the full path.
+####################################################################################################################################
+sub readyWatchRead
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $fWait,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->readyWatchRead', \@_,
+            {name => 'fWait', trace => true},
+        );
+
+    foreach my $rEvent (@{storagePosixWatchRead($self->{iReadyWatch}, int($fWait * 1000))})
+    {
+        my ($strType, $strFile) = @{$rEvent};
+
+        # Events were lost (o = overflow)
+        if ($strType eq 'o')
+        {
+            $self->readyWatchInit();
+            last;
+        }
+
+        # Ignore events until the path has been read and for files that are not .ready files
+        next if !defined($self->{hReadyFile}) || $strFile !~ /\.ready$/;
+
+        # Add (a) or remove (r) the .ready file
+        if ($strType eq 'a')
+        {
+            $self->{hReadyFile}{$strFile} = true;
+        }
+        else
+        {
+            delete($self->{hReadyFile}{$strFile});
+        }
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+####################################################################################################################################
+# readyWatchFree
+#
+# Stop watching the archive status path.
+####################################################################################################################################
+sub readyWatchFree
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->readyWatchFree');
+
+    if (defined($self->{iReadyWatch}))
+    {
+        storagePosixWatchFree($self->{iReadyWatch});
+        delete($self->{iReadyWatch});
+    }
+
+    # The path must be read again once the watch is started
+    delete($self->{hReadyFile});
+
     # Return from function and log return values if any
     return logDebugReturn($strOperation);
 }
 
+####################################################################################################################################
+# readyStatusList
+#
+# Get the list of .ready files in the archive status path.  When the path is watched the .ready files are kept in memory and the
+# path is only read when the watch starts and every ARCHIVE_PUSH_ASYNC_RESCAN seconds after that.  Since events are applied in the
+# order they occurred the events queued while the path is being read leave the list correct.
+####################################################################################################################################
+sub readyStatusList
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->readyStatusList');
+
+    my $stryReadyFile;
+
+    if (defined($self->{iReadyWatch}))
+    {
+        $self->readyWatchRead(0);
+    }
+
+    # Read the path when it is not watched (or the watch could not be started again above)
+    if (!defined($self->{iReadyWatch}))
+    {
+        $stryReadyFile = $self->SUPER::readyStatusList();
+    }
+    else
+    {
+        if (!defined($self->{hReadyFile}) || time() - $self->{iReadyFileTime} >= ARCHIVE_PUSH_ASYNC_RESCAN)
+        {
+            $self->{hReadyFile} = {map {$_ => true} @{$self->SUPER::readyStatusList()}};
+            $self->{iReadyFileTime} = time();
+        }
+
+        $stryReadyFile = [sort(keys(%{$self->{hReadyFile}}))];
+    }
+
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'stryReadyFile', value => $stryReadyFile, ref => true}
+    );
+}
+
 ####################################################################################################################################
 # processServer
 #
@@ -173,10 +368,50 @@ sub processServer
     # Assign function parameters, defaults, and log debug info
     my ($strOperation) = logDebugParam(__PACKAGE__ . '->processServer');
 
-    # There is no loop here because it seems wise to let the async process exit periodically.  As the queue grows each async
-    # execution will naturally run longer.  This behavior is also far easier to test.
     $self->initServer();
-    $self->processQueue();
+
+    # Keep processing while new WAL is ready so the local processes, and the remote connections they hold, are reused between
+    # batches rather than started again for every async execution.  The async process still exits once no WAL has been ready for
+    # ARCHIVE_PUSH_ASYNC_LINGER seconds since it seems wise to let it exit periodically.  In test mode the process does not linger
+    # so each async execution runs a single batch, which is far easier to test.  Unit tests may pass a linger time to the
+    # constructor.
+    my $iLinger = defined($self->{iLinger}) ? $self->{iLinger} : (cfgOption(CFGOPT_TEST) ? 0 : ARCHIVE_PUSH_ASYNC_LINGER);
+    my $fLingerBegin = gettimeofday();
+
+    while (true)
+    {
+        my ($iNewTotal, $iDropTotal, $iOkTotal, $iErrorTotal) = $self->processQueue();
+
+        # Exit when WAL could not be pushed so it is not retried continuously.  The next archive-push will start a new async process
+        # to retry it.
+        last if $iErrorTotal > 0 || $iOkTotal + $iDropTotal < $iNewTotal;
+
+        # Restart the linger time whenever WAL was pushed
+        $fLingerBegin = gettimeofday() if $iNewTotal > 0;
+
+        # Keep the local processes and remote alive while waiting
+        $self->{oArchiveProcess}->keepAlive();
+        protocolKeepAlive();
+
+        last if gettimeofday() - $fLingerBegin >= $iLinger;
+
+        # Wait for new WAL.  When the archive status path is watched the wait ends as soon as a .ready file is written, otherwise
+        # the path is read again after a short sleep.
+        if (defined($self->{iReadyWatch}))
+        {
+            $self->readyWatchRead(ARCHIVE_PUSH_ASYNC_WATCH_WAIT);
+        }
+        else
+        {
+            waitHiRes(ARCHIVE_PUSH_ASYNC_POLL);
+        }
+
+        # Stop lingering if a stop was requested while waiting
+        lockStopTest();
+    }
+
+    $self->readyWatchFree();
+    $self->{oArchiveProcess}->close();
 
     # Return from function and log return values if any
     return logDebugReturn($strOperation);
@@ -197,12 +432,19 @@ sub processQueue
     # Get jobs to process
     my $stryWalFile = $self->readyList();
 
-    # Queue the jobs
-    foreach my $strWalFile (@{$stryWalFile})
+    # Queue the jobs in groups of consecutive files so archive.info and the archive paths are read once per group
+    my $iGroupSize = int((@{$stryWalFile} + cfgOption(CFGOPT_PROCESS_MAX) - 1) / cfgOption(CFGOPT_PROCESS_MAX));
+    $iGroupSize = ARCHIVE_PUSH_ASYNC_GROUP_MAX if $iGroupSize > ARCHIVE_PUSH_ASYNC_GROUP_MAX;
+
+    for (my $iWalIdx = 0; $iWalIdx < @{$stryWalFile}; $iWalIdx += $iGroupSize)
     {
+        my $iWalLastIdx = $iWalIdx + $iGroupSize - 1;
+        $iWalLastIdx = @{$stryWalFile} - 1 if $iWalLastIdx >= @{$stryWalFile};
+
         $self->{oArchiveProcess}->queueJob(
-            1, 'default', $strWalFile, OP_ARCHIVE_PUSH_FILE,
-            [$self->{strWalPath}, $strWalFile, cfgOption(CFGOPT_COMPRESS), cfgOption(CFGOPT_COMPRESS_LEVEL)]);
+            1, 'default', ${$stryWalFile}[$iWalIdx], OP_ARCHIVE_PUSH_FILE_GROUP,
+            [$self->{strWalPath}, [@{$stryWalFile}[$iWalIdx .. $iWalLastIdx]], cfgOption(CFGOPT_COMPRESS),
+                cfgOption(CFGOPT_COMPRESS_LEVEL)]);
     }
 
     # Process jobs if there are any
@@ -228,31 +470,45 @@ sub processQueue
 
                 foreach my $hJob (@{$hyJob})
                 {
-                    my $strWalFile = @{$hJob->{rParam}}[1];
-                    my $strWarning = @{$hJob->{rResult}}[0];
+                    # If the job failed then all files in the group failed
+                    my $hyResult = defined($hJob->{oException}) ?
+                        [map {{strWalFile => $_, iErrorCode => $hJob->{oException}->code(),
+                            strErrorMessage => $hJob->{oException}->message()}} @{@{$hJob->{rParam}}[1]}] :
+                        @{$hJob->{rResult}}[0];
 
-                    # If error then write out an error file
-                    if (defined($hJob->{oException}))
+                    foreach my $hResult (@{$hyResult})
                     {
-                        $self->walStatusWrite(
-                            WAL_STATUS_ERROR, $strWalFile, $hJob->{oException}->code(), $hJob->{oException}->message());
+                        my $strWalFile = $hResult->{strWalFile};
 
-                        $iErrorTotal++;
+                        # If error then write out an error file
+                        if (defined($hResult->{iErrorCode}))
+                        {
+                            # Errors caught in the group are reported the same way as errors raised by the local process
+                            my $strErrorMessage =
+                                (defined($hJob->{oException}) ? '' : "raised from local-$hJob->{iProcessId} process: ") .
+                                $hResult->{strErrorMessage};
 
-                        &log(WARN,
-                            "could not push WAl file ${strWalFile} to archive (will be retried): [" .
-                                $hJob->{oException}->code() . "] " . $hJob->{oException}->message());
-                    }
-                    # Else write success
-                    else
-                    {
-                        $self->walStatusWrite(
-                            WAL_STATUS_OK, $strWalFile, defined($strWarning) ? 0 : undef,
-                            defined($strWarning) ? $strWarning : undef);
+                            $self->walStatusWrite(WAL_STATUS_ERROR, $strWalFile, $hResult->{iErrorCode}, $strErrorMessage);
+
+                            $iErrorTotal++;
+
+                            &log(WARN,
+                                "could not push WAl file ${strWalFile} to archive (will be retried): [" .
+                                    $hResult->{iErrorCode} . "] " . $strErrorMessage);
+                        }
+                        # Else write success
+                        else
+                        {
+                            my $strWarning = $hResult->{strWarning};
+
+                            $self->walStatusWrite(
+                                WAL_STATUS_OK, $strWalFile, defined($strWarning) ? 0 : undef,
+                                defined($strWarning) ? $strWarning : undef);
 
-                        $iOkTotal++;
+                            $iOkTotal++;
 
-                        &log(DETAIL, "pushed WAL file ${strWalFile} to archive", undef, undef, undef, $hJob->{iProcessId});
+                            &log(DETAIL, "pushed WAL file ${strWalFile} to archive", undef, undef, undef, $hJob->{iProcessId});
+                        }
                     }
                 }
 
@@ -21,13 +21,77 @@ use pgBackRest::Protocol::Helper;
 use pgBackRest::Protocol::Storage::Helper;
 use pgBackRest::Storage::Filter::Gzip;
 use pgBackRest::Storage::Filter::Sha;
+use pgBackRest::Storage::Filter::Zero;
 use pgBackRest::Storage::Helper;
 
+####################################################################################################################################
+# archivePushInfo
+#
+# Get archive info for checking pushed WAL.  Processes that push many segments (the async local processes and the remote) keep the
+# archive info loaded and only load it again when the file changes, which is detected with a stat of the file (or the ETag on S3)
+# rather than reading and checksumming the file and its copy for every segment.
+####################################################################################################################################
+my $hArchiveInfoCache;
+
+sub archivePushInfo
+{
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '::archivePushInfo');
+
+    my $oStorageRepo = storageRepo();
+    my $strKey;
+
+    # Get a key that changes whenever the file is written.  If the file cannot be found then it is loaded below so the copy can be
+    # used or the usual error raised.
+    eval
+    {
+        my $oInfo = $oStorageRepo->info(STORAGE_REPO_ARCHIVE . qw{/} . ARCHIVE_INFO_FILE);
+
+        $strKey =
+            "${oStorageRepo}:" .
+            ($oInfo->can('etag') ? $oInfo->etag() : join(':', $oInfo->dev(), $oInfo->ino(), $oInfo->mtime(), $oInfo->size()));
+
+        return true;
+    }
+    or do
+    {
+        undef($strKey);
+    };
+
+    # Load the file if it has changed.  The key is read before the file is loaded so a change made while loading is seen next time.
+    my $oArchiveInfo;
+
+    if (defined($strKey) && defined($hArchiveInfoCache) && $hArchiveInfoCache->{strKey} eq $strKey)
+    {
+        $oArchiveInfo = $hArchiveInfoCache->{oArchiveInfo};
+    }
+    else
+    {
+        $oArchiveInfo = new pgBackRest::Archive::Info($oStorageRepo->pathGet(STORAGE_REPO_ARCHIVE));
+        $hArchiveInfoCache = defined($strKey) ? {strKey => $strKey, oArchiveInfo => $oArchiveInfo} : undef;
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'oArchiveInfo', value => $oArchiveInfo, trace => true}
+    );
+}
+
+push @EXPORT, qw(archivePushInfo);
+
 ####################################################################################################################################
 # archivePushCheck
 #
 # Check that a WAL segment does not already exist in the archive be pushing.  Files that are not segments (e.g. .history, .backup)
 # will always be reported as not present and will be overwritten by archivePushFile().
+#
+# When the repo is remote the caller may submit the check with cmdSubmit() and pass the command id so other work can be done while
+# waiting for the result.  The WAL hash may also be passed if the caller has already calculated it.
+#
+# When the repo is local the caller may pass archive info that has already been loaded and set bCache to find segments using the WAL
+# segment cache (see archivePushFileGroup()).
 ####################################################################################################################################
 sub archivePushCheck
 {
@@ -39,6 +103,10 @@ sub archivePushCheck
         $strDbVersion,
         $ullDbSysId,
         $strWalFile,
+        $iCheckId,
+        $strWalHash,
+        $oArchiveInfo,
+        $bCache,
     ) =
         logDebugParam
         (
@@ -47,6 +115,10 @@ sub archivePushCheck
             {name => 'strDbVersion', required => false},
             {name => 'ullDbSysId', required => false},
             {name => 'strWalFile', required => false},
+            {name => 'iCheckId', required => false, trace => true},
+            {name => 'strWalHash', required => false, trace => true},
+            {name => 'oArchiveInfo', required => false, trace => true},
+            {name => 'bCache', required => false, default => false, trace => true},
         );
 
     # Set operation and debug strings
@@ -59,21 +131,32 @@ sub archivePushCheck
 
     if (!isRepoLocal())
     {
-        # Execute the command
-        ($strArchiveId, $strChecksum) = protocolGet(CFGOPTVAL_REMOTE_TYPE_BACKUP)->cmdExecute(
-            OP_ARCHIVE_PUSH_CHECK, [$strArchiveFile, $strDbVersion, $ullDbSysId], true);
+        my $oProtocol = protocolGet(CFGOPTVAL_REMOTE_TYPE_BACKUP);
+
+        # Get the result if the check was already submitted, else execute the command
+        ($strArchiveId, $strChecksum) = defined($iCheckId) ?
+            $oProtocol->cmdResult($iCheckId, true) :
+            $oProtocol->cmdExecute(OP_ARCHIVE_PUSH_CHECK, [$strArchiveFile, $strDbVersion, $ullDbSysId], true);
     }
     else
     {
+        # Load the info file if it was not passed.  The remote checks segments for the life of the calling process so it keeps the
+        # info loaded.
+        if (!defined($oArchiveInfo))
+        {
+            $oArchiveInfo = cfgCommandTest(CFGCMD_REMOTE) ?
+                archivePushInfo() : new pgBackRest::Archive::Info($oStorageRepo->pathGet(STORAGE_REPO_ARCHIVE));
+        }
+
         # If a segment check db version and system-id
         if ($bWalSegment)
         {
             # If the info file exists check db version and system-id else error
-            $strArchiveId = (new pgBackRest::Archive::Info(
-                $oStorageRepo->pathGet(STORAGE_REPO_ARCHIVE)))->check($strDbVersion, $ullDbSysId);
+            $strArchiveId = $oArchiveInfo->check($strDbVersion, $ullDbSysId);
 
             # Check if the WAL segment already exists in the archive
-            my $strFoundFile = walSegmentFind($oStorageRepo, $strArchiveId, $strArchiveFile);
+            my $strFoundFile = walSegmentFind(
+                $oStorageRepo, $strArchiveId, $strArchiveFile, undef, {bCache => $bCache, bCacheMissing => $bCache});
 
             if (defined($strFoundFile))
             {
@@ -83,7 +166,7 @@ sub archivePushCheck
         # Else just get the archive id
         else
         {
-            $strArchiveId = (new pgBackRest::Archive::Info($oStorageRepo->pathGet(STORAGE_REPO_ARCHIVE)))->archiveId();
+            $strArchiveId = $oArchiveInfo->archiveId();
         }
     }
 
@@ -91,7 +174,12 @@ sub archivePushCheck
 
     if (defined($strChecksum) && !cfgCommandTest(CFGCMD_REMOTE))
     {
-        my ($strChecksumNew) = storageDb()->hashSize($strWalFile);
+        my $strChecksumNew = $strWalHash;
+
+        if (!defined($strChecksumNew))
+        {
+            ($strChecksumNew) = storageDb()->hashSize($strWalFile);
+        }
 
         if ($strChecksumNew ne $strChecksum)
         {
@@ -120,7 +208,7 @@ push @EXPORT, qw(archivePushCheck);
 ####################################################################################################################################
 # archivePushFile
 #
-# Copy a file from the WAL directory to the archive.
+# Copy a file from the WAL directory to the archive.  The optional parameters are used by archivePushFileGroup().
 ####################################################################################################################################
 sub archivePushFile
 {
@@ -132,6 +220,9 @@ sub archivePushFile
         $strWalFile,
         $bCompress,
         $iCompressLevel,
+        $iCheckId,
+        $oArchiveInfo,
+        $bCache,
     ) =
         logDebugParam
         (
@@ -140,6 +231,9 @@ sub archivePushFile
             {name => 'strWalFile'},
             {name => 'bCompress'},
             {name => 'iCompressLevel'},
+            {name => 'iCheckId', optional => true, trace => true},
+            {name => 'oArchiveInfo', optional => true, trace => true},
+            {name => 'bCache', optional => true, default => false, trace => true},
         );
 
     # Get cluster info from the WAL
@@ -152,9 +246,27 @@ sub archivePushFile
         ($strDbVersion, $ullDbSysId) = walInfo("${strWalPath}/${strWalFile}");
     }
 
+    # When the repo is remote submit the check without waiting (unless it was already submitted) and hash the segment while the
+    # remote is working.  The hash is required whether or not the segment already exists in the repo so no work is wasted.
+    my $strSourceHash;
+    my $lSourceSize;
+
+    if (!isRepoLocal())
+    {
+        $iCheckId = protocolGet(CFGOPTVAL_REMOTE_TYPE_BACKUP)->cmdSubmit(
+            OP_ARCHIVE_PUSH_CHECK, [$strWalFile, $strDbVersion, $ullDbSysId])
+            if !defined($iCheckId);
+
+        if (walIsSegment($strWalFile))
+        {
+            ($strSourceHash, $lSourceSize) = storageDb()->hashSize("${strWalPath}/${strWalFile}");
+        }
+    }
+
     # Check if the WAL already exists in the repo
     my ($strArchiveId, $strChecksum, $strWarning) = archivePushCheck(
-        $strWalFile, $strDbVersion, $ullDbSysId, walIsSegment($strWalFile) ? "${strWalPath}/${strWalFile}" : undef);
+        $strWalFile, $strDbVersion, $ullDbSysId, walIsSegment($strWalFile) ? "${strWalPath}/${strWalFile}" : undef, $iCheckId,
+        $strSourceHash, $oArchiveInfo, $bCache);
 
     # Only copy the WAL segment if checksum is not defined.  If checksum is defined it means that the WAL segment already exists
     # in the repository with the same checksum (else there would have been an error on checksum mismatch).
@@ -165,8 +277,11 @@ sub archivePushFile
         # If a WAL segment
         if (walIsSegment($strWalFile))
         {
-            # Get hash
-            my ($strSourceHash) = storageDb()->hashSize("${strWalPath}/${strWalFile}");
+            # Get hash if it was not calculated above
+            if (!defined($strSourceHash))
+            {
+                ($strSourceHash, $lSourceSize) = storageDb()->hashSize("${strWalPath}/${strWalFile}");
+            }
 
             $strArchiveFile .= "-${strSourceHash}";
 
@@ -182,7 +297,11 @@ sub archivePushFile
 
         if (walIsSegment($strWalFile) && $bCompress)
         {
-            push(@{$rhyFilter}, {strClass => STORAGE_FILTER_GZIP, rxyParam => [{iLevel => $iCompressLevel}]});
+            # Only store the used part of the segment.  The segment size is stored in the gzip header so decompression can restore
+            # the zeros trimmed from the end.
+            push(
+                @{$rhyFilter}, {strClass => STORAGE_FILTER_ZERO},
+                {strClass => STORAGE_FILTER_GZIP, rxyParam => [{iLevel => $iCompressLevel, lOriginalSize => $lSourceSize}]});
         }
 
         # Copy
@@ -197,10 +316,167 @@ sub archivePushFile
     return logDebugReturn
     (
         $strOperation,
-        {name => 'strWarning', value => $strWarning}
+        {name => 'strWarning', value => $strWarning},
+        {name => 'strArchiveId', value => $strArchiveId, log => false}
     );
 }
 
 push @EXPORT, qw(archivePushFile);
 
+####################################################################################################################################
+# archivePushFileGroup
+#
+# Copy a group of consecutive files from the WAL directory to the archive.  The group shares work that archivePushFile() would do
+# for every file:
+#
+# * When the repo is local archive.info is checked once and each archive path is listed once to find segments that already exist.
+#   The archive paths written are synced once at the end rather than not at all.
+# * When the repo is remote the checks for all files are submitted before the first file is copied so the remote checks the next
+#   files while the current file is compressed and sent.
+#
+# Files are pushed independently so an error on one file does not stop the rest of the group.  Returns a result for each file with
+# the warning (if any) or the error code and message.
+####################################################################################################################################
+sub archivePushFileGroup
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $strWalPath,
+        $stryWalFile,
+        $bCompress,
+        $iCompressLevel,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::archivePushFileGroup', \@_,
+            {name => 'strWalPath'},
+            {name => 'stryWalFile'},
+            {name => 'bCompress'},
+            {name => 'iCompressLevel'},
+        );
+
+    my $oStorageRepo = storageRepo();
+    my $bRepoLocal = isRepoLocal();
+    my $hyResult = [map {{strWalFile => $_}} @{$stryWalFile}];
+
+    # Store the error for a file
+    my $fnError = sub
+    {
+        my $hResult = shift;
+        my $oException = shift;
+
+        $hResult->{iErrorCode} = exceptionCode($oException);
+        $hResult->{strErrorMessage} = exceptionMessage($oException);
+    };
+
+    # Prepare the group
+    my $oArchiveInfo;
+
+    eval
+    {
+        # Get archive.info once for the group (it is only loaded again when it changes).  Segments already in the archive are found
+        # with one list of each archive path -- the list is cleared first so segments missing from a list made before the group
+        # started are not trusted.
+        if ($bRepoLocal)
+        {
+            $oArchiveInfo = archivePushInfo();
+            walSegmentCacheClear();
+        }
+        # Else submit all the checks
+        else
+        {
+            my $oProtocol = protocolGet(CFGOPTVAL_REMOTE_TYPE_BACKUP);
+
+            foreach my $hResult (@{$hyResult})
+            {
+                eval
+                {
+                    my ($strDbVersion, $ullDbSysId) =
+                        walIsSegment($hResult->{strWalFile}) ? walInfo("${strWalPath}/$hResult->{strWalFile}") : ();
+
+                    $hResult->{iCheckId} = $oProtocol->cmdSubmit(
+                        OP_ARCHIVE_PUSH_CHECK, [$hResult->{strWalFile}, $strDbVersion, $ullDbSysId]);
+
+                    return true;
+                }
+                or do
+                {
+                    $fnError->($hResult, $EVAL_ERROR);
+                };
+            }
+        }
+
+        return true;
+    }
+    or do
+    {
+        $fnError->($_, $EVAL_ERROR) foreach (@{$hyResult});
+    };
+
+    # Push the files
+    my $hSyncPath = {};
+
+    foreach my $hResult (@{$hyResult})
+    {
+        next if defined($hResult->{iErrorCode});
+
+        eval
+        {
+            my $strWalFile = $hResult->{strWalFile};
+
+            # Send keep alives to protocol
+            protocolKeepAlive();
+
+            my $strArchiveId;
+
+            ($hResult->{strWarning}, $strArchiveId) = archivePushFile(
+                $strWalPath, $strWalFile, $bCompress, $iCompressLevel,
+                {iCheckId => $hResult->{iCheckId}, oArchiveInfo => $oArchiveInfo, bCache => $bRepoLocal});
+
+            # A file was copied unless it was already in the archive (which always generates a warning)
+            if ($bRepoLocal && !defined($hResult->{strWarning}))
+            {
+                push(
+                    @{$hSyncPath->{STORAGE_REPO_ARCHIVE . "/${strArchiveId}" .
+                        (walIsSegment($strWalFile) ? '/' . substr($strWalFile, 0, 16) : '')}},
+                    $hResult);
+            }
+
+            return true;
+        }
+        or do
+        {
+            $fnError->($hResult, $EVAL_ERROR);
+        };
+    }
+
+    # Sync the paths written.  If a path cannot be synced then error the files written to it so they will be pushed again.
+    foreach my $strSyncPath (sort(keys(%{$hSyncPath})))
+    {
+        eval
+        {
+            $oStorageRepo->pathSync($strSyncPath);
+            return true;
+        }
+        or do
+        {
+            my $oException = $EVAL_ERROR;
+            $fnError->($_, $oException) foreach (@{$hSyncPath->{$strSyncPath}});
+        };
+    }
+
+    walSegmentCacheClear() if $bRepoLocal;
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'hyResult', value => $hyResult, ref => true, trace => true}
+    );
+}
+
+push @EXPORT, qw(archivePushFileGroup);
+
 1;
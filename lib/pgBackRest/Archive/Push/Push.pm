@@ -272,14 +272,13 @@ sub readyList
     }
 
     # Read the .ready files
-    my $strWalStatusPath = "$self->{strWalPath}/archive_status";
-    my @stryReadyFile = storageDb()->list($strWalStatusPath, {strExpression => '\.ready$'});
+    my $stryReadyFile = $self->readyStatusList();
 
     # Generate a list of new files
     my @stryNewReadyFile;
     my $hReadyFile = {};
 
-    foreach my $strReadyFile (@stryReadyFile)
+    foreach my $strReadyFile (@{$stryReadyFile})
     {
         # Remove .ready extension
         $strReadyFile = substr($strReadyFile, 0, length($strReadyFile) - length('.ready'));
@@ -311,6 +310,27 @@ sub readyList
     );
 }
 
+####################################################################################################################################
+# readyStatusList
+#
+# Get the list of .ready files in the archive status path.
+####################################################################################################################################
+sub readyStatusList
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->readyStatusList');
+
+    my @stryReadyFile = storageDb()->list("$self->{strWalPath}/archive_status", {strExpression => '\.ready$'});
+
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'stryReadyFile', value => \@stryReadyFile, ref => true}
+    );
+}
+
 ####################################################################################################################################
 # dropList
 #
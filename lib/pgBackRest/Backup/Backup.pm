@@ -19,6 +19,7 @@ use pgBackRest::Backup::Info;
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Exit;
 use pgBackRest::Common::Ini;
+use pgBackRest::Common::Limit;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::Wait;
 use pgBackRest::Common::String;
@@ -239,7 +240,28 @@ sub processManifest
         $oBackupProcess->hostAdd($self->{iMasterRemoteIdx}, 1);
     }
 
-    $oBackupProcess->hostAdd($self->{iCopyRemoteIdx}, cfgOption(CFGOPT_PROCESS_MAX));
+    # In auto mode the number of processes copying from the database host is adjusted to throughput and, if a load max is set, the
+    # load average of the host
+    my $rhProcessAuto;
+
+    if (cfgOption(CFGOPT_PROCESS_AUTO))
+    {
+        my $oStorageDbCopy = storageDb({iRemoteIdx => $self->{iCopyRemoteIdx}});
+
+        $rhProcessAuto =
+        {
+            fLoadMax => cfgOption(CFGOPT_PROCESS_LOAD_MAX, false),
+            fnLoad => sub
+            {
+                my $rstrLoad = $oStorageDbCopy->get($oStorageDbCopy->openRead('/proc/loadavg', {bIgnoreMissing => true}));
+
+                return defined($rstrLoad) && defined($$rstrLoad) ? (split(' ', $$rstrLoad))[0] : undef;
+            },
+        };
+    }
+
+    $oBackupProcess->hostAdd(
+        $self->{iCopyRemoteIdx}, cfgOption(CFGOPT_PROCESS_MAX), cfgOption(CFGOPT_PROCESS_DEVICE_MAX, false), $rhProcessAuto);
 
     # Variables used for parallel copy
     my $lFileTotal = 0;
@@ -276,11 +298,26 @@ sub processManifest
         iWalOffset => defined($strLsnStart) ? hex((split('/', $strLsnStart))[1]) : 0xFFFF,
     };
 
-    # Iterate all files in the manifest
-    foreach my $strRepoFile (
-        sort {sprintf("%016d-${b}", $oBackupManifest->numericGet(MANIFEST_SECTION_TARGET_FILE, $b, MANIFEST_SUBKEY_SIZE)) cmp
-              sprintf("%016d-${a}", $oBackupManifest->numericGet(MANIFEST_SECTION_TARGET_FILE, $a, MANIFEST_SUBKEY_SIZE))}
-        ($oBackupManifest->keys(MANIFEST_SECTION_TARGET_FILE, INI_SORT_NONE)))
+    # Get file sizes once so they are not looked up for every comparison in the sort.  Also total the size of files that will be
+    # copied to determine which files are too large to be copied by a single local process.
+    my %hFileSize;
+    my $lSizeCopyTotal = 0;
+
+    foreach my $strRepoFile ($oBackupManifest->keys(MANIFEST_SECTION_TARGET_FILE, INI_SORT_NONE))
+    {
+        $hFileSize{$strRepoFile} = $oBackupManifest->numericGet(MANIFEST_SECTION_TARGET_FILE, $strRepoFile, MANIFEST_SUBKEY_SIZE);
+
+        if (!$oBackupManifest->test(MANIFEST_SECTION_TARGET_FILE, $strRepoFile, MANIFEST_SUBKEY_REFERENCE))
+        {
+            $lSizeCopyTotal += $hFileSize{$strRepoFile};
+        }
+    }
+
+    # Files that are copied in parts and need to be assembled when all the parts are complete
+    my %hFilePart;
+
+    # Iterate all files in the manifest from largest to smallest
+    foreach my $strRepoFile (sort {$hFileSize{$b} <=> $hFileSize{$a} || $b cmp $a} keys(%hFileSize))
     {
         # If the file has a reference it does not need to be copied since it can be retrieved from the referenced backup.
         # However, if hard-linking is turned on the link will need to be created
@@ -329,6 +366,10 @@ sub processManifest
             $iHostConfigIdx = $self->{iMasterRemoteIdx};
         }
 
+        # Tag the job with the device the file is read from so reads can be spread across devices.  Devices are recorded when the
+        # manifest is built on the master so they are not known for files copied from a standby.
+        my $strDevice = $iHostConfigIdx == $self->{iMasterRemoteIdx} ? $oBackupManifest->fileDevice($strRepoFile) : undef;
+
         # Make sure that pg_control is not removed during the backup
         if ($strRepoFile eq MANIFEST_TARGET_PGDATA . '/' . DB_FILE_PGCONTROL)
         {
@@ -336,20 +377,57 @@ sub processManifest
         }
 
         # Increment file total and size
-        my $lSize = $oBackupManifest->numericGet(MANIFEST_SECTION_TARGET_FILE, $strRepoFile, MANIFEST_SUBKEY_SIZE);
+        my $lSize = $hFileSize{$strRepoFile};
 
         $lFileTotal++;
         $lSizeTotal += $lSize;
 
-        # Queue for parallel backup
-        $oBackupProcess->queueJob(
-            $iHostConfigIdx, $strQueueKey, $strRepoFile, OP_BACKUP_FILE,
-            [$strDbFile, $strRepoFile, $lSize,
-                $oBackupManifest->get(MANIFEST_SECTION_TARGET_FILE, $strRepoFile, MANIFEST_SUBKEY_CHECKSUM, false),
+        my $strChecksum = $oBackupManifest->get(MANIFEST_SECTION_TARGET_FILE, $strRepoFile, MANIFEST_SUBKEY_CHECKSUM, false);
+        my $rParam =
+            [$strDbFile, $strRepoFile, $lSize, $strChecksum,
                 cfgOption(CFGOPT_CHECKSUM_PAGE) ? isChecksumPage($strRepoFile) : false, $strBackupLabel, $bCompress,
                 cfgOption(CFGOPT_COMPRESS_LEVEL), $oBackupManifest->numericGet(MANIFEST_SECTION_TARGET_FILE, $strRepoFile,
                 MANIFEST_SUBKEY_TIMESTAMP, false), $bIgnoreMissing,
-                cfgOption(CFGOPT_CHECKSUM_PAGE) && isChecksumPage($strRepoFile) ? $hStartLsnParam : undef]);
+                cfgOption(CFGOPT_CHECKSUM_PAGE) && isChecksumPage($strRepoFile) ? $hStartLsnParam : undef];
+
+        # If the file is larger than its share of the backup then split it into page-aligned parts that can be copied in parallel.
+        # Resumed files are not split since they only need to be checksummed.
+        my $iProcessMax = cfgOption(CFGOPT_PROCESS_MAX);
+        my $lPartSize;
+
+        if (!defined($strChecksum) && $iHostConfigIdx == $self->{iCopyRemoteIdx} && $iProcessMax > 1 &&
+            $lSize > $lSizeCopyTotal / $iProcessMax && $lSize >= BACKUP_FILE_PART_SIZE_MIN * 2)
+        {
+            my $iPartTotal = int($lSize / BACKUP_FILE_PART_SIZE_MIN);
+            $iPartTotal = $iProcessMax if $iPartTotal > $iProcessMax;
+
+            $lPartSize = int(($lSize + $iPartTotal - 1) / $iPartTotal);
+            $lPartSize = int(($lPartSize + PG_PAGE_SIZE - 1) / PG_PAGE_SIZE) * PG_PAGE_SIZE;
+        }
+
+        # Queue for parallel backup
+        if (defined($lPartSize))
+        {
+            $hFilePart{$strRepoFile} = {iHostConfigIdx => $iHostConfigIdx, strQueueKey => $strQueueKey, rParam => $rParam};
+
+            for (my $lOffset = 0; $lOffset < $lSize; $lOffset += $lPartSize)
+            {
+                # The last part is copied to the end of the file in case the file has grown
+                my $lLength = $lOffset + $lPartSize < $lSize ? $lPartSize : undef;
+
+                $oBackupProcess->queueJob(
+                    $iHostConfigIdx, $strQueueKey, $strRepoFile, OP_BACKUP_FILE, [@{$rParam}, $lOffset, $lLength],
+                    defined($lLength) ? $lLength : $lSize - $lOffset, false, $strDevice);
+
+                $hFilePart{$strRepoFile}{iPartTotal}++;
+            }
+        }
+        else
+        {
+            $oBackupProcess->queueJob(
+                $iHostConfigIdx, $strQueueKey, $strRepoFile, OP_BACKUP_FILE, $rParam, $lSize, $lSize <= BACKUP_FILE_BATCH_SIZE,
+                $strDevice);
+        }
 
         # Size and checksum will be removed and then verified later as a sanity check
         $oBackupManifest->remove(MANIFEST_SECTION_TARGET_FILE, $strRepoFile, MANIFEST_SUBKEY_SIZE);
@@ -383,22 +461,95 @@ sub processManifest
         $lManifestSaveSize = cfgOption(CFGOPT_MANIFEST_SAVE_THRESHOLD);
     }
 
-    # Run the backup jobs and process results
-    while (my $hyJob = $oBackupProcess->process())
+    # If data written to the repository is persisted as it is written then record completed files in a journal rather than saving
+    # the entire manifest
+    if (storageRepo()->driver()->capability(STORAGE_CAPABILITY_APPEND))
+    {
+        $oBackupManifest->journalOpen();
+    }
+
+    # Share the rate limit with the local processes
+    my $bLimit = cfgOptionTest(CFGOPT_RATE_MAX) || cfgOptionTest(CFGOPT_RATE_DEVICE_MAX);
+
+    if ($bLimit)
     {
-        foreach my $hJob (@{$hyJob})
+        limitCreate(
+            cfgOptionTest(CFGOPT_RATE_MAX) ? cfgOption(CFGOPT_RATE_MAX) : 0,
+            cfgOptionTest(CFGOPT_RATE_DEVICE_MAX) ? cfgOption(CFGOPT_RATE_DEVICE_MAX) : 0);
+    }
+
+    # Run the backup jobs and process results.  Files copied in parts are assembled by a second run once all the parts are complete.
+    my $bProcess = true;
+    my $rhyProcessTime;
+
+    while ($bProcess)
+    {
+        while (my $hyJob = $oBackupProcess->process())
         {
-            ($lSizeCurrent, $lManifestSaveCurrent) = backupManifestUpdate(
-                $oBackupManifest, cfgOption(cfgOptionIndex(CFGOPT_DB_HOST, $hJob->{iHostConfigIdx}), false), $hJob->{iProcessId},
-                @{$hJob->{rParam}}[0..4], @{$hJob->{rResult}},
-                $lSizeTotal, $lSizeCurrent, $lManifestSaveSize, $lManifestSaveCurrent);
+            foreach my $hJob (@{$hyJob})
+            {
+                # Store the result of each part until the file can be assembled
+                if ($hJob->{strOp} eq OP_BACKUP_FILE && defined($hFilePart{$hJob->{strKey}}))
+                {
+                    push(
+                        @{$hFilePart{$hJob->{strKey}}{hyPart}},
+                        {lOffset => $hJob->{rParam}[11], lLength => $hJob->{rParam}[12], rResult => $hJob->{rResult}});
+                    next;
+                }
+
+                ($lSizeCurrent, $lManifestSaveCurrent) = backupManifestUpdate(
+                    $oBackupManifest, cfgOption(cfgOptionIndex(CFGOPT_DB_HOST, $hJob->{iHostConfigIdx}), false),
+                    $hJob->{iProcessId}, @{$hJob->{rParam}}[0..4], @{$hJob->{rResult}},
+                    $lSizeTotal, $lSizeCurrent, $lManifestSaveSize, $lManifestSaveCurrent);
+            }
+
+            # A keep-alive is required here because if there are a large number of resumed files that need to be checksummed
+            # then the remote might timeout while waiting for a command.
+            protocolKeepAlive();
+        }
+
+        # Idle time is reported for the copy but not the assembly
+        $rhyProcessTime = $oBackupProcess->processTime() if !defined($rhyProcessTime);
+
+        # Queue assembly of files copied in parts
+        $bProcess = false;
+
+        foreach my $strRepoFile (sort(keys(%hFilePart)))
+        {
+            my $hFile = $hFilePart{$strRepoFile};
+
+            if (@{$hFile->{hyPart}} != $hFile->{iPartTotal})
+            {
+                confess &log(
+                    ASSERT, "${strRepoFile} has $hFile->{iPartTotal} parts but only " . @{$hFile->{hyPart}} . ' completed');
+            }
+
+            $oBackupProcess->queueJob(
+                $hFile->{iHostConfigIdx}, $hFile->{strQueueKey}, $strRepoFile, OP_BACKUP_FILE_ASSEMBLE,
+                [@{$hFile->{rParam}}, $hFile->{hyPart}], $hFile->{rParam}[2]);
+
+            $bProcess = true;
         }
 
-        # A keep-alive is required here because if there are a large number of resumed files that need to be checksummed
-        # then the remote might timeout while waiting for a command.
-        protocolKeepAlive();
+        %hFilePart = ();
+    }
+
+    if ($bLimit)
+    {
+        limitRemove();
+    }
+
+    # Report idle time for each local process.  High idle time means that the jobs could not be evenly divided between the
+    # processes.
+    foreach my $hProcessTime (@{$rhyProcessTime})
+    {
+        &log(DETAIL,
+            "local process $hProcessTime->{iProcessId} idle " . sprintf('%.2fs of %.2fs', $hProcessTime->{fIdleTime},
+                $hProcessTime->{fTotalTime}));
     }
 
+    $oBackupManifest->journalClose();
+
     # Validate the manifest
     $oBackupManifest->validate();
 
@@ -487,7 +638,7 @@ sub process
         if (defined($strBackupLastPath) && $oBackupInfo->confirmDb($strBackupLastPath, $strDbVersion, $ullDbSysId))
         {
             $oLastManifest = new pgBackRest::Manifest(
-                $oStorageRepo->pathGet(STORAGE_REPO_BACKUP . "/${strBackupLastPath}/" . FILE_MANIFEST));
+                $oStorageRepo->pathGet(STORAGE_REPO_BACKUP . "/${strBackupLastPath}/" . FILE_MANIFEST), {bBinary => true});
 
             &log(INFO, 'last backup label = ' . $oLastManifest->get(MANIFEST_SECTION_BACKUP, MANIFEST_KEY_LABEL) .
                        ', version = ' . $oLastManifest->get(INI_SECTION_BACKREST, INI_KEY_VERSION));
@@ -543,8 +694,9 @@ sub process
 
                 eval
                 {
-                    # Load the aborted manifest
+                    # Load the aborted manifest and apply files completed since it was saved
                     $oAbortedManifest = new pgBackRest::Manifest("${strBackupPath}/" . FILE_MANIFEST);
+                    $oAbortedManifest->journalReplay();
 
                     # Key and values that do not match
                     my $strKey;
@@ -886,26 +1038,55 @@ sub process
         # After the backup has been stopped, need to make a copy of the archive logs to make the db consistent
         logDebugMisc($strOperation, "retrieve archive logs ${strArchiveStart}:${strArchiveStop}");
         my $strArchiveId = new pgBackRest::Archive::Get::Get()->getArchiveId();
-        my @stryArchive = lsnFileRange($strLsnStart, $strLsnStop, $strDbVersion);
+        my $stryArchive = [map {substr($strArchiveStop, 0, 8) . $_} lsnFileRange($strLsnStart, $strLsnStop, $strDbVersion)];
+
+        # Each archive path is listed once to find all the segments.  When the segments span more than one path the paths are listed
+        # in parallel by local processes.
+        my $oArchiveProcess;
 
-        foreach my $strArchive (@stryArchive)
+        if (cfgOption(CFGOPT_PROCESS_MAX) > 1 && keys(%{{map {substr($_, 0, 16) => true} @{$stryArchive}}}) > 1)
         {
-            my $strArchiveFile = walSegmentFind(
-                $oStorageRepo, $strArchiveId, substr($strArchiveStop, 0, 8) . $strArchive, cfgOption(CFGOPT_ARCHIVE_TIMEOUT));
+            $oArchiveProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP);
+            $oArchiveProcess->hostAdd(1, cfgOption(CFGOPT_PROCESS_MAX));
+        }
+
+        my $stryArchiveFile = walSegmentFindList(
+            $oStorageRepo, $strArchiveId, $stryArchive, cfgOption(CFGOPT_ARCHIVE_TIMEOUT), {oProcess => $oArchiveProcess});
 
-            $strArchive = substr($strArchiveFile, 0, 24);
+        foreach my $strArchiveFile (@{$stryArchiveFile})
+        {
+            my $strArchive = substr($strArchiveFile, 0, 24);
 
             if (cfgOption(CFGOPT_ARCHIVE_COPY))
             {
                 logDebugMisc($strOperation, "archive: ${strArchive} (${strArchiveFile})");
 
-                # Copy the log file from the archive repo to the backup
-                my $bArchiveCompressed = $strArchiveFile =~ ('^.*\.' . COMPRESS_EXT . '\$');
-
-                $oStorageRepo->copy(
-                    STORAGE_REPO_ARCHIVE . "/${strArchiveId}/${strArchiveFile}",
+                # Copy the log file from the archive repo to the backup.  The file is copied as-is unless the compression differs,
+                # in which case decompression also restores the zeros trimmed from the end of the segment when it was pushed.
+                my $bArchiveCompressed = $strArchiveFile =~ ('^.*\.' . COMPRESS_EXT . '$') ? true : false;
+                my $strArchiveSource = STORAGE_REPO_ARCHIVE . "/${strArchiveId}/${strArchiveFile}";
+                my $strArchiveDestination =
                     STORAGE_REPO_BACKUP . "/${strBackupLabel}/" . MANIFEST_TARGET_PGDATA . qw{/} . $oBackupManifest->walPath() .
-                        "/${strArchive}" . ($bCompress ? qw{.} . COMPRESS_EXT : ''));
+                        "/${strArchive}" . ($bCompress ? qw{.} . COMPRESS_EXT : '');
+
+                if ($bArchiveCompressed == $bCompress)
+                {
+                    $oStorageRepo->copy($strArchiveSource, $strArchiveDestination);
+                }
+                else
+                {
+                    $oStorageRepo->copy(
+                        $oStorageRepo->openRead(
+                            $strArchiveSource,
+                            {rhyFilter => $bArchiveCompressed ?
+                                [{strClass => STORAGE_FILTER_GZIP, rxyParam => [{strCompressType => STORAGE_DECOMPRESS}]}] :
+                                undef}),
+                        $oStorageRepo->openWrite(
+                            $strArchiveDestination,
+                            {rhyFilter => $bCompress ?
+                                [{strClass => STORAGE_FILTER_GZIP, rxyParam => [{iLevel => cfgOption(CFGOPT_COMPRESS_LEVEL)}]}] :
+                                undef}));
+                }
 
                 # Add the archive file to the manifest so it can be part of the restore and checked in validation
                 my $strPathLog = MANIFEST_TARGET_PGDATA . qw{/} . $oBackupManifest->walPath();
@@ -927,7 +1108,7 @@ sub process
     $oStorageRepo->pathSync(STORAGE_REPO_BACKUP . "/${strBackupLabel}", {bRecurse => true});
 
     # Final save of the backup manifest
-    $oBackupManifest->save();
+    $oBackupManifest->save({bBinary => cfgOption(CFGOPT_MANIFEST_BINARY)});
 
     &log(INFO, "new backup label = ${strBackupLabel}");
 
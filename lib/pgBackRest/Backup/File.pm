@@ -9,19 +9,24 @@ use Carp qw(confess);
 
 use Exporter qw(import);
     our @EXPORT = qw();
+use Digest::SHA;
 use File::Basename qw(dirname);
 use Storable qw(dclone);
 
 use pgBackRest::Backup::Filter::PageChecksum;
 use pgBackRest::Common::Exception;
+use pgBackRest::Common::Io::Base;
 use pgBackRest::Common::Io::Handle;
+use pgBackRest::Common::Limit;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::String;
 use pgBackRest::DbVersion;
 use pgBackRest::Manifest;
+use pgBackRest::Protocol::Helper;
 use pgBackRest::Protocol::Storage::Helper;
 use pgBackRest::Storage::Base;
 use pgBackRest::Storage::Filter::Gzip;
+use pgBackRest::Storage::Filter::Limit;
 use pgBackRest::Storage::Filter::Sha;
 use pgBackRest::Storage::Helper;
 
@@ -37,6 +42,33 @@ use constant BACKUP_FILE_RECOPY                                     => 2;
 use constant BACKUP_FILE_SKIP                                       => 3;
     push @EXPORT, qw(BACKUP_FILE_SKIP);
 
+####################################################################################################################################
+# Files up to this size are batched so many can be copied by a local process in a single request.  This covers config files, empty
+# relations, and most visibility map forks.
+####################################################################################################################################
+use constant BACKUP_FILE_BATCH_SIZE                                 => PG_PAGE_SIZE;
+    push @EXPORT, qw(BACKUP_FILE_BATCH_SIZE);
+
+####################################################################################################################################
+# A file that is larger than its share of the backup would be left running alone after the other local processes are done, so it is
+# split into parts that are copied in parallel and then assembled in the repo.  Parts are never smaller than this size.
+####################################################################################################################################
+use constant BACKUP_FILE_PART_SIZE_MIN                              => 16777216;
+    push @EXPORT, qw(BACKUP_FILE_PART_SIZE_MIN);
+
+####################################################################################################################################
+# backupFilePart - name of a part in the repo
+####################################################################################################################################
+sub backupFilePart
+{
+    my $strRepoFile = shift;
+    my $lOffset = shift;
+
+    return "${strRepoFile}.${lOffset}.part";
+}
+
+push @EXPORT, qw(backupFilePart);
+
 ####################################################################################################################################
 # backupFile
 ####################################################################################################################################
@@ -57,6 +89,8 @@ sub backupFile
         $lModificationTime,                         # File modification time
         $bIgnoreMissing,                            # Is it OK if the file is missing?
         $hExtraParam,                               # Parameter to pass to the extra function
+        $lOffset,                                   # Offset of the part to copy (undef to copy the entire file)
+        $lLength,                                   # Length of the part to copy (undef to copy to the end of the file)
     ) =
         logDebugParam
         (
@@ -72,6 +106,8 @@ sub backupFile
             {name => 'lModificationTime', trace => true},
             {name => 'bIgnoreMissing', default => true, trace => true},
             {name => 'hExtraParam', required => false, trace => true},
+            {name => 'lOffset', required => false, trace => true},
+            {name => 'lLength', required => false, trace => true},
         );
 
     my $oStorageRepo = storageRepo();               # Repo storage
@@ -81,8 +117,9 @@ sub backupFile
     my $lCopySize;                                  # Copy Size
     my $lRepoSize;                                  # Repo size
 
-    # Add compression suffix if needed
-    my $strFileOp = $strRepoFile . ($bCompress ? '.' . COMPRESS_EXT : '');
+    # Add compression suffix if needed.  Parts are copied to their own file and assembled later.
+    my $strFileOp =
+        (defined($lOffset) ? backupFilePart($strRepoFile, $lOffset) : $strRepoFile) . ($bCompress ? '.' . COMPRESS_EXT : '');
 
     # If checksum is defined then the file already exists but needs to be checked
     my $bCopy = true;
@@ -123,7 +160,9 @@ sub backupFile
             push(
                 @{$rhyFilter},
                 {strClass => BACKUP_FILTER_PAGECHECKSUM,
-                    rxyParam => [$iSegmentNo, $hExtraParam->{iWalId}, $hExtraParam->{iWalOffset}]});
+                    rxyParam => [
+                        $iSegmentNo, $hExtraParam->{iWalId}, $hExtraParam->{iWalOffset},
+                        defined($lOffset) ? int($lOffset / PG_PAGE_SIZE) : 0]});
         };
 
         # Add compression
@@ -132,8 +171,24 @@ sub backupFile
             push(@{$rhyFilter}, {strClass => STORAGE_FILTER_GZIP, rxyParam => [{iLevel => $iCompressLevel}]});
         }
 
+        # Limit the read rate when a limit is set for the backup.  When the database is local the limit is applied to the bytes read
+        # from the file so the per device limit can be enforced, else it is applied to the bytes received from the remote.
+        my $bLimit = limitActive();
+        my $bLimitFile = $bLimit && isDbLocal();
+
+        if ($bLimitFile)
+        {
+            unshift(@{$rhyFilter}, {strClass => STORAGE_FILTER_LIMIT, rxyParam => [(stat($strDbFile))[0]]});
+        }
+
         # Open the file
-        my $oSourceFileIo = storageDb()->openRead($strDbFile, {rhyFilter => $rhyFilter, bIgnoreMissing => true});
+        my $oSourceFileIo = storageDb()->openRead(
+            $strDbFile, {rhyFilter => $rhyFilter, bIgnoreMissing => true, lOffset => $lOffset, lLimit => $lLength});
+
+        if ($bLimit && !$bLimitFile && defined($oSourceFileIo))
+        {
+            $oSourceFileIo = new pgBackRest::Storage::Filter::Limit($oSourceFileIo);
+        }
 
         # If source file exists
         if (defined($oSourceFileIo))
@@ -180,6 +235,221 @@ sub backupFile
 
 push @EXPORT, qw(backupFile);
 
+####################################################################################################################################
+# backupFileAssemble
+#
+# Assemble the parts of a file that was copied in parallel.  Each part is verified against the checksum returned when it was copied
+# and then appended to the file as stored.  Compressed parts are separate gzip members so they can be concatenated without being
+# recompressed.  If the parts do not line up because the file changed size while it was being copied then the entire file is copied
+# again.
+####################################################################################################################################
+sub backupFileAssemble
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $strDbFile,                                 # Database file to backup
+        $strRepoFile,                               # Location in the repository to copy to
+        $lSizeFile,                                 # File size
+        $strChecksum,                               # File checksum to be checked
+        $bChecksumPage,                             # Should page checksums be calculated?
+        $strBackupLabel,                            # Label of current backup
+        $bCompress,                                 # Compress destination file
+        $iCompressLevel,                            # Compress level
+        $lModificationTime,                         # File modification time
+        $bIgnoreMissing,                            # Is it OK if the file is missing?
+        $hExtraParam,                               # Parameter to pass to the extra function
+        $rhyPart,                                   # Offset, length, and backupFile() result of each part
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::backupFileAssemble', \@_,
+            {name => 'strDbFile', trace => true},
+            {name => 'strRepoFile', trace => true},
+            {name => 'lSizeFile', trace => true},
+            {name => 'strChecksum', required => false, trace => true},
+            {name => 'bChecksumPage', trace => true},
+            {name => 'strBackupLabel', trace => true},
+            {name => 'bCompress', trace => true},
+            {name => 'iCompressLevel', trace => true},
+            {name => 'lModificationTime', trace => true},
+            {name => 'bIgnoreMissing', default => true, trace => true},
+            {name => 'hExtraParam', required => false, trace => true},
+            {name => 'rhyPart', trace => true},
+        );
+
+    my $oStorageRepo = storageRepo();               # Repo storage
+    my $strBackupPath = STORAGE_REPO_BACKUP . "/${strBackupLabel}";
+    my $strCompressExt = $bCompress ? '.' . COMPRESS_EXT : '';
+    my @hyPart = sort {$a->{lOffset} <=> $b->{lOffset}} @{$rhyPart};
+
+    # Each part must start where the last part ended.  A short part followed by more data means the file changed size during the
+    # copy, and a skipped part means the file was removed.
+    my $bAligned = true;
+    my $lOffsetNext = 0;
+
+    foreach my $hPart (@hyPart)
+    {
+        my ($iCopyResult, $lCopySize) = @{$hPart->{rResult}};
+
+        if ($iCopyResult != BACKUP_FILE_COPY || $hPart->{lOffset} != $lOffsetNext)
+        {
+            $bAligned = false;
+            last;
+        }
+
+        $lOffsetNext += $lCopySize;
+    }
+
+    my ($iCopyResult, $lCopySize, $lRepoSize, $strCopyChecksum, $rExtra);
+
+    if ($bAligned)
+    {
+        my $oSha = Digest::SHA->new('sha1');
+        my $oDestinationFileIo = $oStorageRepo->openWrite(
+            "${strBackupPath}/${strRepoFile}${strCompressExt}", {bPathCreate => true, bProtocolCompress => !$bCompress});
+
+        $lCopySize = 0;
+
+        foreach my $hPart (@hyPart)
+        {
+            my ($iPartCopyResult, $lPartCopySize, $lPartRepoSize, $strPartChecksum, $rPartExtra) = @{$hPart->{rResult}};
+            my $strPartFile = "${strBackupPath}/" . backupFilePart($strRepoFile, $hPart->{lOffset}) . $strCompressExt;
+
+            # Verify the part and add it to the checksum of the file
+            my $rhyFilter = [{strClass => STORAGE_FILTER_SHA}];
+
+            if ($bCompress)
+            {
+                unshift(@{$rhyFilter}, {strClass => STORAGE_FILTER_GZIP, rxyParam => [{strCompressType => STORAGE_DECOMPRESS}]});
+            }
+
+            my $oPartFileIo = $oStorageRepo->openRead($strPartFile, {rhyFilter => $rhyFilter});
+            my $lPartSize = 0;
+            my $lSizeRead;
+
+            do
+            {
+                my $tBuffer;
+
+                $lSizeRead = $oPartFileIo->read(\$tBuffer, COMMON_IO_BUFFER_MAX);
+                $oSha->add($tBuffer) if $lSizeRead > 0;
+                $lPartSize += $lSizeRead;
+            }
+            while ($lSizeRead != 0);
+
+            $oPartFileIo->close();
+
+            if ($oPartFileIo->result(STORAGE_FILTER_SHA) ne $strPartChecksum || $lPartSize != $lPartCopySize)
+            {
+                confess &log(ERROR,
+                    "part of ${strRepoFile} at offset $hPart->{lOffset} should have checksum ${strPartChecksum} and size" .
+                    " ${lPartCopySize} but actually has checksum " . $oPartFileIo->result(STORAGE_FILTER_SHA) .
+                    " and size ${lPartSize}", ERROR_CHECKSUM);
+            }
+
+            # Append the part as it is stored
+            $oPartFileIo = $oStorageRepo->openRead($strPartFile);
+
+            do
+            {
+                my $tBuffer;
+
+                $lSizeRead = $oPartFileIo->read(\$tBuffer, COMMON_IO_BUFFER_MAX);
+                $oDestinationFileIo->write(\$tBuffer) if $lSizeRead > 0;
+            }
+            while ($lSizeRead != 0);
+
+            $oPartFileIo->close();
+            $oStorageRepo->remove($strPartFile);
+
+            $lCopySize += $lPartCopySize;
+
+            # Merge page checksum results
+            if ($bChecksumPage)
+            {
+                $rExtra = backupFilePageMerge($rExtra, $rPartExtra);
+            }
+        }
+
+        $oDestinationFileIo->close();
+
+        $iCopyResult = BACKUP_FILE_COPY;
+        $strCopyChecksum = $oSha->hexdigest();
+        $lRepoSize = ($oStorageRepo->info("${strBackupPath}/${strRepoFile}${strCompressExt}"))->size();
+    }
+    # Else remove the parts and copy the entire file
+    else
+    {
+        foreach my $hPart (@hyPart)
+        {
+            $oStorageRepo->remove(
+                "${strBackupPath}/" . backupFilePart($strRepoFile, $hPart->{lOffset}) . $strCompressExt, {bIgnoreMissing => true});
+        }
+
+        ($iCopyResult, $lCopySize, $lRepoSize, $strCopyChecksum, $rExtra) = backupFile(
+            $strDbFile, $strRepoFile, $lSizeFile, $strChecksum, $bChecksumPage, $strBackupLabel, $bCompress, $iCompressLevel,
+            $lModificationTime, $bIgnoreMissing, $hExtraParam);
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'iCopyResult', value => $iCopyResult, trace => true},
+        {name => 'lCopySize', value => $lCopySize, trace => true},
+        {name => 'lRepoSize', value => $lRepoSize, trace => true},
+        {name => 'strCopyChecksum', value => $strCopyChecksum, trace => true},
+        {name => 'rExtra', value => $rExtra, trace => true},
+    );
+}
+
+push @EXPORT, qw(backupFileAssemble);
+
+####################################################################################################################################
+# backupFilePageMerge - merge the page checksum result of a part into the result for the file
+#
+# Parts are merged in order so an error range that ends on the last page of one part is joined with a range that starts on the first
+# page of the next part, which makes the result the same as if the file had been checked in one pass.
+####################################################################################################################################
+sub backupFilePageMerge
+{
+    my $rExtra = shift;
+    my $rPartExtra = shift;
+
+    return dclone($rPartExtra) if !defined($rExtra);
+
+    $rExtra->{bValid} = $rExtra->{bValid} && $rPartExtra->{bValid} ? true : false;
+    $rExtra->{bAlign} = $rExtra->{bAlign} && $rPartExtra->{bAlign} ? true : false;
+
+    # Error pages are not reported for misaligned files
+    if (!$rExtra->{bAlign})
+    {
+        delete($rExtra->{iyPageError});
+        return $rExtra;
+    }
+
+    foreach my $iyPage (@{$rPartExtra->{iyPageError}})
+    {
+        my $iyLast = defined($rExtra->{iyPageError}) ? $rExtra->{iyPageError}[-1] : undef;
+        my $iPageFirst = ref($iyPage) ? $iyPage->[0] : $iyPage;
+        my $iPageLast = ref($iyPage) ? $iyPage->[1] : $iyPage;
+
+        # Join with the last range if contiguous
+        if (defined($iyLast) && (ref($iyLast) ? $iyLast->[1] : $iyLast) == $iPageFirst - 1)
+        {
+            $rExtra->{iyPageError}[-1] = [ref($iyLast) ? $iyLast->[0] : $iyLast, $iPageLast];
+        }
+        else
+        {
+            push(@{$rExtra->{iyPageError}}, ref($iyPage) ? [@{$iyPage}] : $iyPage);
+        }
+    }
+
+    return $rExtra;
+}
+
 ####################################################################################################################################
 # backupManifestUpdate
 ####################################################################################################################################
@@ -354,12 +624,25 @@ sub backupManifestUpdate
         $oManifest->remove(MANIFEST_SECTION_TARGET_FILE, $strRepoFile);
     }
 
-    # Determine whether to save the manifest
+    # Record the file in the journal
+    if ($oManifest->journalOpened())
+    {
+        $oManifest->journalWrite($strRepoFile);
+    }
+
+    # Determine whether to save the manifest (or sync the journal)
     $lManifestSaveCurrent += $lSize;
 
     if ($lManifestSaveCurrent >= $lManifestSaveSize)
     {
-        $oManifest->saveCopy();
+        if ($oManifest->journalOpened())
+        {
+            $oManifest->journalSync();
+        }
+        else
+        {
+            $oManifest->saveCopy();
+        }
 
         logDebugMisc
         (
@@ -48,6 +48,7 @@ sub new
         $iSegmentNo,
         $iWalId,
         $iWalOffset,
+        $iBlockOffset,
     ) =
         logDebugParam
         (
@@ -56,6 +57,7 @@ sub new
             {name => 'iSegmentNo', trace => true},
             {name => 'iWalId', trace => true},
             {name => 'iWalOffset', trace => true},
+            {name => 'iBlockOffset', default => 0, trace => true},
         );
 
     # Bless with new class
@@ -67,6 +69,9 @@ sub new
     $self->{iWalId} = $iWalId;
     $self->{iWalOffset} = $iWalOffset;
 
+    # Block offset within the segment of the first page read.  This is only non-zero when the segment is backed up in parts.
+    $self->{iBlockOffset} = $iBlockOffset;
+
     # Create the result object
     $self->{hResult}{bValid} = true;
     $self->{hResult}{bAlign} = true;
@@ -109,7 +114,8 @@ sub read
         else
         {
             # Calculate offset to the first block in the buffer
-            my $iBlockOffset = int(($self->size() - $iActualSize) / PG_PAGE_SIZE) + ($self->{iSegmentNo} * 131072);
+            my $iBlockOffset =
+                int(($self->size() - $iActualSize) / PG_PAGE_SIZE) + $self->{iBlockOffset} + ($self->{iSegmentNo} * 131072);
 
             if (!pageChecksumBufferTest(
                     $$rtBuffer, $iActualSize, $iBlockOffset, PG_PAGE_SIZE, $self->{iWalId},
@@ -247,7 +247,7 @@ sub reconstruct
 
         if (!$self->current($strBackup) && $self->{oStorage}->exists($strManifestFile))
         {
-            my $oManifest = pgBackRest::Manifest->new($strManifestFile);
+            my $oManifest = pgBackRest::Manifest->new($strManifestFile, {bBinary => true});
 
             # If we are reconstructing, then we need to be sure this db-id and version is in the history section. Also if it
             # has a db-id greater than anything in the history section, then add it to the db section.
@@ -265,7 +265,7 @@ sub isException
         # Else if a specially formatted string from the C library
         elsif ($$roException =~ /^PGBRCLIB\:[0-9]+\:/)
         {
-            my @stryException = split(/\:/, $$roException);
+            my @stryException = split(/\:/, $$roException, 5);
             $$roException = new pgBackRest::Common::Exception(
                 "ERROR", $stryException[1] + 0, $stryException[4], $stryException[2] . qw{:} . $stryException[3]);
 
@@ -11,11 +11,14 @@ use English '-no_match_vars';
 use Exporter qw(import);
     our @EXPORT = qw();
 use File::Basename qw(dirname);
+use JSON::PP;
 
 use pgBackRest::Common::Exception;
+use pgBackRest::Common::Limit;
 use pgBackRest::Common::Lock;
 use pgBackRest::Common::Log;
 use pgBackRest::Config::Config;
+use pgBackRest::Protocol::Base::Stats;
 use pgBackRest::Protocol::Helper;
 
 ####################################################################################################################################
@@ -61,6 +64,32 @@ sub exitSafe
     # Close the remote
     protocolDestroy(undef, undef, defined($iExitCode) && ($iExitCode == 0 || $iExitCode == 1));
 
+    # Log protocol stats and write them to the stats file.  Don't fail if the stats can't be written.
+    if (protocolStatsEnabled())
+    {
+        eval
+        {
+            protocolStatsLog();
+
+            require pgBackRest::Storage::Helper;
+            pgBackRest::Storage::Helper->import();
+
+            storageLocal()->put(
+                cfgOption(CFGOPT_LOG_PATH) . '/' . (cfgOptionTest(CFGOPT_STANZA) ? cfgOption(CFGOPT_STANZA) : 'all') . '-' .
+                    lc(cfgCommandName(cfgCommandGet())) . '.stats',
+                JSON::PP->new()->canonical()->pretty()->encode(protocolStatsReport()));
+
+            return true;
+        }
+        or do
+        {
+            &log(WARN, 'unable to write protocol stats: ' . exceptionMessage($EVAL_ERROR));
+        };
+    }
+
+    # Remove the backup limit file (if this process created it)
+    limitRemove();
+
     # Don't fail if the lock can't be released
     eval
     {
@@ -8,6 +8,7 @@ use warnings FATAL => qw(all);
 use Carp qw(confess);
 use English '-no_match_vars';
 
+use B;
 use Digest::SHA;
 use Exporter qw(import);
     our @EXPORT = qw();
@@ -18,6 +19,7 @@ use JSON::PP;
 use Storable qw(dclone);
 
 use pgBackRest::Common::Exception;
+use pgBackRest::Common::IniBinary;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::String;
 use pgBackRest::Version;
@@ -59,6 +61,26 @@ use constant INI_SORT_REVERSE                                       => 'reverse'
 use constant INI_SORT_NONE                                          => 'none';
     push @EXPORT, qw(INI_SORT_NONE);
 
+####################################################################################################################################
+# Packed value types
+#
+# Values in packed sections are stored as strings rather than hashes to reduce memory usage.  A packed hash is a list of fields,
+# each made up of the string table index of the key, a type, and the value.  Strings are interned in a table owned by the ini object
+# so repeated values like user, group, mode, and reference are only stored once.
+####################################################################################################################################
+use constant INI_PACK_HASH                                          => 'H';
+use constant INI_PACK_JSON                                          => 'J';
+
+use constant INI_PACK_TYPE_FALSE                                    => 'f';
+use constant INI_PACK_TYPE_JSON                                     => 'j';
+use constant INI_PACK_TYPE_SHA1                                     => 'h';
+use constant INI_PACK_TYPE_STRING                                   => 's';
+use constant INI_PACK_TYPE_TRUE                                     => 't';
+use constant INI_PACK_TYPE_UINT                                     => 'u';
+
+# JSON object used for values that do not have a more compact packed type
+my $oPackJSON = JSON::PP->new()->canonical()->allow_nonref();
+
 ####################################################################################################################################
 # new()
 ####################################################################################################################################
@@ -84,6 +106,8 @@ sub new
         $self->{iInitFormat},
         $self->{strInitVersion},
         my $bIgnoreMissing,
+        $self->{bBinary},
+        my $stryPackSection,
     ) =
         logDebugParam
         (
@@ -95,8 +119,15 @@ sub new
             {name => 'iInitFormat', optional => true, default => BACKREST_FORMAT, trace => true},
             {name => 'strInitVersion', optional => true, default => BACKREST_VERSION, trace => true},
             {name => 'bIgnoreMissing', optional => true, default => false, trace => true},
+            {name => 'bBinary', optional => true, default => false, trace => true},
+            {name => 'stryPackSection', optional => true, default => [], trace => true},
         );
 
+    # Sections where values are stored packed
+    $self->{hPackSection} = {map {$_ => true} @{$stryPackSection}};
+    $self->{stryPackString} = [];
+    $self->{hPackString} = {};
+
     # Set changed to false
     $self->{bModified} = false;
 
@@ -111,7 +142,7 @@ sub new
     # Load from a string if provided
     elsif (defined($strContent))
     {
-        $self->{oContent} = iniParse($strContent);
+        $self->{oContent} = iniParse($strContent, {oIni => $self});
         $self->headerCheck();
     }
 
@@ -142,7 +173,7 @@ sub loadVersion
     if (defined($rstrContent))
     {
 
-        my $rhContent = iniParse($$rstrContent, {bIgnoreInvalid => $bIgnoreError});
+        my $rhContent = iniParse($$rstrContent, {bIgnoreInvalid => $bIgnoreError, oIni => $self});
 
         # If the content is valid then check the header
         if (defined($rhContent))
@@ -160,6 +191,299 @@ sub loadVersion
     return defined($self->{oContent});
 }
 
+####################################################################################################################################
+# checksumFile() - get the checksum stored in the main ini file, or in the copy if the main file is missing
+#
+# The checksum is found with a pattern rather than by parsing the file since only the checksum is needed.
+####################################################################################################################################
+sub checksumFile
+{
+    my $self = shift;
+
+    foreach my $bCopy (false, true)
+    {
+        my $rstrContent = $self->{oStorage}->get(
+            $self->{oStorage}->openRead($self->{strFileName} . ($bCopy ? INI_COPY_EXT : ''), {bIgnoreMissing => true}));
+
+        if (defined($rstrContent))
+        {
+            my $strPattern = '^' . INI_KEY_CHECKSUM . '="([0-9a-f]+)"$';
+            my ($strChecksum) = $$rstrContent =~ /$strPattern/m;
+
+            return $strChecksum;
+        }
+    }
+
+    return;
+}
+
+####################################################################################################################################
+# loadBinary() - load the binary version of the ini file
+#
+# Only the header and index are validated here.  Sections are validated and decoded when they are first accessed by sectionLoad().
+####################################################################################################################################
+sub loadBinary
+{
+    my $self = shift;
+
+    my $rstrContent = $self->{oStorage}->get(
+        $self->{oStorage}->openRead($self->{strFileName} . INI_BINARY_EXT, {bIgnoreMissing => true}));
+
+    # If the file exists then attempt to read the index
+    if (defined($rstrContent))
+    {
+        # Note that the binary file exists so it can be removed if the ini is saved without it
+        $self->{bBinaryExists} = true;
+
+        my $hIndex = iniBinaryIndex($rstrContent, {bIgnoreInvalid => true});
+
+        if (defined($hIndex))
+        {
+            $self->{rstrBinary} = $rstrContent;
+            $self->{hBinaryIndex} = $hIndex;
+            $self->{hBinarySection} = {map {$_ => true} iniBinarySectionList($hIndex)};
+            $self->{oContent} = {};
+
+            # If the header is invalid or the checksum does not match the ini then undef content.  A mismatch means the binary file
+            # is left over from a save that did not complete or from a save by an Ini object that did not know about it.
+            my $strChecksumFile = $self->checksumFile();
+
+            if (!$self->headerCheck({bIgnoreInvalid => true}) || !defined($strChecksumFile) ||
+                $self->get(INI_SECTION_BACKREST, INI_KEY_CHECKSUM) ne $strChecksumFile)
+            {
+                delete($self->{hBinarySection});
+                delete($self->{hBinaryIndex});
+                delete($self->{rstrBinary});
+                delete($self->{oContent});
+            }
+        }
+    }
+
+    return defined($self->{oContent});
+}
+
+####################################################################################################################################
+# sectionLoad() - decode a section from the binary file if it has not already been decoded
+####################################################################################################################################
+sub sectionLoad
+{
+    my $self = shift;
+    my $strSection = shift;
+
+    if (defined($self->{hBinarySection}) && delete($self->{hBinarySection}{$strSection}))
+    {
+        $self->{oContent}{$strSection} = iniBinarySectionParse($self->{rstrBinary}, $self->{hBinaryIndex}, $strSection);
+
+        if ($self->{hPackSection}{$strSection})
+        {
+            my $hSection = $self->{oContent}{$strSection};
+
+            foreach my $strKey (keys(%{$hSection}))
+            {
+                $hSection->{$strKey} = $self->valuePack($hSection->{$strKey});
+            }
+        }
+    }
+}
+
+####################################################################################################################################
+# stringIntern() - get the index of a string in the string table, adding it if it does not exist
+####################################################################################################################################
+sub stringIntern
+{
+    my $self = shift;
+    my $strValue = shift;
+
+    my $iIndex = $self->{hPackString}{$strValue};
+
+    if (!defined($iIndex))
+    {
+        # Store a copy so the string table is not affected by changes to the flags of the caller's variable
+        push(@{$self->{stryPackString}}, "${strValue}");
+        $iIndex = @{$self->{stryPackString}} - 1;
+        $self->{hPackString}{$strValue} = $iIndex;
+    }
+
+    return $iIndex;
+}
+
+####################################################################################################################################
+# valuePack() - pack a value so it can be stored in a packed section
+#
+# Types are chosen so that unpacking returns values that render to exactly the same JSON, otherwise the checksum would change.  A
+# scalar is a number to the JSON encoder when it has numeric flags and no string flag, so the same test is used here.
+####################################################################################################################################
+sub valuePack
+{
+    my $self = shift;
+    my $oValue = shift;
+
+    # Values that are not hashes are stored as JSON
+    if (ref($oValue) ne 'HASH')
+    {
+        return INI_PACK_JSON . $oPackJSON->encode($oValue);
+    }
+
+    my $strPacked = INI_PACK_HASH;
+
+    foreach my $strKey (keys(%{$oValue}))
+    {
+        my $oSubValue = $oValue->{$strKey};
+
+        $strPacked .= pack('w', $self->stringIntern($strKey));
+
+        if (!defined($oSubValue))
+        {
+            $strPacked .= INI_PACK_TYPE_JSON . pack('w/a', 'null');
+        }
+        elsif (ref($oSubValue))
+        {
+            if (ref($oSubValue) eq 'JSON::PP::Boolean')
+            {
+                $strPacked .= $oSubValue ? INI_PACK_TYPE_TRUE : INI_PACK_TYPE_FALSE;
+            }
+            else
+            {
+                $strPacked .= INI_PACK_TYPE_JSON . pack('w/a', $oPackJSON->encode($oSubValue));
+            }
+        }
+        else
+        {
+            my $iFlag = B::svref_2object(\$oSubValue)->FLAGS;
+
+            # Numbers
+            if ($iFlag & (B::SVp_IOK | B::SVp_NOK) && !($iFlag & B::SVp_POK))
+            {
+                # Only integers that can be represented exactly are stored as integers
+                if ("${oSubValue}" =~ /^(0|[1-9][0-9]{0,14})$/)
+                {
+                    $strPacked .= INI_PACK_TYPE_UINT . pack('w', $oSubValue);
+                }
+                else
+                {
+                    $strPacked .= INI_PACK_TYPE_JSON . pack('w/a', $oPackJSON->encode($oSubValue));
+                }
+            }
+            # Checksums
+            elsif ($oSubValue =~ /^[0-9a-f]{40}$/)
+            {
+                $strPacked .= INI_PACK_TYPE_SHA1 . pack('H40', $oSubValue);
+            }
+            # Other strings
+            else
+            {
+                $strPacked .= INI_PACK_TYPE_STRING . pack('w', $self->stringIntern($oSubValue));
+            }
+        }
+    }
+
+    return $strPacked;
+}
+
+####################################################################################################################################
+# valueUnpack() - unpack a value stored in a packed section
+####################################################################################################################################
+sub valueUnpack
+{
+    my $self = shift;
+    my $strPacked = shift;
+
+    if (substr($strPacked, 0, 1) eq INI_PACK_JSON)
+    {
+        return $oPackJSON->decode(substr($strPacked, 1));
+    }
+
+    my $hValue = {};
+    my $iPos = 1;
+    my $iSize = length($strPacked);
+
+    while ($iPos < $iSize)
+    {
+        (my $iKey, my $strType, $iPos) = unpack("\@${iPos} w a .", $strPacked);
+        my $strKey = $self->{stryPackString}[$iKey];
+
+        if ($strType eq INI_PACK_TYPE_UINT)
+        {
+            ($hValue->{$strKey}, $iPos) = unpack("\@${iPos} w .", $strPacked);
+        }
+        elsif ($strType eq INI_PACK_TYPE_STRING)
+        {
+            (my $iString, $iPos) = unpack("\@${iPos} w .", $strPacked);
+            $hValue->{$strKey} = $self->{stryPackString}[$iString];
+        }
+        elsif ($strType eq INI_PACK_TYPE_SHA1)
+        {
+            ($hValue->{$strKey}, $iPos) = unpack("\@${iPos} H40 .", $strPacked);
+        }
+        elsif ($strType eq INI_PACK_TYPE_TRUE)
+        {
+            $hValue->{$strKey} = INI_TRUE;
+        }
+        elsif ($strType eq INI_PACK_TYPE_FALSE)
+        {
+            $hValue->{$strKey} = INI_FALSE;
+        }
+        else
+        {
+            (my $strJSON, $iPos) = unpack("\@${iPos} w/a .", $strPacked);
+            $hValue->{$strKey} = $oPackJSON->decode($strJSON);
+        }
+    }
+
+    return $hValue;
+}
+
+####################################################################################################################################
+# content() - get all content with packed sections unpacked
+#
+# Packed sections are unpacked into a copy so changes to them will not be reflected in the ini.  This is expensive for large packed
+# sections so it should only be used when all the content is required in a hash.
+####################################################################################################################################
+sub content
+{
+    my $self = shift;
+
+    # All sections are required
+    $self->sectionLoadAll();
+
+    my $hContent = {};
+
+    foreach my $strSection (keys(%{$self->{oContent}}))
+    {
+        if ($self->{hPackSection}{$strSection})
+        {
+            my $hSection = $self->{oContent}{$strSection};
+            $hContent->{$strSection} = {map {$_ => $self->valueUnpack($hSection->{$_})} keys(%{$hSection})};
+        }
+        else
+        {
+            $hContent->{$strSection} = $self->{oContent}{$strSection};
+        }
+    }
+
+    return $hContent;
+}
+
+####################################################################################################################################
+# sectionLoadAll() - decode all remaining sections from the binary file and free it
+####################################################################################################################################
+sub sectionLoadAll
+{
+    my $self = shift;
+
+    if (defined($self->{hBinarySection}))
+    {
+        foreach my $strSection (keys(%{$self->{hBinarySection}}))
+        {
+            $self->sectionLoad($strSection);
+        }
+
+        delete($self->{hBinarySection});
+        delete($self->{hBinaryIndex});
+        delete($self->{rstrBinary});
+    }
+}
+
 ####################################################################################################################################
 # load() - load the ini
 ####################################################################################################################################
@@ -168,8 +492,8 @@ sub load
     my $self = shift;
     my $bIgnoreMissing = shift;
 
-    # If main was not loaded then try the copy
-    if (!$self->loadVersion(false, true))
+    # If binary, main, and copy were not loaded then error
+    if (!($self->{bBinary} && $self->loadBinary()) && !$self->loadVersion(false, true))
     {
         if (!$self->loadVersion(true, true))
         {
@@ -207,9 +531,10 @@ sub headerCheck
     eval
     {
 
-        # Make sure the ini is valid by testing checksum
+        # Make sure the ini is valid by testing checksum.  Binary sections are checksummed individually when they are decoded so
+        # only check that a checksum is present.
         my $strChecksum = $self->get(INI_SECTION_BACKREST, INI_KEY_CHECKSUM, undef, false);
-        my $strTestChecksum = $self->hash();
+        my $strTestChecksum = defined($self->{hBinarySection}) ? $strChecksum : $self->hash();
 
         if (!defined($strChecksum) || $strChecksum ne $strTestChecksum)
         {
@@ -258,6 +583,8 @@ sub headerCheck
 
 ####################################################################################################################################
 # iniParse() - parse from standard INI format to a hash.
+#
+# If oIni is set then values in sections it packs are packed as they are parsed.
 ####################################################################################################################################
 push @EXPORT, qw(iniParse);
 
@@ -270,6 +597,7 @@ sub iniParse
         $strContent,
         $bRelaxed,
         $bIgnoreInvalid,
+        $oIni,
     ) =
         logDebugParam
         (
@@ -277,6 +605,7 @@ sub iniParse
             {name => 'strContent', required => false, trace => true},
             {name => 'bRelaxed', optional => true, default => false, trace => true},
             {name => 'bIgnoreInvalid', optional => true, default => false, trace => true},
+            {name => 'oIni', optional => true, trace => true},
         );
 
     # Ini content
@@ -341,6 +670,12 @@ sub iniParse
                     else
                     {
                         ${$oContent}{$strSection}{$strKey} = $oJSON->decode($strValue);
+
+                        # Pack the value while parsing so the entire section is never stored unpacked
+                        if (defined($oIni) && $oIni->{hPackSection}{$strSection})
+                        {
+                            ${$oContent}{$strSection}{$strKey} = $oIni->valuePack(${$oContent}{$strSection}{$strKey});
+                        }
                     }
                 }
             }
@@ -376,22 +711,41 @@ sub iniParse
 
 ####################################################################################################################################
 # save() - save the file.
+#
+# If bBinary is set then a binary version of the file is saved after the main file and the copy.  Otherwise any binary version
+# known to exist is removed.  A binary version that is out of sync with the main file is ignored by load() since the checksums
+# will not match.
 ####################################################################################################################################
 sub save
 {
     my $self = shift;
+    my $bBinary = shift;
 
     # Save only if modified
     if ($self->{bModified})
     {
-        # Calculate the hash
-        $self->hash();
+        # Calculate the hash and render the content
+        my $strContent = $self->render();
 
         # Save the file
-        $self->{oStorage}->put($self->{strFileName}, iniRender($self->{oContent}));
+        $self->{oStorage}->put($self->{strFileName}, $strContent);
         $self->{oStorage}->pathSync(dirname($self->{strFileName}));
-        $self->{oStorage}->put($self->{strFileName} . INI_COPY_EXT, iniRender($self->{oContent}));
+        $self->{oStorage}->put($self->{strFileName} . INI_COPY_EXT, $strContent);
         $self->{oStorage}->pathSync(dirname($self->{strFileName}));
+
+        # Save or remove the binary file
+        if ($bBinary)
+        {
+            $self->{oStorage}->put($self->{strFileName} . INI_BINARY_EXT, iniBinaryRender($self->content()));
+            $self->{oStorage}->pathSync(dirname($self->{strFileName}));
+            $self->{bBinaryExists} = true;
+        }
+        elsif ($self->{bBinaryExists})
+        {
+            $self->{oStorage}->remove($self->{strFileName} . INI_BINARY_EXT);
+            $self->{bBinaryExists} = false;
+        }
+
         $self->{bModified} = false;
 
         # Indicate the file now exists
@@ -417,8 +771,7 @@ sub saveCopy
         confess &log(ASSERT, "cannot save copy only when '$self->{strFileName}' exists");
     }
 
-    $self->hash();
-    $self->{oStorage}->put($self->{strFileName} . INI_COPY_EXT, iniRender($self->{oContent}));
+    $self->{oStorage}->put($self->{strFileName} . INI_COPY_EXT, $self->render());
 }
 
 ####################################################################################################################################
@@ -509,18 +862,95 @@ sub hash
 {
     my $self = shift;
 
+    # The hash is calculated while rendering so there is no need to encode the content a second time
+    $self->render(true);
+
+    return $self->{oContent}{&INI_SECTION_BACKREST}{&INI_KEY_CHECKSUM};
+}
+
+####################################################################################################################################
+# render() - generate hash for the manifest and render to standard INI format in a single pass.
+#
+# The hash is the SHA1 of the canonical JSON encoding of the content.  Sections and keys are rendered in the same sorted order used
+# by the canonical encoder and each value is already JSON encoded to render it, so the JSON document can be passed to the digest
+# piece by piece while rendering rather than encoding the entire content a second time.  Packed values are unpacked one at a time so
+# the entire content is never unpacked at once.
+#
+# If bHashOnly is set then only the hash is calculated and nothing is returned.
+####################################################################################################################################
+sub render
+{
+    my $self = shift;
+    my $bHashOnly = shift;
+
+    # All sections are required to render
+    $self->sectionLoadAll();
+
     # Remove the old checksum
     delete($self->{oContent}{&INI_SECTION_BACKREST}{&INI_KEY_CHECKSUM});
 
-    # Calculate the checksum
     my $oSHA = Digest::SHA->new('sha1');
     my $oJSON = JSON::PP->new()->canonical()->allow_nonref();
-    $oSHA->add($oJSON->encode($self->{oContent}));
+
+    # Rendered content is stored as a list so the checksum can be inserted once it has been calculated
+    my @stryContent;
+    my $iChecksumIdx;
+    my $bFirstSection = true;
+
+    $oSHA->add('{');
+
+    foreach my $strSection (sort(keys(%{$self->{oContent}})))
+    {
+        my $hSection = $self->{oContent}{$strSection};
+        my $bPack = $self->{hPackSection}{$strSection};
+
+        # Add a linefeed between sections
+        push(@stryContent, ($bFirstSection ? '' : "\n") . "[${strSection}]\n") if !$bHashOnly;
+
+        # The checksum is rendered in sort order but is not part of the hash
+        my @stryKey = keys(%{$hSection});
+
+        if ($strSection eq INI_SECTION_BACKREST)
+        {
+            push(@stryKey, INI_KEY_CHECKSUM);
+        }
+
+        $oSHA->add(($bFirstSection ? '' : ',') . $oJSON->encode($strSection) . ':{');
+        my $bFirstKey = true;
+
+        foreach my $strKey (sort(@stryKey))
+        {
+            if ($strSection eq INI_SECTION_BACKREST && $strKey eq INI_KEY_CHECKSUM)
+            {
+                push(@stryContent, undef);
+                $iChecksumIdx = @stryContent - 1;
+                next;
+            }
+
+            my $strValue = $oJSON->encode($bPack ? $self->valueUnpack($hSection->{$strKey}) : $hSection->{$strKey});
+
+            push(@stryContent, "${strKey}=${strValue}\n") if !$bHashOnly;
+            $oSHA->add(($bFirstKey ? '' : ',') . $oJSON->encode($strKey) . ":${strValue}");
+
+            $bFirstKey = false;
+        }
+
+        $oSHA->add('}');
+        $bFirstSection = false;
+    }
+
+    $oSHA->add('}');
 
     # Set the new checksum
     $self->{oContent}{&INI_SECTION_BACKREST}{&INI_KEY_CHECKSUM} = $oSHA->hexdigest();
 
-    return $self->{oContent}{&INI_SECTION_BACKREST}{&INI_KEY_CHECKSUM};
+    return if $bHashOnly;
+
+    # Insert the checksum into the rendered content (the backrest section always exists since it was vivified above)
+    $stryContent[$iChecksumIdx] =
+        INI_KEY_CHECKSUM . '=' . $oJSON->encode($self->{oContent}{&INI_SECTION_BACKREST}{&INI_KEY_CHECKSUM}) . "\n";
+
+    return join('', @stryContent);
 }
 
 ####################################################################################################################################
@@ -546,13 +976,28 @@ sub get
         confess &log(ASSERT, "strKey is required when strSubKey '${strSubKey}' is requested");
     }
 
+    # Decode the section if it has not been loaded yet
+    $self->sectionLoad($strSection);
+
     # Get the result
     my $oResult = $self->{oContent}->{$strSection};
 
+    # Unpack the entire section when requested from a packed section
+    if (!defined($strKey) && defined($oResult) && $self->{hPackSection}{$strSection})
+    {
+        $oResult = {map {$_ => $self->valueUnpack($oResult->{$_})} keys(%{$oResult})};
+    }
+
     if (defined($strKey) && defined($oResult))
     {
         $oResult = $oResult->{$strKey};
 
+        # Unpack the value if it is in a packed section
+        if (defined($oResult) && $self->{hPackSection}{$strSection})
+        {
+            $oResult = $self->valueUnpack($oResult);
+        }
+
         if (defined($strSubKey) && defined($oResult))
         {
             $oResult = $oResult->{$strSubKey};
@@ -628,15 +1073,28 @@ sub set
         confess &log(ASSERT, 'strSection and strKey are required');
     }
 
+    # Decode the section if it has not been loaded yet so the value is not set in a section that will be replaced
+    $self->sectionLoad($strSection);
+
+    # Values in packed sections are unpacked to be modified and packed again when changed
+    my $bPack = $self->{hPackSection}{$strSection};
+    my $oValueRoot;
+
+    if ($bPack)
+    {
+        $oValueRoot =
+            defined($self->{oContent}{$strSection}{$strKey}) ? $self->valueUnpack($self->{oContent}{$strSection}{$strKey}) : undef;
+    }
+
     my $oCurrentValue;
 
     if (defined($strSubKey))
     {
-        $oCurrentValue = \$self->{oContent}{$strSection}{$strKey}{$strSubKey};
+        $oCurrentValue = $bPack ? \$oValueRoot->{$strSubKey} : \$self->{oContent}{$strSection}{$strKey}{$strSubKey};
     }
     else
     {
-        $oCurrentValue = \$self->{oContent}{$strSection}{$strKey};
+        $oCurrentValue = $bPack ? \$oValueRoot : \$self->{oContent}{$strSection}{$strKey};
     }
 
     if (!defined($$oCurrentValue) ||
@@ -645,6 +1103,11 @@ sub set
     {
         $$oCurrentValue = $oValue;
 
+        if ($bPack)
+        {
+            $self->{oContent}{$strSection}{$strKey} = $self->valuePack($oValueRoot);
+        }
+
         if (!$self->{bModified})
         {
             $self->{bModified} = true;
@@ -700,7 +1163,16 @@ sub remove
         # Remove a subkey
         if (defined($strSubKey))
         {
-            delete($self->{oContent}{$strSection}{$strKey}{$strSubKey});
+            if ($self->{hPackSection}{$strSection})
+            {
+                my $hValue = $self->valueUnpack($self->{oContent}{$strSection}{$strKey});
+                delete($hValue->{$strSubKey});
+                $self->{oContent}{$strSection}{$strKey} = $self->valuePack($hValue);
+            }
+            else
+            {
+                delete($self->{oContent}{$strSection}{$strKey}{$strSubKey});
+            }
         }
 
         # Remove a key
@@ -747,17 +1219,20 @@ sub keys
 
     if ($self->test($strSection))
     {
+        # Get keys directly from the content so packed sections are not unpacked
+        my $hSection = $self->{oContent}{$strSection};
+
         if (!defined($strSortOrder) || $strSortOrder eq INI_SORT_FORWARD)
         {
-            return (sort(keys(%{$self->get($strSection)})));
+            return (sort(keys(%{$hSection})));
         }
         elsif ($strSortOrder eq INI_SORT_REVERSE)
         {
-            return (sort {$b cmp $a} (keys(%{$self->get($strSection)})));
+            return (sort {$b cmp $a} (keys(%{$hSection})));
         }
         elsif ($strSortOrder eq INI_SORT_NONE)
         {
-            return (keys(%{$self->get($strSection)}));
+            return (keys(%{$hSection}));
         }
         else
         {
@@ -783,6 +1258,13 @@ sub test
     my $strSubValue = shift;
     my $strTest = shift;
 
+    # Test that a section exists without getting it so packed sections are not unpacked
+    if (defined($strSection) && !defined($strValue) && !defined($strSubValue) && !defined($strTest))
+    {
+        $self->sectionLoad($strSection);
+        return defined($self->{oContent}{$strSection}) ? true : false;
+    }
+
     # Get the value
     my $strResult = $self->get($strSection, $strValue, $strSubValue, false);
 
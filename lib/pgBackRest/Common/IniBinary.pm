@@ -0,0 +1,450 @@
+####################################################################################################################################
+# COMMON INI BINARY MODULE
+#
+# Compact binary representation of ini content.  The layout is:
+#
+# header        - magic, format, section total, and size of the string table and index (fixed size)
+# string table  - interned strings (section names, subkeys, and repeated string values such as user/group/mode/reference)
+# index         - name, type, offset, size, and SHA1 checksum of each section followed by a SHA1 checksum of everything above it
+# sections      - section data in sort order
+#
+# Sections where every value is a hash (e.g. the manifest target:* sections) are stored in sorted columnar form with one column per
+# subkey.  Columns are typed so integers, booleans, and SHA1 checksums are stored in binary and repeated strings are stored as
+# string table references.  Any value that does not fit the type chosen for its column causes the entire column to be stored as
+# JSON so content always survives a round trip exactly as it would through the ini format.  All other sections are stored as JSON
+# key/value pairs.
+#
+# Since each section has its own offset and checksum the index can be read and validated without decoding any sections.  Sections
+# can then be decoded on demand.
+####################################################################################################################################
+package pgBackRest::Common::IniBinary;
+
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+
+use Digest::SHA qw(sha1);
+use English '-no_match_vars';
+use Exporter qw(import);
+    our @EXPORT = qw();
+use JSON::PP;
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Log;
+
+####################################################################################################################################
+# Binary ini constants
+####################################################################################################################################
+use constant INI_BINARY_EXT                                         => '.bin';
+    push @EXPORT, qw(INI_BINARY_EXT);
+
+use constant INI_BINARY_MAGIC                                       => 'PGBRINIB';
+use constant INI_BINARY_FORMAT                                      => 1;
+    push @EXPORT, qw(INI_BINARY_FORMAT);
+
+# Header is magic, format, section total, string table size, index size
+use constant INI_BINARY_HEADER                                      => 'a8 N N N N';
+use constant INI_BINARY_HEADER_SIZE                                 => 24;
+
+# Section types
+use constant INI_BINARY_SECTION_VALUE                               => 0;
+use constant INI_BINARY_SECTION_COLUMN                              => 1;
+
+# Column types
+use constant INI_BINARY_COLUMN_JSON                                 => 0;
+use constant INI_BINARY_COLUMN_UINT                                 => 1;
+use constant INI_BINARY_COLUMN_STRING                               => 2;
+use constant INI_BINARY_COLUMN_BOOL                                 => 3;
+use constant INI_BINARY_COLUMN_SHA1                                 => 4;
+
+# The string table is stored in the index with a name that cannot be a section
+use constant INI_BINARY_STRING_TABLE                                => '';
+
+####################################################################################################################################
+# Helper to make sure a string can be stored as bytes
+####################################################################################################################################
+sub iniBinaryBytes
+{
+    my $strValue = shift;
+
+    if (!utf8::downgrade($strValue, true))
+    {
+        confess &log(ERROR, 'unable to store wide character string in binary ini', ERROR_FORMAT);
+    }
+
+    return $strValue;
+}
+
+####################################################################################################################################
+# iniBinaryRender() - render hash to binary ini format.
+####################################################################################################################################
+push @EXPORT, qw(iniBinaryRender);
+
+sub iniBinaryRender
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $oContent,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::iniBinaryRender', \@_,
+            {name => 'oContent', trace => true},
+        );
+
+    my $oJSON = JSON::PP->new()->canonical()->allow_nonref();
+
+    # String table
+    my @stryString;
+    my %hStringIdx;
+
+    my $fnStringIdx = sub
+    {
+        my $strValue = iniBinaryBytes(shift);
+
+        if (!defined($hStringIdx{$strValue}))
+        {
+            push(@stryString, $strValue);
+            $hStringIdx{$strValue} = @stryString - 1;
+        }
+
+        return $hStringIdx{$strValue};
+    };
+
+    # Render sections
+    my $strData = '';
+    my $strIndex = '';
+    my @stryName = sort(keys(%{$oContent}));
+
+    foreach my $strSection (@stryName)
+    {
+        my $hSection = $oContent->{$strSection};
+        my @stryKey = sort(keys(%{$hSection}));
+        my $strSectionData;
+        my $iType = INI_BINARY_SECTION_COLUMN;
+
+        # Only use columns when every value is a hash
+        foreach my $strKey (@stryKey)
+        {
+            if (ref($hSection->{$strKey}) ne 'HASH')
+            {
+                $iType = INI_BINARY_SECTION_VALUE;
+                last;
+            }
+        }
+
+        if ($iType == INI_BINARY_SECTION_VALUE)
+        {
+            $strSectionData = pack('w', scalar(@stryKey));
+
+            foreach my $strKey (@stryKey)
+            {
+                $strSectionData .= pack('w/a w/a', iniBinaryBytes($strKey), iniBinaryBytes($oJSON->encode($hSection->{$strKey})));
+            }
+        }
+        else
+        {
+            $strSectionData = pack('w/(w/a)', map {iniBinaryBytes($_)} @stryKey);
+
+            # Find all subkeys in the section
+            my %hSubKey;
+
+            foreach my $strKey (@stryKey)
+            {
+                foreach my $strSubKey (keys(%{$hSection->{$strKey}}))
+                {
+                    $hSubKey{$strSubKey} = true;
+                }
+            }
+
+            my @strySubKey = sort(keys(%hSubKey));
+            $strSectionData .= pack('w', scalar(@strySubKey));
+
+            foreach my $strSubKey (@strySubKey)
+            {
+                # Encode each value once to determine the column type
+                my @stryJSON = map
+                    {exists($hSection->{$_}{$strSubKey}) ? $oJSON->encode($hSection->{$_}{$strSubKey}) : undef} @stryKey;
+                my ($bUInt, $bSha1, $bString, $bBool) = (true, true, true, true);
+
+                for (my $iKeyIdx = 0; $iKeyIdx < @stryKey; $iKeyIdx++)
+                {
+                    next if !defined($stryJSON[$iKeyIdx]);
+
+                    my $strJSON = $stryJSON[$iKeyIdx];
+
+                    $bUInt = false if $bUInt && $strJSON !~ /^(0|[1-9][0-9]{0,14})$/;
+                    $bSha1 = false if $bSha1 && $strJSON !~ /^\"[0-9a-f]{40}\"$/;
+                    $bBool = false if $bBool && ref($hSection->{$stryKey[$iKeyIdx]}{$strSubKey}) ne 'JSON::PP::Boolean';
+                    $bString = false if $bString &&
+                        (ref($hSection->{$stryKey[$iKeyIdx]}{$strSubKey}) || substr($strJSON, 0, 1) ne '"');
+                }
+
+                my $strColumn;
+                my $iColumnType;
+
+                if ($bUInt)
+                {
+                    $iColumnType = INI_BINARY_COLUMN_UINT;
+                    $strColumn = pack('w*', map {defined($_) ? $_ + 1 : 0} @stryJSON);
+                }
+                elsif ($bBool)
+                {
+                    $iColumnType = INI_BINARY_COLUMN_BOOL;
+                    $strColumn = pack('C*', map {defined($_) ? ($_ eq 'true' ? 2 : 1) : 0} @stryJSON);
+                }
+                elsif ($bSha1)
+                {
+                    $iColumnType = INI_BINARY_COLUMN_SHA1;
+                    $strColumn = join('', map {defined($_) ? pack('C H40', 1, substr($_, 1, 40)) : pack('C', 0)} @stryJSON);
+                }
+                elsif ($bString)
+                {
+                    $iColumnType = INI_BINARY_COLUMN_STRING;
+                    $strColumn = pack(
+                        'w*',
+                        map {exists($hSection->{$_}{$strSubKey}) ? $fnStringIdx->($hSection->{$_}{$strSubKey}) + 1 : 0} @stryKey);
+                }
+                else
+                {
+                    $iColumnType = INI_BINARY_COLUMN_JSON;
+                    $strColumn = pack('(w/a)*', map {defined($_) ? iniBinaryBytes($_) : ''} @stryJSON);
+                }
+
+                $strSectionData .= pack('w C w/a', $fnStringIdx->($strSubKey), $iColumnType, $strColumn);
+            }
+        }
+
+        $strIndex .= pack('w C w w a20', $fnStringIdx->($strSection), $iType, length($strData), length($strSectionData),
+            sha1($strSectionData));
+        $strData .= $strSectionData;
+    }
+
+    my $strStringTable = pack('w/(w/a)', @stryString);
+    my $strHeader =
+        pack(INI_BINARY_HEADER, INI_BINARY_MAGIC, INI_BINARY_FORMAT, scalar(@stryName), length($strStringTable),
+            length($strIndex) + 20) .
+        $strStringTable . $strIndex;
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'strContent', value => $strHeader . sha1($strHeader) . $strData, trace => true}
+    );
+}
+
+####################################################################################################################################
+# iniBinaryIndex() - validate the header and return the section index.
+#
+# The index is a hash with an entry per section containing the section type, offset, size, and checksum.  Sections are not decoded.
+####################################################################################################################################
+push @EXPORT, qw(iniBinaryIndex);
+
+sub iniBinaryIndex
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $rstrContent,
+        $bIgnoreInvalid,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::iniBinaryIndex', \@_,
+            {name => 'rstrContent', trace => true},
+            {name => 'bIgnoreInvalid', optional => true, default => false, trace => true},
+        );
+
+    my $hIndex;
+
+    eval
+    {
+        if (length($$rstrContent) < INI_BINARY_HEADER_SIZE)
+        {
+            confess &log(ERROR, 'binary ini header is truncated', ERROR_FORMAT);
+        }
+
+        my ($strMagic, $iFormat, $iSectionTotal, $iStringSize, $iIndexSize) =
+            unpack(INI_BINARY_HEADER, substr($$rstrContent, 0, INI_BINARY_HEADER_SIZE));
+
+        if ($strMagic ne INI_BINARY_MAGIC)
+        {
+            confess &log(ERROR, 'binary ini header is invalid', ERROR_FORMAT);
+        }
+
+        if ($iFormat != INI_BINARY_FORMAT)
+        {
+            confess &log(ERROR, 'expected binary ini format ' . INI_BINARY_FORMAT . " but found ${iFormat}", ERROR_FORMAT);
+        }
+
+        # Validate the header before decoding anything else
+        my $iDataOffset = INI_BINARY_HEADER_SIZE + $iStringSize + $iIndexSize;
+
+        if (length($$rstrContent) < $iDataOffset ||
+            sha1(substr($$rstrContent, 0, $iDataOffset - 20)) ne substr($$rstrContent, $iDataOffset - 20, 20))
+        {
+            confess &log(ERROR, 'binary ini header checksum is invalid', ERROR_CHECKSUM);
+        }
+
+        my @stryString = unpack('w/(w/a)', substr($$rstrContent, INI_BINARY_HEADER_SIZE, $iStringSize));
+        my @oyIndex = unpack(
+            "(w C w w a20)${iSectionTotal}", substr($$rstrContent, INI_BINARY_HEADER_SIZE + $iStringSize, $iIndexSize - 20));
+
+        while (@oyIndex)
+        {
+            my ($iNameIdx, $iType, $iOffset, $iSize, $tChecksum) = splice(@oyIndex, 0, 5);
+
+            $hIndex->{$stryString[$iNameIdx]} =
+                {iType => $iType, iOffset => $iDataOffset + $iOffset, iSize => $iSize, tChecksum => $tChecksum};
+        }
+
+        $hIndex->{&INI_BINARY_STRING_TABLE} = \@stryString;
+
+        return true;
+    }
+    or do
+    {
+        # Confess the error if it should not be ignored
+        if (!$bIgnoreInvalid)
+        {
+            confess $EVAL_ERROR;
+        }
+
+        # Undef index when errors are ignored
+        undef($hIndex);
+    };
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'hIndex', value => $hIndex, trace => true}
+    );
+}
+
+####################################################################################################################################
+# iniBinarySectionList() - list of sections in the index.
+####################################################################################################################################
+push @EXPORT, qw(iniBinarySectionList);
+
+sub iniBinarySectionList
+{
+    my $hIndex = shift;
+
+    return grep {$_ ne INI_BINARY_STRING_TABLE} keys(%{$hIndex});
+}
+
+####################################################################################################################################
+# iniBinarySectionParse() - decode a single section.
+####################################################################################################################################
+push @EXPORT, qw(iniBinarySectionParse);
+
+sub iniBinarySectionParse
+{
+    my $rstrContent = shift;
+    my $hIndex = shift;
+    my $strSection = shift;
+
+    my $hSectionIndex = $hIndex->{$strSection};
+    my $stryString = $hIndex->{&INI_BINARY_STRING_TABLE};
+    my $strData = substr($$rstrContent, $hSectionIndex->{iOffset}, $hSectionIndex->{iSize});
+
+    if (length($strData) != $hSectionIndex->{iSize} || sha1($strData) ne $hSectionIndex->{tChecksum})
+    {
+        confess &log(ERROR, "binary ini section '${strSection}' checksum is invalid", ERROR_CHECKSUM);
+    }
+
+    my $oJSON = JSON::PP->new()->allow_nonref();
+    my $hSection = {};
+
+    if ($hSectionIndex->{iType} == INI_BINARY_SECTION_VALUE)
+    {
+        my ($iKeyTotal, @stryKeyValue) = unpack('w (w/a w/a)*', $strData);
+
+        while (@stryKeyValue)
+        {
+            my ($strKey, $strValue) = splice(@stryKeyValue, 0, 2);
+            $hSection->{$strKey} = $oJSON->decode($strValue);
+        }
+    }
+    else
+    {
+        my @stryKey = unpack('w/(w/a)', $strData);
+        my @stryColumn = unpack('w/(w/a) w (w C w/a)*', $strData);
+
+        # Remove keys and column total from the front of the column data
+        splice(@stryColumn, 0, @stryKey + 1);
+
+        # Every key exists even if no subkeys were stored
+        $hSection->{$_} = {} foreach @stryKey;
+
+        while (@stryColumn)
+        {
+            my ($iSubKeyIdx, $iColumnType, $strColumn) = splice(@stryColumn, 0, 3);
+            my $strSubKey = $stryString->[$iSubKeyIdx];
+            my @bExists;
+            my @xValue;
+
+            if ($iColumnType == INI_BINARY_COLUMN_UINT)
+            {
+                @xValue = unpack('w*', $strColumn);
+                @bExists = map {$_ != 0} @xValue;
+                @xValue = map {$_ - 1} @xValue;
+            }
+            elsif ($iColumnType == INI_BINARY_COLUMN_BOOL)
+            {
+                @xValue = unpack('C*', $strColumn);
+                @bExists = map {$_ != 0} @xValue;
+                @xValue = map {$_ == 2 ? JSON::PP::true : JSON::PP::false} @xValue;
+            }
+            elsif ($iColumnType == INI_BINARY_COLUMN_SHA1)
+            {
+                my $iOffset = 0;
+
+                for (my $iKeyIdx = 0; $iKeyIdx < @stryKey; $iKeyIdx++)
+                {
+                    $bExists[$iKeyIdx] = unpack('C', substr($strColumn, $iOffset, 1));
+
+                    if ($bExists[$iKeyIdx])
+                    {
+                        $xValue[$iKeyIdx] = unpack('H40', substr($strColumn, $iOffset + 1, 20));
+                        $iOffset += 21;
+                    }
+                    else
+                    {
+                        $iOffset++;
+                    }
+                }
+            }
+            elsif ($iColumnType == INI_BINARY_COLUMN_STRING)
+            {
+                @xValue = unpack('w*', $strColumn);
+                @bExists = map {$_ != 0} @xValue;
+                @xValue = map {$_ == 0 ? undef : $stryString->[$_ - 1]} @xValue;
+            }
+            else
+            {
+                @xValue = unpack('(w/a)*', $strColumn);
+                @bExists = map {$_ ne ''} @xValue;
+                @xValue = map {$_ eq '' ? undef : $oJSON->decode($_)} @xValue;
+            }
+
+            # Only set values that exist so no subkeys are created that were not in the original content
+            for (my $iKeyIdx = 0; $iKeyIdx < @stryKey; $iKeyIdx++)
+            {
+                if ($bExists[$iKeyIdx])
+                {
+                    $hSection->{$stryKey[$iKeyIdx]}{$strSubKey} = $xValue[$iKeyIdx];
+                }
+            }
+        }
+    }
+
+    return $hSection;
+}
+
+1;
@@ -166,6 +166,19 @@ sub writeLine
     return $self->parent()->writeLine($strBuffer);
 }
 
+####################################################################################################################################
+# write - check for error before writing, see writeLine()
+####################################################################################################################################
+sub write
+{
+    my $self = shift;
+    my $rtBuffer = shift;
+
+    $self->error();
+
+    return $self->parent()->write($rtBuffer);
+}
+
 ####################################################################################################################################
 # close - check if the process terminated on error
 ####################################################################################################################################
@@ -0,0 +1,267 @@
+####################################################################################################################################
+# COMMON LIMIT MODULE
+#
+# Limits the rate at which a backup reads from the database host.  The limit is shared by all local processes through a file in the
+# lock path.  The file stores the rate limits followed by the time when the next read is allowed for the total limit and for each
+# device.  Every read moves that time forward by the size of the read divided by the rate and the reader sleeps until it is within
+# the burst time of the new value.  This is the same as a token bucket where the bucket holds LIMIT_BURST seconds worth of tokens.
+#
+# The main process creates the file and the rate options are passed to the local processes so they know to open it.  The file holds
+# the current limits so they can be changed while the backup is running by sending SIGUSR1 (half the rate) or SIGUSR2 (double the
+# rate) to the main process.  The file is removed when the main process exits, even on error.
+####################################################################################################################################
+package pgBackRest::Common::Limit;
+
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use Exporter qw(import);
+    our @EXPORT = qw();
+use Fcntl qw(:DEFAULT :flock SEEK_SET);
+use Time::HiRes qw(gettimeofday sleep);
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Log;
+use pgBackRest::Config::Config;
+
+####################################################################################################################################
+# Seconds worth of reads that can be done at once without waiting
+####################################################################################################################################
+use constant LIMIT_BURST                                            => 1;
+
+####################################################################################################################################
+# Key for the total limit in the limit file
+####################################################################################################################################
+use constant LIMIT_KEY_TOTAL                                        => 'total';
+
+####################################################################################################################################
+# Limit file handle, whether this process created it, and whether a limit is active (undef until checked)
+####################################################################################################################################
+my $hLimitHandle;
+my $bLimitOwner = false;
+my $bLimitActive;
+
+####################################################################################################################################
+# limitFileName
+#
+# Get the limit file name.
+####################################################################################################################################
+sub limitFileName
+{
+    return cfgOption(CFGOPT_LOCK_PATH) . '/' . cfgOption(CFGOPT_STANZA) . '_' . cfgCommandName(CFGCMD_BACKUP) . '.limit';
+}
+
+####################################################################################################################################
+# limitRead/limitWrite
+#
+# Read and write the limit file.  The caller must hold an exclusive lock on the file.
+####################################################################################################################################
+sub limitRead
+{
+    my $tContent = '';
+
+    sysseek($hLimitHandle, 0, SEEK_SET)
+        or confess &log(ERROR, 'unable to seek limit file ' . limitFileName(), ERROR_FILE_READ);
+
+    while (sysread($hLimitHandle, $tContent, 4096, length($tContent))) {};
+
+    my ($strRate, @stryNext) = split("\n", $tContent);
+    my ($lRateMax, $lRateDeviceMax) = split(' ', defined($strRate) ? $strRate : '0 0');
+    my $hNext = {map {split(' ', $_)} @stryNext};
+
+    return ($lRateMax, $lRateDeviceMax, $hNext);
+}
+
+sub limitWrite
+{
+    my $lRateMax = shift;
+    my $lRateDeviceMax = shift;
+    my $hNext = shift;
+
+    my $tContent = "${lRateMax} ${lRateDeviceMax}\n" . join('', map {"$_ $hNext->{$_}\n"} sort(keys(%{$hNext})));
+
+    sysseek($hLimitHandle, 0, SEEK_SET)
+        or confess &log(ERROR, 'unable to seek limit file ' . limitFileName(), ERROR_FILE_WRITE);
+
+    syswrite($hLimitHandle, $tContent) == length($tContent)
+        or confess &log(ERROR, 'unable to write limit file ' . limitFileName(), ERROR_FILE_WRITE);
+
+    truncate($hLimitHandle, length($tContent))
+        or confess &log(ERROR, 'unable to truncate limit file ' . limitFileName(), ERROR_FILE_WRITE);
+}
+
+####################################################################################################################################
+# limitCreate
+#
+# Create the limit file with the total and per device limits (in bytes per second, 0 for no limit).  Called by the main process.
+####################################################################################################################################
+sub limitCreate
+{
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $lRateMax,
+        $lRateDeviceMax,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '::limitCreate', \@_,
+            {name => 'lRateMax'},
+            {name => 'lRateDeviceMax'},
+        );
+
+    my $strLimitFile = limitFileName();
+
+    sysopen($hLimitHandle, $strLimitFile, O_RDWR | O_CREAT, oct(640))
+        or confess &log(ERROR, "unable to open limit file ${strLimitFile}", ERROR_FILE_OPEN);
+
+    flock($hLimitHandle, LOCK_EX);
+    limitWrite($lRateMax, $lRateDeviceMax, {});
+    flock($hLimitHandle, LOCK_UN);
+
+    $bLimitOwner = true;
+    $bLimitActive = true;
+
+    # Change the rate while the backup is running
+    $SIG{USR1} = sub {limitScale(.5)};
+    $SIG{USR2} = sub {limitScale(2)};
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+push @EXPORT, qw(limitCreate);
+
+####################################################################################################################################
+# limitScale
+#
+# Multiply the limits by a factor.  Called by the signal handlers in the main process.
+####################################################################################################################################
+sub limitScale
+{
+    my $fScale = shift;
+
+    return if (!$bLimitOwner);
+
+    flock($hLimitHandle, LOCK_EX);
+
+    my ($lRateMax, $lRateDeviceMax, $hNext) = limitRead();
+
+    $lRateMax = $lRateMax > 0 ? int($lRateMax * $fScale) || 1 : 0;
+    $lRateDeviceMax = $lRateDeviceMax > 0 ? int($lRateDeviceMax * $fScale) || 1 : 0;
+
+    limitWrite($lRateMax, $lRateDeviceMax, $hNext);
+    flock($hLimitHandle, LOCK_UN);
+
+    &log(INFO,
+        'rate limit changed to ' . ($lRateMax > 0 ? "${lRateMax}B/s" : 'none') . ' total, ' .
+        ($lRateDeviceMax > 0 ? "${lRateDeviceMax}B/s" : 'none') . ' per device');
+}
+
+####################################################################################################################################
+# limitRemove
+#
+# Remove the limit file if this process created it and close it.  Called by the main process when the backup is done and by
+# exitSafe() so the file is removed on error.
+####################################################################################################################################
+sub limitRemove
+{
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '::limitRemove');
+
+    if ($bLimitOwner)
+    {
+        $SIG{USR1} = 'DEFAULT';
+        $SIG{USR2} = 'DEFAULT';
+
+        unlink(limitFileName());
+        $bLimitOwner = false;
+    }
+
+    if (defined($hLimitHandle))
+    {
+        close($hLimitHandle);
+        undef($hLimitHandle);
+    }
+
+    undef($bLimitActive);
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+push @EXPORT, qw(limitRemove);
+
+####################################################################################################################################
+# limitActive
+#
+# Is a limit active for this backup?  Only when a rate option is set, so a limit file left behind by another process is never used.
+# The limit file is only opened once per process.
+####################################################################################################################################
+sub limitActive
+{
+    if (!defined($bLimitActive))
+    {
+        my $bActive = false;
+
+        if (cfgOptionTest(CFGOPT_RATE_MAX) || cfgOptionTest(CFGOPT_RATE_DEVICE_MAX))
+        {
+            my $strLimitFile = limitFileName();
+
+            sysopen($hLimitHandle, $strLimitFile, O_RDWR)
+                or confess &log(ERROR, "unable to open limit file ${strLimitFile}", ERROR_FILE_OPEN);
+
+            $bActive = true;
+        }
+
+        $bLimitActive = $bActive;
+    }
+
+    return $bLimitActive;
+}
+
+push @EXPORT, qw(limitActive);
+
+####################################################################################################################################
+# limitTake
+#
+# Account for a read from the device (if known) and sleep until the read is within the limits.
+####################################################################################################################################
+sub limitTake
+{
+    my $lSize = shift;
+    my $strDevice = shift;
+
+    return if (!limitActive() || $lSize == 0);
+
+    flock($hLimitHandle, LOCK_EX);
+
+    my ($lRateMax, $lRateDeviceMax, $hNext) = limitRead();
+    my $fTime = gettimeofday();
+    my $fSleep = 0;
+
+    foreach my $rxLimit ([LIMIT_KEY_TOTAL, $lRateMax], [$strDevice, $lRateDeviceMax])
+    {
+        my ($strKey, $lRate) = @{$rxLimit};
+
+        next if (!defined($strKey) || $lRate <= 0);
+
+        my $fNext = (defined($hNext->{$strKey}) && $hNext->{$strKey} > $fTime ? $hNext->{$strKey} : $fTime) + $lSize / $lRate;
+
+        $hNext->{$strKey} = $fNext;
+        $fSleep = $fNext - $fTime - LIMIT_BURST if ($fNext - $fTime - LIMIT_BURST > $fSleep);
+    }
+
+    limitWrite($lRateMax, $lRateDeviceMax, $hNext);
+    flock($hLimitHandle, LOCK_UN);
+
+    # Sleep outside the lock so other processes can account for their reads
+    sleep($fSleep) if ($fSleep > 0);
+}
+
+push @EXPORT, qw(limitTake);
+
+1;
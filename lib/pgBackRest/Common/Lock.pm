@@ -228,8 +228,8 @@ sub lockStop
             my $hLockHandle;
             my $strLockFile = "${strLockPath}/${strFile}";
 
-            # Skip if this is a stop file
-            next if ($strFile =~ /\.stop$/);
+            # Skip if this is a stop file or a backup rate limit file
+            next if ($strFile =~ /\.(stop|limit)$/);
 
             # Open the lock file for read
             if (!sysopen($hLockHandle, $strLockFile, O_RDONLY))
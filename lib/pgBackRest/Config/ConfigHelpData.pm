@@ -31,7 +31,11 @@ my $oConfigHelpData =
             description =>
                 "WAL segments will be copied to the local repo, then a process will be forked to compress the segment and " .
                     "transfer it to the remote repo if configured. Control will be returned to PostgreSQL as soon as the WAL " .
-                    "segment is copied locally."
+                    "segment is copied locally.\n" .
+                "\n" .
+                "For archive-get a process will be forked to fetch the requested WAL segment and the segments that follow it " .
+                    "into the spool path in parallel. Subsequent requests are satisfied from the spool path without waiting for " .
+                    "the repository."
         },
 
         # ARCHIVE-CHECK Option Help
@@ -64,6 +68,19 @@ my $oConfigHelpData =
                     "database cluster to a consistent state."
         },
 
+        # ARCHIVE-GET-QUEUE-MAX Option Help
+        #---------------------------------------------------------------------------------------------------------------------------
+        'archive-get-queue-max' =>
+        {
+            section => 'archive',
+            summary =>
+                "Maximum size (in bytes) of the archive-get queue.",
+            description =>
+                "Specifies the maximum size of the archive-get queue when archive-async is enabled. The queue is stored in the " .
+                    "spool-path and is used to speed providing WAL to PostgreSQL. The requested WAL segment is always fetched " .
+                    "even when the queue is smaller than a segment."
+        },
+
         # ARCHIVE-QUEUE-MAX Option Help
         #---------------------------------------------------------------------------------------------------------------------------
         'archive-queue-max' =>
@@ -97,7 +114,8 @@ my $oConfigHelpData =
             description =>
                 "Set maximum time, in seconds, to wait for WAL segments to reach the archive. The timeout applies to the check " .
                     "command and to the backup command when waiting for WAL segments required to make the backup consistent to " .
-                    "be archived."
+                    "be archived. It also applies to asynchronous archive-push and archive-get when waiting for the async " .
+                    "process."
         },
 
         # BACKUP-CMD Option Help
@@ -525,6 +543,20 @@ my $oConfigHelpData =
                     "generating documentation."
         },
 
+        # MANIFEST-BINARY Option Help
+        #---------------------------------------------------------------------------------------------------------------------------
+        'manifest-binary' =>
+        {
+            section => 'backup',
+            summary =>
+                "Save a binary copy of the manifest.",
+            description =>
+                "In addition to the standard manifest, save a compact binary manifest at the end of the backup. The binary " .
+                    "manifest is used in preference to the standard manifest when it exists and its sections are only decoded as " .
+                    "they are accessed, which makes loading manifests of backups with a large number of files faster. The " .
+                    "standard manifest is always saved so the backup can be read without the binary manifest."
+        },
+
         # MANIFEST-SAVE-THRESHOLD Option Help
         #---------------------------------------------------------------------------------------------------------------------------
         'manifest-save-threshold' =>
@@ -554,6 +586,50 @@ my $oConfigHelpData =
                     "the command line."
         },
 
+        # PROCESS-AUTO Option Help
+        #---------------------------------------------------------------------------------------------------------------------------
+        'process-auto' =>
+        {
+            section => 'general',
+            summary =>
+                "Adjust the number of backup processes automatically.",
+            description =>
+                "The backup starts with a single process and adds processes up to process-max as long as each new process " .
+                    "improves throughput by at least 10%. Throughput is measured from the bytes read by the backup processes and " .
+                    "is checked every five seconds. When throughput stops improving the last process added is removed since it " .
+                    "did not help. Processes are added again if throughput later changes by more than 10%, e.g. when the backup " .
+                    "moves to a tablespace on different storage. This allows process-max to be set high without overloading " .
+                    "storage or network that is already saturated."
+        },
+
+        # PROCESS-DEVICE-MAX Option Help
+        #---------------------------------------------------------------------------------------------------------------------------
+        'process-device-max' =>
+        {
+            section => 'general',
+            summary =>
+                "Max processes reading from each device.",
+            description =>
+                "Tablespaces are often stored on separate devices. The backup spreads reads across devices by starting jobs on " .
+                    "the device with the fewest running jobs, but a device may still end up with every process reading from it " .
+                    "when it holds most of the data. Set process-device-max to limit the number of processes reading from a " .
+                    "single device at once, e.g. to keep a slow device from being overloaded. Processes wait rather than exceed " .
+                    "the limit."
+        },
+
+        # PROCESS-LOAD-MAX Option Help
+        #---------------------------------------------------------------------------------------------------------------------------
+        'process-load-max' =>
+        {
+            section => 'general',
+            summary =>
+                "Max database host load when adjusting processes automatically.",
+            description =>
+                "When process-auto is enabled, a process is removed whenever the one minute load average of the database host " .
+                    "(read from /proc/loadavg) exceeds this value. Processes are added again once the load is below this value. " .
+                    "This keeps the backup from impacting database performance."
+        },
+
         # PROCESS-MAX Option Help
         #---------------------------------------------------------------------------------------------------------------------------
         'process-max' =>
@@ -563,7 +639,27 @@ my $oConfigHelpData =
                 "Max processes to use for compress/transfer.",
             description =>
                 "Each process will perform compression and transfer to make the command run faster, but don't set process-max " .
-                    "so high that it impacts database performance."
+                    "so high that it impacts database performance.\n" .
+                "\n" .
+                "The expire command uses the processes to remove expired WAL in parallel, which is faster when the repository " .
+                    "has high latency for each remove (e.g. S3)."
+        },
+
+        # PROTOCOL-STATS Option Help
+        #---------------------------------------------------------------------------------------------------------------------------
+        'protocol-stats' =>
+        {
+            section => 'general',
+            summary =>
+                "Report protocol stats when the command exits.",
+            description =>
+                "Counts, bytes, and latency percentiles are logged at detail level for each protocol command sent to local and " .
+                    "remote processes. The master side shows the time from sending a command until its output is received, " .
+                    "while the minion side shows the time spent running the command, so the difference is time spent in ssh, " .
+                    "encoding, and waiting. Data blocks streamed for storage commands are reported as the block command.\n" .
+                "\n" .
+                "The stats are also written in JSON format to the log path as stanza-command.stats, including the latency " .
+                    "histogram."
         },
 
         # PROTOCOL-TIMEOUT Option Help
@@ -579,6 +675,34 @@ my $oConfigHelpData =
                     "option must be greater than the db-timeout option."
         },
 
+        # RATE-DEVICE-MAX Option Help
+        #---------------------------------------------------------------------------------------------------------------------------
+        'rate-device-max' =>
+        {
+            section => 'general',
+            summary =>
+                "Max rate, in bytes per second, to read from each device during backup.",
+            description =>
+                "Works like rate-max but limits each tablespace device separately. Only enforced when the database host is local " .
+                    "to the backup since the device is not known for remote reads."
+        },
+
+        # RATE-MAX Option Help
+        #---------------------------------------------------------------------------------------------------------------------------
+        'rate-max' =>
+        {
+            section => 'general',
+            summary =>
+                "Max rate, in bytes per second, to read from the database host during backup.",
+            description =>
+                "The limit is shared by all backup processes so it does not need to change when process-max changes. Reads are " .
+                    "limited on the database host when it is local, otherwise the data received from the database host is " .
+                    "limited. Short bursts of up to one second of reads are allowed.\n" .
+                "\n" .
+                "The limit can be changed while a backup is running by sending SIGUSR1 (half the rate) or SIGUSR2 (double the " .
+                    "rate) to the backup process. The process id is in the backup lock file."
+        },
+
         # RECOVERY-OPTION Option Help
         #---------------------------------------------------------------------------------------------------------------------------
         'recovery-option' =>
@@ -821,7 +945,10 @@ my $oConfigHelpData =
                     "are compressed and moved to the repository. Depending on the volume of WAL generated this directory could " .
                     "become very large so be sure to plan accordingly.\n" .
                 "\n" .
-                "The archive-queue-max option can be used to limit the amount of WAL that will be spooled locally."
+                "The archive-queue-max option can be used to limit the amount of WAL that will be spooled locally.\n" .
+                "\n" .
+                "WAL segments fetched ahead by asynchronous archive-get are renamed from the spool path into place, so the spool " .
+                    "path should be on the same filesystem as the PostgreSQL WAL directory. Otherwise they are copied."
         },
 
         # STANZA Option Help
@@ -924,6 +1051,9 @@ my $oConfigHelpData =
 
             option =>
             {
+                'archive-async' => 'section',
+                'archive-get-queue-max' => 'section',
+                'archive-timeout' => 'section',
                 'backup-cmd' => 'section',
                 'backup-config' => 'section',
                 'backup-host' => 'section',
@@ -944,6 +1074,8 @@ my $oConfigHelpData =
                 'log-path' => 'section',
                 'log-timestamp' => 'section',
                 'neutral-umask' => 'section',
+                'process-max' => 'section',
+                'protocol-stats' => 'section',
                 'protocol-timeout' => 'section',
                 'repo-path' => 'section',
                 'repo-s3-bucket' => 'section',
@@ -956,6 +1088,7 @@ my $oConfigHelpData =
                 'repo-s3-region' => 'section',
                 'repo-s3-verify-ssl' => 'section',
                 'repo-type' => 'section',
+                'spool-path' => 'section',
                 'stanza' => 'default'
             }
         },
@@ -998,6 +1131,7 @@ my $oConfigHelpData =
                 'log-timestamp' => 'section',
                 'neutral-umask' => 'section',
                 'process-max' => 'section',
+                'protocol-stats' => 'section',
                 'protocol-timeout' => 'section',
                 'repo-path' => 'section',
                 'repo-s3-bucket' => 'section',
@@ -1072,6 +1206,7 @@ my $oConfigHelpData =
                 'log-level-stderr' => 'section',
                 'log-path' => 'section',
                 'log-timestamp' => 'section',
+                'manifest-binary' => 'section',
                 'manifest-save-threshold' => 'section',
                 'neutral-umask' => 'section',
 
@@ -1090,8 +1225,14 @@ my $oConfigHelpData =
                             "and archive-check is automatically disabled for the backup."
                 },
 
+                'process-auto' => 'section',
+                'process-device-max' => 'section',
+                'process-load-max' => 'section',
                 'process-max' => 'section',
+                'protocol-stats' => 'section',
                 'protocol-timeout' => 'section',
+                'rate-device-max' => 'section',
+                'rate-max' => 'section',
                 'repo-path' => 'section',
                 'repo-s3-bucket' => 'section',
                 'repo-s3-ca-file' => 'section',
@@ -1190,6 +1331,7 @@ my $oConfigHelpData =
                         "Specifying --no-online prevents pgBackRest from connecting to PostgreSQL and will disable some checks."
                 },
 
+                'protocol-stats' => 'section',
                 'protocol-timeout' => 'section',
                 'repo-path' => 'section',
                 'repo-s3-bucket' => 'section',
@@ -1221,6 +1363,8 @@ my $oConfigHelpData =
             {
                 'buffer-size' => 'section',
                 'cmd-ssh' => 'section',
+                'compress-level' => 'section',
+                'compress-level-network' => 'section',
                 'config' => 'default',
                 'db-cmd' => 'section',
                 'db-config' => 'section',
@@ -1233,6 +1377,8 @@ my $oConfigHelpData =
                 'log-path' => 'section',
                 'log-timestamp' => 'section',
                 'neutral-umask' => 'section',
+                'process-max' => 'section',
+                'protocol-timeout' => 'section',
                 'repo-path' => 'section',
                 'repo-s3-bucket' => 'section',
                 'repo-s3-ca-file' => 'section',
@@ -1312,6 +1458,7 @@ my $oConfigHelpData =
                         "* json - Exhaustive machine-readable backup information in JSON format."
                 },
 
+                'protocol-stats' => 'section',
                 'protocol-timeout' => 'section',
                 'repo-path' => 'section',
                 'repo-s3-bucket' => 'section',
@@ -1385,6 +1532,7 @@ my $oConfigHelpData =
                 'log-timestamp' => 'section',
                 'neutral-umask' => 'section',
                 'process-max' => 'section',
+                'protocol-stats' => 'section',
                 'protocol-timeout' => 'section',
                 'recovery-option' => 'section',
                 'repo-path' => 'section',
@@ -1549,6 +1697,7 @@ my $oConfigHelpData =
                         "Specifying --no-online prevents pgBackRest from connecting to PostgreSQL when creating the stanza."
                 },
 
+                'protocol-stats' => 'section',
                 'protocol-timeout' => 'section',
                 'repo-path' => 'section',
                 'repo-s3-bucket' => 'section',
@@ -1615,6 +1764,7 @@ my $oConfigHelpData =
                         "Specifying --no-online prevents pgBackRest from connecting to PostgreSQL when upgrading the stanza."
                 },
 
+                'protocol-stats' => 'section',
                 'protocol-timeout' => 'section',
                 'repo-path' => 'section',
                 'repo-s3-bucket' => 'section',
@@ -163,8 +163,20 @@ use constant CFGOPT_NEUTRAL_UMASK                                   => 'neutral-
     push @EXPORT, qw(CFGOPT_NEUTRAL_UMASK);
 use constant CFGOPT_PROTOCOL_TIMEOUT                                => 'protocol-timeout';
     push @EXPORT, qw(CFGOPT_PROTOCOL_TIMEOUT);
+use constant CFGOPT_PROTOCOL_STATS                                  => 'protocol-stats';
+    push @EXPORT, qw(CFGOPT_PROTOCOL_STATS);
 use constant CFGOPT_PROCESS_MAX                                     => 'process-max';
     push @EXPORT, qw(CFGOPT_PROCESS_MAX);
+use constant CFGOPT_PROCESS_DEVICE_MAX                              => 'process-device-max';
+    push @EXPORT, qw(CFGOPT_PROCESS_DEVICE_MAX);
+use constant CFGOPT_PROCESS_AUTO                                    => 'process-auto';
+    push @EXPORT, qw(CFGOPT_PROCESS_AUTO);
+use constant CFGOPT_PROCESS_LOAD_MAX                                => 'process-load-max';
+    push @EXPORT, qw(CFGOPT_PROCESS_LOAD_MAX);
+use constant CFGOPT_RATE_MAX                                        => 'rate-max';
+    push @EXPORT, qw(CFGOPT_RATE_MAX);
+use constant CFGOPT_RATE_DEVICE_MAX                                 => 'rate-device-max';
+    push @EXPORT, qw(CFGOPT_RATE_DEVICE_MAX);
 
 # Commands
 use constant CFGOPT_CMD_SSH                                         => 'cmd-ssh';
@@ -218,6 +230,8 @@ use constant CFGOPT_LOG_TIMESTAMP                                   => 'log-time
 #-----------------------------------------------------------------------------------------------------------------------------------
 use constant CFGOPT_ARCHIVE_ASYNC                                   => 'archive-async';
     push @EXPORT, qw(CFGOPT_ARCHIVE_ASYNC);
+use constant CFGOPT_ARCHIVE_GET_QUEUE_MAX                           => 'archive-get-queue-max';
+    push @EXPORT, qw(CFGOPT_ARCHIVE_GET_QUEUE_MAX);
 # Deprecated and to be removed
 use constant CFGOPT_ARCHIVE_MAX_MB                                  => 'archive-max-mb';
     push @EXPORT, qw(CFGOPT_ARCHIVE_MAX_MB);
@@ -246,6 +260,8 @@ use constant CFGOPT_CHECKSUM_PAGE                                   => 'checksum
     push @EXPORT, qw(CFGOPT_CHECKSUM_PAGE);
 use constant CFGOPT_HARDLINK                                        => 'hardlink';
     push @EXPORT, qw(CFGOPT_HARDLINK);
+use constant CFGOPT_MANIFEST_BINARY                                 => 'manifest-binary';
+    push @EXPORT, qw(CFGOPT_MANIFEST_BINARY);
 use constant CFGOPT_MANIFEST_SAVE_THRESHOLD                         => 'manifest-save-threshold';
     push @EXPORT, qw(CFGOPT_MANIFEST_SAVE_THRESHOLD);
 use constant CFGOPT_RESUME                                          => 'resume';
@@ -386,6 +402,9 @@ use constant CFGDEF_DEFAULT_DB_TIMEOUT                              => 1800;
 use constant CFGDEF_DEFAULT_DB_TIMEOUT_MIN                          => WAIT_TIME_MINIMUM;
 use constant CFGDEF_DEFAULT_DB_TIMEOUT_MAX                          => 86400 * 7;
 
+use constant CFGDEF_DEFAULT_RATE_MIN                                => 1024;
+use constant CFGDEF_DEFAULT_RATE_MAX                                => 1024 * 1024 * 1024 * 1024;
+
 use constant CFGDEF_DEFAULT_RETENTION_MIN                           => 1;
 use constant CFGDEF_DEFAULT_RETENTION_MAX                           => 999999999;
 
@@ -824,6 +843,7 @@ my %hOptionRule =
         &CFGBLDDEF_RULE_ALLOW_RANGE => [WAIT_TIME_MINIMUM, 86400],
         &CFGBLDDEF_RULE_COMMAND =>
         {
+            &CFGCMD_ARCHIVE_GET => {},
             &CFGCMD_ARCHIVE_PUSH => {},
             &CFGCMD_BACKUP => {},
             &CFGCMD_CHECK => {},
@@ -910,6 +930,7 @@ my %hOptionRule =
             &CFGCMD_ARCHIVE_PUSH => {},
             &CFGCMD_BACKUP => {},
             &CFGCMD_CHECK => {},
+            &CFGCMD_EXPIRE => {},
             &CFGCMD_INFO => {},
             &CFGCMD_LOCAL => {},
             &CFGCMD_REMOTE => {},
@@ -931,6 +952,7 @@ my %hOptionRule =
             &CFGCMD_ARCHIVE_PUSH => {},
             &CFGCMD_BACKUP => {},
             &CFGCMD_CHECK => {},
+            &CFGCMD_EXPIRE => {},
             &CFGCMD_INFO => {},
             &CFGCMD_LOCAL => {},
             &CFGCMD_REMOTE => {},
@@ -1036,6 +1058,27 @@ my %hOptionRule =
         &CFGBLDDEF_RULE_DEFAULT => CFGDEF_DEFAULT_DB_TIMEOUT + 30,
         &CFGBLDDEF_RULE_ALLOW_RANGE => [CFGDEF_DEFAULT_DB_TIMEOUT_MIN, CFGDEF_DEFAULT_DB_TIMEOUT_MAX],
         &CFGBLDDEF_RULE_COMMAND =>
+        {
+            &CFGCMD_ARCHIVE_GET => {},
+            &CFGCMD_ARCHIVE_PUSH => {},
+            &CFGCMD_BACKUP => {},
+            &CFGCMD_CHECK => {},
+            &CFGCMD_EXPIRE => {},
+            &CFGCMD_INFO => {},
+            &CFGCMD_LOCAL => {},
+            &CFGCMD_REMOTE => {},
+            &CFGCMD_RESTORE => {},
+            &CFGCMD_STANZA_CREATE => {},
+            &CFGCMD_STANZA_UPGRADE => {},
+        }
+    },
+
+    &CFGOPT_PROTOCOL_STATS =>
+    {
+        &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
+        &CFGBLDDEF_RULE_TYPE => CFGOPTDEF_TYPE_BOOLEAN,
+        &CFGBLDDEF_RULE_DEFAULT => false,
+        &CFGBLDDEF_RULE_COMMAND =>
         {
             &CFGCMD_ARCHIVE_GET => {},
             &CFGCMD_ARCHIVE_PUSH => {},
@@ -1162,6 +1205,7 @@ my %hOptionRule =
         &CFGBLDDEF_RULE_DEFAULT => '/var/spool/' . BACKREST_EXE,
         &CFGBLDDEF_RULE_COMMAND =>
         {
+            &CFGCMD_ARCHIVE_GET => {},
             &CFGCMD_ARCHIVE_PUSH => {},
         },
         &CFGBLDDEF_RULE_DEPEND =>
@@ -1180,12 +1224,79 @@ my %hOptionRule =
         &CFGBLDDEF_RULE_ALLOW_RANGE => [1, 96],
         &CFGBLDDEF_RULE_COMMAND =>
         {
+            &CFGCMD_ARCHIVE_GET => {},
             &CFGCMD_ARCHIVE_PUSH => {},
             &CFGCMD_BACKUP => {},
+            &CFGCMD_EXPIRE => {},
             &CFGCMD_RESTORE => {},
         }
     },
 
+    &CFGOPT_PROCESS_DEVICE_MAX =>
+    {
+        &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
+        &CFGBLDDEF_RULE_TYPE => CFGOPTDEF_TYPE_INTEGER,
+        &CFGBLDDEF_RULE_REQUIRED => false,
+        &CFGBLDDEF_RULE_ALLOW_RANGE => [1, 96],
+        &CFGBLDDEF_RULE_COMMAND =>
+        {
+            &CFGCMD_BACKUP => {},
+        }
+    },
+
+    &CFGOPT_PROCESS_AUTO =>
+    {
+        &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
+        &CFGBLDDEF_RULE_TYPE => CFGOPTDEF_TYPE_BOOLEAN,
+        &CFGBLDDEF_RULE_DEFAULT => false,
+        &CFGBLDDEF_RULE_COMMAND =>
+        {
+            &CFGCMD_BACKUP => {},
+        }
+    },
+
+    &CFGOPT_PROCESS_LOAD_MAX =>
+    {
+        &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
+        &CFGBLDDEF_RULE_TYPE => CFGOPTDEF_TYPE_FLOAT,
+        &CFGBLDDEF_RULE_REQUIRED => false,
+        &CFGBLDDEF_RULE_DEPEND =>
+        {
+            &CFGBLDDEF_RULE_DEPEND_OPTION => CFGOPT_PROCESS_AUTO,
+            &CFGBLDDEF_RULE_DEPEND_LIST => [true],
+        },
+        &CFGBLDDEF_RULE_COMMAND =>
+        {
+            &CFGCMD_BACKUP => {},
+        }
+    },
+
+    &CFGOPT_RATE_MAX =>
+    {
+        &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
+        &CFGBLDDEF_RULE_TYPE => CFGOPTDEF_TYPE_INTEGER,
+        &CFGBLDDEF_RULE_REQUIRED => false,
+        &CFGBLDDEF_RULE_ALLOW_RANGE => [CFGDEF_DEFAULT_RATE_MIN, CFGDEF_DEFAULT_RATE_MAX],
+        &CFGBLDDEF_RULE_COMMAND =>
+        {
+            &CFGCMD_BACKUP => {},
+            &CFGCMD_LOCAL => {},
+        }
+    },
+
+    &CFGOPT_RATE_DEVICE_MAX =>
+    {
+        &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
+        &CFGBLDDEF_RULE_TYPE => CFGOPTDEF_TYPE_INTEGER,
+        &CFGBLDDEF_RULE_REQUIRED => false,
+        &CFGBLDDEF_RULE_ALLOW_RANGE => [CFGDEF_DEFAULT_RATE_MIN, CFGDEF_DEFAULT_RATE_MAX],
+        &CFGBLDDEF_RULE_COMMAND =>
+        {
+            &CFGCMD_BACKUP => {},
+            &CFGCMD_LOCAL => {},
+        }
+    },
+
     # Logging options
     #-------------------------------------------------------------------------------------------------------------------------------
     &CFGOPT_LOG_LEVEL_CONSOLE =>
@@ -1267,10 +1378,27 @@ my %hOptionRule =
         &CFGBLDDEF_RULE_DEFAULT => false,
         &CFGBLDDEF_RULE_COMMAND =>
         {
+            &CFGCMD_ARCHIVE_GET => {},
             &CFGCMD_ARCHIVE_PUSH => {},
         }
     },
 
+    &CFGOPT_ARCHIVE_GET_QUEUE_MAX =>
+    {
+        &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
+        &CFGBLDDEF_RULE_TYPE => CFGOPTDEF_TYPE_INTEGER,
+        &CFGBLDDEF_RULE_DEFAULT => 134217728,
+        &CFGBLDDEF_RULE_COMMAND =>
+        {
+            &CFGCMD_ARCHIVE_GET => {},
+        },
+        &CFGBLDDEF_RULE_DEPEND =>
+        {
+            &CFGBLDDEF_RULE_DEPEND_OPTION => CFGOPT_ARCHIVE_ASYNC,
+            &CFGBLDDEF_RULE_DEPEND_LIST => [true],
+        },
+    },
+
     # Deprecated and to be removed
     &CFGOPT_ARCHIVE_MAX_MB =>
     {
@@ -1436,6 +1564,17 @@ my %hOptionRule =
         }
     },
 
+    &CFGOPT_MANIFEST_BINARY =>
+    {
+        &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
+        &CFGBLDDEF_RULE_TYPE => CFGOPTDEF_TYPE_BOOLEAN,
+        &CFGBLDDEF_RULE_DEFAULT => false,
+        &CFGBLDDEF_RULE_COMMAND =>
+        {
+            &CFGCMD_BACKUP => {},
+        }
+    },
+
     &CFGOPT_MANIFEST_SAVE_THRESHOLD =>
     {
         &CFGBLDDEF_RULE_SECTION => CFGDEF_SECTION_GLOBAL,
@@ -23,8 +23,15 @@ use pgBackRest::Config::Config;
 use pgBackRest::InfoCommon;
 use pgBackRest::Manifest;
 use pgBackRest::Protocol::Helper;
+use pgBackRest::Protocol::Local::Process;
 use pgBackRest::Protocol::Storage::Helper;
 
+####################################################################################################################################
+# Maximum number of archive files removed with a single call to the repository storage, so drivers that can remove many files in a
+# single request (e.g. S3) make as few requests as possible
+####################################################################################################################################
+use constant EXPIRE_REMOVE_FILE_MAX                                 => 1000;
+
 ####################################################################################################################################
 # new
 ####################################################################################################################################
@@ -87,6 +94,71 @@ sub logExpire
     }
 }
 
+####################################################################################################################################
+# archiveRemove
+#
+# Remove expired archive paths (recursively) and files.  The entire set is found before anything is removed so the removes can be
+# batched and, when process-max > 1, run in parallel by local processes.  This is much faster when the repository has high latency
+# for each remove (e.g. S3) or there are many years of WAL to expire.
+####################################################################################################################################
+sub archiveRemove
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $stryPath,
+        $stryFile,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->archiveRemove', \@_,
+            {name => 'stryPath', trace => true},
+            {name => 'stryFile', trace => true},
+        );
+
+    # Build the list of removes.  Each is a list of parameters for the repository storage remove().
+    my @ryRemove = map {[$_, {bRecurse => true}]} @{$stryPath};
+
+    for (my $iFileIdx = 0; $iFileIdx < @{$stryFile}; $iFileIdx += EXPIRE_REMOVE_FILE_MAX)
+    {
+        my $iFileLastIdx = $iFileIdx + EXPIRE_REMOVE_FILE_MAX - 1;
+        push(@ryRemove, [[@{$stryFile}[$iFileIdx .. ($iFileLastIdx < @{$stryFile} ? $iFileLastIdx : @{$stryFile} - 1)]]]);
+    }
+
+    # Remove in parallel when there is more than one remove and more than one process is allowed
+    if (cfgOption(CFGOPT_PROCESS_MAX) > 1 && @ryRemove > 1)
+    {
+        my $oRemoveProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP);
+        $oRemoveProcess->hostAdd(1, cfgOption(CFGOPT_PROCESS_MAX));
+
+        for (my $iRemoveIdx = 0; $iRemoveIdx < @ryRemove; $iRemoveIdx++)
+        {
+            $oRemoveProcess->queueJob(1, 'default', $iRemoveIdx, OP_STORAGE_REMOVE, $ryRemove[$iRemoveIdx]);
+        }
+
+        while (my $hyJob = $oRemoveProcess->process())
+        {
+            foreach my $hJob (@{$hyJob})
+            {
+                logDebugMisc($strOperation, 'remove complete', {name => 'rRemove', value => $hJob->{rParam}});
+            }
+        }
+    }
+    else
+    {
+        foreach my $rRemove (@ryRemove)
+        {
+            storageRepo()->remove(@{$rRemove});
+        }
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
 ####################################################################################################################################
 # process
 #
@@ -133,6 +205,7 @@ sub process
                 foreach my $strPath ($oBackupInfo->list('^' . $stryPath[$iFullIdx] . '.*'))
                 {
                     $oStorageRepo->remove(STORAGE_REPO_BACKUP . "/${strPath}/" . FILE_MANIFEST . INI_COPY_EXT);
+                    $oStorageRepo->remove(STORAGE_REPO_BACKUP . "/${strPath}/" . FILE_MANIFEST_BINARY);
                     $oStorageRepo->remove(STORAGE_REPO_BACKUP . "/${strPath}/" . FILE_MANIFEST);
                     $oBackupInfo->delete($strPath);
 
@@ -179,7 +252,8 @@ sub process
                     # Remove all differential and incremental backups before the oldest valid differential
                     if ($strPath lt $stryPath[$iDiffIdx + 1])
                     {
-                        $oStorageRepo->remove(STORAGE_REPO_BACKUP . "/${strPath}" . FILE_MANIFEST);
+                        $oStorageRepo->remove(STORAGE_REPO_BACKUP . "/${strPath}/" . FILE_MANIFEST_BINARY);
+                        $oStorageRepo->remove(STORAGE_REPO_BACKUP . "/${strPath}/" . FILE_MANIFEST);
                         $oBackupInfo->delete($strPath);
 
                         if ($strPath ne $stryPath[$iDiffIdx])
@@ -256,7 +330,11 @@ sub process
             my @stryTmp = @stryGlobalBackupRetention;
             my @stryGlobalBackupArchiveRetention = splice(@stryTmp, 0, $iArchiveRetention);
 
-            # For each archiveId, remove WAL that are not part of retention
+            # Archive paths and files to remove
+            my $stryRemovePath = [];
+            my $stryRemoveFile = [];
+
+            # For each archiveId, find WAL that is not part of retention
             foreach my $strArchiveId (@stryListArchiveDisk)
             {
                 # From the global list of backups to retain, create a list of backups, oldest to newest, associated with this
@@ -278,7 +356,7 @@ sub process
                     {
                         my $strFullPath = $oStorageRepo->pathGet(STORAGE_REPO_ARCHIVE . "/${strArchiveId}");
 
-                        $oStorageRepo->remove($strFullPath, {bRecurse => true});
+                        push(@{$stryRemovePath}, $strFullPath);
 
                         &log(INFO, "remove archive path: ${strFullPath}");
                     }
@@ -397,7 +475,7 @@ sub process
                             {
                                 my $strFullPath = $oStorageRepo->pathGet(STORAGE_REPO_ARCHIVE . "/${strArchiveId}") . "/${strPath}";
 
-                                $oStorageRepo->remove($strFullPath, {bRecurse => true});
+                                push(@{$stryRemovePath}, $strFullPath);
 
                                 # Log expire info
                                 logDebugMisc($strOperation, "remove major WAL path: ${strFullPath}");
@@ -428,7 +506,7 @@ sub process
                                     # Remove archive log if it is not used in a backup
                                     if ($bRemove)
                                     {
-                                        $oStorageRepo->remove(STORAGE_REPO_ARCHIVE . "/${strArchiveId}/${strSubPath}");
+                                        push(@{$stryRemoveFile}, STORAGE_REPO_ARCHIVE . "/${strArchiveId}/${strSubPath}");
 
                                         logDebugMisc($strOperation, "remove WAL segment: ${strArchiveId}/${strSubPath}");
 
@@ -452,6 +530,9 @@ sub process
                     }
                 }
             }
+
+            # Remove expired archive
+            $self->archiveRemove($stryRemovePath, $stryRemoveFile);
         }
     }
 
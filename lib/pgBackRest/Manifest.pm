@@ -12,11 +12,13 @@ use Exporter qw(import);
     our @EXPORT = qw();
 use File::Basename qw(dirname basename);
 use Digest::SHA;
+use JSON::PP;
 use Time::Local qw(timelocal);
 
 use pgBackRest::DbVersion;
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Ini;
+use pgBackRest::Common::IniBinary;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::Wait;
 use pgBackRest::Config::Config;
@@ -33,6 +35,12 @@ use constant FILE_MANIFEST                                          => 'backup.m
     push @EXPORT, qw(FILE_MANIFEST);
 use constant FILE_MANIFEST_COPY                                     => FILE_MANIFEST . INI_COPY_EXT;
     push @EXPORT, qw(FILE_MANIFEST_COPY);
+use constant FILE_MANIFEST_BINARY                                   => FILE_MANIFEST . INI_BINARY_EXT;
+    push @EXPORT, qw(FILE_MANIFEST_BINARY);
+use constant MANIFEST_JOURNAL_EXT                                   => '.journal';
+    push @EXPORT, qw(MANIFEST_JOURNAL_EXT);
+use constant FILE_MANIFEST_JOURNAL                                  => FILE_MANIFEST . MANIFEST_JOURNAL_EXT;
+    push @EXPORT, qw(FILE_MANIFEST_JOURNAL);
 
 ####################################################################################################################################
 # Default match factor
@@ -285,6 +293,7 @@ sub new
         $bLoad,
         $oStorage,
         $strDbVersion,
+        $bBinary,
     ) =
         logDebugParam
         (
@@ -293,10 +302,17 @@ sub new
             {name => 'bLoad', optional => true, default => true, trace => true},
             {name => 'oStorage', optional => true, default => storageRepo(), trace => true},
             {name => 'strDbVersion', optional => true, trace => true},
+            {name => 'bBinary', optional => true, default => false, trace => true},
         );
 
-    # Init object and store variables
-    my $self = $class->SUPER::new($strFileName, {bLoad => $bLoad, oStorage => $oStorage});
+    # Init object and store variables.  If bBinary is set the binary manifest is loaded in preference to the main file when it
+    # exists.  File entries are packed since there is one for every file in the cluster.
+    my $self = $class->SUPER::new(
+        $strFileName,
+        {bLoad => $bLoad, oStorage => $oStorage, bBinary => $bBinary, stryPackSection => [MANIFEST_SECTION_TARGET_FILE]});
+
+    # Device of each target, only known when the manifest is built
+    $self->{hTargetDevice} = {};
 
     # If manifest not loaded from a file then the db version must be set
     if (!$bLoad)
@@ -320,22 +336,174 @@ sub new
 ####################################################################################################################################
 # save
 #
-# Save the manifest.
+# Save the manifest.  If bBinary is set then a binary manifest is saved as well.
 ####################################################################################################################################
 sub save
 {
     my $self = shift;
 
     # Assign function parameters, defaults, and log debug info
-    my ($strOperation) = logDebugParam(__PACKAGE__ . '->save');
+    my
+    (
+        $strOperation,
+        $bBinary,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->save', \@_,
+            {name => 'bBinary', optional => true, default => false, trace => true},
+        );
 
     # Call inherited save
-    $self->SUPER::save();
+    $self->SUPER::save($bBinary);
+
+    # The journal is no longer needed once the full manifest has been saved
+    if ($self->{bJournal})
+    {
+        $self->{oStorage}->remove($self->{strFileName} . MANIFEST_JOURNAL_EXT);
+        $self->{bJournal} = false;
+    }
 
     # Return from function and log return values if any
     return logDebugReturn($strOperation);
 }
 
+####################################################################################################################################
+# journalOpen
+#
+# Start a new journal.  While the journal is open each file is appended to the journal as it is completed, so the progress of the
+# backup is preserved for resume without saving the entire manifest.  The journal is removed when the manifest is saved.
+####################################################################################################################################
+sub journalOpen
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->journalOpen');
+
+    $self->{oJournal} = $self->{oStorage}->openWrite($self->{strFileName} . MANIFEST_JOURNAL_EXT);
+    $self->{oJournalJSON} = JSON::PP->new()->canonical()->allow_nonref();
+    $self->{bJournal} = true;
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+####################################################################################################################################
+# journalWrite
+#
+# Append a file to the journal.  Each record is the JSON file name and the JSON file entry, or null when the file has been removed.
+####################################################################################################################################
+sub journalWrite
+{
+    my $self = shift;
+    my $strFile = shift;
+
+    my $strRecord =
+        $self->{oJournalJSON}->encode($strFile) . '=' .
+        $self->{oJournalJSON}->encode($self->SUPER::get(MANIFEST_SECTION_TARGET_FILE, $strFile, undef, false)) . "\n";
+
+    $self->{oJournal}->write(\$strRecord);
+}
+
+####################################################################################################################################
+# journalSync
+#
+# Sync the journal to disk so completed files survive a crash of the host.
+####################################################################################################################################
+sub journalSync
+{
+    my $self = shift;
+
+    if (defined($self->{oJournal}->handle()))
+    {
+        $self->{oJournal}->handle()->sync();
+    }
+}
+
+####################################################################################################################################
+# journalClose
+####################################################################################################################################
+sub journalClose
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->journalClose');
+
+    if (defined($self->{oJournal}))
+    {
+        $self->{oJournal}->close();
+        delete($self->{oJournal});
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+####################################################################################################################################
+# journalReplay
+#
+# Apply the journal left by an aborted backup to the manifest.  A partial record at the end of the journal is ignored since it was
+# being written when the backup was aborted.
+####################################################################################################################################
+sub journalReplay
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->journalReplay');
+
+    my $iRecordTotal = 0;
+    my $rstrJournal = $self->{oStorage}->get(
+        $self->{oStorage}->openRead($self->{strFileName} . MANIFEST_JOURNAL_EXT, {bIgnoreMissing => true}));
+
+    if (defined($rstrJournal))
+    {
+        my $oJSON = JSON::PP->new()->allow_nonref();
+
+        # Only complete records are replayed
+        my $iJournalSize = rindex($$rstrJournal, "\n") + 1;
+
+        foreach my $strRecord (split("\n", substr($$rstrJournal, 0, $iJournalSize)))
+        {
+            # File names are JSON encoded so the first = not in a quoted string is the separator
+            my ($strFile, $strEntry) = $strRecord =~ /^(\"(?:[^\"\\]|\\.)*\")=(.*)$/;
+
+            if (!defined($strFile))
+            {
+                confess &log(ERROR, "invalid record '${strRecord}' in journal for '$self->{strFileName}'", ERROR_FORMAT);
+            }
+
+            $strFile = $oJSON->decode($strFile);
+            my $hEntry = $oJSON->decode($strEntry);
+
+            if (defined($hEntry))
+            {
+                $self->set(MANIFEST_SECTION_TARGET_FILE, $strFile, undef, $hEntry);
+            }
+            else
+            {
+                $self->remove(MANIFEST_SECTION_TARGET_FILE, $strFile);
+            }
+
+            $iRecordTotal++;
+        }
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'iRecordTotal', value => $iRecordTotal, trace => true}
+    );
+}
+
+####################################################################################################################################
+# journalOpened - is the journal open?
+####################################################################################################################################
+sub journalOpened {defined(shift->{oJournal}) ? true : false}
+
 ####################################################################################################################################
 # get
 #
@@ -543,6 +711,32 @@ sub isTargetTablespace
     return $self->test(MANIFEST_SECTION_BACKUP_TARGET, $strTarget, MANIFEST_SUBKEY_TABLESPACE_ID);
 }
 
+####################################################################################################################################
+# fileDevice
+#
+# Get the device of the target that contains a file.  Returns undef when the device was not recorded while building the manifest.
+####################################################################################################################################
+sub fileDevice
+{
+    my $self = shift;
+    my $strFile = shift;
+
+    my $strDevice;
+    my $strTargetFound = '';
+
+    # Find the most specific target containing the file since link targets can be inside other targets
+    foreach my $strTarget (CORE::keys(%{$self->{hTargetDevice}}))
+    {
+        if (length($strTarget) > length($strTargetFound) && ($strFile eq $strTarget || index($strFile, "${strTarget}/") == 0))
+        {
+            $strTargetFound = $strTarget;
+            $strDevice = $self->{hTargetDevice}{$strTarget};
+        }
+    }
+
+    return $strDevice;
+}
+
 ####################################################################################################################################
 # build
 #
@@ -639,6 +833,12 @@ sub build
     my $hManifest = $oStorageDbMaster->manifest($strPath);
     my $strManifestType = MANIFEST_VALUE_LINK;
 
+    # Remember the device this level is stored on so backup can spread reads across devices.  This is not saved in the manifest.
+    if (defined($hManifest->{'.'}) && defined($hManifest->{'.'}{device}))
+    {
+        $self->{hTargetDevice}{$strLevel} = $hManifest->{'.'}{device};
+    }
+
     # Loop though all paths/files/links in the manifest
     foreach my $strName (sort(CORE::keys(%{$hManifest})))
     {
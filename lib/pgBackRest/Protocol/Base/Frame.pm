@@ -0,0 +1,157 @@
+####################################################################################################################################
+# Protocol Binary Frames
+#
+# Once negotiated, messages between the master and minion are sent as frames rather than JSON lines.  Each frame is a one byte type
+# and a four byte length in network order followed by the payload.  Commands and output are encoded with Storable, which is much
+# faster than JSON for large parameter lists and does not require scanning for linefeeds.  Data blocks are written as is so they do
+# not need to be copied or encoded.
+####################################################################################################################################
+package pgBackRest::Protocol::Base::Frame;
+
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use Exporter qw(import);
+    our @EXPORT = qw();
+use Storable qw(nfreeze thaw);
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Log;
+
+####################################################################################################################################
+# Frame format advertised in the minion greeting
+#
+# The Storable format version is included because older versions of Storable cannot read images written by newer versions.  Binary
+# frames are only used when the master and minion write the same format, otherwise they fall back to JSON.
+####################################################################################################################################
+use constant PROTOCOL_FRAME_BINARY                                  =>
+    'binary-' . Storable::BIN_MAJOR . '.' . Storable::BIN_WRITE_MINOR;
+    push @EXPORT, qw(PROTOCOL_FRAME_BINARY);
+
+####################################################################################################################################
+# Frame types
+####################################################################################################################################
+use constant PROTOCOL_FRAME_TYPE_COMMAND                            => 'C';
+    push @EXPORT, qw(PROTOCOL_FRAME_TYPE_COMMAND);
+use constant PROTOCOL_FRAME_TYPE_DATA                               => 'D';
+    push @EXPORT, qw(PROTOCOL_FRAME_TYPE_DATA);
+use constant PROTOCOL_FRAME_TYPE_OUTPUT                             => 'O';
+    push @EXPORT, qw(PROTOCOL_FRAME_TYPE_OUTPUT);
+
+####################################################################################################################################
+# Frame header size and pack template
+####################################################################################################################################
+use constant PROTOCOL_FRAME_HEADER                                  => 'a N';
+use constant PROTOCOL_FRAME_HEADER_SIZE                             => 5;
+
+####################################################################################################################################
+# protocolFrameHeaderRead - read a frame header and check the type
+####################################################################################################################################
+sub protocolFrameHeaderRead
+{
+    my $oIo = shift;
+    my $strTypeExpected = shift;
+
+    my $tHeader = '';
+    $oIo->read(\$tHeader, PROTOCOL_FRAME_HEADER_SIZE, true);
+
+    my ($strType, $lSize) = unpack(PROTOCOL_FRAME_HEADER, $tHeader);
+
+    if ($strType ne $strTypeExpected)
+    {
+        confess &log(ERROR, "expected protocol frame type '${strTypeExpected}' but found '${strType}'", ERROR_PROTOCOL);
+    }
+
+    return $lSize;
+}
+
+####################################################################################################################################
+# protocolMessageRead - read a frame and decode the message (the size of the frame is stored in rlSize when passed)
+####################################################################################################################################
+push @EXPORT, qw(protocolMessageRead);
+
+sub protocolMessageRead
+{
+    my $oIo = shift;
+    my $strType = shift;
+    my $rlSize = shift;
+
+    my $lSize = protocolFrameHeaderRead($oIo, $strType);
+    my $tPayload = '';
+
+    $oIo->read(\$tPayload, $lSize, true);
+
+    if (defined($rlSize))
+    {
+        $$rlSize = PROTOCOL_FRAME_HEADER_SIZE + $lSize;
+    }
+
+    return thaw($tPayload);
+}
+
+####################################################################################################################################
+# protocolMessageWrite - encode a message and write it as a single frame, returning the size of the frame
+####################################################################################################################################
+push @EXPORT, qw(protocolMessageWrite);
+
+sub protocolMessageWrite
+{
+    my $oIo = shift;
+    my $strType = shift;
+    my $hMessage = shift;
+
+    my $tPayload = nfreeze($hMessage);
+    my $tFrame = pack(PROTOCOL_FRAME_HEADER, $strType, length($tPayload)) . $tPayload;
+
+    $oIo->write(\$tFrame);
+
+    return length($tFrame);
+}
+
+####################################################################################################################################
+# protocolBlockRead - read a data block into the buffer and return the size (0 means the end of the data)
+####################################################################################################################################
+push @EXPORT, qw(protocolBlockRead);
+
+sub protocolBlockRead
+{
+    my $oIo = shift;
+    my $rtBuffer = shift;
+
+    my $lSize = protocolFrameHeaderRead($oIo, PROTOCOL_FRAME_TYPE_DATA);
+
+    if ($lSize > 0)
+    {
+        $oIo->read($rtBuffer, $lSize, true);
+    }
+
+    return $lSize;
+}
+
+####################################################################################################################################
+# protocolBlockWrite - write a data block (an undefined or empty buffer ends the data)
+####################################################################################################################################
+push @EXPORT, qw(protocolBlockWrite);
+
+sub protocolBlockWrite
+{
+    my $oIo = shift;
+    my $rtBuffer = shift;
+
+    my $lSize = defined($rtBuffer) ? length($$rtBuffer) : 0;
+    my $tHeader = pack(PROTOCOL_FRAME_HEADER, PROTOCOL_FRAME_TYPE_DATA, $lSize);
+
+    $oIo->write(\$tHeader);
+
+    # The block is written directly from the caller's buffer to avoid a copy
+    if ($lSize > 0)
+    {
+        $oIo->write($rtBuffer);
+    }
+
+    return $lSize;
+}
+
+1;
@@ -16,6 +16,8 @@ use JSON::PP;
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Ini;
 use pgBackRest::Common::Log;
+use pgBackRest::Protocol::Base::Frame;
+use pgBackRest::Protocol::Base::Stats;
 use pgBackRest::Version;
 
 ####################################################################################################################################
@@ -25,6 +27,17 @@ use constant OP_NOOP                                                => 'noop';
     push @EXPORT, qw(OP_NOOP);
 use constant OP_EXIT                                                => 'exit';
     push @EXPORT, qw(OP_EXIT);
+use constant OP_FRAME                                               => 'frame';
+    push @EXPORT, qw(OP_FRAME);
+use constant OP_STATS                                               => 'stats';
+    push @EXPORT, qw(OP_STATS);
+
+####################################################################################################################################
+# Maximum commands that can be submitted without waiting for output.  This limits how much output can be waiting in the pipe so the
+# minion does not block writing output while the master is blocked writing commands.
+####################################################################################################################################
+use constant PROTOCOL_COMMAND_PENDING_MAX                           => 16;
+    push @EXPORT, qw(PROTOCOL_COMMAND_PENDING_MAX);
 
 ####################################################################################################################################
 # CONSTRUCTOR
@@ -55,6 +68,18 @@ sub new
     # Create JSON object
     $self->{oJSON} = JSON::PP->new()->allow_nonref();
 
+    # JSON lines are used until binary frames are negotiated
+    $self->{bFrame} = false;
+
+    # Commands submitted without waiting for output and output received for them
+    $self->{iCommandId} = 0;
+    $self->{hCommandPending} = {};
+    $self->{hCommandOutput} = {};
+
+    # Command written with cmdWrite() that is waiting for output and the size of the last output received (for stats)
+    $self->{hCommandWrite} = undef;
+    $self->{lOutputSize} = 0;
+
     # Setup the keepalive timer
     $self->{fKeepAliveTimeout} = $self->io()->timeout() / 2 > 120 ? 120 : $self->io()->timeout() / 2;
     $self->{fKeepAliveTime} = gettimeofday();
@@ -123,46 +148,55 @@ sub greetingRead
         }
     }
 
+    # Switch to binary frames if the minion supports the same format
+    if (defined($hGreeting->{frame}) && $hGreeting->{frame} eq PROTOCOL_FRAME_BINARY)
+    {
+        $self->cmdExecute(OP_FRAME, [PROTOCOL_FRAME_BINARY], false);
+        $self->{bFrame} = true;
+    }
+
     # Perform noop to catch errors early
     $self->noOp();
 }
 
 ####################################################################################################################################
-# outputRead
+# outputReceive
 #
-# Read output from the remote process.
+# Read the next output message from the remote process.
 ####################################################################################################################################
-sub outputRead
+sub outputReceive
 {
     my $self = shift;
 
-    # Assign function parameters, defaults, and log debug info
-    my
-    (
-        $strOperation,
-        $bOutputRequired,
-        $bSuppressLog,
-        $bWarnOnError,
-        $bRef,
-    ) =
-        logDebugParam
-        (
-            __PACKAGE__ . '->outputRead', \@_,
-            {name => 'bOutputRequired', default => false, trace => true},
-            {name => 'bSuppressLog', required => false, trace => true},
-            {name => 'bWarnOnError', default => false, trace => true},
-            {name => 'bRef', default => false, trace => true},
-        );
+    if ($self->{bFrame})
+    {
+        return protocolMessageRead($self->io(), PROTOCOL_FRAME_TYPE_OUTPUT, \$self->{lOutputSize});
+    }
 
     my $strProtocolResult = $self->io()->readLine();
+    $self->{lOutputSize} = length($strProtocolResult) + 1;
 
     logDebugMisc
     (
-        $strOperation, undef,
+        __PACKAGE__ . '->outputReceive', undef,
         {name => 'strProtocolResult', value => $strProtocolResult, trace => true}
     );
 
-    my $hResult = $self->{oJSON}->decode($strProtocolResult);
+    return $self->{oJSON}->decode($strProtocolResult);
+}
+
+####################################################################################################################################
+# outputResult
+#
+# Raise errors returned by the remote process and check that output is defined when required.
+####################################################################################################################################
+sub outputResult
+{
+    my $self = shift;
+    my $hResult = shift;
+    my $bOutputRequired = shift;
+    my $bSuppressLog = shift;
+    my $bWarnOnError = shift;
 
     # Raise any errors
     if (defined($hResult->{err}))
@@ -188,18 +222,148 @@ sub outputRead
         confess &log(ERROR, "$self->{strErrorPrefix}: output is not defined", ERROR_PROTOCOL_OUTPUT_REQUIRED);
     }
 
+    return $hResult->{out};
+}
+
+####################################################################################################################################
+# outputRead
+#
+# Read output from the remote process.
+####################################################################################################################################
+sub outputRead
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $bOutputRequired,
+        $bSuppressLog,
+        $bWarnOnError,
+        $bRef,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->outputRead', \@_,
+            {name => 'bOutputRequired', default => false, trace => true},
+            {name => 'bSuppressLog', required => false, trace => true},
+            {name => 'bWarnOnError', default => false, trace => true},
+            {name => 'bRef', default => false, trace => true},
+        );
+
+    my $hResult = $self->outputReceive();
+
+    if (defined($self->{hCommandWrite}))
+    {
+        $self->statsAdd(delete($self->{hCommandWrite}));
+    }
+
+    my $xOutput = $self->outputResult($hResult, $bOutputRequired, $bSuppressLog, $bWarnOnError);
+
     # Return from function and log return values if any
     return logDebugReturn
     (
         $strOperation,
-        {name => 'hOutput', value => $hResult->{out}, ref => $bRef, trace => true}
+        {name => 'hOutput', value => $xOutput, ref => $bRef, trace => true}
     );
 }
 
+####################################################################################################################################
+# outputPendingReceive
+#
+# Receive output for the next submitted command and store it until the result is requested.  The minion returns output in the order
+# commands were submitted but it is matched by id so that is not required.
+####################################################################################################################################
+sub outputPendingReceive
+{
+    my $self = shift;
+
+    my $hResult = $self->outputReceive();
+    my $hCommand = defined($hResult->{id}) ? delete($self->{hCommandPending}{$hResult->{id}}) : undef;
+
+    if (!defined($hCommand))
+    {
+        confess &log(ERROR,
+            "$self->{strErrorPrefix}: output received for unknown command id " .
+                (defined($hResult->{id}) ? $hResult->{id} : '[undef]'),
+            ERROR_PROTOCOL);
+    }
+
+    $self->statsAdd($hCommand);
+    $self->{hCommandOutput}{$hResult->{id}} = $hResult;
+}
+
+####################################################################################################################################
+# statsAdd
+#
+# Record stats for a command once its output has been received.  Stats requests are not recorded since they are not part of the
+# work being measured.
+####################################################################################################################################
+sub statsAdd
+{
+    my $self = shift;
+    my $hCommand = shift;
+
+    if ($hCommand->{strCommand} ne OP_STATS)
+    {
+        protocolStatsAdd(
+            $self->{strName}, $hCommand->{strCommand}, PROTOCOL_STATS_MASTER, gettimeofday() - $hCommand->{fTime},
+            $hCommand->{lSize}, $self->{lOutputSize});
+    }
+}
+
+####################################################################################################################################
+# cmdSend
+#
+# Write a command to the remote process, with an id if the output will be matched to the command.  Returns the command so stats
+# can be recorded when the output is received.
+####################################################################################################################################
+sub cmdSend
+{
+    my $self = shift;
+    my $strCommand = shift;
+    my $hParam = shift;
+    my $iCommandId = shift;
+
+    my $hCommand = {cmd => $strCommand, param => $hParam};
+    my $fTime = gettimeofday();
+    my $lSize;
+
+    if (defined($iCommandId))
+    {
+        $hCommand->{id} = $iCommandId;
+    }
+
+    # Write out the command
+    if ($self->{bFrame})
+    {
+        $lSize = protocolMessageWrite($self->io(), PROTOCOL_FRAME_TYPE_COMMAND, $hCommand);
+    }
+    else
+    {
+        my $strProtocolCommand = $self->{oJSON}->encode($hCommand);
+
+        logDebugMisc
+        (
+            __PACKAGE__ . '->cmdSend', undef,
+            {name => 'strProtocolCommand', value => $strProtocolCommand, trace => true}
+        );
+
+        $self->io()->writeLine($strProtocolCommand);
+        $lSize = length($strProtocolCommand) + 1;
+    }
+
+    # Reset the keep alive time
+    $self->{fKeepAliveTime} = gettimeofday();
+
+    return {strCommand => $strCommand, fTime => $fTime, lSize => $lSize};
+}
+
 ####################################################################################################################################
 # cmdWrite
 #
-# Send command to remote process.
+# Send command to remote process.  Output must be read with outputRead().
 ####################################################################################################################################
 sub cmdWrite
 {
@@ -219,22 +383,104 @@ sub cmdWrite
             {name => 'hParam', required => false, trace => true},
         );
 
-    my $strProtocolCommand = $self->{oJSON}->encode({cmd => $strCommand, param => $hParam});
+    # Receive output for submitted commands first so it will not be read as output for this command
+    while (keys(%{$self->{hCommandPending}}) > 0)
+    {
+        $self->outputPendingReceive();
+    }
+
+    $self->{hCommandWrite} = $self->cmdSend($strCommand, $hParam);
 
-    logDebugMisc
+    # Return from function and log return values if any
+    logDebugReturn($strOperation);
+}
+
+####################################################################################################################################
+# cmdSubmit
+#
+# Send command to remote process without waiting for output and return an id that can be passed to cmdResult() to get the output.
+# Any number of commands can be submitted before their results are requested, which saves a round trip for each command when they
+# do not depend on each other.  Commands that stream data (e.g. openRead/openWrite) must not be submitted while others are pending.
+####################################################################################################################################
+sub cmdSubmit
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $strCommand,
+        $hParam,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->cmdSubmit', \@_,
+            {name => 'strCommand', trace => true},
+            {name => 'hParam', required => false, trace => true},
+        );
+
+    # Receive output when too many commands are pending
+    while (keys(%{$self->{hCommandPending}}) >= PROTOCOL_COMMAND_PENDING_MAX)
+    {
+        $self->outputPendingReceive();
+    }
+
+    my $iCommandId = ++$self->{iCommandId};
+
+    $self->{hCommandPending}{$iCommandId} = $self->cmdSend($strCommand, $hParam, $iCommandId);
+
+    # Return from function and log return values if any
+    return logDebugReturn
     (
-        $strOperation, undef,
-        {name => 'strProtocolCommand', value => $strProtocolCommand, trace => true}
+        $strOperation,
+        {name => 'iCommandId', value => $iCommandId, trace => true}
     );
+}
 
-    # Write out the command
-    $self->io()->writeLine($strProtocolCommand);
+####################################################################################################################################
+# cmdResult
+#
+# Get output for a submitted command, waiting for it if required.  Errors are raised here rather than when the command is submitted.
+####################################################################################################################################
+sub cmdResult
+{
+    my $self = shift;
 
-    # Reset the keep alive time
-    $self->{fKeepAliveTime} = gettimeofday();
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $iCommandId,
+        $bOutputRequired,
+        $bWarnOnError,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->cmdResult', \@_,
+            {name => 'iCommandId', trace => true},
+            {name => 'bOutputRequired', default => false, trace => true},
+            {name => 'bWarnOnError', default => false, trace => true},
+        );
+
+    if (!$self->{hCommandPending}{$iCommandId} && !defined($self->{hCommandOutput}{$iCommandId}))
+    {
+        confess &log(ASSERT, "command id ${iCommandId} has not been submitted or the result has already been read");
+    }
+
+    while (!defined($self->{hCommandOutput}{$iCommandId}))
+    {
+        $self->outputPendingReceive();
+    }
+
+    my $xOutput = $self->outputResult(delete($self->{hCommandOutput}{$iCommandId}), $bOutputRequired, undef, $bWarnOnError);
 
     # Return from function and log return values if any
-    logDebugReturn($strOperation);
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'hOutput', value => $xOutput, trace => true}
+    );
 }
 
 ####################################################################################################################################
@@ -250,9 +496,7 @@ sub cmdExecute
     my $bOutputRequired = shift;
     my $bWarnOnError = shift;
 
-    $self->cmdWrite($strCommand, $oParamRef);
-
-    return $self->outputRead($bOutputRequired, undef, $bWarnOnError);
+    return $self->cmdResult($self->cmdSubmit($strCommand, $oParamRef), $bOutputRequired, $bWarnOnError);
 }
 
 ####################################################################################################################################
@@ -286,10 +530,29 @@ sub noOp
     $self->{fKeepAliveTime} = gettimeofday();
 }
 
+####################################################################################################################################
+# statsCollect
+#
+# Merge stats from the minion into the stats for this process.  Stats are only collected once since the minion returns all the
+# stats it has recorded.
+####################################################################################################################################
+sub statsCollect
+{
+    my $self = shift;
+
+    if (!$self->{bStatsCollected})
+    {
+        protocolStatsMerge($self->cmdExecute(OP_STATS, undef, true));
+        $self->{bStatsCollected} = true;
+    }
+}
+
 ####################################################################################################################################
 # Getters
 ####################################################################################################################################
+sub frame {shift->{bFrame}}
 sub io {shift->{oIo}}
 sub master {true}
+sub name {shift->{strName}}
 
 1;
@@ -11,13 +11,16 @@ use English '-no_match_vars';
 use Exporter qw(import);
     our @EXPORT = qw();
 use JSON::PP;
+use Time::HiRes qw(gettimeofday);
 
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Ini;
 use pgBackRest::Common::Lock;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::String;
+use pgBackRest::Protocol::Base::Frame;
 use pgBackRest::Protocol::Base::Master;
+use pgBackRest::Protocol::Base::Stats;
 use pgBackRest::Protocol::Helper;
 use pgBackRest::Version;
 
@@ -54,6 +57,13 @@ sub new
     # Create JSON object
     $self->{oJSON} = JSON::PP->new()->allow_nonref();
 
+    # JSON lines are used until the master requests binary frames
+    $self->{bFrame} = false;
+
+    # Size of the last command read and output written (for stats)
+    $self->{lCommandSize} = 0;
+    $self->{lOutputSize} = 0;
+
     # Write the greeting so master process knows who we are
     $self->greetingWrite();
 
@@ -71,7 +81,8 @@ sub new
 ####################################################################################################################################
 # greetingWrite
 #
-# Send a greeting to the master process.
+# Send a greeting to the master process.  The greeting includes the binary frame format supported by the minion so the master can
+# request it.
 ####################################################################################################################################
 sub greetingWrite
 {
@@ -79,7 +90,7 @@ sub greetingWrite
 
     # Write the greeting
     $self->io()->writeLine((JSON::PP->new()->canonical()->allow_nonref())->encode(
-        {name => BACKREST_NAME, service => $self->{strName}, version => BACKREST_VERSION}));
+        {frame => PROTOCOL_FRAME_BINARY, name => BACKREST_NAME, service => $self->{strName}, version => BACKREST_VERSION}));
 }
 
 ####################################################################################################################################
@@ -99,7 +110,7 @@ sub errorWrite
     }
 
     # Write error code and message
-    $self->io()->writeLine($self->{oJSON}->encode({err => $oException->code(), out => $oException->message()}));
+    $self->messageWrite({err => $oException->code(), out => $oException->message()});
 }
 
 ####################################################################################################################################
@@ -111,7 +122,36 @@ sub outputWrite
 {
     my $self = shift;
 
-    $self->io()->writeLine($self->{oJSON}->encode({out => \@_}));
+    $self->messageWrite({out => \@_});
+}
+
+####################################################################################################################################
+# messageWrite
+#
+# Write an output or error message.  The id of the current command is included when the master sent one so that the master can
+# match output to commands it submitted without waiting.
+####################################################################################################################################
+sub messageWrite
+{
+    my $self = shift;
+    my $hMessage = shift;
+
+    if (defined($self->{iCommandId}))
+    {
+        $hMessage->{id} = $self->{iCommandId};
+    }
+
+    if ($self->{bFrame})
+    {
+        $self->{lOutputSize} = protocolMessageWrite($self->io(), PROTOCOL_FRAME_TYPE_OUTPUT, $hMessage);
+    }
+    else
+    {
+        my $strMessage = $self->{oJSON}->encode($hMessage);
+
+        $self->io()->writeLine($strMessage);
+        $self->{lOutputSize} = length($strMessage) + 1;
+    }
 }
 
 ####################################################################################################################################
@@ -123,7 +163,22 @@ sub cmdRead
 {
     my $self = shift;
 
-    my $hCommand = $self->{oJSON}->decode($self->io()->readLine());
+    my $hCommand;
+
+    if ($self->{bFrame})
+    {
+        $hCommand = protocolMessageRead($self->io(), PROTOCOL_FRAME_TYPE_COMMAND, \$self->{lCommandSize});
+    }
+    else
+    {
+        my $strCommand = $self->io()->readLine();
+
+        $hCommand = $self->{oJSON}->decode($strCommand);
+        $self->{lCommandSize} = length($strCommand) + 1;
+    }
+
+    # Store the command id so it can be returned with the output
+    $self->{iCommandId} = $hCommand->{id};
 
     return $hCommand->{cmd}, $hCommand->{param};
 }
@@ -164,6 +219,7 @@ sub process
         while (true)
         {
             my ($strCommand, $rParam) = $self->cmdRead();
+            my $fTime = gettimeofday();
 
             last if ($strCommand eq OP_EXIT);
 
@@ -188,6 +244,25 @@ sub process
                         protocolKeepAlive();
                         $self->outputWrite();
                     }
+                    # Return stats for this process, including stats collected from the minions it is connected to
+                    elsif ($strCommand eq OP_STATS)
+                    {
+                        protocolStatsCollect();
+                        $self->outputWrite(protocolStatsGet());
+                    }
+                    # Switch to binary frames after acknowledging the request in the current format
+                    elsif ($strCommand eq OP_FRAME)
+                    {
+                        if (!defined($rParam->[0]) || $rParam->[0] ne PROTOCOL_FRAME_BINARY)
+                        {
+                            confess &log(
+                                ERROR, 'unsupported protocol frame format ' .
+                                    (defined($rParam->[0]) ? "'$rParam->[0]'" : '[undef]'), ERROR_PROTOCOL);
+                        }
+
+                        $self->outputWrite();
+                        $self->{bFrame} = true;
+                    }
                     else
                     {
                         confess "invalid command: ${strCommand}";
@@ -207,6 +282,13 @@ sub process
                     $self->errorWrite($EVAL_ERROR);
                 };
             }
+
+            if ($strCommand ne OP_STATS)
+            {
+                protocolStatsAdd(
+                    $self->{strName}, $strCommand, PROTOCOL_STATS_MINION, gettimeofday() - $fTime, $self->{lOutputSize},
+                    $self->{lCommandSize});
+            }
         }
 
         return true;
@@ -234,7 +316,9 @@ sub process
 ####################################################################################################################################
 # Getters
 ####################################################################################################################################
+sub frame {shift->{bFrame}}
 sub io {shift->{oIo}}
 sub master {false}
+sub name {shift->{strName}}
 
 1;
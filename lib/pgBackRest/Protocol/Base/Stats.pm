@@ -0,0 +1,253 @@
+####################################################################################################################################
+# Protocol Statistics
+#
+# Count, bytes, and latency for each protocol command.  The master records the time from sending a command until its output is
+# received, which includes the time spent in ssh, encoding, and waiting for the minion.  The minion records the time spent running
+# the command.  Comparing the two shows where the time goes.  Data blocks streamed by storage commands are recorded as the block
+# command.
+#
+# Latency is recorded in histogram buckets that double in size starting at PROTOCOL_STATS_BUCKET_MIN seconds so the percentiles can
+# be estimated without keeping every sample.
+####################################################################################################################################
+package pgBackRest::Protocol::Base::Stats;
+
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+
+use Exporter qw(import);
+    our @EXPORT = qw();
+
+use pgBackRest::Common::Log;
+
+####################################################################################################################################
+# Side of the protocol where the stats were recorded
+####################################################################################################################################
+use constant PROTOCOL_STATS_MASTER                                  => 'master';
+    push @EXPORT, qw(PROTOCOL_STATS_MASTER);
+use constant PROTOCOL_STATS_MINION                                  => 'minion';
+    push @EXPORT, qw(PROTOCOL_STATS_MINION);
+
+####################################################################################################################################
+# Command used to record data blocks
+####################################################################################################################################
+use constant PROTOCOL_STATS_BLOCK                                   => 'block';
+    push @EXPORT, qw(PROTOCOL_STATS_BLOCK);
+
+####################################################################################################################################
+# Upper bound of the first latency bucket (in seconds)
+####################################################################################################################################
+use constant PROTOCOL_STATS_BUCKET_MIN                              => .0001;
+
+####################################################################################################################################
+# Stats for this process stored by service, command, and side
+####################################################################################################################################
+my $hStats = {};
+my $bStatsEnabled = false;
+
+####################################################################################################################################
+# protocolStatsAdd
+#
+# Record a command.  Nothing is recorded unless stats are enabled.
+####################################################################################################################################
+sub protocolStatsAdd
+{
+    my $strService = shift;
+    my $strCommand = shift;
+    my $strSide = shift;
+    my $fTime = shift;
+    my $lBytesOut = shift;
+    my $lBytesIn = shift;
+
+    return if (!$bStatsEnabled);
+
+    my $hCommand = $hStats->{$strService}{$strCommand}{$strSide};
+
+    if (!defined($hCommand))
+    {
+        $hCommand = {iCount => 0, lBytesOut => 0, lBytesIn => 0, fTime => 0, fTimeMax => 0, iyBucket => []};
+        $hStats->{$strService}{$strCommand}{$strSide} = $hCommand;
+    }
+
+    # Find the bucket for the latency
+    my $iBucket = 0;
+
+    for (my $fBucketMax = PROTOCOL_STATS_BUCKET_MIN; $fTime > $fBucketMax; $fBucketMax *= 2)
+    {
+        $iBucket++;
+    }
+
+    $hCommand->{iCount}++;
+    $hCommand->{lBytesOut} += $lBytesOut;
+    $hCommand->{lBytesIn} += $lBytesIn;
+    $hCommand->{fTime} += $fTime;
+    $hCommand->{fTimeMax} = $fTime if ($fTime > $hCommand->{fTimeMax});
+    $hCommand->{iyBucket}[$iBucket]++;
+}
+
+push @EXPORT, qw(protocolStatsAdd);
+
+####################################################################################################################################
+# protocolStatsMerge
+#
+# Merge stats returned by a minion into the stats for this process.
+####################################################################################################################################
+sub protocolStatsMerge
+{
+    my $hStatsMerge = shift;
+
+    foreach my $strService (keys(%{$hStatsMerge}))
+    {
+        foreach my $strCommand (keys(%{$hStatsMerge->{$strService}}))
+        {
+            foreach my $strSide (keys(%{$hStatsMerge->{$strService}{$strCommand}}))
+            {
+                my $hCommandMerge = $hStatsMerge->{$strService}{$strCommand}{$strSide};
+                my $hCommand = $hStats->{$strService}{$strCommand}{$strSide};
+
+                if (!defined($hCommand))
+                {
+                    $hStats->{$strService}{$strCommand}{$strSide} = $hCommandMerge;
+                    next;
+                }
+
+                $hCommand->{$_} += $hCommandMerge->{$_} foreach ('iCount', 'lBytesOut', 'lBytesIn', 'fTime');
+                $hCommand->{fTimeMax} = $hCommandMerge->{fTimeMax} if ($hCommandMerge->{fTimeMax} > $hCommand->{fTimeMax});
+
+                for (my $iBucket = 0; $iBucket < @{$hCommandMerge->{iyBucket}}; $iBucket++)
+                {
+                    next if (!defined($hCommandMerge->{iyBucket}[$iBucket]));
+
+                    $hCommand->{iyBucket}[$iBucket] += $hCommandMerge->{iyBucket}[$iBucket];
+                }
+            }
+        }
+    }
+}
+
+push @EXPORT, qw(protocolStatsMerge);
+
+####################################################################################################################################
+# protocolStatsPercentile
+#
+# Estimate a latency percentile as the upper bound of the bucket that contains it.
+####################################################################################################################################
+sub protocolStatsPercentile
+{
+    my $hCommand = shift;
+    my $fPercentile = shift;
+
+    my $iCount = 0;
+    my $fBucketMax = PROTOCOL_STATS_BUCKET_MIN;
+
+    for (my $iBucket = 0; $iBucket < @{$hCommand->{iyBucket}}; $iBucket++, $fBucketMax *= 2)
+    {
+        $iCount += defined($hCommand->{iyBucket}[$iBucket]) ? $hCommand->{iyBucket}[$iBucket] : 0;
+
+        last if ($iCount >= $hCommand->{iCount} * $fPercentile);
+    }
+
+    # The max is a better estimate than the bucket bound when it is lower
+    return $fBucketMax < $hCommand->{fTimeMax} ? $fBucketMax : $hCommand->{fTimeMax};
+}
+
+####################################################################################################################################
+# protocolStatsReport
+#
+# Return the stats in a machine-readable form with the percentiles calculated.
+####################################################################################################################################
+sub protocolStatsReport
+{
+    my $hReport = {};
+
+    foreach my $strService (keys(%{$hStats}))
+    {
+        foreach my $strCommand (keys(%{$hStats->{$strService}}))
+        {
+            foreach my $strSide (keys(%{$hStats->{$strService}{$strCommand}}))
+            {
+                my $hCommand = $hStats->{$strService}{$strCommand}{$strSide};
+                my $fBucketMax = PROTOCOL_STATS_BUCKET_MIN;
+
+                $hReport->{$strService}{$strCommand}{$strSide} =
+                {
+                    count => $hCommand->{iCount},
+                    bytesOut => $hCommand->{lBytesOut},
+                    bytesIn => $hCommand->{lBytesIn},
+                    time => $hCommand->{fTime},
+                    timeMax => $hCommand->{fTimeMax},
+                    timeP50 => protocolStatsPercentile($hCommand, .5),
+                    timeP90 => protocolStatsPercentile($hCommand, .9),
+                    timeP99 => protocolStatsPercentile($hCommand, .99),
+                    histogram =>
+                        {map {my $fMax = $fBucketMax; $fBucketMax *= 2; defined($_) ? ($fMax => $_) : ()}
+                            @{$hCommand->{iyBucket}}},
+                };
+            }
+        }
+    }
+
+    return $hReport;
+}
+
+push @EXPORT, qw(protocolStatsReport);
+
+####################################################################################################################################
+# protocolStatsLog
+#
+# Log a summary line for each command.
+####################################################################################################################################
+sub protocolStatsLog
+{
+    my $hReport = protocolStatsReport();
+
+    foreach my $strService (sort(keys(%{$hReport})))
+    {
+        foreach my $strCommand (sort(keys(%{$hReport->{$strService}})))
+        {
+            foreach my $strSide (sort(keys(%{$hReport->{$strService}{$strCommand}})))
+            {
+                my $hCommand = $hReport->{$strService}{$strCommand}{$strSide};
+
+                &log(DETAIL,
+                    "protocol ${strService} ${strCommand} (${strSide}): $hCommand->{count} calls, " .
+                    "$hCommand->{bytesOut}B out, $hCommand->{bytesIn}B in, " .
+                    sprintf(
+                        'avg %.2fms, p50 %.2fms, p90 %.2fms, p99 %.2fms, max %.2fms',
+                        $hCommand->{time} / $hCommand->{count} * 1000, $hCommand->{timeP50} * 1000,
+                        $hCommand->{timeP90} * 1000, $hCommand->{timeP99} * 1000, $hCommand->{timeMax} * 1000));
+            }
+        }
+    }
+}
+
+push @EXPORT, qw(protocolStatsLog);
+
+####################################################################################################################################
+# protocolStatsGet - get stats for this process so they can be returned to the master
+####################################################################################################################################
+sub protocolStatsGet
+{
+    return $hStats;
+}
+
+push @EXPORT, qw(protocolStatsGet);
+
+####################################################################################################################################
+# protocolStatsEnable/protocolStatsEnabled - should stats be recorded and collected from minions when they are closed?
+####################################################################################################################################
+sub protocolStatsEnable
+{
+    $bStatsEnabled = true;
+}
+
+push @EXPORT, qw(protocolStatsEnable);
+
+sub protocolStatsEnabled
+{
+    return $bStatsEnabled;
+}
+
+push @EXPORT, qw(protocolStatsEnabled);
+
+1;
@@ -17,6 +17,7 @@ use pgBackRest::Common::Ini;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::Io::Process;
 use pgBackRest::Protocol::Base::Master;
+use pgBackRest::Protocol::Base::Stats;
 use pgBackRest::Version;
 
 ####################################################################################################################################
@@ -103,6 +104,12 @@ sub close
 
         eval
         {
+            # Collect stats from the minion before it exits
+            if (protocolStatsEnabled())
+            {
+                $self->statsCollect();
+            }
+
             $self->cmdWrite(OP_EXIT);
             return true;
         }
@@ -21,6 +21,8 @@ use pgBackRest::Version;
 # Backup module
 use constant OP_BACKUP_FILE                                          => 'backupFile';
     push @EXPORT, qw(OP_BACKUP_FILE);
+use constant OP_BACKUP_FILE_ASSEMBLE                                 => 'backupFileAssemble';
+    push @EXPORT, qw(OP_BACKUP_FILE_ASSEMBLE);
 
 # Archive Module
 use constant OP_ARCHIVE_GET_ARCHIVE_ID                              => 'archiveId';
@@ -29,14 +31,24 @@ use constant OP_ARCHIVE_GET_CHECK                                   => 'archiveC
     push @EXPORT, qw(OP_ARCHIVE_GET_CHECK);
 use constant OP_ARCHIVE_PUSH_CHECK                                  => 'archivePushCheck';
     push @EXPORT, qw(OP_ARCHIVE_PUSH_CHECK);
+use constant OP_ARCHIVE_PATH_LIST                                   => 'archivePathList';
+    push @EXPORT, qw(OP_ARCHIVE_PATH_LIST);
 
 # Archive Push Async Module
 use constant OP_ARCHIVE_PUSH_ASYNC                                  => 'archivePushAsync';
     push @EXPORT, qw(OP_ARCHIVE_PUSH_ASYNC);
 
 # Archive File Module
+use constant OP_ARCHIVE_GET_FILE                                    => 'archiveGetFile';
+    push @EXPORT, qw(OP_ARCHIVE_GET_FILE);
 use constant OP_ARCHIVE_PUSH_FILE                                   => 'archivePushFile';
     push @EXPORT, qw(OP_ARCHIVE_PUSH_FILE);
+use constant OP_ARCHIVE_PUSH_FILE_GROUP                             => 'archivePushFileGroup';
+    push @EXPORT, qw(OP_ARCHIVE_PUSH_FILE_GROUP);
+
+# Local Process Module
+use constant OP_LOCAL_BATCH                                         => 'localBatch';
+    push @EXPORT, qw(OP_LOCAL_BATCH);
 
 # Check Module
 use constant OP_CHECK_BACKUP_INFO_CHECK                             => 'backupInfoCheck';
@@ -65,6 +77,8 @@ use constant OP_STORAGE_MOVE                                        => 'storageM
     push @EXPORT, qw(OP_STORAGE_MOVE);
 use constant OP_STORAGE_PATH_GET                                    => 'storagePathGet';
     push @EXPORT, qw(OP_STORAGE_PATH_GET);
+use constant OP_STORAGE_REMOVE                                      => 'storageRemove';
+    push @EXPORT, qw(OP_STORAGE_REMOVE);
 
 # Info module
 use constant OP_INFO_STANZA_LIST                                    => 'infoStanzList';
@@ -443,4 +457,23 @@ sub protocolKeepAlive
 
 push @EXPORT, qw(protocolKeepAlive);
 
+####################################################################################################################################
+# protocolStatsCollect - collect stats from the minions of all protocols
+####################################################################################################################################
+sub protocolStatsCollect
+{
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '::protocolStatsCollect');
+
+    foreach my $rhProtocol (protocolList())
+    {
+        $hProtocol->{$rhProtocol->{strRemoteType}}{$rhProtocol->{iRemoteIdx}}->statsCollect();
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+push @EXPORT, qw(protocolStatsCollect);
+
 1;
@@ -8,6 +8,8 @@ use strict;
 use warnings FATAL => qw(all);
 use Carp qw(confess);
 
+use pgBackRest::Archive::Common;
+use pgBackRest::Archive::Get::File;
 use pgBackRest::Archive::Push::File;
 use pgBackRest::Backup::File;
 use pgBackRest::Common::Log;
@@ -17,6 +19,7 @@ use pgBackRest::Protocol::Base::Master;
 use pgBackRest::Protocol::Base::Minion;
 use pgBackRest::Protocol::Command::Minion;
 use pgBackRest::Protocol::Helper;
+use pgBackRest::Protocol::Storage::Helper;
 use pgBackRest::RestoreFile;
 
 ####################################################################################################################################
@@ -54,9 +57,17 @@ sub init
     # Create anonymous subs for each command
     my $hCommandMap =
     {
+        &OP_ARCHIVE_GET_FILE => sub {archiveGetFile(@{shift()})},
+        &OP_ARCHIVE_PATH_LIST => sub {walPathList(storageRepo(), @{shift()})},
         &OP_ARCHIVE_PUSH_FILE => sub {archivePushFile(@{shift()})},
+        &OP_ARCHIVE_PUSH_FILE_GROUP => sub {archivePushFileGroup(@{shift()})},
         &OP_BACKUP_FILE => sub {backupFile(@{shift()})},
+        &OP_BACKUP_FILE_ASSEMBLE => sub {backupFileAssemble(@{shift()})},
         &OP_RESTORE_FILE => sub {restoreFile(@{shift()})},
+        &OP_STORAGE_REMOVE => sub {storageRepo()->remove(@{shift()})},
+
+        # Run a batch of commands and return the results of each in a list
+        &OP_LOCAL_BATCH => sub {[map {[$self->{hCommandMap}{$_->[0]}->($_->[1])]} @{shift()}]},
 
         # To be run after each command to keep the remote alive
         &OP_POST => sub {protocolKeepAlive()},
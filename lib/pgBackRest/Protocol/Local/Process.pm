@@ -11,13 +11,26 @@ use Carp qw(confess);
 use English '-no_match_vars';
 
 use IO::Select;
+use Time::HiRes qw(gettimeofday);
 
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Log;
 use pgBackRest::Config::Config;
+use pgBackRest::Protocol::Helper;
 use pgBackRest::Protocol::Local::Master;
 use pgBackRest::Version;
 
+####################################################################################################################################
+# Maximum number of jobs that can be sent to a local process in a single batch
+####################################################################################################################################
+use constant PROCESS_BATCH_MAX                                      => 64;
+
+####################################################################################################################################
+# Seconds between throughput checks in auto mode and the minimum improvement needed to keep adding processes
+####################################################################################################################################
+use constant PROCESS_AUTO_INTERVAL                                  => 5;
+use constant PROCESS_AUTO_GAIN_MIN                                  => .1;
+
 ####################################################################################################################################
 # CONSTRUCTOR
 ####################################################################################################################################
@@ -35,6 +48,7 @@ sub new
         $self->{iSelectTimeout},
         $self->{strBackRestBin},
         $self->{bConfessError},
+        $self->{bPersist},
     ) =
         logDebugParam
         (
@@ -43,12 +57,20 @@ sub new
             {name => 'iSelectTimeout', default => int(cfgOption(CFGOPT_PROTOCOL_TIMEOUT) / 2)},
             {name => 'strBackRestBin', default => BACKREST_BIN},
             {name => 'bConfessError', default => true},
+            {name => 'bPersist', default => false, trace => true},
         );
 
     # Declare host map and array
     $self->{hHostMap} = {};
     $self->{hyHost} = undef;
 
+    # When persist is set local processes are kept in a pool when they run out of jobs so they can be reused by the next run rather
+    # than starting new processes.  The pool is keyed by process id.
+    $self->{hLocalPool} = {};
+
+    # Busy and idle time for each local process in the last run
+    $self->{hyProcessTime} = [];
+
     # Reset module variables to get ready for queueing
     $self->reset();
 
@@ -95,7 +117,17 @@ sub reset
 ####################################################################################################################################
 # hostAdd
 #
-# Add a host where jobs can be executed.
+# Add a host where jobs can be executed.  If a device max is set then no more than that many jobs will read from the same device at
+# once.
+#
+# If process auto is set then processing starts with a single local process and more are added up to the process max while
+# throughput keeps improving (see processAuto()).  Process auto is a hash that may contain:
+#
+# fLoadMax - remove local processes when the load returned by fnLoad exceeds this value
+# fnLoad - function that returns the current load of the host
+# fInterval - seconds between throughput checks (defaults to PROCESS_AUTO_INTERVAL)
+# fnRead - function that returns the bytes read by a system process id (defaults to processRead())
+# fnTime - function that returns the current time in seconds (defaults to gettimeofday())
 ####################################################################################################################################
 sub hostAdd
 {
@@ -107,12 +139,16 @@ sub hostAdd
         $strOperation,
         $iHostConfigIdx,
         $iProcessMax,
+        $iDeviceMax,
+        $rhProcessAuto,
     ) =
         logDebugParam
         (
             __PACKAGE__ . '->hostAdd', \@_,
             {name => 'iHostConfigIdx'},
             {name => 'iProcessMax'},
+            {name => 'iDeviceMax', required => false, trace => true},
+            {name => 'rhProcessAuto', required => false, trace => true},
         );
 
     my $iHostIdx = $self->{hHostMap}{$iHostConfigIdx};
@@ -127,6 +163,8 @@ sub hostAdd
     {
         iHostConfigIdx => $iHostConfigIdx,
         iProcessMax => $iProcessMax,
+        iDeviceMax => $iDeviceMax,
+        rhProcessAuto => $rhProcessAuto,
     };
 
     push(@{$self->{hyHost}}, $hHost);
@@ -165,47 +203,27 @@ sub hostConnect
             next;
         }
 
-        for (my $iHostProcessIdx = 0; $iHostProcessIdx < $hHost->{iProcessMax}; $iHostProcessIdx++)
-        {
-            my $iLocalIdx = defined($self->{hyLocal}) ? @{$self->{hyLocal}} : 0;
-            my $iProcessId = $iLocalIdx + 1;
-
-            logDebugMisc(
-                $strOperation, 'start local process',
-                {name => 'strHostType', value => $self->{strHostType}},
-                {name => 'iHostProcessIdx', value => $iHostProcessIdx},
-                {name => 'iHostConfigIdx', value => $hHost->{iHostConfigIdx}},
-                {name => 'iHostIdx', value => $iHostIdx},
-                {name => 'iProcessId', value => $iProcessId});
-
-            my $oLocal = new pgBackRest::Protocol::Local::Master
-            (
-                cfgCommandWrite(
-                    CFGCMD_LOCAL, true, $self->{strBackRestBin}, undef,
-                    {
-                        &CFGOPT_COMMAND => {value => cfgCommandName(cfgCommandGet())},
-                        &CFGOPT_PROCESS => {value => $iProcessId},
-                        &CFGOPT_TYPE => {value => $self->{strHostType}},
-                        &CFGOPT_HOST_ID => {value => $hHost->{iHostConfigIdx}},
-
-                        &CFGOPT_LOG_LEVEL_STDERR => {},
-                    }),
-                $iLocalIdx + 1
-            );
-
-            my $hLocal =
-            {
-                iHostIdx => $iHostIdx,
-                iProcessId => $iProcessId,
-                iHostProcessIdx => $iHostProcessIdx,
-                oLocal => $oLocal,
-                hndIn => fileno($oLocal->io()->handleRead()),
-            };
+        # In auto mode start with a single local process and add more while throughput improves
+        $hHost->{iHostIdx} = $iHostIdx;
+        $hHost->{iProcessTarget} = defined($hHost->{rhProcessAuto}) ? 1 : $hHost->{iProcessMax};
+        $hHost->{iProcessTotal} = 0;
+        $hHost->{iProcessStarted} = 0;
 
-            push(@{$self->{hyLocal}}, $hLocal);
+        # Bytes read since the last auto check and the throughput measured with the current number of processes.  The bytes read by
+        # the local processes are used when available since jobs may run longer than the interval, otherwise the size of completed
+        # jobs is used.  This must be set before local processes are started so they can record the bytes they have already read.
+        if (defined($hHost->{rhProcessAuto}))
+        {
+            $hHost->{fAutoTime} = $self->processAutoTime($hHost);
+            $hHost->{lAutoSize} = 0;
+            $hHost->{fAutoRate} = undef;
+            $hHost->{bAutoGrow} = true;
+            $hHost->{bAutoRead} = true;
+        }
 
-            $self->{hLocalMap}{$hLocal->{hndIn}} = $hLocal;
-            $self->{oSelect}->add($hLocal->{hndIn});
+        while ($hHost->{iProcessTotal} < $hHost->{iProcessTarget})
+        {
+            $self->localStart($strOperation, $hHost);
         }
 
         $iHostIdx++;
@@ -219,6 +237,133 @@ sub hostConnect
     );
 }
 
+####################################################################################################################################
+# localStart
+#
+# Start a local process for a host, or reuse one from the pool.  Debug info is logged under the calling operation.
+####################################################################################################################################
+sub localStart
+{
+    my $self = shift;
+    my $strOperation = shift;
+    my $hHost = shift;
+
+    my $iHostIdx = $hHost->{iHostIdx};
+    my $iHostProcessIdx = $hHost->{iProcessStarted} % $hHost->{iProcessMax};
+
+    # Use the first free slot and the lowest process id not in use.  Local processes are stopped and started again in auto mode so
+    # this keeps process ids from growing past the process max.
+    my $iLocalIdx = 0;
+    my %hProcessIdUsed;
+
+    if (defined($self->{hyLocal}))
+    {
+        %hProcessIdUsed = map {$_->{iProcessId} => true} grep {defined($_)} @{$self->{hyLocal}};
+        $iLocalIdx++ while ($iLocalIdx < @{$self->{hyLocal}} && defined($self->{hyLocal}[$iLocalIdx]));
+    }
+
+    my $iProcessId = 1;
+    $iProcessId++ while ($hProcessIdUsed{$iProcessId});
+
+    # Reuse a pooled local process if there is one for this host and it is still responding
+    my $hLocal = $self->localPoolGet($iProcessId, $iHostIdx);
+
+    if (!defined($hLocal))
+    {
+        logDebugMisc(
+            $strOperation, 'start local process',
+            {name => 'strHostType', value => $self->{strHostType}},
+            {name => 'iHostProcessIdx', value => $iHostProcessIdx},
+            {name => 'iHostConfigIdx', value => $hHost->{iHostConfigIdx}},
+            {name => 'iHostIdx', value => $iHostIdx},
+            {name => 'iProcessId', value => $iProcessId});
+
+        my $oLocal = new pgBackRest::Protocol::Local::Master
+        (
+            cfgCommandWrite(
+                CFGCMD_LOCAL, true, $self->{strBackRestBin}, undef,
+                {
+                    &CFGOPT_COMMAND => {value => cfgCommandName(cfgCommandGet())},
+                    &CFGOPT_PROCESS => {value => $iProcessId},
+                    &CFGOPT_TYPE => {value => $self->{strHostType}},
+                    &CFGOPT_HOST_ID => {value => $hHost->{iHostConfigIdx}},
+
+                    &CFGOPT_LOG_LEVEL_STDERR => {},
+                }),
+            $iProcessId
+        );
+
+        $hLocal =
+        {
+            iHostIdx => $iHostIdx,
+            iProcessId => $iProcessId,
+            iHostProcessIdx => $iHostProcessIdx,
+            oLocal => $oLocal,
+            hndIn => fileno($oLocal->io()->handleRead()),
+        };
+    }
+
+    $hLocal->{fBusyTime} = 0;
+    $hLocal->{fStartTime} = gettimeofday();
+
+    # Record bytes already read by the process so only bytes read from now on are counted in auto mode
+    if (defined($hHost->{rhProcessAuto}) && $hHost->{bAutoRead})
+    {
+        $hLocal->{lAutoRead} = $self->localRead($hHost, $hLocal);
+        $hHost->{bAutoRead} = false if !defined($hLocal->{lAutoRead});
+    }
+
+    $self->{hyLocal}[$iLocalIdx] = $hLocal;
+
+    $self->{hLocalMap}{$hLocal->{hndIn}} = $hLocal;
+    $self->{oSelect}->add($hLocal->{hndIn});
+
+    $hHost->{iProcessTotal}++;
+    $hHost->{iProcessStarted}++;
+
+    return $hLocal;
+}
+
+####################################################################################################################################
+# localInit
+#
+# Set the queue where a local process starts looking for jobs and the direction it moves through the queues.  Debug info is logged
+# under the calling operation.
+####################################################################################################################################
+sub localInit
+{
+    my $self = shift;
+    my $strOperation = shift;
+    my $hLocal = shift;
+
+    my $hHost = $self->{hyHost}[$hLocal->{iHostIdx}];
+    my $hyQueue = $hHost->{hyQueue};
+
+    # Initialize variables to keep track of what job the local is working on
+    $hLocal->{iDirection} = $hLocal->{iHostProcessIdx} % 2 == 0 ? 1 : -1;
+    $hLocal->{iQueueIdx} = int((@{$hyQueue} / $hHost->{iProcessMax}) * $hLocal->{iHostProcessIdx});
+
+    # Calculate the last queue that this process should pull from
+    $hLocal->{iQueueLastIdx} = $hLocal->{iQueueIdx} + ($hLocal->{iDirection} * -1);
+
+    if ($hLocal->{iQueueLastIdx} < 0)
+    {
+        $hLocal->{iQueueLastIdx} = @{$hyQueue} - 1;
+    }
+    elsif ($hLocal->{iQueueLastIdx} >= @{$hyQueue})
+    {
+        $hLocal->{iQueueLastIdx} = 0;
+    }
+
+    logDebugMisc(
+        $strOperation, 'init local process',
+        {name => 'iHostIdx', value => $hLocal->{iHostIdx}},
+        {name => 'iProcessId', value => $hLocal->{iProcessId}},
+        {name => 'iDirection', value => $hLocal->{iDirection}},
+        {name => 'iQueueIdx', value => $hLocal->{iQueueIdx}},
+        {name => 'iQueueLastIdx', value => $hLocal->{iQueueLastIdx}});
+}
+
 ####################################################################################################################################
 # init
 #
@@ -233,37 +378,21 @@ sub init
 
     if ($self->hostConnect())
     {
-        foreach my $hLocal (@{$self->{hyLocal}})
+        foreach my $hHost (@{$self->{hyHost}})
         {
-            my $hHost = $self->{hyHost}[$hLocal->{iHostIdx}];
-            my $hyQueue = $hHost->{hyQueue};
-
-            # Initialize variables to keep track of what job the local is working on
-            $hLocal->{iDirection} = $hLocal->{iHostProcessIdx} % 2 == 0 ? 1 : -1;
-            $hLocal->{iQueueIdx} = int((@{$hyQueue} / $hHost->{iProcessMax}) * $hLocal->{iHostProcessIdx});
-
-            # Calculate the last queue that this process should pull from
-            $hLocal->{iQueueLastIdx} = $hLocal->{iQueueIdx} + ($hLocal->{iDirection} * -1);
-
-            if ($hLocal->{iQueueLastIdx} < 0)
-            {
-                $hLocal->{iQueueLastIdx} = @{$hyQueue} - 1;
-            }
-            elsif ($hLocal->{iQueueLastIdx} >= @{$hyQueue})
-            {
-                $hLocal->{iQueueLastIdx} = 0;
-            }
+            # Jobs running on each device
+            $hHost->{hDeviceRunning} = {};
+        }
 
-            logDebugMisc(
-                $strOperation, 'init local process',
-                {name => 'iHostIdx', value => $hLocal->{iHostIdx}},
-                {name => 'iProcessId', value => $hLocal->{iProcessId}},
-                {name => 'iDirection', value => $hLocal->{iDirection}},
-                {name => 'iQueueIdx', value => $hLocal->{iQueueIdx}},
-                {name => 'iQueueLastIdx', value => $hLocal->{iQueueLastIdx}});
+        foreach my $hLocal (@{$self->{hyLocal}})
+        {
+            $self->localInit($strOperation, $hLocal);
         }
 
         $self->{bProcessing} = true;
+
+        # Track busy and idle time for each local process
+        $self->{hyProcessTime} = [];
     }
 
     # Return from function and log return values if any
@@ -321,12 +450,25 @@ sub process
                 confess &log(ASSERT, "unable to map from fileno ${hndIn} to local");
             }
 
-            # Get the job result
-            my $hJob = $hLocal->{hJob};
+            # Get the job results.  A batch returns a list with the result of each job.
+            my $hyJob = $hLocal->{hyJob};
 
             eval
             {
-                $hJob->{rResult} = $hLocal->{oLocal}->outputRead(true, undef, undef, true);
+                my $rResult = $hLocal->{oLocal}->outputRead(true, undef, undef, true);
+
+                if (@{$hyJob} == 1)
+                {
+                    $hyJob->[0]{rResult} = $rResult;
+                }
+                else
+                {
+                    for (my $iJobIdx = 0; $iJobIdx < @{$hyJob}; $iJobIdx++)
+                    {
+                        $hyJob->[$iJobIdx]{rResult} = $rResult->[0][$iJobIdx];
+                    }
+                }
+
                 return true;
             }
             or do
@@ -347,36 +489,57 @@ sub process
                 {
                     confess logException($oException);
                 }
-                # Else store exception so caller can process it
+                # Else store exception so caller can process it.  The exception applies to every job in a batch.
                 else
                 {
-                    $hJob->{oException} = $oException;
+                    foreach my $hJob (@{$hyJob})
+                    {
+                        $hJob->{oException} = $oException;
+                    }
                 }
             };
 
-            $hJob->{iProcessId} = $hLocal->{iProcessId};
-            push(@hyResult, $hJob);
+            my $hHost = $self->{hyHost}[$hLocal->{iHostIdx}];
 
-            logDebugMisc(
-                $strOperation, 'job complete',
-                {name => 'iProcessId', value => $hJob->{iProcessId}},
-                {name => 'strKey', value => $hJob->{strKey}},
-                {name => 'rResult', value => $hJob->{rResult}});
+            foreach my $hJob (@{$hyJob})
+            {
+                $hJob->{iProcessId} = $hLocal->{iProcessId};
+                push(@hyResult, $hJob);
+
+                # Use the size of completed jobs in auto mode when the bytes read by local processes are not available
+                $hHost->{lAutoSize} += $hJob->{lSize} if (defined($hHost->{rhProcessAuto}) && !$hHost->{bAutoRead});
+
+                logDebugMisc(
+                    $strOperation, 'job complete',
+                    {name => 'iProcessId', value => $hJob->{iProcessId}},
+                    {name => 'strKey', value => $hJob->{strKey}},
+                    {name => 'rResult', value => $hJob->{rResult}});
+            }
 
             # Free the local process to receive another job
-            $hLocal->{hJob} = undef;
+            if (defined($hLocal->{strDevice}))
+            {
+                $hHost->{hDeviceRunning}{$hLocal->{strDevice}}--;
+            }
+
+            $hLocal->{hyJob} = undef;
+            $hLocal->{fBusyTime} += gettimeofday() - $hLocal->{fJobStartTime};
             $self->{iRunning}--;
             $iCompleted++;
         }
     }
 
-    # If any jobs are not running/completed then assign new jobs
-    if ($self->{iRunning} == 0 || $iCompleted > 0)
+    # Add or remove local processes for hosts in auto mode
+    my $iStarted = $self->processAuto();
+
+    # If any jobs are not running/completed or local processes were started then assign new jobs
+    if ($self->{iRunning} == 0 || $iCompleted > 0 || $iStarted > 0)
     {
         &logDebugMisc(
             $strOperation, 'get new jobs',
             {name => 'iRunning', value => $self->{iRunning}, trace => true},
-            {name => 'iCompleted', value => $iCompleted, trace => true});
+            {name => 'iCompleted', value => $iCompleted, trace => true},
+            {name => 'iStarted', value => $iStarted, trace => true});
 
         my $bFound = false;
         my $iLocalIdx = -1;
@@ -392,28 +555,72 @@ sub process
             my $hyQueue = $hHost->{hyQueue};
 
             # If this process does not currently have a job assigned then find one
-            if (!defined($hLocal->{hJob}))
+            if (!defined($hLocal->{hyJob}))
             {
-                # Search queues for a new job
-                my $iQueueIdx = $hLocal->{iQueueIdx};
-                my $hJob = shift(@{$$hyQueue[$iQueueIdx]});
+                # Stop the local process if auto mode has lowered the number of processes for the host
+                if ($hHost->{iProcessTotal} > $hHost->{iProcessTarget})
+                {
+                    logDebugMisc(
+                        $strOperation, 'process target reached, stop local',
+                        {name => 'iHostIdx', value => $hLocal->{iHostIdx}},
+                        {name => 'iProcessId', value => $hLocal->{iProcessId}});
+
+                    $self->localStop($iLocalIdx);
+                    next;
+                }
 
-                while (!defined($hJob) && $iQueueIdx != $hLocal->{iQueueLastIdx})
+                # Search all queues for the job on the device with the fewest running jobs so reads are spread across devices.
+                # Within a device the largest job is chosen so the longest jobs are started first and do not end up running alone
+                # at the end.  Queues are searched starting with the local's own queue in the local's direction and ties go to the
+                # first queue found, so locals still tend to work on different queues (e.g. tablespaces) when jobs are the same
+                # size.  Jobs on a device that has reached the device max are skipped.
+                my $hDeviceRunning = $hHost->{hDeviceRunning};
+                my $iQueueIdx;
+                my $iQueueDeviceRunning;
+                my $iQueueSearchIdx = $hLocal->{iQueueIdx};
+                my $bDeviceMax = false;
+
+                while (true)
                 {
-                    $iQueueIdx += $hLocal->{iDirection};
+                    my $hJobHead = $$hyQueue[$iQueueSearchIdx][0];
 
-                    if ($iQueueIdx < 0)
+                    if (defined($hJobHead))
                     {
-                        $iQueueIdx = @{$hyQueue} - 1;
+                        my $strDevice = $hJobHead->{strDevice};
+                        my $iDeviceRunning =
+                            defined($strDevice) && defined($hDeviceRunning->{$strDevice}) ? $hDeviceRunning->{$strDevice} : 0;
+
+                        if (defined($hHost->{iDeviceMax}) && $iDeviceRunning >= $hHost->{iDeviceMax})
+                        {
+                            $bDeviceMax = true;
+                        }
+                        elsif (!defined($iQueueIdx) || $iDeviceRunning < $iQueueDeviceRunning ||
+                               ($iDeviceRunning == $iQueueDeviceRunning && $hJobHead->{lSize} > $$hyQueue[$iQueueIdx][0]{lSize}))
+                        {
+                            $iQueueIdx = $iQueueSearchIdx;
+                            $iQueueDeviceRunning = $iDeviceRunning;
+                        }
                     }
-                    elsif ($iQueueIdx >= @{$hyQueue})
+
+                    last if ($iQueueSearchIdx == $hLocal->{iQueueLastIdx});
+
+                    $iQueueSearchIdx += $hLocal->{iDirection};
+
+                    if ($iQueueSearchIdx < 0)
                     {
-                        $iQueueIdx = 0;
+                        $iQueueSearchIdx = @{$hyQueue} - 1;
+                    }
+                    elsif ($iQueueSearchIdx >= @{$hyQueue})
+                    {
+                        $iQueueSearchIdx = 0;
                     }
-
-                    $hJob = shift(@{$$hyQueue[$iQueueIdx]});
                 }
 
+                my $hJob = defined($iQueueIdx) ? shift(@{$$hyQueue[$iQueueIdx]}) : undef;
+
+                # If jobs are waiting for a device that is busy then leave the local idle until a running job completes
+                next if (!defined($hJob) && $bDeviceMax);
+
                 # If no job was found then stop the local process
                 if (!defined($hJob))
                 {
@@ -424,45 +631,52 @@ sub process
                         {name => 'iHostIdx', value => $hLocal->{iHostIdx}},
                         {name => 'iProcessId', value => $hLocal->{iProcessId}});
 
-                    # Remove input handle from the select object
-                    my $iHandleTotal = $self->{oSelect}->count();
-
-                    $self->{oSelect}->remove($hLocal->{hndIn});
+                    $self->localStop($iLocalIdx);
+                    next;
+                }
 
-                    if ($iHandleTotal - $self->{oSelect}->count() != 1)
-                    {
-                        confess &log(ASSERT,
-                            "iProcessId $hLocal->{iProcessId}, handle $hLocal->{hndIn} was not removed from select object");
-                    }
+                # Assign job to local process.  If the job can be batched then add following jobs from the same queue that can also
+                # be batched so they are sent to the local process in a single request.
+                $hLocal->{hyJob} = [$hJob];
+                $hLocal->{strDevice} = $hJob->{strDevice};
+                $bFound = true;
+                $self->{iRunning}++;
 
-                    # Remove input handle from the map
-                    delete($self->{hLocalMap}{$hLocal->{hndIn}});
+                if (defined($hJob->{strDevice}))
+                {
+                    $hDeviceRunning->{$hJob->{strDevice}}++;
+                }
 
-                    # Close the local process
-                    $hLocal->{oLocal}->close(true);
+                while ($hJob->{bBatch} && @{$hLocal->{hyJob}} < PROCESS_BATCH_MAX && defined($$hyQueue[$iQueueIdx][0]) &&
+                       $$hyQueue[$iQueueIdx][0]{bBatch} && $$hyQueue[$iQueueIdx][0]{strOp} eq $hJob->{strOp})
+                {
+                    push(@{$hLocal->{hyJob}}, shift(@{$$hyQueue[$iQueueIdx]}));
+                }
 
-                    # Undefine local process so it is no longer checked for new jobs
-                    undef(${$self->{hyLocal}}[$iLocalIdx]);
+                foreach my $hJobBatch (@{$hLocal->{hyJob}})
+                {
+                    $self->{iQueued}--;
 
-                    # Skip to next local process
-                    next;
+                    logDebugMisc(
+                        $strOperation, 'get job from queue',
+                        {name => 'iHostIdx', value => $hLocal->{iHostIdx}},
+                        {name => 'iProcessId', value => $hLocal->{iProcessId}},
+                        {name => 'strQueueIdx', value => $iQueueIdx},
+                        {name => 'strKey', value => $hJobBatch->{strKey}});
                 }
 
-                # Assign job to local process
-                $hLocal->{hJob} = $hJob;
-                $bFound = true;
-                $self->{iRunning}++;
-                $self->{iQueued}--;
+                # Send job (or batch of jobs) to local process
+                $hLocal->{fJobStartTime} = gettimeofday();
 
-                logDebugMisc(
-                    $strOperation, 'get job from queue',
-                    {name => 'iHostIdx', value => $hLocal->{iHostIdx}},
-                    {name => 'iProcessId', value => $hLocal->{iProcessId}},
-                    {name => 'strQueueIdx', value => $iQueueIdx},
-                    {name => 'strKey', value => $hLocal->{hJob}{strKey}});
-
-                # Send job to local process
-                $hLocal->{oLocal}->cmdWrite($hLocal->{hJob}{strOp}, $hLocal->{hJob}->{rParam});
+                if (@{$hLocal->{hyJob}} == 1)
+                {
+                    $hLocal->{oLocal}->cmdWrite($hJob->{strOp}, $hJob->{rParam});
+                }
+                else
+                {
+                    $hLocal->{oLocal}->cmdWrite(
+                        OP_LOCAL_BATCH, [map {[$_->{strOp}, $_->{rParam}]} @{$hLocal->{hyJob}}]);
+                }
             }
         }
 
@@ -470,6 +684,20 @@ sub process
         if (!$bFound && !$self->{iRunning} && @hyResult == 0)
         {
             logDebugMisc($strOperation, 'all jobs complete');
+
+            # Calculate idle time for each local process, which includes time waiting for the main process to send a job and time
+            # after the local was stopped while other locals were still running.  Time before a local was started in auto mode is
+            # not included.
+            my $fEndTime = gettimeofday();
+
+            foreach my $hProcessTime (@{$self->{hyProcessTime}})
+            {
+                $hProcessTime->{fTotalTime} = $fEndTime - delete($hProcessTime->{fStartTime});
+                $hProcessTime->{fIdleTime} = $hProcessTime->{fTotalTime} - $hProcessTime->{fBusyTime};
+            }
+
+            @{$self->{hyProcessTime}} = sort {$a->{iProcessId} <=> $b->{iProcessId}} @{$self->{hyProcessTime}};
+
             $self->reset();
             return;
         }
@@ -479,10 +707,399 @@ sub process
     return \@hyResult;
 }
 
+####################################################################################################################################
+# localStop
+#
+# Stop a local process and record how long it was busy.
+####################################################################################################################################
+sub localStop
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $iLocalIdx,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->localStop', \@_,
+            {name => 'iLocalIdx', trace => true},
+        );
+
+    my $hLocal = $self->{hyLocal}[$iLocalIdx];
+
+    # Remove input handle from the select object
+    my $iHandleTotal = $self->{oSelect}->count();
+
+    $self->{oSelect}->remove($hLocal->{hndIn});
+
+    if ($iHandleTotal - $self->{oSelect}->count() != 1)
+    {
+        confess &log(ASSERT, "iProcessId $hLocal->{iProcessId}, handle $hLocal->{hndIn} was not removed from select object");
+    }
+
+    # Remove input handle from the map
+    delete($self->{hLocalMap}{$hLocal->{hndIn}});
+
+    # Count bytes read by the process since the last auto check before it is stopped
+    my $hHost = $self->{hyHost}[$hLocal->{iHostIdx}];
+
+    if (defined($hHost->{rhProcessAuto}) && $hHost->{bAutoRead})
+    {
+        $self->localAutoRead($hHost, $hLocal);
+    }
+
+    # Return the local process to the pool or close it, and record how long it was busy
+    if ($self->{bPersist})
+    {
+        $self->{hLocalPool}{$hLocal->{iProcessId}} = $hLocal;
+    }
+    else
+    {
+        $hLocal->{oLocal}->close(true);
+    }
+
+    # Process ids are reused when processes are started again in auto mode so add to the busy time already recorded for the id
+    my ($hProcessTime) = grep {$_->{iProcessId} == $hLocal->{iProcessId}} @{$self->{hyProcessTime}};
+
+    if (defined($hProcessTime))
+    {
+        $hProcessTime->{fBusyTime} += $hLocal->{fBusyTime};
+    }
+    else
+    {
+        push(
+            @{$self->{hyProcessTime}},
+            {iProcessId => $hLocal->{iProcessId}, fBusyTime => $hLocal->{fBusyTime}, fStartTime => $hLocal->{fStartTime}});
+    }
+
+    # Undefine local process so it is no longer checked for new jobs
+    undef(${$self->{hyLocal}}[$iLocalIdx]);
+    $hHost->{iProcessTotal}--;
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
+####################################################################################################################################
+# processAuto
+#
+# Adjust the number of local processes for hosts in auto mode.  Throughput is measured over an interval using the bytes read by the
+# local processes.  A process is added as long as each addition improves throughput by at least PROCESS_AUTO_GAIN_MIN.  Once
+# throughput stops improving the last process added is removed since it did not help and growth stops.  Throughput is then measured
+# with the remaining processes and growth starts again if it later changes by more than PROCESS_AUTO_GAIN_MIN, since the data being
+# read may have moved to storage that performs differently.  A process is also removed when the load of the host exceeds the load
+# max and growth starts again once the load is below the max.  Processes are stopped when they finish their current job.
+#
+# Returns the number of processes started.
+####################################################################################################################################
+sub processAuto
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->processAuto');
+
+    my $iStarted = 0;
+
+    foreach my $hHost (@{$self->{hyHost}})
+    {
+        my $rhProcessAuto = $hHost->{rhProcessAuto};
+
+        # Skip hosts that are not in auto mode or have no local processes running
+        next if (!defined($rhProcessAuto) || !$hHost->{iProcessTotal});
+
+        # Wait until the interval has passed
+        my $fTime = $self->processAutoTime($hHost);
+        my $fInterval = defined($rhProcessAuto->{fInterval}) ? $rhProcessAuto->{fInterval} : PROCESS_AUTO_INTERVAL;
+
+        next if ($fTime - $hHost->{fAutoTime} < $fInterval);
+
+        # Add the bytes read by running local processes since the last check
+        if ($hHost->{bAutoRead})
+        {
+            foreach my $hLocal (grep {defined($_) && $_->{iHostIdx} == $hHost->{iHostIdx}} @{$self->{hyLocal}})
+            {
+                $self->localAutoRead($hHost, $hLocal);
+            }
+        }
+
+        # Wait until something has been read so there is something to measure
+        next if ($hHost->{lAutoSize} == 0);
+
+        my $fRate = $hHost->{lAutoSize} / ($fTime - $hHost->{fAutoTime});
+        my $fLoad = defined($rhProcessAuto->{fLoadMax}) ? $rhProcessAuto->{fnLoad}->() : undef;
+        my $iProcessTarget = $hHost->{iProcessTarget};
+
+        $hHost->{fAutoTime} = $fTime;
+        $hHost->{lAutoSize} = 0;
+
+        # Remove a process when the host load is too high.  Throughput is measured again once the load is below the max.
+        if (defined($fLoad) && $fLoad > $rhProcessAuto->{fLoadMax})
+        {
+            $iProcessTarget-- if ($iProcessTarget > 1);
+            $hHost->{fAutoRate} = undef;
+            $hHost->{bAutoGrow} = true;
+        }
+        # Else add a process while throughput improves
+        elsif ($hHost->{bAutoGrow})
+        {
+            if (!defined($hHost->{fAutoRate}) || $fRate > $hHost->{fAutoRate} * (1 + PROCESS_AUTO_GAIN_MIN))
+            {
+                $hHost->{fAutoRate} = $fRate;
+
+                # Stop growing at the process max since the last process added was useful
+                if ($iProcessTarget < $hHost->{iProcessMax})
+                {
+                    $iProcessTarget++;
+                }
+                else
+                {
+                    $hHost->{bAutoGrow} = false;
+                }
+            }
+            # Else the last process added did not help so remove it.  The throughput of the remaining processes is measured at the
+            # next check.
+            else
+            {
+                $iProcessTarget-- if ($iProcessTarget > 1);
+                $hHost->{fAutoRate} = undef;
+                $hHost->{bAutoGrow} = false;
+            }
+        }
+        # Else store the throughput of the remaining processes after growth stopped
+        elsif (!defined($hHost->{fAutoRate}))
+        {
+            $hHost->{fAutoRate} = $fRate;
+        }
+        # Else start growing again if throughput has changed enough that another process might help
+        elsif ($iProcessTarget < $hHost->{iProcessMax} &&
+               abs($fRate - $hHost->{fAutoRate}) > $hHost->{fAutoRate} * PROCESS_AUTO_GAIN_MIN)
+        {
+            $hHost->{fAutoRate} = $fRate;
+            $hHost->{bAutoGrow} = true;
+            $iProcessTarget++;
+        }
+
+        if ($iProcessTarget != $hHost->{iProcessTarget})
+        {
+            &log(DETAIL,
+                ($iProcessTarget > $hHost->{iProcessTarget} ? 'increase' : 'decrease') .
+                " local processes for host $hHost->{iHostConfigIdx} to ${iProcessTarget} (" .
+                sprintf('%.2fMB/s', $fRate / 1048576) . (defined($fLoad) ? ", load ${fLoad}" : '') . ')');
+
+            $hHost->{iProcessTarget} = $iProcessTarget;
+        }
+
+        # Start processes up to the target if there are still jobs queued that they can work on
+        while ($hHost->{iProcessTotal} < $hHost->{iProcessTarget} && grep {@{$_} > 0} @{$hHost->{hyQueue}})
+        {
+            $self->localInit($strOperation, $self->localStart($strOperation, $hHost));
+            $iStarted++;
+        }
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'iStarted', value => $iStarted, trace => true}
+    );
+}
+
+####################################################################################################################################
+# processAutoTime
+#
+# Get the current time used to measure throughput in auto mode.
+####################################################################################################################################
+sub processAutoTime
+{
+    my $self = shift;
+    my $hHost = shift;
+
+    return defined($hHost->{rhProcessAuto}{fnTime}) ? $hHost->{rhProcessAuto}{fnTime}->() : gettimeofday();
+}
+
+####################################################################################################################################
+# localRead
+#
+# Get the bytes read by a local process.  Returns undef when the bytes read are not available.
+####################################################################################################################################
+sub localRead
+{
+    my $self = shift;
+    my $hHost = shift;
+    my $hLocal = shift;
+
+    my $iProcessId = $hLocal->{oLocal}->io()->processId();
+
+    return defined($hHost->{rhProcessAuto}{fnRead}) ? $hHost->{rhProcessAuto}{fnRead}->($iProcessId) : processRead($iProcessId);
+}
+
+####################################################################################################################################
+# localAutoRead
+#
+# Add the bytes read by a local process since the last call to the bytes read for the host.  If the bytes read are no longer
+# available then the size of completed jobs is used instead.
+####################################################################################################################################
+sub localAutoRead
+{
+    my $self = shift;
+    my $hHost = shift;
+    my $hLocal = shift;
+
+    my $lRead = $self->localRead($hHost, $hLocal);
+
+    if (!defined($lRead))
+    {
+        $hHost->{bAutoRead} = false;
+        return;
+    }
+
+    $hHost->{lAutoSize} += $lRead - $hLocal->{lAutoRead};
+    $hLocal->{lAutoRead} = $lRead;
+}
+
+####################################################################################################################################
+# processRead
+#
+# Get the bytes read by a system process, including bytes read from pipes and sockets so reads from remote hosts are counted.
+# Returns undef when /proc is not available.
+####################################################################################################################################
+sub processRead
+{
+    my $iProcessId = shift;
+
+    my $lRead;
+
+    if (defined($iProcessId) && open(my $hFile, '<', "/proc/${iProcessId}/io"))
+    {
+        while (my $strLine = readline($hFile))
+        {
+            if ($strLine =~ /^rchar\: ([0-9]+)$/)
+            {
+                $lRead = $1;
+                last;
+            }
+        }
+
+        CORE::close($hFile);
+    }
+
+    return $lRead;
+}
+
+####################################################################################################################################
+# localPoolGet
+#
+# Get a local process from the pool.  The process is checked with a noop first since it may have exited while it was idle.
+####################################################################################################################################
+sub localPoolGet
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $iProcessId,
+        $iHostIdx,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->localPoolGet', \@_,
+            {name => 'iProcessId', trace => true},
+            {name => 'iHostIdx', trace => true},
+        );
+
+    my $hLocal = delete($self->{hLocalPool}{$iProcessId});
+
+    if (defined($hLocal))
+    {
+        # Ignore SIGPIPE so a process that has exited results in an error rather than terminating this process
+        local $SIG{PIPE} = 'IGNORE';
+
+        # A process that was started for a different host cannot be used.  Otherwise make sure the process is still responding.
+        my $bValid = $hLocal->{iHostIdx} == $iHostIdx;
+
+        if ($bValid)
+        {
+            eval
+            {
+                $hLocal->{oLocal}->noOp();
+                return true;
+            }
+            or do
+            {
+                logDebugMisc(
+                    $strOperation, 'pooled local process is not responding',
+                    {name => 'iProcessId', value => $iProcessId},
+                    {name => 'strError', value => exceptionMessage($EVAL_ERROR)});
+
+                $bValid = false;
+            };
+        }
+
+        # Close the process if it will not be reused.  Errors are ignored since the process may have already exited.
+        if (!$bValid)
+        {
+            eval {$hLocal->{oLocal}->close()};
+            undef($hLocal);
+        }
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'hLocal', value => $hLocal, trace => true}
+    );
+}
+
+####################################################################################################################################
+# keepAlive
+#
+# Send keep-alives to pooled local processes so they do not time out while waiting for the next run.
+####################################################################################################################################
+sub keepAlive
+{
+    my $self = shift;
+
+    foreach my $iProcessId (sort(keys(%{$self->{hLocalPool}})))
+    {
+        $self->{hLocalPool}{$iProcessId}{oLocal}->keepAlive();
+    }
+}
+
+####################################################################################################################################
+# close
+#
+# Close pooled local processes.
+####################################################################################################################################
+sub close
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->close');
+
+    foreach my $iProcessId (sort(keys(%{$self->{hLocalPool}})))
+    {
+        delete($self->{hLocalPool}{$iProcessId})->{oLocal}->close(true);
+    }
+
+    # Return from function and log return values if any
+    return logDebugReturn($strOperation);
+}
+
 ####################################################################################################################################
 # queueJob
 #
-# Queue a job for processing.
+# Queue a job for processing.  The size is used to start the largest jobs first.  Jobs that can be batched are sent to the local
+# process together with the jobs that follow them in the same queue, which saves a round trip per job when the jobs are small.  The
+# device the job reads from is used to spread jobs across devices.
 ####################################################################################################################################
 sub queueJob
 {
@@ -497,6 +1114,9 @@ sub queueJob
         $strKey,
         $strOp,
         $rParam,
+        $lSize,
+        $bBatch,
+        $strDevice,
     ) =
         logDebugParam
         (
@@ -506,6 +1126,9 @@ sub queueJob
             {name => 'strKey'},
             {name => 'strOp'},
             {name => 'rParam'},
+            {name => 'lSize', default => 0, trace => true},
+            {name => 'bBatch', default => false, trace => true},
+            {name => 'strDevice', required => false, trace => true},
         );
 
     # Don't add jobs while in the middle of processing the current queue
@@ -522,6 +1145,9 @@ sub queueJob
         strKey => $strKey,
         strOp => $strOp,
         rParam => $rParam,
+        lSize => $lSize,
+        bBatch => $bBatch,
+        strDevice => $strDevice,
     };
 
     # Get the host that will perform this job
@@ -604,6 +1230,26 @@ sub dequeueJobs
     return logDebugReturn($strOperation);
 }
 
+####################################################################################################################################
+# processTime
+#
+# Busy and idle time for each local process in the last run.
+####################################################################################################################################
+sub processTime
+{
+    my $self = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my ($strOperation) = logDebugParam(__PACKAGE__ . '->processTime');
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'hyProcessTime', value => $self->{hyProcessTime}, ref => true, trace => true}
+    );
+}
+
 ####################################################################################################################################
 # jobTotal
 #
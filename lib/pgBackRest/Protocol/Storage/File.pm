@@ -11,9 +11,12 @@ use English '-no_match_vars';
 
 use Exporter qw(import);
     our @EXPORT = qw();
+use Time::HiRes qw(gettimeofday);
 
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Log;
+use pgBackRest::Protocol::Base::Frame;
+use pgBackRest::Protocol::Base::Stats;
 
 ####################################################################################################################################
 # CONSTRUCTOR
@@ -63,25 +66,36 @@ sub read
     my $self = shift;
     my $rtBuffer = shift;
 
+    my $fTime = gettimeofday();
     my $lBlockSize;
 
-    # Read the block header and make sure it's valid
-    my $strBlockHeader = $self->{oProtocol}->io()->readLine();
-
-    if ($strBlockHeader !~ /^BRBLOCK[0-9]+$/)
+    # Read the block from a binary frame
+    if ($self->{oProtocol}->frame())
     {
-        confess &log(ERROR, "invalid block header '${strBlockHeader}'", ERROR_FILE_READ);
+        $lBlockSize = protocolBlockRead($self->{oProtocol}->io(), $rtBuffer);
     }
+    else
+    {
+        # Read the block header and make sure it's valid
+        my $strBlockHeader = $self->{oProtocol}->io()->readLine();
+
+        if ($strBlockHeader !~ /^BRBLOCK[0-9]+$/)
+        {
+            confess &log(ERROR, "invalid block header '${strBlockHeader}'", ERROR_FILE_READ);
+        }
 
-    # Get block size from the header
-    $lBlockSize = substr($strBlockHeader, 7);
+        # Get block size from the header
+        $lBlockSize = substr($strBlockHeader, 7);
 
-    # Read block if size > 0
-    if ($lBlockSize > 0)
-    {
-        $self->{oProtocol}->io()->read($rtBuffer, $lBlockSize, true);
+        # Read block if size > 0
+        if ($lBlockSize > 0)
+        {
+            $self->{oProtocol}->io()->read($rtBuffer, $lBlockSize, true);
+        }
     }
 
+    $self->statsAdd($fTime, 0, $lBlockSize);
+
     # Return the block size
     return $lBlockSize;
 }
@@ -98,10 +112,15 @@ sub write
     $self->{bWrite} = true;
 
     # Get the buffer size
+    my $fTime = gettimeofday();
     my $lBlockSize = defined($rtBuffer) ? length($$rtBuffer) : 0;
 
     # Write if size > 0 (0 ends the copy stream so it should only be done in close())
-    if ($lBlockSize > 0)
+    if ($lBlockSize > 0 && $self->{oProtocol}->frame())
+    {
+        protocolBlockWrite($self->{oProtocol}->io(), $rtBuffer);
+    }
+    elsif ($lBlockSize > 0)
     {
         # Write block header to the protocol stream
         $self->{oProtocol}->io()->writeLine("BRBLOCK${lBlockSize}");
@@ -110,9 +129,30 @@ sub write
         $self->{oProtocol}->io()->write($rtBuffer);
     }
 
+    $self->statsAdd($fTime, $lBlockSize, 0);
+
     return length($$rtBuffer);
 }
 
+####################################################################################################################################
+# statsAdd - record the time and size of a data block
+####################################################################################################################################
+sub statsAdd
+{
+    my $self = shift;
+    my $fTime = shift;
+    my $lBytesOut = shift;
+    my $lBytesIn = shift;
+
+    if ($lBytesOut > 0 || $lBytesIn > 0)
+    {
+        protocolStatsAdd(
+            $self->{oProtocol}->name(), PROTOCOL_STATS_BLOCK,
+            $self->{oProtocol}->master() ? PROTOCOL_STATS_MASTER : PROTOCOL_STATS_MINION, gettimeofday() - $fTime, $lBytesOut,
+            $lBytesIn);
+    }
+}
+
 ####################################################################################################################################
 # close - set the result hash
 ####################################################################################################################################
@@ -126,7 +166,14 @@ sub close
         # If writing output terminator
         if ($self->{bWrite})
         {
-            $self->{oProtocol}->io()->writeLine("BRBLOCK0");
+            if ($self->{oProtocol}->frame())
+            {
+                protocolBlockWrite($self->{oProtocol}->io());
+            }
+            else
+            {
+                $self->{oProtocol}->io()->writeLine("BRBLOCK0");
+            }
         }
 
         # On master read the results
@@ -29,6 +29,8 @@ use constant STORAGE_DECOMPRESS                                     => 'decompre
 ####################################################################################################################################
 use constant STORAGE_CAPABILITY_LINK                                => 'link';
     push @EXPORT, qw(STORAGE_CAPABILITY_LINK);
+use constant STORAGE_CAPABILITY_APPEND                              => 'append';
+    push @EXPORT, qw(STORAGE_CAPABILITY_APPEND);
 
 ####################################################################################################################################
 # new
@@ -1,5 +1,9 @@
 ####################################################################################################################################
 # GZIP Filter
+#
+# When lOriginalSize is passed for compression the size is stored in an extra field of the gzip header (RFC 1952).  This is used
+# when zeros were trimmed from the end of the data before compression (see Storage::Filter::Zero), so decompression can extend the
+# data with zeros to the original size.  Data without the extra field is never extended.
 ####################################################################################################################################
 package pgBackRest::Storage::Filter::Gzip;
 use parent 'pgBackRest::Common::Io::Filter';
@@ -24,6 +28,19 @@ use pgBackRest::Storage::Base;
 use constant STORAGE_FILTER_GZIP                                    => __PACKAGE__;
     push @EXPORT, qw(STORAGE_FILTER_GZIP);
 
+####################################################################################################################################
+# Gzip header constants used to store the original size
+####################################################################################################################################
+use constant GZIP_MAGIC                                             => "\x1f\x8b";
+use constant GZIP_METHOD_DEFLATE                                    => 8;
+use constant GZIP_FLAG_EXTRA                                        => 4;
+use constant GZIP_OS_UNIX                                           => 3;
+use constant GZIP_HEADER_SIZE                                       => 10;
+
+# Extra field id and data size of the original size
+use constant GZIP_EXTRA_ORIGINAL_SIZE                               => 'pB';
+use constant GZIP_EXTRA_ORIGINAL_SIZE_SIZE                          => 4;
+
 ####################################################################################################################################
 # CONSTRUCTOR
 ####################################################################################################################################
@@ -40,6 +57,7 @@ sub new
         $strCompressType,
         $iLevel,
         $lCompressBufferMax,
+        $lOriginalSize,
     ) =
         logDebugParam
         (
@@ -49,6 +67,7 @@ sub new
             {name => 'strCompressType', optional => true, default => STORAGE_COMPRESS, trace => true},
             {name => 'iLevel', optional => true, default => 6, trace => true},
             {name => 'lCompressBufferMax', optional => true, default => COMMON_IO_BUFFER_MAX, trace => true},
+            {name => 'lOriginalSize', optional => true, trace => true},
         );
 
     # Bless with new class
@@ -60,6 +79,7 @@ sub new
     $self->{iLevel} = $iLevel;
     $self->{lCompressBufferMax} = $lCompressBufferMax;
     $self->{strCompressType} = $strCompressType;
+    $self->{lOriginalSize} = $lOriginalSize;
 
     # Set read/write
     $self->{bWrite} = false;
@@ -69,11 +89,14 @@ sub new
 
     if ($self->{strCompressType} eq STORAGE_COMPRESS)
     {
+        # Zlib cannot write an extra field so raw deflate is used and the gzip header and trailer are written by this filter
+        $self->{bHeaderWrite} = $self->{bWantGzip} && defined($self->{lOriginalSize});
+
         ($self->{oZLib}, $iZLibStatus) = new Compress::Raw::Zlib::Deflate(
-            WindowBits => $self->{bWantGzip} ? WANT_GZIP : MAX_WBITS, Level => $self->{iLevel},
-            Bufsize => $self->{lCompressBufferMax}, AppendOutput => 1);
+            WindowBits => $self->{bHeaderWrite} ? -MAX_WBITS : ($self->{bWantGzip} ? WANT_GZIP : MAX_WBITS),
+            Level => $self->{iLevel}, Bufsize => $self->{lCompressBufferMax}, AppendOutput => 1, CRC32 => $self->{bHeaderWrite});
 
-        $self->{tCompressedBuffer} = undef;
+        $self->{tCompressedBuffer} = $self->{bHeaderWrite} ? $self->header() : undef;
     }
     else
     {
@@ -83,6 +106,9 @@ sub new
 
         $self->{tUncompressedBuffer} = undef;
         $self->{lUncompressedBufferSize} = 0;
+        $self->{lUncompressedSize} = 0;
+        $self->{bMemberEnd} = false;
+        $self->{bHeaderCheck} = false;
     }
 
     $self->errorCheck($iZLibStatus);
@@ -115,6 +141,62 @@ sub errorCheck
     return Z_OK;
 }
 
+####################################################################################################################################
+# header - gzip header with the original size stored in an extra field
+####################################################################################################################################
+sub header
+{
+    my $self = shift;
+
+    return
+        pack('a2CCVCC', GZIP_MAGIC, GZIP_METHOD_DEFLATE, GZIP_FLAG_EXTRA, 0, 0, GZIP_OS_UNIX) .
+        pack('va2vV', GZIP_EXTRA_ORIGINAL_SIZE_SIZE + 4, GZIP_EXTRA_ORIGINAL_SIZE, GZIP_EXTRA_ORIGINAL_SIZE_SIZE,
+            $self->{lOriginalSize});
+}
+
+####################################################################################################################################
+# trailer - gzip trailer with the crc and size of the uncompressed data
+####################################################################################################################################
+sub trailer
+{
+    my $self = shift;
+
+    return pack('VV', $self->{oZLib}->crc32(), $self->{oZLib}->total_in() & 0xffffffff);
+}
+
+####################################################################################################################################
+# headerCheck - get the original size from the extra field of the first gzip header, if it is present
+####################################################################################################################################
+sub headerCheck
+{
+    my $self = shift;
+    my $rtBuffer = shift;
+
+    $self->{bHeaderCheck} = true;
+
+    return if
+        !$self->{bWantGzip} || length($$rtBuffer) < GZIP_HEADER_SIZE + 2 || substr($$rtBuffer, 0, 2) ne GZIP_MAGIC ||
+        !(ord(substr($$rtBuffer, 3, 1)) & GZIP_FLAG_EXTRA);
+
+    my $iExtraEnd = GZIP_HEADER_SIZE + 2 + unpack('v', substr($$rtBuffer, GZIP_HEADER_SIZE, 2));
+    my $iExtraIdx = GZIP_HEADER_SIZE + 2;
+
+    # Search the extra subfields for the original size
+    while ($iExtraIdx + 4 <= $iExtraEnd && $iExtraIdx + 4 <= length($$rtBuffer))
+    {
+        my ($strId, $iSize) = unpack('a2v', substr($$rtBuffer, $iExtraIdx, 4));
+
+        if ($strId eq GZIP_EXTRA_ORIGINAL_SIZE && $iSize == GZIP_EXTRA_ORIGINAL_SIZE_SIZE &&
+            $iExtraIdx + 4 + $iSize <= length($$rtBuffer))
+        {
+            $self->{lOriginalSize} = unpack('V', substr($$rtBuffer, $iExtraIdx + 4, $iSize));
+            last;
+        }
+
+        $iExtraIdx += 4 + $iSize;
+    }
+}
+
 ####################################################################################################################################
 # read - compress/decompress data
 ####################################################################################################################################
@@ -132,6 +214,13 @@ sub read
         my $lUncompressedSize;
         my $lCompressedSize;
 
+        # Return the header written by this filter with the first compressed data
+        if (defined($self->{tCompressedBuffer}))
+        {
+            $$rtBuffer .= $self->{tCompressedBuffer};
+            $self->{tCompressedBuffer} = undef;
+        }
+
         do
         {
             my $tUncompressedBuffer;
@@ -144,6 +233,7 @@ sub read
             else
             {
                 $self->errorCheck($self->{oZLib}->flush($$rtBuffer));
+                $$rtBuffer .= $self->trailer() if $self->{bHeaderWrite};
             }
 
             $lCompressedSize = length($$rtBuffer) - $lSizeBegin;
@@ -163,12 +253,34 @@ sub read
                 if (!defined($self->{tCompressedBuffer}) || length($self->{tCompressedBuffer}) == 0)
                 {
                     $self->parent()->read(\$self->{tCompressedBuffer}, $self->{lCompressBufferMax});
+                    $self->headerCheck(\$self->{tCompressedBuffer}) if !$self->{bHeaderCheck};
+
+                    # If the last member ended exactly at the end of the previous read then this is the start of the next member
+                    if ($self->{bMemberEnd} && length($self->{tCompressedBuffer}) > 0)
+                    {
+                        $self->{oZLib}->inflateReset();
+                        $self->{bMemberEnd} = false;
+                    }
                 }
 
                 my $iZLibStatus = $self->{oZLib}->inflate($self->{tCompressedBuffer}, $self->{tUncompressedBuffer});
                 $self->{lUncompressedBufferSize} = length($self->{tUncompressedBuffer});
 
-                last if $iZLibStatus == Z_STREAM_END;
+                # A gzip file may contain more than one member (e.g. when a file is backed up in parts that are compressed
+                # separately), so keep decompressing when there is data after the end of a member
+                if ($iZLibStatus == Z_STREAM_END)
+                {
+                    last if !$self->{bWantGzip};
+
+                    if (length($self->{tCompressedBuffer}) > 0)
+                    {
+                        $self->{oZLib}->inflateReset();
+                        next;
+                    }
+
+                    $self->{bMemberEnd} = true;
+                    last;
+                }
 
                 $self->errorCheck($iZLibStatus);
             }
@@ -185,6 +297,17 @@ sub read
         $self->{tUncompressedBuffer} = substr($self->{tUncompressedBuffer}, $iActualSize);
         $self->{lUncompressedBufferSize} -= $iActualSize;
 
+        # At the end of the data extend with zeros to the original size when it was stored in the header
+        if ($iActualSize == 0 && defined($self->{lOriginalSize}) && $self->{lUncompressedSize} < $self->{lOriginalSize})
+        {
+            $iActualSize =
+                $self->{lOriginalSize} - $self->{lUncompressedSize} < $iSize ?
+                    $self->{lOriginalSize} - $self->{lUncompressedSize} : $iSize;
+            $$rtBuffer .= "\0" x $iActualSize;
+        }
+
+        $self->{lUncompressedSize} += $iActualSize;
+
         # Return the actual size read
         return $iActualSize;
     }
@@ -215,15 +338,23 @@ sub write
     else
     {
         my $tCompressedBuffer = $$rtBuffer;
+        $self->headerCheck(\$tCompressedBuffer) if !$self->{bHeaderCheck} && length($tCompressedBuffer) > 0;
 
         while (length($tCompressedBuffer) > 0)
         {
             my $tUncompressedBuffer;
 
             my $iZLibStatus = $self->{oZLib}->inflate($tCompressedBuffer, $tUncompressedBuffer);
-            $self->parent()->write(\$tUncompressedBuffer);
+            $self->{lUncompressedSize} += $self->parent()->write(\$tUncompressedBuffer);
+
+            # Reset at the end of each gzip member in case another member follows
+            if ($iZLibStatus == Z_STREAM_END)
+            {
+                last if !$self->{bWantGzip};
 
-            last if $iZLibStatus == Z_STREAM_END;
+                $self->{oZLib}->inflateReset();
+                next;
+            }
 
             $self->errorCheck($iZLibStatus);
         }
@@ -249,10 +380,17 @@ sub close
             {
                 # Flush out last compressed bytes
                 $self->errorCheck($self->{oZLib}->flush($self->{tCompressedBuffer}));
+                $self->{tCompressedBuffer} .= $self->trailer() if $self->{bHeaderWrite};
 
                 # Write last compressed bytes
                 $self->parent()->write(\$self->{tCompressedBuffer});
             }
+            # Extend with zeros to the original size when it was stored in the header
+            elsif (defined($self->{lOriginalSize}) && $self->{lUncompressedSize} < $self->{lOriginalSize})
+            {
+                my $tZeroBuffer = "\0" x ($self->{lOriginalSize} - $self->{lUncompressedSize});
+                $self->{lUncompressedSize} += $self->parent()->write(\$tZeroBuffer);
+            }
         }
 
         undef($self->{oZLib});
@@ -0,0 +1,82 @@
+####################################################################################################################################
+# Limit Filter
+#
+# Limit the rate of reads using the limit shared by all processes (see pgBackRest::Common::Limit).
+####################################################################################################################################
+package pgBackRest::Storage::Filter::Limit;
+use parent 'pgBackRest::Common::Io::Filter';
+
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use Exporter qw(import);
+    our @EXPORT = qw();
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Limit;
+use pgBackRest::Common::Log;
+
+####################################################################################################################################
+# Package name constant
+####################################################################################################################################
+use constant STORAGE_FILTER_LIMIT                                   => __PACKAGE__;
+    push @EXPORT, qw(STORAGE_FILTER_LIMIT);
+
+####################################################################################################################################
+# CONSTRUCTOR
+####################################################################################################################################
+sub new
+{
+    my $class = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $oParent,
+        $strDevice,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->new', \@_,
+            {name => 'oParent', trace => true},
+            {name => 'strDevice', required => false, trace => true},
+        );
+
+    # Bless with new class
+    my $self = $class->SUPER::new($oParent);
+    bless $self, $class;
+
+    # Set variables
+    $self->{strDevice} = $strDevice;
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'self', value => $self}
+    );
+}
+
+####################################################################################################################################
+# read - wait until the read is within the limit
+####################################################################################################################################
+sub read
+{
+    my $self = shift;
+    my $rtBuffer = shift;
+    my $iSize = shift;
+
+    # Call the io method
+    my $iActualSize = $self->parent()->read($rtBuffer, $iSize);
+
+    # Account for the read and wait if the limit has been reached
+    limitTake($iActualSize, $self->{strDevice});
+
+    # Return the actual size read
+    return $iActualSize;
+}
+
+1;
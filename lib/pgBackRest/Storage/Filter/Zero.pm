@@ -0,0 +1,99 @@
+####################################################################################################################################
+# Zero Filter
+#
+# Trim zeros from the end of a file when reading.  WAL segments that were switched before they were full (e.g. after archive_timeout)
+# are mostly zeros after the last record, so only the used part of the segment needs to be read by later filters (e.g. compression).
+# The original size must be stored so the zeros can be restored (see Storage::Filter::Gzip).
+####################################################################################################################################
+package pgBackRest::Storage::Filter::Zero;
+use parent 'pgBackRest::Common::Io::Filter';
+
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use Exporter qw(import);
+    our @EXPORT = qw();
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Log;
+
+####################################################################################################################################
+# Package name constant
+####################################################################################################################################
+use constant STORAGE_FILTER_ZERO                                    => __PACKAGE__;
+    push @EXPORT, qw(STORAGE_FILTER_ZERO);
+
+####################################################################################################################################
+# CONSTRUCTOR
+####################################################################################################################################
+sub new
+{
+    my $class = shift;
+
+    # Assign function parameters, defaults, and log debug info
+    my
+    (
+        $strOperation,
+        $oParent,
+    ) =
+        logDebugParam
+        (
+            __PACKAGE__ . '->new', \@_,
+            {name => 'oParent', trace => true},
+        );
+
+    # Bless with new class
+    my $self = $class->SUPER::new($oParent);
+    bless $self, $class;
+
+    # Set variables
+    $self->{lZeroSize} = 0;
+
+    # Return from function and log return values if any
+    return logDebugReturn
+    (
+        $strOperation,
+        {name => 'self', value => $self}
+    );
+}
+
+####################################################################################################################################
+# read - hold back zeros until non-zero data follows them, so zeros at the end of the file are never returned
+####################################################################################################################################
+sub read
+{
+    my $self = shift;
+    my $rtBuffer = shift;
+    my $iSize = shift;
+
+    while (true)
+    {
+        # Call the io method and return at the end of the file, dropping any zeros that were held back
+        my $tZeroBuffer;
+        my $iActualSize = $self->parent()->read(\$tZeroBuffer, $iSize);
+
+        return 0 if $iActualSize == 0;
+
+        # Find the end of the non-zero data in the buffer
+        my $iDataSize = $tZeroBuffer =~ /[^\0]\0*\z/ ? $LAST_MATCH_START[0] + 1 : 0;
+
+        # If the buffer is all zeros then hold it back and read again
+        if ($iDataSize == 0)
+        {
+            $self->{lZeroSize} += $iActualSize;
+            next;
+        }
+
+        # Return the zeros held back and the non-zero data, then hold back the zeros at the end of the buffer
+        my $lZeroSize = $self->{lZeroSize};
+
+        $$rtBuffer .= ("\0" x $lZeroSize) . substr($tZeroBuffer, 0, $iDataSize);
+        $self->{lZeroSize} = $iActualSize - $iDataSize;
+
+        return $lZeroSize + $iDataSize;
+    }
+}
+
+1;
@@ -395,6 +395,8 @@ sub openRead
         $xFileExp,
         $bIgnoreMissing,
         $rhyFilter,
+        $lOffset,
+        $lLimit,
     ) =
         logDebugParam
         (
@@ -402,10 +404,16 @@ sub openRead
             {name => 'xFileExp'},
             {name => 'bIgnoreMissing', optional => true, default => false},
             {name => 'rhyFilter', optional => true},
+            {name => 'lOffset', optional => true, trace => true},
+            {name => 'lLimit', optional => true, trace => true},
         );
 
-    # Need to push this down to drivers so errors do not appear in the log
-    my $oFileIo = $self->driver()->openRead($self->pathGet($xFileExp), {bIgnoreMissing => $bIgnoreMissing});
+    # Need to push this down to drivers so errors do not appear in the log.  Offset and limit are only passed when a range of the
+    # file is being read since not all drivers support them.
+    my $oFileIo = $self->driver()->openRead(
+        $self->pathGet($xFileExp),
+        {bIgnoreMissing => $bIgnoreMissing, defined($lOffset) ? (lOffset => $lOffset) : (),
+            defined($lLimit) ? (lLimit => $lLimit) : ()});
 
     # Apply filters if file is defined
     if (defined($rhyFilter) && defined($oFileIo))
@@ -712,7 +720,7 @@ sub pathSync
             {name => 'bRecurse', default => false},
         );
 
-    $self->driver()->pathSync($self->pathGet($strPathExp), {bRecurse => true});
+    $self->driver()->pathSync($self->pathGet($strPathExp), {bRecurse => $bRecurse});
 
     # Return from function and log return values if any
     return logDebugReturn($strOperation);
@@ -18,6 +18,7 @@ use File::stat qw{lstat};
 
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Log;
+use pgBackRest::LibCLoad;
 use pgBackRest::Storage::Base;
 use pgBackRest::Storage::Posix::FileRead;
 use pgBackRest::Storage::Posix::FileWrite;
@@ -28,6 +29,20 @@ use pgBackRest::Storage::Posix::FileWrite;
 use constant STORAGE_POSIX_DRIVER                                      => __PACKAGE__;
     push @EXPORT, qw(STORAGE_POSIX_DRIVER);
 
+####################################################################################################################################
+# Number of threads used by the C library to build a manifest
+####################################################################################################################################
+use constant STORAGE_POSIX_MANIFEST_THREAD                             => 4;
+
+####################################################################################################################################
+# Load the C library if present
+####################################################################################################################################
+if (libC())
+{
+    require pgBackRest::LibC;
+    pgBackRest::LibC->import(qw(:storage));
+};
+
 ####################################################################################################################################
 # new
 ####################################################################################################################################
@@ -328,9 +343,25 @@ sub manifest
             {name => 'bIgnoreMissing', optional => true, default => false, trace => true},
         );
 
-    # Generate the manifest
-    my $hManifest = {};
-    $self->manifestRecurse($strPath, undef, 0, $hManifest, $bIgnoreMissing);
+    # Generate the manifest.  The C library reads paths in parallel and stats each file relative to the open path so it is much
+    # faster when there are a lot of files.
+    my $hManifest;
+
+    if (libC())
+    {
+        $hManifest = storagePosixManifest($strPath, $bIgnoreMissing, STORAGE_POSIX_MANIFEST_THREAD);
+    }
+    else
+    {
+        $hManifest = {};
+        $self->manifestRecurse($strPath, undef, 0, $hManifest, $bIgnoreMissing);
+    }
+
+    # Store the device of the base path so callers can tell which paths share a device
+    if (defined($hManifest->{'.'}))
+    {
+        $hManifest->{'.'}{device} = (stat($strPath))[0];
+    }
 
     # Return from function and log return values if any
     return logDebugReturn
@@ -597,15 +628,20 @@ sub openRead
         $strOperation,
         $strFile,
         $bIgnoreMissing,
+        $lOffset,
+        $lLimit,
     ) =
         logDebugParam
     (
         __PACKAGE__ . '->openRead', \@_,
         {name => 'strFile', trace => true},
         {name => 'bIgnoreMissing', optional => true, default => false, trace => true},
+        {name => 'lOffset', optional => true, trace => true},
+        {name => 'lLimit', optional => true, trace => true},
     );
 
-    my $oFileIO = new pgBackRest::Storage::Posix::FileRead($self, $strFile, {bIgnoreMissing => $bIgnoreMissing});
+    my $oFileIO = new pgBackRest::Storage::Posix::FileRead(
+        $self, $strFile, {bIgnoreMissing => $bIgnoreMissing, lOffset => $lOffset, lLimit => $lLimit});
 
     # Return from function and log return values if any
     return logDebugReturn
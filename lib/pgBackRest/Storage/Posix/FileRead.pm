@@ -9,7 +9,7 @@ use warnings FATAL => qw(all);
 use Carp qw(confess);
 use English '-no_match_vars';
 
-use Fcntl qw(O_RDONLY);
+use Fcntl qw(O_RDONLY SEEK_SET);
 
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Log;
@@ -28,6 +28,8 @@ sub new
         $oDriver,
         $strName,
         $bIgnoreMissing,
+        $lOffset,
+        $lLimit,
     ) =
         logDebugParam
         (
@@ -35,6 +37,8 @@ sub new
             {name => 'oDriver', trace => true},
             {name => 'strName', trace => true},
             {name => 'bIgnoreMissing', optional => true, default => false, trace => true},
+            {name => 'lOffset', optional => true, trace => true},
+            {name => 'lLimit', optional => true, trace => true},
         );
 
     # Open the file
@@ -58,6 +62,12 @@ sub new
         # Set file mode to binary
         binmode($fhFile);
 
+        # Seek to the offset when only part of the file will be read
+        if (defined($lOffset) && $lOffset > 0 && !sysseek($fhFile, $lOffset, SEEK_SET))
+        {
+            logErrorResult(ERROR_FILE_READ, "unable to seek to ${lOffset} in '${strName}'", $OS_ERROR);
+        }
+
         # Create the class hash
         $self = $class->SUPER::new("'${strName}'", $fhFile);
         bless $self, $class;
@@ -66,6 +76,7 @@ sub new
         $self->{oDriver} = $oDriver;
         $self->{strName} = $strName;
         $self->{fhFile} = $fhFile;
+        $self->{lLimit} = $lLimit;
     }
 
     # Return from function and log return values if any
@@ -76,6 +87,23 @@ sub new
     );
 }
 
+####################################################################################################################################
+# read - read data from the file without reading past the limit (if set)
+####################################################################################################################################
+sub read
+{
+    my $self = shift;
+    my $rtBuffer = shift;
+    my $iSize = shift;
+
+    if (defined($self->{lLimit}) && $self->{lLimit} - $self->size() < $iSize)
+    {
+        $iSize = $self->{lLimit} - $self->size();
+    }
+
+    return $self->SUPER::read($rtBuffer, $iSize);
+}
+
 ####################################################################################################################################
 # close - close the file
 ####################################################################################################################################
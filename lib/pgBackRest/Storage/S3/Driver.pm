@@ -116,6 +116,7 @@ sub manifest
         $strPath,
         $bRecurse,
         $bPath,
+        $bEtag,
     ) =
         logDebugParam
         (
@@ -124,6 +125,7 @@ sub manifest
             # Optional parameters not part of the driver spec
             {name => 'bRecurse', optional => true, default => true, trace => true},
             {name => 'bPath', optional => true, default => true, trace => true},
+            {name => 'bEtag', optional => true, default => false, trace => true},
         );
 
     # Determine the prefix (this is the search path within the bucket)
@@ -173,6 +175,7 @@ sub manifest
 
             $hManifest->{$strName}->{type} = 'f';
             $hManifest->{$strName}->{size} = xmlTagText($oFile, 'Size') + 0;
+            $hManifest->{$strName}->{etag} = xmlTagText($oFile, 'ETag', false) if $bEtag;
 
             # Generate paths from the name if recursing
             if ($bRecurse)
@@ -402,7 +405,7 @@ sub info
         );
 
     # Get the file
-    my $rhFile = $self->manifest($strFile, {bRecurse => false, bPath => false})->{basename($strFile)};
+    my $rhFile = $self->manifest($strFile, {bRecurse => false, bPath => false, bEtag => true})->{basename($strFile)};
 
     if (!defined($rhFile))
     {
@@ -413,7 +416,7 @@ sub info
     return logDebugReturn
     (
         $strOperation,
-        {name => 'oInfo', value => new pgBackRest::Storage::S3::Info($rhFile->{size}), trace => true}
+        {name => 'oInfo', value => new pgBackRest::Storage::S3::Info($rhFile->{size}, $rhFile->{etag}), trace => true}
     );
 }
 
@@ -474,7 +477,7 @@ sub remove
                 $iTotal++;
                 $strXml .= '<Object><Key>' . substr($strFile, 1) . '</Key></Object>';
 
-                $strFile = $iTotal < 2 ? shift(@{$rstryFileAll}) : undef;
+                $strFile = $iTotal < S3_BATCH_MAX ? shift(@{$rstryFileAll}) : undef;
             }
 
             $strXml .= '</Delete>';
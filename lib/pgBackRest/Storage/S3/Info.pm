@@ -25,11 +25,13 @@ sub new
     (
         my $strOperation,
         $self->{lSize},
+        $self->{strEtag},
     ) =
         logDebugParam
         (
             __PACKAGE__ . '->new', \@_,
             {name => 'lSize'},
+            {name => 'strEtag', required => false},
         );
 
     # Return from function and log return values if any
@@ -44,5 +46,6 @@ sub new
 # Getters
 ####################################################################################################################################
 sub size {shift->{lSize}}
+sub etag {shift->{strEtag}}
 
 1;
@@ -30,6 +30,8 @@ These includes are from the src directory.  There is no Perl-specific code in th
 #include "config/config.h"
 #include "config/configRule.h"
 #include "postgres/pageChecksum.h"
+#include "storage/posix/manifest.h"
+#include "storage/posix/watch.h"
 
 /***********************************************************************************************************************************
 Helper macros
@@ -42,6 +44,8 @@ XSH includes
 These includes define data structures that are required for the C to Perl interface but are not part of the regular C source.
 ***********************************************************************************************************************************/
 #include "xs/common/encode.xsh"
+#include "xs/storage/posix/manifest.xsh"
+#include "xs/storage/posix/watch.xsh"
 
 /***********************************************************************************************************************************
 Constant include
@@ -70,3 +74,5 @@ INCLUDE: xs/common/encode.xs
 INCLUDE: xs/config/config.xs
 INCLUDE: xs/config/configRule.xs
 INCLUDE: xs/postgres/pageChecksum.xs
+INCLUDE: xs/storage/posix/manifest.xs
+INCLUDE: xs/storage/posix/watch.xs
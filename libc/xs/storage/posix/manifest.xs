@@ -0,0 +1,27 @@
+# ----------------------------------------------------------------------------------------------------------------------------------
+# Posix Storage Manifest Perl Exports
+# ----------------------------------------------------------------------------------------------------------------------------------
+
+MODULE = pgBackRest::LibC PACKAGE = pgBackRest::LibC
+
+####################################################################################################################################
+SV *
+storagePosixManifest(path, ignoreMissing, threadTotal)
+    const char *path
+    bool ignoreMissing
+    U32 threadTotal
+CODE:
+    RETVAL = NULL;
+
+    // The hash is mortal so it is freed if an error is thrown
+    HV *manifest = (HV *)sv_2mortal((SV *)newHV());
+
+    ERROR_XS_BEGIN()
+    {
+        storagePosixManifest(path, ignoreMissing, threadTotal, storagePosixManifestXsCallback, manifest);
+    }
+    ERROR_XS_END();
+
+    RETVAL = newRV_inc((SV *)manifest);
+OUTPUT:
+    RETVAL
@@ -0,0 +1,48 @@
+# ----------------------------------------------------------------------------------------------------------------------------------
+# Posix Storage Watch Perl Exports
+# ----------------------------------------------------------------------------------------------------------------------------------
+
+MODULE = pgBackRest::LibC PACKAGE = pgBackRest::LibC
+
+####################################################################################################################################
+I32
+storagePosixWatchNew(path)
+    const char *path
+CODE:
+    RETVAL = -1;
+
+    ERROR_XS_BEGIN()
+    {
+        RETVAL = storagePosixWatchNew(path);
+    }
+    ERROR_XS_END();
+OUTPUT:
+    RETVAL
+
+####################################################################################################################################
+SV *
+storagePosixWatchRead(watch, waitMs)
+    I32 watch
+    U32 waitMs
+CODE:
+    RETVAL = NULL;
+
+    // The array is mortal so it is freed if an error is thrown
+    AV *eventList = (AV *)sv_2mortal((SV *)newAV());
+
+    ERROR_XS_BEGIN()
+    {
+        storagePosixWatchRead(watch, waitMs, storagePosixWatchXsCallback, eventList);
+    }
+    ERROR_XS_END();
+
+    RETVAL = newRV_inc((SV *)eventList);
+OUTPUT:
+    RETVAL
+
+####################################################################################################################################
+void
+storagePosixWatchFree(watch)
+    I32 watch
+CODE:
+    storagePosixWatchFree(watch);
@@ -0,0 +1,496 @@
+/***********************************************************************************************************************************
+Archive Push Command
+
+Push a WAL segment synchronously to a repository on local posix storage without starting Perl.  PostgreSQL runs archive_command for
+every segment so most of the time spent pushing a segment with Perl is compiling the modules rather than doing the work.
+
+This command only handles the common case where the segment is pushed without any errors or warnings -- the result must be
+identical to the Perl command in every other respect.  If anything is unusual (async archiving, a remote, a stop file, an
+archive.info that does not match, a segment that already exists, etc.) then false is returned before anything has been written or
+logged and the caller runs the Perl command, which reports errors and warnings the usual way.
+***********************************************************************************************************************************/
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "command/archive/push/push.h"
+#include "command/command.h"
+#include "common/error.h"
+#include "common/ini.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "config/config.h"
+#include "config/configRule.h"
+#include "crypto/hash.h"
+#include "postgres/wal.h"
+#include "storage/posix/fileWrite.h"
+#include "storage/posix/storage.h"
+#include "version.h"
+
+/***********************************************************************************************************************************
+Archive info file and keys
+***********************************************************************************************************************************/
+#define ARCHIVE_INFO_FILE                                           "archive.info"
+#define ARCHIVE_INFO_COPY_EXT                                       ".copy"
+
+#define INI_SECTION_BACKREST                                        "backrest"
+#define INI_KEY_CHECKSUM                                            "backrest-checksum"
+#define INI_KEY_FORMAT                                              "backrest-format"
+
+#define INFO_ARCHIVE_SECTION_DB                                     "db"
+#define INFO_ARCHIVE_KEY_DB_ID                                      "db-id"
+#define INFO_ARCHIVE_KEY_DB_SYSTEM_ID                               "db-system-id"
+#define INFO_ARCHIVE_KEY_DB_VERSION                                 "db-version"
+
+/***********************************************************************************************************************************
+Compression extension and the size of each block of compressed output written to the repository
+***********************************************************************************************************************************/
+#define COMPRESS_EXT                                                "gz"
+#define COMPRESS_BUFFER_SIZE                                        65536
+
+/***********************************************************************************************************************************
+Gzip extra field that stores the original size of a segment with zeros trimmed from the end (must match Storage/Filter/Gzip.pm)
+***********************************************************************************************************************************/
+#define GZIP_EXTRA_ID_1                                             'p'
+#define GZIP_EXTRA_ID_2                                             'B'
+#define GZIP_EXTRA_ORIGINAL_SIZE_SIZE                               4
+#define GZIP_EXTRA_SIZE                                             (4 + GZIP_EXTRA_ORIGINAL_SIZE_SIZE)
+#define GZIP_OS_UNIX                                                3
+
+/***********************************************************************************************************************************
+Size of buffers used for paths and file names
+***********************************************************************************************************************************/
+#define PUSH_PATH_SIZE_MAX                                          4096
+
+/***********************************************************************************************************************************
+Format a path into a buffer of PUSH_PATH_SIZE_MAX bytes and error if it does not fit
+***********************************************************************************************************************************/
+static void __attribute__((format(printf, 2, 3)))
+pushPath(char *buffer, const char *format, ...)
+{
+    va_list argList;
+    va_start(argList, format);
+    int size = vsnprintf(buffer, PUSH_PATH_SIZE_MAX, format, argList);
+    va_end(argList);
+
+    if (size < 0 || size >= PUSH_PATH_SIZE_MAX)
+        ERROR_THROW(FormatError, "path is longer than %d bytes", PUSH_PATH_SIZE_MAX - 1);
+}
+
+/***********************************************************************************************************************************
+Is the option valid and set?  Options that are not valid for the command are not set.
+***********************************************************************************************************************************/
+static bool
+pushOptionTest(int optionId)
+{
+    return cfgOptionValid(optionId) && cfgOptionTest(optionId);
+}
+
+/***********************************************************************************************************************************
+Can the native command handle the options?  Anything that would require a remote, async processing, a warning, or debug logging is
+left to Perl.
+***********************************************************************************************************************************/
+static bool
+pushOptionValid()
+{
+    // Exactly one WAL file
+    if (cfgCommandParamTotal() != 1)
+        return false;
+
+    // No remotes
+    if (pushOptionTest(CFGOPT_BACKUP_HOST))
+        return false;
+
+    for (int dbIdx = 0; dbIdx < cfgOptionIndexTotal(CFGOPT_DB_HOST); dbIdx++)
+    {
+        char optionName[64];
+        snprintf(optionName, sizeof(optionName), "db%d-host", dbIdx + 1);
+
+        if (pushOptionTest(cfgOptionId(optionName)))
+            return false;
+    }
+
+    // Only posix repositories
+    if (!cfgOptionValid(CFGOPT_REPO_TYPE) || cfgOption(CFGOPT_REPO_TYPE) == NULL ||
+        strcmp(cfgOption(CFGOPT_REPO_TYPE), "posix") != 0)
+    {
+        return false;
+    }
+
+    // Options that must be set
+    if (!pushOptionTest(CFGOPT_STANZA) || !pushOptionTest(CFGOPT_REPO_PATH) || !pushOptionTest(CFGOPT_LOCK_PATH) ||
+        !cfgOptionValid(CFGOPT_COMPRESS) || !pushOptionTest(CFGOPT_COMPRESS_LEVEL) || !cfgOptionValid(CFGOPT_NEUTRAL_UMASK) ||
+        !pushOptionTest(CFGOPT_LOG_LEVEL_CONSOLE) || !pushOptionTest(CFGOPT_LOG_LEVEL_STDERR) ||
+        !pushOptionTest(CFGOPT_LOG_LEVEL_FILE) || !pushOptionTest(CFGOPT_LOG_PATH) || !cfgOptionValid(CFGOPT_LOG_TIMESTAMP))
+    {
+        return false;
+    }
+
+    // Options that change behavior or produce warnings
+    if ((cfgOptionValid(CFGOPT_ARCHIVE_ASYNC) && cfgOptionBool(CFGOPT_ARCHIVE_ASYNC)) ||
+        pushOptionTest(CFGOPT_ARCHIVE_QUEUE_MAX) || pushOptionTest(CFGOPT_ARCHIVE_MAX_MB) ||
+        (cfgOptionValid(CFGOPT_TEST) && cfgOptionBool(CFGOPT_TEST)) ||
+        (cfgOptionValid(CFGOPT_PROTOCOL_STATS) && cfgOptionBool(CFGOPT_PROTOCOL_STATS)) ||
+        cfgOptionValid(CFGOPT_RETENTION_FULL) || cfgOptionValid(CFGOPT_RETENTION_ARCHIVE))
+    {
+        return false;
+    }
+
+    // Debug logging includes messages that only Perl produces
+    if (logLevelEnum(cfgOption(CFGOPT_LOG_LEVEL_CONSOLE)) >= logLevelDebug ||
+        logLevelEnum(cfgOption(CFGOPT_LOG_LEVEL_STDERR)) >= logLevelDebug ||
+        logLevelEnum(cfgOption(CFGOPT_LOG_LEVEL_FILE)) >= logLevelDebug)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/***********************************************************************************************************************************
+Parse archive.info content and return it only if the header is valid
+***********************************************************************************************************************************/
+static Ini *
+pushArchiveInfoParse(const unsigned char *content)
+{
+    Ini *volatile result = NULL;
+    Ini *info = iniNew((const char *)content);
+
+    ERROR_TRY()
+    {
+        // The checksum is a JSON string
+        char checksum[HASH_TYPE_HEX_SIZE_MAX];
+        char checksumJson[HASH_TYPE_HEX_SIZE_MAX + 2];
+
+        iniChecksum(info, INI_SECTION_BACKREST, INI_KEY_CHECKSUM, checksum);
+        snprintf(checksumJson, sizeof(checksumJson), "\"%s\"", checksum);
+
+        const char *checksumInfo = iniGet(info, INI_SECTION_BACKREST, INI_KEY_CHECKSUM);
+        const char *format = iniGet(info, INI_SECTION_BACKREST, INI_KEY_FORMAT);
+        char formatExpected[32];
+
+        snprintf(formatExpected, sizeof(formatExpected), "%d", PGBACKREST_FORMAT);
+
+        if (checksumInfo != NULL && strcmp(checksumInfo, checksumJson) == 0 && format != NULL &&
+            strcmp(format, formatExpected) == 0)
+        {
+            result = info;
+        }
+    }
+    ERROR_CATCH_ANY()
+    {
+        iniFree(info);
+        ERROR_RETHROW();
+    }
+
+    if (result == NULL)
+        iniFree(info);
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Load archive.info (or the copy) and return it only if it exists and is valid
+***********************************************************************************************************************************/
+static Ini *
+pushArchiveInfoLoad(const char *archivePath, bool copy)
+{
+    Ini *volatile result = NULL;
+    char file[PUSH_PATH_SIZE_MAX];
+
+    pushPath(file, "%s/" ARCHIVE_INFO_FILE "%s", archivePath, copy ? ARCHIVE_INFO_COPY_EXT : "");
+
+    unsigned char *content = storagePosixGet(file, true, NULL);
+
+    if (content != NULL)
+    {
+        ERROR_TRY()
+        {
+            result = pushArchiveInfoParse(content);
+        }
+        // Perl ignores errors in archive.info and tries the copy
+        ERROR_CATCH(FormatError)
+        {
+        }
+        ERROR_FINALLY()
+        {
+            memFree(content);
+        }
+    }
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Get the archive id for the WAL segment.  Returns false if archive.info is missing, invalid, or does not match the segment
+***********************************************************************************************************************************/
+static bool
+pushArchiveId(const char *archivePath, WalInfo wal, char *archiveId, size_t archiveIdSize)
+{
+    volatile bool result = false;
+
+    Ini *info = pushArchiveInfoLoad(archivePath, false);
+
+    if (info == NULL)
+        info = pushArchiveInfoLoad(archivePath, true);
+
+    if (info != NULL)
+    {
+        ERROR_TRY()
+        {
+            // The version is a JSON string and the system id and db id are JSON numbers
+            const char *dbVersion = iniGet(info, INFO_ARCHIVE_SECTION_DB, INFO_ARCHIVE_KEY_DB_VERSION);
+            const char *dbSystemId = iniGet(info, INFO_ARCHIVE_SECTION_DB, INFO_ARCHIVE_KEY_DB_SYSTEM_ID);
+            const char *dbId = iniGet(info, INFO_ARCHIVE_SECTION_DB, INFO_ARCHIVE_KEY_DB_ID);
+
+            char dbVersionExpected[64];
+            char dbSystemIdExpected[64];
+
+            snprintf(dbVersionExpected, sizeof(dbVersionExpected), "\"%s\"", wal.version);
+            snprintf(dbSystemIdExpected, sizeof(dbSystemIdExpected), "%llu", (unsigned long long)wal.systemId);
+
+            // System ids larger than a signed 64-bit integer are stored by Perl as floats so they are left to Perl
+            if (dbVersion != NULL && strcmp(dbVersion, dbVersionExpected) == 0 && wal.systemId <= INT64_MAX &&
+                dbSystemId != NULL && strcmp(dbSystemId, dbSystemIdExpected) == 0 &&
+                dbId != NULL && dbId[0] != '\0' && strspn(dbId, "0123456789") == strlen(dbId) &&
+                (size_t)snprintf(archiveId, archiveIdSize, "%s-%s", wal.version, dbId) < archiveIdSize)
+            {
+                result = true;
+            }
+        }
+        ERROR_CATCH(FormatError)
+        {
+        }
+        ERROR_FINALLY()
+        {
+            iniFree(info);
+        }
+    }
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Check if a file in the archive path could be the WAL segment, i.e. the name starts with the segment name followed by a dash
+***********************************************************************************************************************************/
+typedef struct PushFindData
+{
+    const char *walSegment;                                         // Segment name to find, including .partial
+    bool found;                                                     // Was a file found?
+} PushFindData;
+
+static void
+pushFindCallback(void *callbackData, const char *name)
+{
+    PushFindData *data = callbackData;
+    size_t walSegmentSize = strlen(data->walSegment);
+
+    if (strncmp(name, data->walSegment, walSegmentSize) == 0 && name[walSegmentSize] == '-')
+        data->found = true;
+}
+
+/***********************************************************************************************************************************
+Write the segment to the repository, compressing it if requested
+
+Zeros at the end of the segment are not compressed.  The segment size is stored in an extra field of the gzip header so
+decompression can restore them (see lib/pgBackRest/Storage/Filter/Gzip.pm).
+***********************************************************************************************************************************/
+static void
+pushWrite(const char *file, const unsigned char *walBuffer, size_t walSize, bool compress, int compressLevel)
+{
+    StorageFileWrite *fileWrite = storagePosixFileWriteOpen(file, STORAGE_FILE_MODE_DEFAULT, STORAGE_PATH_MODE_DEFAULT, true);
+
+    ERROR_TRY()
+    {
+        if (compress)
+        {
+            // Gzip extra field with the segment size as a little-endian 32-bit integer
+            unsigned char extra[GZIP_EXTRA_SIZE] =
+            {
+                GZIP_EXTRA_ID_1, GZIP_EXTRA_ID_2, GZIP_EXTRA_ORIGINAL_SIZE_SIZE, 0, (unsigned char)walSize,
+                (unsigned char)(walSize >> 8), (unsigned char)(walSize >> 16), (unsigned char)(walSize >> 24),
+            };
+
+            gz_header header = {.extra = extra, .extra_len = GZIP_EXTRA_SIZE, .os = GZIP_OS_UNIX};
+
+            // Gzip header and trailer with the same defaults as Compress::Raw::Zlib
+            z_stream stream = {.zalloc = Z_NULL};
+
+            if (deflateInit2(&stream, compressLevel, Z_DEFLATED, MAX_WBITS + 16, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+                ERROR_THROW(MemoryError, "unable to initialize compression: %s", stream.msg == NULL ? "unknown" : stream.msg);
+
+            // Trim zeros from the end of the segment
+            stream.next_in = (unsigned char *)walBuffer;
+            stream.avail_in = (unsigned int)walSize;
+
+            while (stream.avail_in > 0 && walBuffer[stream.avail_in - 1] == 0)
+                stream.avail_in--;
+
+            unsigned char *output = memNewRaw(COMPRESS_BUFFER_SIZE);
+
+            ERROR_TRY()
+            {
+                if (deflateSetHeader(&stream, &header) != Z_OK)
+                {
+                    ERROR_THROW(
+                        FormatError, "unable to set header for '%s': %s", file, stream.msg == NULL ? "unknown" : stream.msg);
+                }
+
+                int deflateResult = Z_OK;
+
+                while (deflateResult != Z_STREAM_END)
+                {
+                    stream.next_out = output;
+                    stream.avail_out = COMPRESS_BUFFER_SIZE;
+
+                    deflateResult = deflate(&stream, Z_FINISH);
+
+                    if (deflateResult != Z_OK && deflateResult != Z_STREAM_END && deflateResult != Z_BUF_ERROR)
+                        ERROR_THROW(FormatError, "unable to compress '%s': %s", file, stream.msg == NULL ? "unknown" : stream.msg);
+
+                    storagePosixFileWrite(fileWrite, output, COMPRESS_BUFFER_SIZE - stream.avail_out);
+                }
+            }
+            ERROR_FINALLY()
+            {
+                deflateEnd(&stream);
+                memFree(output);
+            }
+        }
+        else
+            storagePosixFileWrite(fileWrite, walBuffer, walSize);
+
+        storagePosixFileWriteClose(fileWrite);
+    }
+    ERROR_FINALLY()
+    {
+        storagePosixFileWriteFree(fileWrite);
+    }
+}
+
+/***********************************************************************************************************************************
+Push a WAL segment
+
+Returns false if the segment was not pushed and the Perl command should run instead.
+***********************************************************************************************************************************/
+bool
+cmdArchivePush()
+{
+    if (!pushOptionValid())
+        return false;
+
+    // Set the log levels
+    logInit(
+        logLevelEnum(cfgOption(CFGOPT_LOG_LEVEL_CONSOLE)), logLevelEnum(cfgOption(CFGOPT_LOG_LEVEL_STDERR)),
+        logLevelEnum(cfgOption(CFGOPT_LOG_LEVEL_FILE)), cfgOptionBool(CFGOPT_LOG_TIMESTAMP));
+
+    // Neutralize the umask to make the repository file/path modes more consistent
+    if (cfgOptionBool(CFGOPT_NEUTRAL_UMASK))
+        umask(0000);
+
+    // Stop files are reported by Perl
+    char file[PUSH_PATH_SIZE_MAX];
+
+    pushPath(file, "%s/%s.stop", cfgOption(CFGOPT_LOCK_PATH), cfgOption(CFGOPT_STANZA));
+
+    if (storagePosixExists(file))
+        return false;
+
+    pushPath(file, "%s/all.stop", cfgOption(CFGOPT_LOCK_PATH));
+
+    if (storagePosixExists(file))
+        return false;
+
+    // Get the full path to the WAL segment.  Relative paths are relative to db-path.
+    const char *walPathFile = cfgCommandParam(0);
+    char walPathFileFull[PUSH_PATH_SIZE_MAX];
+
+    if (walPathFile[0] != '/')
+    {
+        if (!pushOptionTest(CFGOPT_DB_PATH))
+            return false;
+
+        pushPath(walPathFileFull, "%s/%s", cfgOption(CFGOPT_DB_PATH), walPathFile);
+    }
+    else
+        pushPath(walPathFileFull, "%s", walPathFile);
+
+    // Only segments are pushed.  Other files (e.g. .history) are stored in the current archive id without checks and are rarely
+    // pushed so they are left to Perl, as are segment names with characters that are not hex.
+    const char *walSegment = strrchr(walPathFileFull, '/') + 1;
+
+    if (!walIsSegment(walSegment) || strspn(walSegment, "0123456789ABCDEF") != 24)
+        return false;
+
+    // Read the segment.  A missing segment is reported by Perl.
+    size_t walSize;
+    unsigned char *walBuffer = storagePosixGet(walPathFileFull, true, &walSize);
+
+    if (walBuffer == NULL)
+        return false;
+
+    bool result = false;
+
+    ERROR_TRY()
+    {
+        // Get the version and system id
+        WalInfo wal = walInfo(walBuffer, walSize);
+
+        // Get the archive id from archive.info
+        char archivePath[PUSH_PATH_SIZE_MAX];
+        char archiveId[128];
+
+        pushPath(archivePath, "%s/archive/%s", cfgOption(CFGOPT_REPO_PATH), cfgOption(CFGOPT_STANZA));
+
+        if (pushArchiveId(archivePath, wal, archiveId, sizeof(archiveId)))
+        {
+            // Check if the segment already exists in the archive
+            char walPath[PUSH_PATH_SIZE_MAX];
+            PushFindData findData = {.walSegment = walSegment};
+
+            pushPath(walPath, "%s/%s/%.16s", archivePath, archiveId, walSegment);
+            storagePosixList(walPath, true, pushFindCallback, &findData);
+
+            if (!findData.found)
+            {
+                // Write the segment to the archive with the checksum in the name
+                bool compress = cfgOptionBool(CFGOPT_COMPRESS);
+                char checksum[HASH_TYPE_HEX_SIZE_MAX];
+
+                cryptoHashOne(HASH_TYPE_SHA1, walBuffer, walSize, checksum);
+
+                pushPath(file, "%s/%s-%s%s", walPath, walSegment, checksum, compress ? "." COMPRESS_EXT : "");
+
+                // Open the log file before writing anything so an error opening it is reported by Perl
+                if (logLevelEnum(cfgOption(CFGOPT_LOG_LEVEL_FILE)) != logLevelOff)
+                {
+                    char logFile[PUSH_PATH_SIZE_MAX];
+
+                    storagePosixPathCreate(cfgOption(CFGOPT_LOG_PATH), 0770, true, true);
+
+                    pushPath(
+                        logFile, "%s/%s-%s.log", cfgOption(CFGOPT_LOG_PATH), cfgOption(CFGOPT_STANZA),
+                        cfgCommandName(cfgCommand()));
+                    logFileSet(logFile);
+                }
+
+                pushWrite(file, walBuffer, walSize, compress, (int)cfgOptionInt64(CFGOPT_COMPRESS_LEVEL));
+
+                // Log the same messages as the Perl command
+                cmdBegin();
+                LOG_INFO("pushed WAL segment %s", walSegment);
+                cmdEnd(0);
+
+                result = true;
+            }
+        }
+    }
+    ERROR_FINALLY()
+    {
+        memFree(walBuffer);
+    }
+
+    return result;
+}
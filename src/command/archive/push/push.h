@@ -0,0 +1,14 @@
+/***********************************************************************************************************************************
+Archive Push Command
+***********************************************************************************************************************************/
+#ifndef COMMAND_ARCHIVE_PUSH_H
+#define COMMAND_ARCHIVE_PUSH_H
+
+#include "common/type.h"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+bool cmdArchivePush();
+
+#endif
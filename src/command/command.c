@@ -0,0 +1,80 @@
+/***********************************************************************************************************************************
+Common Command Routines
+
+Log the beginning and end of a command the same way as commandBegin() and commandEnd() in lib/pgBackRest/Config/Config.pm.
+***********************************************************************************************************************************/
+#include <string.h>
+
+#include "command/command.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "config/config.h"
+#include "config/configRule.h"
+#include "version.h"
+
+/***********************************************************************************************************************************
+Value logged in place of secure options
+***********************************************************************************************************************************/
+#define COMMAND_SECURE_VALUE                                        "<redacted>"
+
+/***********************************************************************************************************************************
+Log the command begin with all options that were not set by default
+***********************************************************************************************************************************/
+void
+cmdBegin()
+{
+    // Only build the message if it will be logged
+    if (logWill(logLevelInfo))
+    {
+        // Add up the space required for the options
+        size_t infoSize = strlen(cfgCommandName(cfgCommand())) + sizeof(" command begin " PGBACKREST_VERSION ":");
+
+        for (int optionId = 0; optionId < CFGOPTDEF_TOTAL; optionId++)
+        {
+            if (cfgOptionTest(optionId) && cfgOptionSource(optionId) != cfgSourceDefault)
+            {
+                infoSize +=
+                    strlen(cfgOptionName(optionId)) + strlen(cfgOption(optionId)) + sizeof(" \"--no-=\"") +
+                    sizeof(COMMAND_SECURE_VALUE);
+            }
+        }
+
+        char *info = memNewRaw(infoSize);
+        char *infoPtr = info;
+
+        infoPtr += sprintf(infoPtr, "%s command begin " PGBACKREST_VERSION ":", cfgCommandName(cfgCommand()));
+
+        for (int optionId = 0; optionId < CFGOPTDEF_TOTAL; optionId++)
+        {
+            if (cfgOptionTest(optionId) && cfgOptionSource(optionId) != cfgSourceDefault)
+            {
+                const char *value = cfgRuleOptionSecure(optionId) ? COMMAND_SECURE_VALUE : cfgOption(optionId);
+                const char *quote = strchr(value, ' ') != NULL ? "\"" : "";
+
+                if (cfgRuleOptionType(optionId) == CFGOPTDEF_TYPE_BOOLEAN)
+                {
+                    infoPtr += sprintf(
+                        infoPtr, " %s--%s%s%s", quote, strcmp(value, CFGOPTVAL_FALSE) == 0 ? "no-" : "", cfgOptionName(optionId),
+                        quote);
+                }
+                else
+                    infoPtr += sprintf(infoPtr, " %s--%s=%s%s", quote, cfgOptionName(optionId), value, quote);
+            }
+        }
+
+        LOG_INFO("%s", info);
+        memFree(info);
+    }
+}
+
+/***********************************************************************************************************************************
+Log the command end
+***********************************************************************************************************************************/
+void
+cmdEnd(int code)
+{
+    if (code == 0)
+        LOG_INFO("%s command end: completed successfully", cfgCommandName(cfgCommand()));
+    else
+        LOG_INFO("%s command end: aborted with exception [%03d]", cfgCommandName(cfgCommand()), code);
+}
@@ -0,0 +1,13 @@
+/***********************************************************************************************************************************
+Common Command Routines
+***********************************************************************************************************************************/
+#ifndef COMMAND_H
+#define COMMAND_H
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void cmdBegin();
+void cmdEnd(int code);
+
+#endif
@@ -30,7 +30,21 @@ Define errors
 ***********************************************************************************************************************************/
 ERROR_DEFINE(ERROR_CODE_MIN, AssertError, RuntimeError);
 
+ERROR_DEFINE(ERROR_CODE_MIN + 01, ChecksumError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 03, FileInvalidError, RuntimeError);
 ERROR_DEFINE(ERROR_CODE_MIN + 04, FormatError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 16, FileOpenError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 17, FileReadError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 21, VersionNotSupportedError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 22, PathCreateError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 27, FileSyncError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 28, PathOpenError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 30, FileMissingError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 39, FileWriteError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 42, FeatureNotSupportedError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 48, PathMissingError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 49, FileMoveError, RuntimeError);
+ERROR_DEFINE(ERROR_CODE_MIN + 54, FileCloseError, RuntimeError);
 ERROR_DEFINE(ERROR_CODE_MIN + 69, MemoryError, RuntimeError);
 
 ERROR_DEFINE(ERROR_CODE_MAX, RuntimeError, RuntimeError);
@@ -16,7 +16,21 @@ typedef struct ErrorType ErrorType;
 // Error types
 ERROR_DECLARE(AssertError);
 
+ERROR_DECLARE(ChecksumError);
+ERROR_DECLARE(FileInvalidError);
 ERROR_DECLARE(FormatError);
+ERROR_DECLARE(FileOpenError);
+ERROR_DECLARE(FileReadError);
+ERROR_DECLARE(VersionNotSupportedError);
+ERROR_DECLARE(PathCreateError);
+ERROR_DECLARE(FileSyncError);
+ERROR_DECLARE(PathOpenError);
+ERROR_DECLARE(FileMissingError);
+ERROR_DECLARE(FileWriteError);
+ERROR_DECLARE(FeatureNotSupportedError);
+ERROR_DECLARE(PathMissingError);
+ERROR_DECLARE(FileMoveError);
+ERROR_DECLARE(FileCloseError);
 ERROR_DECLARE(MemoryError);
 
 ERROR_DECLARE(RuntimeError);
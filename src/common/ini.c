@@ -0,0 +1,269 @@
+/***********************************************************************************************************************************
+Ini Handler
+***********************************************************************************************************************************/
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/error.h"
+#include "common/ini.h"
+#include "common/memContext.h"
+#include "crypto/hash.h"
+
+/***********************************************************************************************************************************
+Contains information about the ini
+***********************************************************************************************************************************/
+struct Ini
+{
+    MemContext *memContext;                                         // Context that contains the ini
+    char *content;                                                  // Copy of the content that sections/keys/values point into
+    IniKeyValue *keyValueList;                                      // Key/value pairs in content order
+    unsigned int keyValueTotal;                                     // Total key/value pairs
+};
+
+/***********************************************************************************************************************************
+Trim whitespace from both ends of a line in place
+***********************************************************************************************************************************/
+static char *
+iniTrim(char *line)
+{
+    while (isspace((unsigned char)*line))
+        line++;
+
+    char *end = line + strlen(line);
+
+    while (end > line && isspace((unsigned char)*(end - 1)))
+        end--;
+
+    *end = '\0';
+
+    return line;
+}
+
+/***********************************************************************************************************************************
+Create an ini object from content
+
+Lines are trimmed and blank lines or comments (#) are skipped.  The section name is everything between the first and last characters
+of a line that starts with [ and the key is everything before the first = on the line, neither of which are trimmed further.
+***********************************************************************************************************************************/
+Ini *
+iniNew(const char *content)
+{
+    Ini *volatile this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("ini")
+    {
+        this = memNew(sizeof(Ini));
+        this->memContext = MEM_CONTEXT_NEW();
+
+        // Copy the content so it can be split in place
+        size_t contentSize = strlen(content);
+        this->content = memNewRaw(contentSize + 1);
+        memcpy(this->content, content, contentSize + 1);
+
+        // There cannot be more key/value pairs than lines
+        unsigned int lineTotal = 1;
+
+        for (const char *contentPtr = content; *contentPtr != '\0'; contentPtr++)
+        {
+            if (*contentPtr == '\n')
+                lineTotal++;
+        }
+
+        this->keyValueList = memNew(sizeof(IniKeyValue) * lineTotal);
+
+        // Parse each line
+        const char *section = NULL;
+        char *linePtr = this->content;
+
+        while (linePtr != NULL)
+        {
+            char *lineEnd = strchr(linePtr, '\n');
+
+            if (lineEnd != NULL)
+                *lineEnd = '\0';
+
+            char *line = iniTrim(linePtr);
+            linePtr = lineEnd == NULL ? NULL : lineEnd + 1;
+
+            // Skip lines that are blank or comments
+            if (line[0] == '\0' || line[0] == '#')
+                continue;
+
+            // Get the section
+            if (line[0] == '[')
+            {
+                line[strlen(line) - 1] = '\0';
+                section = line + 1;
+                continue;
+            }
+
+            if (section == NULL)
+                ERROR_THROW(FormatError, "key/value pair '%s' found outside of a section", line);
+
+            // Get key and value
+            char *value = strchr(line, '=');
+
+            if (value == NULL)
+                ERROR_THROW(FormatError, "unable to find '=' in '%s'", line);
+
+            *value = '\0';
+
+            this->keyValueList[this->keyValueTotal] = (IniKeyValue){.section = section, .key = line, .value = value + 1};
+            this->keyValueTotal++;
+        }
+    }
+    MEM_CONTEXT_NEW_END();
+
+    return this;
+}
+
+/***********************************************************************************************************************************
+Get a value or NULL if the key does not exist
+
+An error is thrown if the key appears more than once in the section since there is no single value to return.
+***********************************************************************************************************************************/
+const char *
+iniGet(const Ini *this, const char *section, const char *key)
+{
+    const char *result = NULL;
+
+    for (unsigned int keyValueIdx = 0; keyValueIdx < this->keyValueTotal; keyValueIdx++)
+    {
+        const IniKeyValue *keyValue = &this->keyValueList[keyValueIdx];
+
+        if (strcmp(keyValue->section, section) == 0 && strcmp(keyValue->key, key) == 0)
+        {
+            if (result != NULL)
+                ERROR_THROW(FormatError, "key '%s' is duplicated in section '%s'", key, section);
+
+            result = keyValue->value;
+        }
+    }
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Get a key/value pair by index
+***********************************************************************************************************************************/
+const IniKeyValue *
+iniKeyValue(const Ini *this, unsigned int keyValueIdx)
+{
+    if (keyValueIdx >= this->keyValueTotal)
+        ERROR_THROW(AssertError, "key/value index %u is out of bounds", keyValueIdx);
+
+    return &this->keyValueList[keyValueIdx];
+}
+
+/***********************************************************************************************************************************
+Total key/value pairs
+***********************************************************************************************************************************/
+unsigned int
+iniKeyValueTotal(const Ini *this)
+{
+    return this->keyValueTotal;
+}
+
+/***********************************************************************************************************************************
+Sort key/value pairs by section and then key
+***********************************************************************************************************************************/
+static int
+iniKeyValueCompare(const void *keyValue1, const void *keyValue2)
+{
+    const IniKeyValue *kv1 = *(const IniKeyValue **)keyValue1;
+    const IniKeyValue *kv2 = *(const IniKeyValue **)keyValue2;
+
+    int result = strcmp(kv1->section, kv2->section);
+
+    return result != 0 ? result : strcmp(kv1->key, kv2->key);
+}
+
+/***********************************************************************************************************************************
+Can the name be rendered in JSON without escapes?  Names that cannot are not supported by iniChecksum().
+***********************************************************************************************************************************/
+static void
+iniChecksumName(const char *name)
+{
+    for (const char *namePtr = name; *namePtr != '\0'; namePtr++)
+    {
+        if (*namePtr < 0x20 || *namePtr > 0x7E || *namePtr == '"' || *namePtr == '\\')
+            ERROR_THROW(FormatError, "unable to checksum name '%s' that requires escapes", name);
+    }
+}
+
+/***********************************************************************************************************************************
+Calculate the checksum of the content the same way as render() in lib/pgBackRest/Common/Ini.pm
+
+The checksum is the SHA1 of the canonical JSON encoding of the content with the checksum key itself skipped.  The values are already
+JSON so they are used as they appear in the content -- this matches the Perl checksum as long as the values are rendered the way the
+Perl encoder renders them, which is always the case for files written by pgBackRest.
+***********************************************************************************************************************************/
+void
+iniChecksum(const Ini *this, const char *sectionSkip, const char *keySkip, char *checksum)
+{
+    // Sort the key/value pairs and calculate the size of the JSON
+    const IniKeyValue **keyValueList = memNewRaw(sizeof(IniKeyValue *) * (this->keyValueTotal + 1));
+    unsigned int keyValueTotal = 0;
+    size_t jsonSize = 2;
+
+    for (unsigned int keyValueIdx = 0; keyValueIdx < this->keyValueTotal; keyValueIdx++)
+    {
+        const IniKeyValue *keyValue = &this->keyValueList[keyValueIdx];
+
+        if (strcmp(keyValue->section, sectionSkip) == 0 && strcmp(keyValue->key, keySkip) == 0)
+            continue;
+
+        iniChecksumName(keyValue->section);
+        iniChecksumName(keyValue->key);
+
+        keyValueList[keyValueTotal++] = keyValue;
+        jsonSize += strlen(keyValue->section) + strlen(keyValue->key) + strlen(keyValue->value) + 10;
+    }
+
+    qsort(keyValueList, keyValueTotal, sizeof(IniKeyValue *), iniKeyValueCompare);
+
+    // Render the JSON
+    char *json = memNewRaw(jsonSize + 1);
+    char *jsonPtr = json;
+
+    *jsonPtr++ = '{';
+
+    for (unsigned int keyValueIdx = 0; keyValueIdx < keyValueTotal; keyValueIdx++)
+    {
+        const IniKeyValue *keyValue = keyValueList[keyValueIdx];
+        const IniKeyValue *keyValuePrior = keyValueIdx == 0 ? NULL : keyValueList[keyValueIdx - 1];
+
+        // Start a new section
+        if (keyValuePrior == NULL || strcmp(keyValuePrior->section, keyValue->section) != 0)
+        {
+            jsonPtr += sprintf(jsonPtr, "%s\"%s\":{", keyValuePrior == NULL ? "" : "},", keyValue->section);
+        }
+        // Else duplicate keys would be merged by the Perl parser so the checksum would not match
+        else if (strcmp(keyValuePrior->key, keyValue->key) == 0)
+        {
+            ERROR_THROW(FormatError, "unable to checksum duplicate key '%s' in section '%s'", keyValue->key, keyValue->section);
+        }
+        else
+            *jsonPtr++ = ',';
+
+        jsonPtr += sprintf(jsonPtr, "\"%s\":%s", keyValue->key, keyValue->value);
+    }
+
+    jsonPtr += sprintf(jsonPtr, "%s}", keyValueTotal == 0 ? "" : "}");
+
+    cryptoHashOne(HASH_TYPE_SHA1, (unsigned char *)json, (size_t)(jsonPtr - json), checksum);
+
+    memFree(json);
+    memFree(keyValueList);
+}
+
+/***********************************************************************************************************************************
+Free the ini
+***********************************************************************************************************************************/
+void
+iniFree(Ini *this)
+{
+    if (this != NULL)
+        memContextFree(this->memContext);
+}
@@ -0,0 +1,37 @@
+/***********************************************************************************************************************************
+Ini Handler
+
+Parse ini content the same way as iniParse() in lib/pgBackRest/Common/Ini.pm.  Values are stored as they appear in the content, so
+values in info files are still JSON encoded.
+***********************************************************************************************************************************/
+#ifndef COMMON_INI_H
+#define COMMON_INI_H
+
+#include "common/type.h"
+
+/***********************************************************************************************************************************
+Ini object
+***********************************************************************************************************************************/
+typedef struct Ini Ini;
+
+/***********************************************************************************************************************************
+Key/value pair in the order that it was found in the content
+***********************************************************************************************************************************/
+typedef struct IniKeyValue
+{
+    const char *section;
+    const char *key;
+    const char *value;
+} IniKeyValue;
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+Ini *iniNew(const char *content);
+const char *iniGet(const Ini *this, const char *section, const char *key);
+const IniKeyValue *iniKeyValue(const Ini *this, unsigned int keyValueIdx);
+unsigned int iniKeyValueTotal(const Ini *this);
+void iniChecksum(const Ini *this, const char *sectionSkip, const char *keySkip, char *checksum);
+void iniFree(Ini *this);
+
+#endif
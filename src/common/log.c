@@ -0,0 +1,271 @@
+/***********************************************************************************************************************************
+Log Handler
+***********************************************************************************************************************************/
+#define _POSIX_C_SOURCE                                             200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common/error.h"
+#include "common/log.h"
+#include "common/memContext.h"
+
+/***********************************************************************************************************************************
+Log settings -- the defaults match the Perl logger before the configuration is loaded
+***********************************************************************************************************************************/
+static LogLevel logLevelConsole = logLevelOff;
+static LogLevel logLevelStdErr = logLevelWarn;
+static LogLevel logLevelFile = logLevelOff;
+static bool logTimestamp = true;
+
+/***********************************************************************************************************************************
+Log file handle and whether the process start banner has been written to it
+***********************************************************************************************************************************/
+static int logHandleFile = -1;
+static bool logFileExists = false;
+static bool logFileFirst = false;
+
+#define LOG_BANNER                                                  "-------------------PROCESS START-------------------\n"
+
+/***********************************************************************************************************************************
+Continuation lines are indented so they align with the first line of the message
+***********************************************************************************************************************************/
+#define LOG_INDENT_TIMESTAMP                                        "                                        "
+#define LOG_INDENT                                                  "            "
+
+/***********************************************************************************************************************************
+Log level names indexed by LogLevel
+***********************************************************************************************************************************/
+static const char *logLevelList[] =
+{
+    "OFF",
+    "ASSERT",
+    "ERROR",
+    "PROTOCOL",
+    "WARN",
+    "INFO",
+    "DETAIL",
+    "DEBUG",
+    "TRACE",
+};
+
+#define LOG_LEVEL_TOTAL                                             (sizeof(logLevelList) / sizeof(char *))
+
+/***********************************************************************************************************************************
+Convert log level string to enum (case-insensitive)
+***********************************************************************************************************************************/
+LogLevel
+logLevelEnum(const char *logLevel)
+{
+    int result = -1;
+
+    for (unsigned int logLevelIdx = 0; logLevelIdx < LOG_LEVEL_TOTAL; logLevelIdx++)
+    {
+        if (strcasecmp(logLevel, logLevelList[logLevelIdx]) == 0)
+            result = (int)logLevelIdx;
+    }
+
+    if (result == -1)
+        ERROR_THROW(AssertError, "log level '%s' does not exist", logLevel);
+
+    return (LogLevel)result;
+}
+
+/***********************************************************************************************************************************
+Convert log level enum to string
+***********************************************************************************************************************************/
+const char *
+logLevelStr(LogLevel logLevel)
+{
+    if ((unsigned int)logLevel >= LOG_LEVEL_TOTAL)
+        ERROR_THROW(AssertError, "invalid log level '%d'", (int)logLevel);
+
+    return logLevelList[logLevel];
+}
+
+/***********************************************************************************************************************************
+Initialize the log system
+***********************************************************************************************************************************/
+void
+logInit(LogLevel logLevelConsoleParam, LogLevel logLevelStdErrParam, LogLevel logLevelFileParam, bool logTimestampParam)
+{
+    logLevelConsole = logLevelConsoleParam;
+    logLevelStdErr = logLevelStdErrParam;
+    logLevelFile = logLevelFileParam;
+    logTimestamp = logTimestampParam;
+}
+
+/***********************************************************************************************************************************
+Set the log file
+
+The file is only opened when file logging is enabled.  Any file that was already open is closed.
+***********************************************************************************************************************************/
+void
+logFileSet(const char *logFile)
+{
+    if (logHandleFile != -1)
+    {
+        close(logHandleFile);
+        logHandleFile = -1;
+    }
+
+    if (logLevelFile != logLevelOff)
+    {
+        logFileExists = access(logFile, F_OK) == 0;
+        logFileFirst = true;
+
+        logHandleFile = open(logFile, O_WRONLY | O_CREAT | O_APPEND, 0660);
+
+        if (logHandleFile == -1)
+            ERROR_THROW(FileOpenError, "unable to open log file '%s': %s", logFile, strerror(errno));
+    }
+}
+
+/***********************************************************************************************************************************
+Will a message at this level be output anywhere?
+***********************************************************************************************************************************/
+bool
+logWill(LogLevel logLevel)
+{
+    return logLevel <= logLevelStdErr || logLevel <= logLevelConsole || (logLevel <= logLevelFile && logHandleFile != -1);
+}
+
+/***********************************************************************************************************************************
+Write a buffer to a file descriptor, ignoring errors like the Perl logger does
+***********************************************************************************************************************************/
+static void
+logWrite(int fd, const char *buffer, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t result = write(fd, buffer, size);
+
+        if (result <= 0)
+            break;
+
+        buffer += result;
+        size -= (size_t)result;
+    }
+}
+
+/***********************************************************************************************************************************
+General log function
+***********************************************************************************************************************************/
+void
+logInternal(LogLevel logLevel, int code, const char *format, ...)
+{
+    if (!logWill(logLevel))
+        return;
+
+    // Format the message
+    va_list argumentList;
+    va_start(argumentList, format);
+    int messageSize = vsnprintf(NULL, 0, format, argumentList);
+    va_end(argumentList);
+
+    char *message = memNewRaw((size_t)messageSize + 1);
+
+    va_start(argumentList, format);
+    vsnprintf(message, (size_t)messageSize + 1, format, argumentList);
+    va_end(argumentList);
+
+    // Output to stderr when the level is included in the stderr level.  Only the level and the raw message are written.
+    if (logLevel <= logLevelStdErr)
+    {
+        char prefix[64] = "";
+
+        if (logLevelStdErr != logLevelProtocol)
+        {
+            if (code != 0)
+                snprintf(prefix, sizeof(prefix), "%s [%03d]: : ", logLevelStr(logLevel), code);
+            else
+                snprintf(prefix, sizeof(prefix), "%s: ", logLevelStr(logLevel));
+        }
+
+        logWrite(STDERR_FILENO, prefix, strlen(prefix));
+        logWrite(STDERR_FILENO, message, (size_t)messageSize);
+        logWrite(STDERR_FILENO, "\n", 1);
+    }
+    // Format the message with timestamp, process id, and level for stdout and the log file
+    bool logConsole = logLevel > logLevelStdErr && logLevel <= logLevelConsole;
+    bool logFile = logLevel <= logLevelFile && logHandleFile != -1;
+
+    if (logConsole || logFile)
+    {
+        const char *indent = logTimestamp ? LOG_INDENT_TIMESTAMP : LOG_INDENT;
+        size_t lineTotal = 1;
+
+        for (const char *messagePtr = message; *messagePtr != '\0'; messagePtr++)
+        {
+            if (*messagePtr == '\n')
+                lineTotal++;
+        }
+
+        // Prefix is the timestamp (24 bytes), process id (3 bytes), padded level (9 bytes), and code (7 bytes)
+        size_t bufferSize = 64 + (size_t)messageSize + (lineTotal - 1) * strlen(indent) + 2;
+        char *buffer = memNewRaw(bufferSize);
+        size_t bufferPos = 0;
+
+        if (logTimestamp)
+        {
+            struct timeval timeNow;
+            gettimeofday(&timeNow, NULL);
+
+            struct tm timeLocal;
+            localtime_r(&timeNow.tv_sec, &timeLocal);
+
+            bufferPos += strftime(buffer, bufferSize, "%Y-%m-%d %H:%M:%S", &timeLocal);
+            bufferPos += (size_t)snprintf(buffer + bufferPos, bufferSize - bufferPos, ".%03d ", (int)(timeNow.tv_usec / 1000));
+        }
+
+        bufferPos += (size_t)snprintf(
+            buffer + bufferPos, bufferSize - bufferPos, "P00%*s: ", 7, logLevelStr(logLevel));
+
+        if (code != 0)
+            bufferPos += (size_t)snprintf(buffer + bufferPos, bufferSize - bufferPos, "[%03d]: ", code);
+
+        // Indent subsequent lines of the message
+        for (const char *messagePtr = message; *messagePtr != '\0'; messagePtr++)
+        {
+            buffer[bufferPos++] = *messagePtr;
+
+            if (*messagePtr == '\n')
+            {
+                memcpy(buffer + bufferPos, indent, strlen(indent));
+                bufferPos += strlen(indent);
+            }
+        }
+
+        buffer[bufferPos++] = '\n';
+
+        // Output to stdout when the message was not output to stderr
+        if (logConsole)
+            logWrite(STDOUT_FILENO, buffer, bufferPos);
+
+        // Output to the log file, with a banner before the first message written by this process
+        if (logFile)
+        {
+            if (logFileFirst)
+            {
+                if (logFileExists)
+                    logWrite(logHandleFile, "\n", 1);
+
+                logWrite(logHandleFile, LOG_BANNER, strlen(LOG_BANNER));
+                logFileFirst = false;
+            }
+
+            logWrite(logHandleFile, buffer, bufferPos);
+        }
+
+        memFree(buffer);
+    }
+
+    memFree(message);
+}
@@ -0,0 +1,54 @@
+/***********************************************************************************************************************************
+Log Handler
+
+Messages are formatted exactly as the Perl logger formats them (see lib/pgBackRest/Common/Log.pm) so output does not change based on
+which code path logged it.  Output can go to the console, stderr, and a log file.
+***********************************************************************************************************************************/
+#ifndef COMMON_LOG_H
+#define COMMON_LOG_H
+
+#include "common/type.h"
+
+/***********************************************************************************************************************************
+Log levels in order of rank, i.e. a level includes all the levels before it
+***********************************************************************************************************************************/
+typedef enum
+{
+    logLevelOff,
+    logLevelAssert,
+    logLevelError,
+    logLevelProtocol,
+    logLevelWarn,
+    logLevelInfo,
+    logLevelDetail,
+    logLevelDebug,
+    logLevelTrace,
+} LogLevel;
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+LogLevel logLevelEnum(const char *logLevel);
+const char *logLevelStr(LogLevel logLevel);
+void logInit(LogLevel logLevelConsole, LogLevel logLevelStdErr, LogLevel logLevelFile, bool logTimestamp);
+void logFileSet(const char *logFile);
+bool logWill(LogLevel logLevel);
+
+/***********************************************************************************************************************************
+Macros
+
+Only the levels used by C code are defined.
+***********************************************************************************************************************************/
+#define LOG_INFO(...)                                                                                                              \
+    logInternal(logLevelInfo, 0, __VA_ARGS__)
+#define LOG_WARN(...)                                                                                                              \
+    logInternal(logLevelWarn, 0, __VA_ARGS__)
+
+/***********************************************************************************************************************************
+Internal functions
+
+These functions are used by the macros and should not be called directly.
+***********************************************************************************************************************************/
+void logInternal(LogLevel logLevel, int code, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+#endif
@@ -1,6 +1,224 @@
 /***********************************************************************************************************************************
 Command and Option Configuration
 ***********************************************************************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/error.h"
+#include "common/memContext.h"
 #include "config/config.h"
 
 #include "config.auto.c"
+
+/***********************************************************************************************************************************
+Memory context that contains the option values
+***********************************************************************************************************************************/
+static MemContext *configMemContext = NULL;
+
+/***********************************************************************************************************************************
+Current command and parameters
+***********************************************************************************************************************************/
+static int command = -1;
+static unsigned int commandParamTotal = 0;
+static const char **commandParamList = NULL;
+
+/***********************************************************************************************************************************
+Option values
+***********************************************************************************************************************************/
+static struct
+{
+    bool valid;                                                     // Is the option valid for the command?
+    ConfigSource source;                                            // Where the value came from
+    const char *value;                                              // Value or NULL when not set
+} configOptionValue[CFGOPTDEF_TOTAL];
+
+/***********************************************************************************************************************************
+Initialize (or reinitialize) the configuration
+***********************************************************************************************************************************/
+void
+cfgInit()
+{
+    if (configMemContext != NULL)
+        memContextFree(configMemContext);
+
+    MEM_CONTEXT_BEGIN(memContextTop())
+    {
+        configMemContext = memContextNew("configuration");
+    }
+    MEM_CONTEXT_END();
+
+    command = -1;
+    commandParamTotal = 0;
+    commandParamList = NULL;
+
+    memset(configOptionValue, 0, sizeof(configOptionValue));
+}
+
+/***********************************************************************************************************************************
+Get/set the current command
+***********************************************************************************************************************************/
+int
+cfgCommand()
+{
+    return command;
+}
+
+void
+cfgCommandSet(int commandId)
+{
+    if (cfgCommandName(commandId) == NULL)
+        ERROR_THROW(AssertError, "command id %d is invalid", commandId);
+
+    command = commandId;
+}
+
+/***********************************************************************************************************************************
+Get/set the command parameters, i.e. the arguments after the command that are not options
+
+The list is copied but the parameters are not so they must exist as long as the configuration does (e.g. argv).
+***********************************************************************************************************************************/
+const char *
+cfgCommandParam(unsigned int paramIdx)
+{
+    if (paramIdx >= commandParamTotal)
+        ERROR_THROW(AssertError, "command parameter %u does not exist", paramIdx);
+
+    return commandParamList[paramIdx];
+}
+
+unsigned int
+cfgCommandParamTotal()
+{
+    return commandParamTotal;
+}
+
+void
+cfgCommandParamSet(unsigned int paramTotal, const char **paramList)
+{
+    if (configMemContext == NULL)
+        ERROR_THROW(AssertError, "configuration is not initialized");
+
+    MEM_CONTEXT_BEGIN(configMemContext)
+    {
+        commandParamList = memNewRaw(sizeof(const char *) * (paramTotal == 0 ? 1 : paramTotal));
+    }
+    MEM_CONTEXT_END();
+
+    for (unsigned int paramIdx = 0; paramIdx < paramTotal; paramIdx++)
+        commandParamList[paramIdx] = paramList[paramIdx];
+
+    commandParamTotal = paramTotal;
+}
+
+/***********************************************************************************************************************************
+Check that an option id is in range
+***********************************************************************************************************************************/
+static void
+cfgOptionCheck(int optionId)
+{
+    if (optionId < 0 || optionId >= CFGOPTDEF_TOTAL)
+        ERROR_THROW(AssertError, "option id %d is invalid", optionId);
+}
+
+/***********************************************************************************************************************************
+Get option value as a string or NULL when the option is not set
+***********************************************************************************************************************************/
+const char *
+cfgOption(int optionId)
+{
+    cfgOptionCheck(optionId);
+
+    if (!configOptionValue[optionId].valid)
+        ERROR_THROW(AssertError, "option '%s' is not valid for the current command", cfgOptionName(optionId));
+
+    return configOptionValue[optionId].value;
+}
+
+/***********************************************************************************************************************************
+Get a boolean option value -- an option that is not set is false
+***********************************************************************************************************************************/
+bool
+cfgOptionBool(int optionId)
+{
+    const char *value = cfgOption(optionId);
+
+    return value != NULL && strcmp(value, CFGOPTVAL_TRUE) == 0;
+}
+
+/***********************************************************************************************************************************
+Get an integer option value, which must be set
+***********************************************************************************************************************************/
+int64
+cfgOptionInt64(int optionId)
+{
+    const char *value = cfgOption(optionId);
+
+    if (value == NULL)
+        ERROR_THROW(AssertError, "option '%s' is required", cfgOptionName(optionId));
+
+    return strtoll(value, NULL, 10);
+}
+
+/***********************************************************************************************************************************
+Set option value and source.  The value is copied so the original does not need to be preserved.
+***********************************************************************************************************************************/
+void
+cfgOptionSet(int optionId, ConfigSource source, const char *value)
+{
+    cfgOptionCheck(optionId);
+
+    if (configMemContext == NULL)
+        ERROR_THROW(AssertError, "configuration is not initialized");
+
+    char *valueCopy = NULL;
+
+    if (value != NULL)
+    {
+        MEM_CONTEXT_BEGIN(configMemContext)
+        {
+            valueCopy = memNewRaw(strlen(value) + 1);
+            strcpy(valueCopy, value);
+        }
+        MEM_CONTEXT_END();
+    }
+
+    configOptionValue[optionId].source = source;
+    configOptionValue[optionId].value = valueCopy;
+}
+
+/***********************************************************************************************************************************
+Where did the option value come from?
+***********************************************************************************************************************************/
+ConfigSource
+cfgOptionSource(int optionId)
+{
+    cfgOptionCheck(optionId);
+    return configOptionValue[optionId].source;
+}
+
+/***********************************************************************************************************************************
+Is the option valid for the command and set?
+***********************************************************************************************************************************/
+bool
+cfgOptionTest(int optionId)
+{
+    cfgOptionCheck(optionId);
+    return configOptionValue[optionId].valid && configOptionValue[optionId].value != NULL;
+}
+
+/***********************************************************************************************************************************
+Get/set whether the option is valid for the command
+***********************************************************************************************************************************/
+bool
+cfgOptionValid(int optionId)
+{
+    cfgOptionCheck(optionId);
+    return configOptionValue[optionId].valid;
+}
+
+void
+cfgOptionValidSet(int optionId, bool valid)
+{
+    cfgOptionCheck(optionId);
+    configOptionValue[optionId].valid = valid;
+}
@@ -7,6 +7,22 @@ Command and Option Configuration
 #include "common/type.h"
 #include "config/config.auto.h"
 
+/***********************************************************************************************************************************
+Where did the option value come from?
+***********************************************************************************************************************************/
+typedef enum
+{
+    cfgSourceDefault,                                               // Default value
+    cfgSourceParam,                                                 // Passed on the command line
+    cfgSourceConfig,                                                // Loaded from the config file
+} ConfigSource;
+
+/***********************************************************************************************************************************
+Boolean option values are stored as these strings
+***********************************************************************************************************************************/
+#define CFGOPTVAL_TRUE                                              "1"
+#define CFGOPTVAL_FALSE                                             "0"
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
@@ -14,4 +30,21 @@ const char *cfgCommandName(int commandId);
 int cfgOptionIndexTotal(int optionId);
 const char *cfgOptionName(int commandId);
 
+void cfgInit();
+
+int cfgCommand();
+void cfgCommandSet(int commandId);
+const char *cfgCommandParam(unsigned int paramIdx);
+unsigned int cfgCommandParamTotal();
+void cfgCommandParamSet(unsigned int paramTotal, const char **paramList);
+
+const char *cfgOption(int optionId);
+bool cfgOptionBool(int optionId);
+int64 cfgOptionInt64(int optionId);
+void cfgOptionSet(int optionId, ConfigSource source, const char *value);
+ConfigSource cfgOptionSource(int optionId);
+bool cfgOptionTest(int optionId);
+bool cfgOptionValid(int optionId);
+void cfgOptionValidSet(int optionId, bool valid);
+
 #endif
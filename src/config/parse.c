@@ -0,0 +1,495 @@
+/***********************************************************************************************************************************
+Parse Command Line and Config File
+***********************************************************************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/error.h"
+#include "common/ini.h"
+#include "common/memContext.h"
+#include "config/config.h"
+#include "config/configRule.h"
+#include "config/parse.h"
+#include "storage/posix/storage.h"
+
+/***********************************************************************************************************************************
+Section names in the config file
+***********************************************************************************************************************************/
+#define CONFIG_SECTION_GLOBAL                                       "global"
+#define CONFIG_SECTION_STANZA                                       "stanza"
+
+/***********************************************************************************************************************************
+Integers with more digits than this are not parsed since Perl may store them as floats and log them differently
+***********************************************************************************************************************************/
+#define PARSE_INTEGER_DIGIT_MAX                                     15
+
+/***********************************************************************************************************************************
+Parse state
+***********************************************************************************************************************************/
+typedef struct ParseData
+{
+    int commandId;                                                  // Command being parsed
+
+    struct
+    {
+        bool found;                                                 // Was the option found on the command line?
+        bool negate;                                                // Was the option negated, e.g. --no-compress?
+        const char *value;                                          // Value from the command line
+        bool resolved;                                              // Has the option been resolved?
+    } optionList[CFGOPTDEF_TOTAL];
+
+    bool configLoaded;                                              // Has an attempt been made to load the config file?
+    Ini *config;                                                    // Config file, NULL if it does not exist or is disabled
+} ParseData;
+
+/***********************************************************************************************************************************
+Find an option by name or alternate name, returns -1 if not found
+***********************************************************************************************************************************/
+static int
+parseOptionFind(const char *name, size_t nameSize)
+{
+    for (int optionId = 0; optionId < CFGOPTDEF_TOTAL; optionId++)
+    {
+        const char *optionName = cfgOptionName(optionId);
+        const char *optionNameAlt = cfgRuleOptionNameAlt(optionId);
+
+        if ((strlen(optionName) == nameSize && strncmp(optionName, name, nameSize) == 0) ||
+            (optionNameAlt != NULL && strlen(optionNameAlt) == nameSize && strncmp(optionNameAlt, name, nameSize) == 0))
+        {
+            return optionId;
+        }
+    }
+
+    return -1;
+}
+
+/***********************************************************************************************************************************
+Is the value an integer or float that Perl will accept and store exactly as written?
+***********************************************************************************************************************************/
+static bool
+parseNumberValid(const char *value, bool integer)
+{
+    const char *valuePtr = value[0] == '-' ? value + 1 : value;
+    size_t digitTotal = strspn(valuePtr, "0123456789");
+
+    if (digitTotal == 0)
+        return false;
+
+    if (integer)
+        return valuePtr[digitTotal] == '\0' && (valuePtr[0] != '0' || (digitTotal == 1 && value == valuePtr)) &&
+            digitTotal <= PARSE_INTEGER_DIGIT_MAX;
+
+    valuePtr += digitTotal;
+
+    if (valuePtr[0] == '.')
+    {
+        digitTotal = strspn(valuePtr + 1, "0123456789");
+
+        if (digitTotal == 0)
+            return false;
+
+        valuePtr += digitTotal + 1;
+    }
+
+    return valuePtr[0] == '\0';
+}
+
+/***********************************************************************************************************************************
+Load the config file the first time an option is looked up in it
+***********************************************************************************************************************************/
+static void
+parseConfigLoad(ParseData *data)
+{
+    if (!data->configLoaded)
+    {
+        data->configLoaded = true;
+
+        // A config file that does not exist is not an error, but one that is not a regular file is and will fail on read
+        if (cfgOptionValid(CFGOPT_CONFIG) && cfgOption(CFGOPT_CONFIG) != NULL && storagePosixExists(cfgOption(CFGOPT_CONFIG)))
+        {
+            unsigned char *content = storagePosixGet(cfgOption(CFGOPT_CONFIG), false, NULL);
+            data->config = iniNew((const char *)content);
+            memFree(content);
+        }
+    }
+}
+
+/***********************************************************************************************************************************
+Get an option value from a config section.  Returns false if the option and its alternate name are both set, since that is an error.
+A key that appears more than once in the section throws an error when read.
+***********************************************************************************************************************************/
+static bool
+parseConfigValue(ParseData *data, const char *section, int optionId, const char **value)
+{
+    *value = iniGet(data->config, section, cfgOptionName(optionId));
+
+    if (cfgRuleOptionNameAlt(optionId) != NULL)
+    {
+        const char *valueAlt = iniGet(data->config, section, cfgRuleOptionNameAlt(optionId));
+
+        if (valueAlt != NULL)
+        {
+            if (*value != NULL)
+                return false;
+
+            *value = valueAlt;
+        }
+    }
+
+    return true;
+}
+
+/***********************************************************************************************************************************
+Look up an option in the config file sections in the same order as Perl: the stanza section, then (for options that are not stanza
+only) the stanza command section, the global command section, and the global section
+***********************************************************************************************************************************/
+static bool
+parseConfigLookup(ParseData *data, int optionId, const char **value)
+{
+    const char *commandName = cfgCommandName(data->commandId);
+    const char *stanza = cfgOptionValid(CFGOPT_STANZA) ? cfgOption(CFGOPT_STANZA) : NULL;
+    char section[1024];
+
+    *value = NULL;
+
+    if (stanza != NULL && !parseConfigValue(data, stanza, optionId, value))
+        return false;
+
+    if (*value == NULL && strcmp(cfgRuleOptionSection(optionId), CONFIG_SECTION_STANZA) != 0)
+    {
+        if (stanza != NULL)
+        {
+            snprintf(section, sizeof(section), "%s:%s", stanza, commandName);
+
+            if (!parseConfigValue(data, section, optionId, value))
+                return false;
+        }
+
+        if (*value == NULL)
+        {
+            snprintf(section, sizeof(section), CONFIG_SECTION_GLOBAL ":%s", commandName);
+
+            if (!parseConfigValue(data, section, optionId, value))
+                return false;
+        }
+
+        if (*value == NULL && !parseConfigValue(data, CONFIG_SECTION_GLOBAL, optionId, value))
+            return false;
+    }
+
+    return true;
+}
+
+/***********************************************************************************************************************************
+Resolve an option after the option it depends on (and the config and stanza options if the config file is needed)
+***********************************************************************************************************************************/
+static bool
+parseOptionResolve(ParseData *data, int optionId)
+{
+    if (data->optionList[optionId].resolved)
+        return true;
+
+    data->optionList[optionId].resolved = true;
+
+    // Options that are not valid for the command are not set
+    if (!cfgRuleOptionValid(data->commandId, optionId))
+        return true;
+
+    cfgOptionValidSet(optionId, true);
+
+    int optionType = cfgRuleOptionType(optionId);
+    bool negate = data->optionList[optionId].negate;
+    const char *value = data->optionList[optionId].value;
+    ConfigSource source = cfgSourceParam;
+
+    if (negate && optionType == CFGOPTDEF_TYPE_BOOLEAN)
+        value = CFGOPTVAL_FALSE;
+
+    // Check that the option it depends on has a valid value
+    bool dependResolved = true;
+
+    if (cfgRuleOptionDepend(data->commandId, optionId))
+    {
+        int dependOptionId = cfgRuleOptionDependOption(data->commandId, optionId);
+
+        if (!parseOptionResolve(data, dependOptionId))
+            return false;
+
+        const char *dependValue = cfgOptionValid(dependOptionId) ? cfgOption(dependOptionId) : NULL;
+        int dependValueTotal = cfgRuleOptionDependValueTotal(data->commandId, optionId);
+
+        if (dependValue == NULL ||
+            (dependValueTotal == 1 && strcmp(cfgRuleOptionDependValue(data->commandId, optionId, 0), dependValue) != 0) ||
+            (dependValueTotal > 1 && !cfgRuleOptionDependValueValid(data->commandId, optionId, dependValue)))
+        {
+            dependResolved = false;
+        }
+    }
+
+    // Look for the option in the config file if it was not set on the command line
+    if (value == NULL && !negate && optionId != CFGOPT_CONFIG && cfgRuleOptionSection(optionId) != NULL && dependResolved)
+    {
+        if (!parseOptionResolve(data, CFGOPT_CONFIG) || !parseOptionResolve(data, CFGOPT_STANZA))
+            return false;
+
+        parseConfigLoad(data);
+
+        if (data->config != NULL)
+        {
+            if (!parseConfigLookup(data, optionId, &value))
+                return false;
+
+            if (value != NULL)
+            {
+                // The empty string is the same as not set
+                if (value[0] == '\0')
+                    value = NULL;
+                // Booleans must be y or n
+                else if (optionType == CFGOPTDEF_TYPE_BOOLEAN)
+                {
+                    if (strcmp(value, "y") == 0)
+                        value = CFGOPTVAL_TRUE;
+                    else if (strcmp(value, "n") == 0)
+                        value = CFGOPTVAL_FALSE;
+                    else
+                        return false;
+                }
+                // Hash and list options are left to Perl
+                else if (optionType == CFGOPTDEF_TYPE_HASH || optionType == CFGOPTDEF_TYPE_LIST)
+                    return false;
+
+                source = cfgSourceConfig;
+            }
+        }
+    }
+
+    // A value is not allowed when the dependency is not resolved
+    if (value != NULL && !dependResolved)
+        return false;
+
+    if (value != NULL)
+    {
+        if ((optionType == CFGOPTDEF_TYPE_INTEGER || optionType == CFGOPTDEF_TYPE_FLOAT) &&
+            !parseNumberValid(value, optionType == CFGOPTDEF_TYPE_INTEGER))
+        {
+            return false;
+        }
+
+        if (cfgRuleOptionAllowList(data->commandId, optionId) &&
+            !cfgRuleOptionAllowListValueValid(data->commandId, optionId, value))
+        {
+            return false;
+        }
+
+        if (cfgRuleOptionAllowRange(data->commandId, optionId) &&
+            (atof(value) < cfgRuleOptionAllowRangeMin(data->commandId, optionId) ||
+             atof(value) > cfgRuleOptionAllowRangeMax(data->commandId, optionId)))
+        {
+            return false;
+        }
+
+        cfgOptionSet(optionId, source, value);
+    }
+    // Else set the default.  A negated option has no value even when there is a default.
+    else if (dependResolved)
+    {
+        const char *valueDefault = cfgRuleOptionDefault(data->commandId, optionId);
+
+        if (valueDefault == NULL && cfgRuleOptionRequired(data->commandId, optionId))
+            return false;
+
+        cfgOptionSet(optionId, cfgSourceDefault, negate ? NULL : valueDefault);
+    }
+
+    return true;
+}
+
+/***********************************************************************************************************************************
+Check the config file for anything that Perl would warn about: invalid options, options that are not valid for the command section
+they are in, and stanza options in a global section
+***********************************************************************************************************************************/
+static bool
+parseConfigValid(ParseData *data)
+{
+    for (unsigned int keyValueIdx = 0; keyValueIdx < iniKeyValueTotal(data->config); keyValueIdx++)
+    {
+        const IniKeyValue *keyValue = iniKeyValue(data->config, keyValueIdx);
+        int optionId = parseOptionFind(keyValue->key, strlen(keyValue->key));
+
+        if (optionId == -1 || cfgRuleOptionSection(optionId) == NULL)
+            return false;
+
+        // Split the section into the section name and the command
+        const char *command = strchr(keyValue->section, ':');
+        size_t sectionSize = command == NULL ? strlen(keyValue->section) : (size_t)(command - keyValue->section);
+
+        if (command != NULL)
+        {
+            command += strspn(command, ":");
+
+            if (command[0] != '\0' &&
+                (cfgCommandId(command) == -1 || !cfgRuleOptionValid(cfgCommandId(command), optionId)))
+            {
+                return false;
+            }
+        }
+
+        if (strcmp(cfgRuleOptionSection(optionId), CONFIG_SECTION_STANZA) == 0 &&
+            sectionSize == strlen(CONFIG_SECTION_GLOBAL) && strncmp(keyValue->section, CONFIG_SECTION_GLOBAL, sectionSize) == 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/***********************************************************************************************************************************
+Parse the command line and config file into the configuration
+***********************************************************************************************************************************/
+static bool
+parseInternal(ParseData *data, unsigned int argListSize, const char *argList[], const char **paramList)
+{
+    unsigned int paramTotal = 0;
+    const char *commandName = NULL;
+
+    // Getopt::Long does not allow options after parameters in this mode
+    if (getenv("POSIXLY_CORRECT") != NULL)
+        return false;
+
+    // Parse the command line
+    for (unsigned int argIdx = 1; argIdx < argListSize; argIdx++)
+    {
+        const char *arg = argList[argIdx];
+
+        // Arguments that are not options are the command and then the parameters
+        if (arg[0] != '-')
+        {
+            if (commandName == NULL)
+                commandName = arg;
+            else
+                paramList[paramTotal++] = arg;
+
+            continue;
+        }
+
+        // Only the --name[=value] form is parsed
+        if (arg[1] != '-' || arg[2] == '\0')
+            return false;
+
+        const char *name = arg + 2;
+        const char *value = strchr(name, '=');
+        size_t nameSize = value == NULL ? strlen(name) : (size_t)(value - name);
+        bool negate = false;
+        int optionId = parseOptionFind(name, nameSize);
+
+        // Perl only recognizes the no- prefix on the option name, not the alternate name
+        if (optionId == -1 && nameSize > 3 && strncmp(name, "no-", 3) == 0)
+        {
+            optionId = parseOptionFind(name + 3, nameSize - 3);
+            negate = true;
+
+            if (optionId != -1 && (!cfgRuleOptionNegate(optionId) || strlen(cfgOptionName(optionId)) != nameSize - 3))
+                optionId = -1;
+        }
+
+        // Unknown (or abbreviated) options, repeated options, and hash/list options are left to Perl
+        if (optionId == -1 || data->optionList[optionId].found ||
+            cfgRuleOptionType(optionId) == CFGOPTDEF_TYPE_HASH || cfgRuleOptionType(optionId) == CFGOPTDEF_TYPE_LIST)
+        {
+            return false;
+        }
+
+        // Booleans and negated options do not take a value
+        if (negate || cfgRuleOptionType(optionId) == CFGOPTDEF_TYPE_BOOLEAN)
+        {
+            if (value != NULL)
+                return false;
+
+            value = negate ? NULL : CFGOPTVAL_TRUE;
+        }
+        // Else the value follows = or is the next argument
+        else
+        {
+            if (value != NULL)
+                value++;
+            else if (argIdx + 1 < argListSize && argList[argIdx + 1][0] != '-')
+                value = argList[++argIdx];
+
+            if (value == NULL || value[0] == '\0')
+                return false;
+        }
+
+        data->optionList[optionId].found = true;
+        data->optionList[optionId].negate = negate;
+        data->optionList[optionId].value = value;
+    }
+
+    // Help is left to Perl since it parses options for another command
+    if (commandName == NULL || cfgCommandId(commandName) == -1 || cfgCommandId(commandName) == CFGCMD_HELP)
+        return false;
+
+    data->commandId = cfgCommandId(commandName);
+    cfgCommandSet(data->commandId);
+    cfgCommandParamSet(paramTotal, paramList);
+
+    // Resolve all options
+    for (int optionId = 0; optionId < CFGOPTDEF_TOTAL; optionId++)
+    {
+        if (!parseOptionResolve(data, optionId))
+            return false;
+    }
+
+    // All options on the command line must be valid for the command
+    for (int optionId = 0; optionId < CFGOPTDEF_TOTAL; optionId++)
+    {
+        if (data->optionList[optionId].found && !cfgOptionValid(optionId))
+            return false;
+    }
+
+    // The config file must not generate warnings
+    if (data->config != NULL && !parseConfigValid(data))
+        return false;
+
+    // Protocol timeout must be greater than db timeout.  Perl increases a default protocol timeout but since the default is much
+    // larger than the db-timeout default this is left to Perl.
+    if (cfgOptionTest(CFGOPT_DB_TIMEOUT) && cfgOptionTest(CFGOPT_PROTOCOL_TIMEOUT) &&
+        atof(cfgOption(CFGOPT_PROTOCOL_TIMEOUT)) <= atof(cfgOption(CFGOPT_DB_TIMEOUT)))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/***********************************************************************************************************************************
+Parse the command line and config file into the configuration
+
+Returns false if Perl must parse the command.  Errors thrown while parsing (e.g. an invalid config file) also mean that Perl must
+parse the command.
+***********************************************************************************************************************************/
+bool
+configParse(unsigned int argListSize, const char *argList[])
+{
+    volatile bool result = false;
+
+    cfgInit();
+
+    ParseData *data = memNew(sizeof(ParseData));
+    const char **paramList = memNewRaw(sizeof(const char *) * (argListSize == 0 ? 1 : argListSize));
+
+    ERROR_TRY()
+    {
+        result = parseInternal(data, argListSize, argList, paramList);
+    }
+    ERROR_FINALLY()
+    {
+        if (data->config != NULL)
+            iniFree(data->config);
+
+        memFree(paramList);
+        memFree(data);
+    }
+
+    return result;
+}
@@ -0,0 +1,18 @@
+/***********************************************************************************************************************************
+Parse Command Line and Config File
+
+Parse the command line and config file the same way as configLoad() in lib/pgBackRest/Config/Config.pm but only when the result is
+certain to be identical.  Anything that Perl would report (errors and warnings) or that Perl parses in a way that is not worth
+reproducing (abbreviated options, single dashes, hash options, etc.) returns false so the caller can let Perl parse the command.
+***********************************************************************************************************************************/
+#ifndef CONFIG_PARSE_H
+#define CONFIG_PARSE_H
+
+#include "common/type.h"
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+bool configParse(unsigned int argListSize, const char *argList[]);
+
+#endif
@@ -0,0 +1,57 @@
+/***********************************************************************************************************************************
+Cryptographic Hashes
+***********************************************************************************************************************************/
+#include <openssl/evp.h>
+
+#include "common/error.h"
+#include "crypto/hash.h"
+
+/***********************************************************************************************************************************
+Is the digest list loaded?  Required by OpenSSL versions before 1.1 so digests can be looked up by name.
+***********************************************************************************************************************************/
+static bool cryptoHashInitDone = false;
+
+/***********************************************************************************************************************************
+Hash a buffer and return the hash as lower-case hex in hashHex, which must be at least HASH_TYPE_HEX_SIZE_MAX bytes
+***********************************************************************************************************************************/
+void
+cryptoHashOne(const char *type, const unsigned char *buffer, size_t size, char *hashHex)
+{
+    if (!cryptoHashInitDone)
+    {
+        OpenSSL_add_all_digests();
+        cryptoHashInitDone = true;
+    }
+
+    const EVP_MD *hashType = EVP_get_digestbyname(type);
+
+    if (hashType == NULL)
+        ERROR_THROW(AssertError, "unable to load hash '%s'", type);
+
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hashSize = 0;
+
+    EVP_MD_CTX *context = EVP_MD_CTX_create();
+
+    if (context == NULL)
+        ERROR_THROW(MemoryError, "unable to create context for hash '%s'", type);
+
+    int result =
+        EVP_DigestInit_ex(context, hashType, NULL) == 1 && EVP_DigestUpdate(context, buffer, size) == 1 &&
+        EVP_DigestFinal_ex(context, hash, &hashSize) == 1;
+
+    EVP_MD_CTX_destroy(context);
+
+    if (!result)
+        ERROR_THROW(AssertError, "unable to calculate hash '%s'", type);
+
+    static const char hexDigit[] = "0123456789abcdef";
+
+    for (unsigned int hashIdx = 0; hashIdx < hashSize; hashIdx++)
+    {
+        hashHex[hashIdx * 2] = hexDigit[hash[hashIdx] >> 4];
+        hashHex[hashIdx * 2 + 1] = hexDigit[hash[hashIdx] & 0x0F];
+    }
+
+    hashHex[hashSize * 2] = '\0';
+}
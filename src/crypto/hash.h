@@ -0,0 +1,24 @@
+/***********************************************************************************************************************************
+Cryptographic Hashes
+***********************************************************************************************************************************/
+#ifndef CRYPTO_HASH_H
+#define CRYPTO_HASH_H
+
+#include <stddef.h>
+
+/***********************************************************************************************************************************
+Hash types
+***********************************************************************************************************************************/
+#define HASH_TYPE_SHA1                                              "sha1"
+
+/***********************************************************************************************************************************
+Size of a buffer large enough to hold any hex-encoded hash with terminator
+***********************************************************************************************************************************/
+#define HASH_TYPE_HEX_SIZE_MAX                                      129
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void cryptoHashOne(const char *type, const unsigned char *buffer, size_t size, char *hashHex);
+
+#endif
@@ -0,0 +1,48 @@
+/***********************************************************************************************************************************
+Main
+
+Commands that are implemented in C run here and everything else (including anything unusual for a C command) is passed to the Perl
+executable with the same arguments.
+***********************************************************************************************************************************/
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "command/archive/push/push.h"
+#include "common/error.h"
+#include "config/config.h"
+#include "config/parse.h"
+
+/***********************************************************************************************************************************
+Location of the Perl executable
+***********************************************************************************************************************************/
+#ifndef PGBACKREST_PERL_BIN
+    #error PGBACKREST_PERL_BIN must be defined
+#endif
+
+int
+main(int argListSize, const char *argList[])
+{
+    volatile bool done = false;
+
+    // Any error in a C command means that Perl should run the command so the error is reported the usual way.  C commands do not
+    // write or log anything before they are sure to succeed.
+    ERROR_TRY()
+    {
+        done = configParse((unsigned int)argListSize, argList) && cfgCommand() == CFGCMD_ARCHIVE_PUSH && cmdArchivePush();
+    }
+    ERROR_CATCH_ANY()
+    {
+        done = false;
+    }
+
+    if (done)
+        return 0;
+
+    // Run the Perl command with the same arguments
+    argList[0] = PGBACKREST_PERL_BIN;
+    execv(PGBACKREST_PERL_BIN, (char **)argList);
+
+    ERROR_THROW(FileOpenError, "unable to execute '%s': %s", PGBACKREST_PERL_BIN, strerror(errno));
+}
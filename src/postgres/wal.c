@@ -0,0 +1,116 @@
+/***********************************************************************************************************************************
+WAL Segment Functions
+***********************************************************************************************************************************/
+#include <string.h>
+
+#include "common/error.h"
+#include "postgres/wal.h"
+
+/***********************************************************************************************************************************
+Map WAL magic to the PostgreSQL version
+
+The magic number can be found in src/include/access/xlog_internal.h.
+***********************************************************************************************************************************/
+static const struct
+{
+    uint16 magic;
+    const char *version;
+} walMagicList[] =
+{
+    {0xD062, "8.3"},
+    {0xD063, "8.4"},
+    {0xD064, "9.0"},
+    {0xD066, "9.1"},
+    {0xD071, "9.2"},
+    {0xD075, "9.3"},
+    {0xD07E, "9.4"},
+    {0xD087, "9.5"},
+    {0xD093, "9.6"},
+    {0xD097, "10"},
+};
+
+/***********************************************************************************************************************************
+Offset of the system identifier in the long page header.  This can be determined by counting bytes in the XLogPageHeaderData struct,
+though the value rarely changes.
+***********************************************************************************************************************************/
+#define PG_WAL_SYSTEM_ID_OFFSET_GTE_93                              24
+#define PG_WAL_SYSTEM_ID_OFFSET_LT_93                               16
+
+/***********************************************************************************************************************************
+Is the file a partial segment?
+***********************************************************************************************************************************/
+bool
+walIsPartial(const char *walFile)
+{
+    return walIsSegment(walFile) && strlen(walFile) > 24;
+}
+
+/***********************************************************************************************************************************
+Is the file a segment (optionally partial)?  Other files, e.g. .history or .backup, are not segments.
+
+This matches /^[0-F]{24}(\.partial){0,1}$/ in walIsSegment() in lib/pgBackRest/Archive/Common.pm.
+***********************************************************************************************************************************/
+bool
+walIsSegment(const char *walFile)
+{
+    for (unsigned int charIdx = 0; charIdx < 24; charIdx++)
+    {
+        if (walFile[charIdx] < '0' || walFile[charIdx] > 'F')
+            return false;
+    }
+
+    return walFile[24] == '\0' || strcmp(walFile + 24, ".partial") == 0;
+}
+
+/***********************************************************************************************************************************
+Get the PostgreSQL version and system identifier from the first page of a WAL segment
+***********************************************************************************************************************************/
+WalInfo
+walInfo(const unsigned char *walBuffer, size_t walSize)
+{
+    WalInfo result = {.version = NULL};
+
+    // Map the magic to the PostgreSQL version
+    uint16 magic;
+
+    if (walSize < sizeof(magic))
+        ERROR_THROW(FileReadError, "unable to read wal magic");
+
+    memcpy(&magic, walBuffer, sizeof(magic));
+
+    for (unsigned int magicIdx = 0; magicIdx < sizeof(walMagicList) / sizeof(walMagicList[0]); magicIdx++)
+    {
+        if (walMagicList[magicIdx].magic == magic)
+            result.version = walMagicList[magicIdx].version;
+    }
+
+    if (result.version == NULL)
+    {
+        ERROR_THROW(
+            VersionNotSupportedError, "unexpected WAL magic 0x%X\nHINT: is this version of PostgreSQL supported?",
+            (unsigned int)magic);
+    }
+
+    // Make sure that the long header is present or there won't be a system id
+    uint16 flag;
+
+    if (walSize < sizeof(magic) + sizeof(flag))
+        ERROR_THROW(FileReadError, "unable to read wal info");
+
+    memcpy(&flag, walBuffer + sizeof(magic), sizeof(flag));
+
+    if (!(flag & 2))
+        ERROR_THROW(FormatError, "expected long header in flags %x", (unsigned int)flag);
+
+    // Get the system id -- the version is before 9.3 only when it is 8.x or 9.[0-2]
+    size_t systemIdOffset =
+        result.version[0] == '8' || (result.version[0] == '9' && result.version[2] < '3') ?
+            PG_WAL_SYSTEM_ID_OFFSET_LT_93 : PG_WAL_SYSTEM_ID_OFFSET_GTE_93;
+
+    if (walSize < systemIdOffset + sizeof(result.systemId))
+        ERROR_THROW(FileReadError, "unable to read database system identifier");
+
+    memcpy(&result.systemId, walBuffer + systemIdOffset, sizeof(result.systemId));
+
+    return result;
+}
@@ -0,0 +1,32 @@
+/***********************************************************************************************************************************
+WAL Segment Functions
+***********************************************************************************************************************************/
+#ifndef POSTGRES_WAL_H
+#define POSTGRES_WAL_H
+
+#include <stddef.h>
+
+#include "common/type.h"
+
+/***********************************************************************************************************************************
+WAL segment size
+***********************************************************************************************************************************/
+#define PG_WAL_SEGMENT_SIZE                                         16777216
+
+/***********************************************************************************************************************************
+WAL segment info
+***********************************************************************************************************************************/
+typedef struct WalInfo
+{
+    const char *version;                                            // PostgreSQL version, e.g. "9.4"
+    uint64 systemId;                                                // Database system identifier
+} WalInfo;
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+bool walIsPartial(const char *walFile);
+bool walIsSegment(const char *walFile);
+WalInfo walInfo(const unsigned char *walBuffer, size_t walSize);
+
+#endif
@@ -0,0 +1,152 @@
+/***********************************************************************************************************************************
+Posix Storage File Write
+***********************************************************************************************************************************/
+#define _POSIX_C_SOURCE                                             200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/error.h"
+#include "common/memContext.h"
+#include "storage/posix/fileWrite.h"
+#include "storage/posix/storage.h"
+
+/***********************************************************************************************************************************
+Contains information about the file being written
+***********************************************************************************************************************************/
+struct StorageFileWrite
+{
+    MemContext *memContext;                                         // Context that contains the file write
+    char *name;                                                     // File name
+    char *nameTmp;                                                  // Temp file name that is renamed to the file name on close
+    int handle;                                                     // File descriptor (-1 when closed)
+};
+
+/***********************************************************************************************************************************
+Open a file for writing
+
+The temp file is created with the mode passed.  If the path is missing and pathCreate is set then the path is created, along with
+missing parent paths, using pathMode.
+***********************************************************************************************************************************/
+StorageFileWrite *
+storagePosixFileWriteOpen(const char *file, mode_t mode, mode_t pathMode, bool pathCreate)
+{
+    StorageFileWrite *volatile this = NULL;
+
+    MEM_CONTEXT_NEW_BEGIN("StorageFileWrite")
+    {
+        this = memNew(sizeof(StorageFileWrite));
+        this->memContext = MEM_CONTEXT_NEW();
+        this->handle = -1;
+
+        this->name = memNewRaw(strlen(file) + 1);
+        strcpy(this->name, file);
+
+        this->nameTmp = memNewRaw(strlen(file) + sizeof("." STORAGE_TEMP_EXT));
+        sprintf(this->nameTmp, "%s." STORAGE_TEMP_EXT, file);
+
+        this->handle = open(this->nameTmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+
+        // If the path does not exist create it if requested and try again
+        if (this->handle == -1 && errno == ENOENT && pathCreate)
+        {
+            char *path = memNewRaw(strlen(file) + 1);
+            strcpy(path, file);
+
+            char *pathEnd = strrchr(path, '/');
+
+            if (pathEnd != NULL && pathEnd != path)
+            {
+                *pathEnd = '\0';
+                storagePosixPathCreate(path, pathMode, true, true);
+            }
+
+            this->handle = open(this->nameTmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+        }
+
+        if (this->handle == -1)
+        {
+            ERROR_THROW(
+                *(errno == ENOENT ? &PathMissingError : &FileOpenError), "unable to open '%s': %s", this->nameTmp,
+                strerror(errno));
+        }
+
+        // Remove the temp file if the object is freed before it is closed
+        memContextCallback(this->memContext, (MemContextCallback)storagePosixFileWriteFree, this);
+    }
+    MEM_CONTEXT_NEW_END();
+
+    return this;
+}
+
+/***********************************************************************************************************************************
+Write a buffer to the file
+***********************************************************************************************************************************/
+void
+storagePosixFileWrite(StorageFileWrite *this, const unsigned char *buffer, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t actualSize = write(this->handle, buffer, size);
+
+        if (actualSize == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            ERROR_THROW(FileWriteError, "unable to write '%s': %s", this->nameTmp, strerror(errno));
+        }
+
+        buffer += actualSize;
+        size -= (size_t)actualSize;
+    }
+}
+
+/***********************************************************************************************************************************
+Sync and close the file and then rename the temp file to the file name
+***********************************************************************************************************************************/
+void
+storagePosixFileWriteClose(StorageFileWrite *this)
+{
+    if (fsync(this->handle) == -1)
+        ERROR_THROW(FileSyncError, "unable to sync '%s': %s", this->nameTmp, strerror(errno));
+
+    int handle = this->handle;
+    this->handle = -1;
+
+    if (close(handle) == -1)
+        ERROR_THROW(FileCloseError, "unable to close '%s': %s", this->nameTmp, strerror(errno));
+
+    if (rename(this->nameTmp, this->name) == -1)
+        ERROR_THROW(FileMoveError, "unable to move '%s' to '%s': %s", this->nameTmp, this->name, strerror(errno));
+
+    // The temp file no longer exists so there is nothing to remove on free
+    this->nameTmp[0] = '\0';
+}
+
+/***********************************************************************************************************************************
+Free the file, closing and removing the temp file if the file was not closed successfully
+***********************************************************************************************************************************/
+void
+storagePosixFileWriteFree(StorageFileWrite *this)
+{
+    if (this != NULL)
+    {
+        if (this->handle != -1)
+        {
+            close(this->handle);
+            this->handle = -1;
+        }
+
+        if (this->nameTmp[0] != '\0')
+        {
+            unlink(this->nameTmp);
+            this->nameTmp[0] = '\0';
+        }
+
+        memContextFree(this->memContext);
+    }
+}
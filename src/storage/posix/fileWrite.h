@@ -0,0 +1,28 @@
+/***********************************************************************************************************************************
+Posix Storage File Write
+
+Files are written atomically -- the content is written to a temp file that is synced and then renamed to the file name on close, so
+the file either has all the content or does not exist.
+***********************************************************************************************************************************/
+#ifndef STORAGE_POSIX_FILEWRITE_H
+#define STORAGE_POSIX_FILEWRITE_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "common/type.h"
+
+/***********************************************************************************************************************************
+File write object
+***********************************************************************************************************************************/
+typedef struct StorageFileWrite StorageFileWrite;
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+StorageFileWrite *storagePosixFileWriteOpen(const char *file, mode_t mode, mode_t pathMode, bool pathCreate);
+void storagePosixFileWrite(StorageFileWrite *this, const unsigned char *buffer, size_t size);
+void storagePosixFileWriteClose(StorageFileWrite *this);
+void storagePosixFileWriteFree(StorageFileWrite *this);
+
+#endif
@@ -0,0 +1,574 @@
+/***********************************************************************************************************************************
+Posix Storage Manifest
+
+Paths are read in parallel by a pool of threads that share a stack of paths waiting to be read.  Each path is opened once and
+every entry is stat'd relative to the open path so the kernel does not need to resolve the full path for each file.  The threads do
+not use the error handler or memory contexts since neither is thread-safe -- errors are stored and thrown by the calling thread
+after all the threads have completed.  User and group names are also resolved by the calling thread since getpwuid()/getgrgid() are
+not thread-safe.
+***********************************************************************************************************************************/
+#define _POSIX_C_SOURCE                                             200809L
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <limits.h>
+#include <pthread.h>
+#include <pwd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/error.h"
+#include "storage/posix/manifest.h"
+
+/***********************************************************************************************************************************
+Maximum number of threads that will be used to read paths
+***********************************************************************************************************************************/
+#define STORAGE_MANIFEST_THREAD_MAX                                 64
+
+/***********************************************************************************************************************************
+Size of the buffer used to store an error raised by a thread
+***********************************************************************************************************************************/
+#define STORAGE_MANIFEST_ERROR_SIZE                                 4096
+
+/***********************************************************************************************************************************
+Path waiting to be read
+***********************************************************************************************************************************/
+typedef struct StorageManifestPath
+{
+    char *name;                                                     // Path name relative to the base path ("" for the base path)
+    struct StorageManifestPath *next;                               // Next path on the stack
+} StorageManifestPath;
+
+/***********************************************************************************************************************************
+Entry found while reading a path along with the ids that will be resolved to names
+***********************************************************************************************************************************/
+typedef struct StorageManifestEntry
+{
+    StorageManifestInfo info;
+    uid_t userId;
+    gid_t groupId;
+} StorageManifestEntry;
+
+/***********************************************************************************************************************************
+State shared by all threads
+***********************************************************************************************************************************/
+typedef struct StorageManifestData
+{
+    const char *path;                                               // Base path
+
+    pthread_mutex_t lock;                                           // Lock for all members below
+    pthread_cond_t wait;                                            // Signalled when paths are added or a thread goes idle
+
+    StorageManifestPath *pathStack;                                 // Paths waiting to be read
+    unsigned int pathActive;                                        // Paths currently being read
+
+    const ErrorType *errorType;                                     // First error raised by a thread
+    char errorMessage[STORAGE_MANIFEST_ERROR_SIZE];
+} StorageManifestData;
+
+/***********************************************************************************************************************************
+State for each thread -- entries are stored per thread so no lock is required to add them
+***********************************************************************************************************************************/
+typedef struct StorageManifestThread
+{
+    pthread_t thread;
+    StorageManifestData *data;
+
+    StorageManifestEntry *entryList;
+    size_t entryTotal;
+    size_t entrySize;
+} StorageManifestThread;
+
+/***********************************************************************************************************************************
+Store an error raised by a thread -- only the first error is kept
+
+The format must contain a single %s which is replaced by the full path of the file.  The system error is appended when errNo != 0.
+***********************************************************************************************************************************/
+static void
+storagePosixManifestError(StorageManifestData *data, const ErrorType *errorType, const char *format, const char *name, int errNo)
+{
+    pthread_mutex_lock(&data->lock);
+
+    if (data->errorType == NULL)
+    {
+        char fileName[PATH_MAX + 1];
+        snprintf(fileName, sizeof(fileName), "%s%s%s", data->path, name[0] == '\0' ? "" : "/", name);
+
+        data->errorType = errorType;
+        int messageSize = snprintf(data->errorMessage, sizeof(data->errorMessage), format, fileName);
+
+        if (errNo != 0 && messageSize >= 0 && (size_t)messageSize < sizeof(data->errorMessage))
+            snprintf(data->errorMessage + messageSize, sizeof(data->errorMessage) - messageSize, ": %s", strerror(errNo));
+    }
+
+    pthread_cond_broadcast(&data->wait);
+    pthread_mutex_unlock(&data->lock);
+}
+
+/***********************************************************************************************************************************
+Join the parent and file names into a new string
+***********************************************************************************************************************************/
+static char *
+storagePosixManifestName(const char *parent, const char *name)
+{
+    size_t parentSize = strlen(parent);
+    size_t nameSize = strlen(name);
+    char *result = malloc(parentSize + nameSize + 2);
+
+    if (result != NULL)
+    {
+        if (parentSize == 0)
+            memcpy(result, name, nameSize + 1);
+        else
+        {
+            memcpy(result, parent, parentSize);
+            result[parentSize] = '/';
+            memcpy(result + parentSize + 1, name, nameSize + 1);
+        }
+    }
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Add an entry from stat data
+
+The file name is used to read link destinations relative to the open path and the name is relative to the base path ("" for the base
+path itself).  Returns false if the entry could not be added, in which case the error has been stored and the name is not owned by
+the entry.
+***********************************************************************************************************************************/
+static bool
+storagePosixManifestEntry(
+    StorageManifestThread *this, int pathFd, const char *fileName, const char *errorName, char *name, const struct stat *statData)
+{
+    StorageManifestEntry entry = {.info = {.name = name}, .userId = statData->st_uid, .groupId = statData->st_gid};
+
+    if (S_ISREG(statData->st_mode))
+    {
+        entry.info.type = storageManifestTypeFile;
+        entry.info.size = (uint64)statData->st_size;
+        entry.info.modificationTime = (int64)statData->st_mtime;
+    }
+    else if (S_ISDIR(statData->st_mode))
+        entry.info.type = storageManifestTypePath;
+    else if (S_ISLNK(statData->st_mode))
+    {
+        entry.info.type = storageManifestTypeLink;
+
+        char linkDestination[PATH_MAX + 1];
+        ssize_t linkDestinationSize = readlinkat(pathFd, fileName, linkDestination, PATH_MAX);
+
+        if (linkDestinationSize == -1)
+        {
+            storagePosixManifestError(
+                this->data, errno == ENOENT ? &FileMissingError : &FileOpenError, "unable to get destination for link %s",
+                errorName, errno);
+            return false;
+        }
+
+        linkDestination[linkDestinationSize] = '\0';
+        entry.info.linkDestination = strdup(linkDestination);
+
+        if (entry.info.linkDestination == NULL)
+        {
+            storagePosixManifestError(this->data, &MemoryError, "unable to allocate destination for link %s", errorName, 0);
+            return false;
+        }
+    }
+    else
+    {
+        storagePosixManifestError(this->data, &FileInvalidError, "%s is not of type directory, file, or link", errorName, 0);
+        return false;
+    }
+
+    if (entry.info.type != storageManifestTypeLink)
+        entry.info.mode = statData->st_mode & 07777;
+
+    // Grow the entry list if needed
+    if (this->entryTotal == this->entrySize)
+    {
+        size_t entrySize = this->entrySize == 0 ? 1024 : this->entrySize * 2;
+        StorageManifestEntry *entryList = realloc(this->entryList, entrySize * sizeof(StorageManifestEntry));
+
+        if (entryList == NULL)
+        {
+            free((void *)entry.info.linkDestination);
+            storagePosixManifestError(this->data, &MemoryError, "unable to allocate manifest entry for '%s'", errorName, 0);
+            return false;
+        }
+
+        this->entryList = entryList;
+        this->entrySize = entrySize;
+    }
+
+    this->entryList[this->entryTotal++] = entry;
+
+    return true;
+}
+
+/***********************************************************************************************************************************
+Read a path and add an entry for each file in it.  Paths found are pushed onto the stack.
+***********************************************************************************************************************************/
+static void
+storagePosixManifestPath(StorageManifestThread *this, const char *pathName)
+{
+    StorageManifestData *data = this->data;
+
+    // Open the path.  Paths below the base path may have been removed since they were found so ignore them if missing.
+    char *pathFull = storagePosixManifestName(data->path, pathName);
+
+    if (pathFull == NULL)
+    {
+        storagePosixManifestError(data, &MemoryError, "unable to allocate name for path '%s'", pathName, 0);
+        return;
+    }
+
+    int pathFd = open(pathFull, O_RDONLY | O_DIRECTORY);
+    free(pathFull);
+
+    if (pathFd == -1)
+    {
+        if (errno != ENOENT || pathName[0] == '\0')
+        {
+            storagePosixManifestError(
+                data, errno == ENOENT ? &FileMissingError : &FileOpenError, "unable to read path '%s'", pathName, errno);
+        }
+
+        return;
+    }
+
+    DIR *dir = fdopendir(pathFd);
+
+    if (dir == NULL)
+    {
+        storagePosixManifestError(data, &FileOpenError, "unable to read path '%s'", pathName, errno);
+        close(pathFd);
+        return;
+    }
+
+    while (true)
+    {
+        // Reset errno before each read since readdir() returns NULL both at the end of the path and on error
+        errno = 0;
+        struct dirent *dirEntry = readdir(dir);
+
+        if (dirEntry == NULL)
+        {
+            if (errno != 0)
+                storagePosixManifestError(data, &FileReadError, "unable to read path '%s'", pathName, errno);
+
+            break;
+        }
+
+        // Skip special entries
+        if (dirEntry->d_name[0] == '.' &&
+            (dirEntry->d_name[1] == '\0' || (dirEntry->d_name[1] == '.' && dirEntry->d_name[2] == '\0')))
+        {
+            continue;
+        }
+
+        char *name = storagePosixManifestName(pathName, dirEntry->d_name);
+
+        if (name == NULL)
+        {
+            storagePosixManifestError(data, &MemoryError, "unable to allocate name for file in '%s'", pathName, 0);
+            break;
+        }
+
+        // Stat the entry relative to the open path, ignoring entries that have been removed since the path was read
+        struct stat statData;
+
+        if (fstatat(pathFd, dirEntry->d_name, &statData, AT_SYMLINK_NOFOLLOW) == -1)
+        {
+            int errNo = errno;
+
+            if (errNo == ENOENT)
+            {
+                free(name);
+                continue;
+            }
+
+            storagePosixManifestError(data, &FileOpenError, "unable to stat '%s'", name, errNo);
+            free(name);
+            break;
+        }
+
+        if (!storagePosixManifestEntry(this, pathFd, dirEntry->d_name, name, name, &statData))
+        {
+            free(name);
+            break;
+        }
+
+        // Push paths onto the stack so any idle thread can read them.  The name is owned by the entry.
+        if (S_ISDIR(statData.st_mode))
+        {
+            StorageManifestPath *path = malloc(sizeof(StorageManifestPath));
+
+            if (path == NULL)
+            {
+                storagePosixManifestError(data, &MemoryError, "unable to allocate path '%s'", name, 0);
+                break;
+            }
+
+            path->name = name;
+
+            pthread_mutex_lock(&data->lock);
+            path->next = data->pathStack;
+            data->pathStack = path;
+            pthread_cond_signal(&data->wait);
+            pthread_mutex_unlock(&data->lock);
+        }
+    }
+
+    closedir(dir);
+}
+
+/***********************************************************************************************************************************
+Thread main -- read paths from the stack until all paths have been read or an error occurs
+***********************************************************************************************************************************/
+static void *
+storagePosixManifestThread(void *thisVoid)
+{
+    StorageManifestThread *this = thisVoid;
+    StorageManifestData *data = this->data;
+
+    pthread_mutex_lock(&data->lock);
+
+    while (true)
+    {
+        // Wait while there is nothing to read but other threads may still find more paths
+        while (data->errorType == NULL && data->pathStack == NULL && data->pathActive > 0)
+            pthread_cond_wait(&data->wait, &data->lock);
+
+        // Done when there was an error or all paths have been read
+        if (data->errorType != NULL || data->pathStack == NULL)
+            break;
+
+        StorageManifestPath *path = data->pathStack;
+        data->pathStack = path->next;
+        data->pathActive++;
+
+        pthread_mutex_unlock(&data->lock);
+
+        storagePosixManifestPath(this, path->name);
+        free(path);
+
+        pthread_mutex_lock(&data->lock);
+        data->pathActive--;
+
+        // Wake waiting threads so they can exit if this was the last path
+        if (data->pathActive == 0 && data->pathStack == NULL)
+            pthread_cond_broadcast(&data->wait);
+    }
+
+    pthread_mutex_unlock(&data->lock);
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+Cache of user/group names resolved from ids -- there are usually only one or two distinct ids so a list is fine
+***********************************************************************************************************************************/
+typedef struct StorageManifestNameCache
+{
+    unsigned int id;
+    char *name;
+} StorageManifestNameCache;
+
+typedef struct StorageManifestNameCacheList
+{
+    StorageManifestNameCache *list;
+    size_t total;
+} StorageManifestNameCacheList;
+
+static const char *
+storagePosixManifestNameCache(StorageManifestNameCacheList *cache, unsigned int id, bool user)
+{
+    for (size_t cacheIdx = 0; cacheIdx < cache->total; cacheIdx++)
+    {
+        if (cache->list[cacheIdx].id == id)
+            return cache->list[cacheIdx].name;
+    }
+
+    StorageManifestNameCache *list = realloc(cache->list, (cache->total + 1) * sizeof(StorageManifestNameCache));
+
+    if (list == NULL)
+        ERROR_THROW(MemoryError, "unable to allocate name cache");
+
+    cache->list = list;
+
+    const char *name = NULL;
+
+    if (user)
+    {
+        struct passwd *userData = getpwuid((uid_t)id);
+        name = userData == NULL ? NULL : userData->pw_name;
+    }
+    else
+    {
+        struct group *groupData = getgrgid((gid_t)id);
+        name = groupData == NULL ? NULL : groupData->gr_name;
+    }
+
+    cache->list[cache->total] = (StorageManifestNameCache){.id = id, .name = name == NULL ? NULL : strdup(name)};
+    cache->total++;
+
+    return cache->list[cache->total - 1].name;
+}
+
+/***********************************************************************************************************************************
+Build a manifest of the path and call the callback for each entry
+
+If the path is a file then only the file is returned.  Entries are passed to the callback in no particular order.
+***********************************************************************************************************************************/
+void
+storagePosixManifest(
+    const char *path, bool ignoreMissing, unsigned int threadTotal, StorageManifestCallback callback, void *callbackData)
+{
+    if (threadTotal < 1 || threadTotal > STORAGE_MANIFEST_THREAD_MAX)
+        ERROR_THROW(AssertError, "thread total must be between 1 and %d", STORAGE_MANIFEST_THREAD_MAX);
+
+    // Stat the path to determine if it is missing or a file
+    struct stat statData;
+
+    if (lstat(path, &statData) == -1)
+    {
+        if (errno != ENOENT)
+            ERROR_THROW(FileOpenError, "unable to stat '%s': %s", path, strerror(errno));
+
+        if (!ignoreMissing)
+            ERROR_THROW(FileMissingError, "unable to stat '%s': %s", path, strerror(errno));
+
+        return;
+    }
+
+    // Setup shared data
+    StorageManifestData data = {.path = path};
+    StorageManifestThread threadList[STORAGE_MANIFEST_THREAD_MAX];
+
+    memset(threadList, 0, sizeof(threadList));
+    pthread_mutex_init(&data.lock, NULL);
+    pthread_cond_init(&data.wait, NULL);
+
+    for (unsigned int threadIdx = 0; threadIdx < threadTotal; threadIdx++)
+        threadList[threadIdx].data = &data;
+
+    // If a path then read it and all paths below it
+    if (S_ISDIR(statData.st_mode))
+    {
+        char *name = strdup(".");
+        StorageManifestPath *pathBase = malloc(sizeof(StorageManifestPath));
+
+        if (name == NULL || pathBase == NULL)
+        {
+            free(name);
+            free(pathBase);
+            storagePosixManifestError(&data, &MemoryError, "unable to allocate path '%s'", "", 0);
+        }
+        else if (!storagePosixManifestEntry(&threadList[0], AT_FDCWD, path, "", name, &statData))
+        {
+            free(name);
+            free(pathBase);
+        }
+        else
+        {
+            *pathBase = (StorageManifestPath){.name = ""};
+            data.pathStack = pathBase;
+
+            // Start threads -- if a thread cannot be started then continue with the threads that were started
+            unsigned int threadStarted = 1;
+
+            while (threadStarted < threadTotal)
+            {
+                if (pthread_create(
+                        &threadList[threadStarted].thread, NULL, storagePosixManifestThread, &threadList[threadStarted]) != 0)
+                {
+                    break;
+                }
+
+                threadStarted++;
+            }
+
+            // The calling thread also reads paths
+            storagePosixManifestThread(&threadList[0]);
+
+            for (unsigned int threadIdx = 1; threadIdx < threadStarted; threadIdx++)
+                pthread_join(threadList[threadIdx].thread, NULL);
+
+            // Free paths left on the stack after an error
+            while (data.pathStack != NULL)
+            {
+                StorageManifestPath *pathNext = data.pathStack->next;
+                free(data.pathStack);
+                data.pathStack = pathNext;
+            }
+        }
+    }
+    // Else only return the file
+    else
+    {
+        const char *fileName = strrchr(path, '/');
+        char *name = strdup(fileName == NULL ? path : fileName + 1);
+
+        if (name == NULL)
+            storagePosixManifestError(&data, &MemoryError, "unable to allocate file '%s'", "", 0);
+        else if (!storagePosixManifestEntry(&threadList[0], AT_FDCWD, path, "", name, &statData))
+            free(name);
+    }
+
+    pthread_cond_destroy(&data.wait);
+    pthread_mutex_destroy(&data.lock);
+
+    // Resolve user/group names and pass entries to the callback
+    StorageManifestNameCacheList userCache = {0};
+    StorageManifestNameCacheList groupCache = {0};
+
+    ERROR_TRY()
+    {
+        if (data.errorType != NULL)
+            ERROR_THROW(*data.errorType, "%s", data.errorMessage);
+
+        for (unsigned int threadIdx = 0; threadIdx < threadTotal; threadIdx++)
+        {
+            StorageManifestThread *thread = &threadList[threadIdx];
+
+            for (size_t entryIdx = 0; entryIdx < thread->entryTotal; entryIdx++)
+            {
+                StorageManifestEntry *entry = &thread->entryList[entryIdx];
+
+                entry->info.user = storagePosixManifestNameCache(&userCache, entry->userId, true);
+                entry->info.group = storagePosixManifestNameCache(&groupCache, entry->groupId, false);
+
+                callback(callbackData, &entry->info);
+            }
+        }
+    }
+    ERROR_FINALLY()
+    {
+        for (unsigned int threadIdx = 0; threadIdx < threadTotal; threadIdx++)
+        {
+            StorageManifestThread *thread = &threadList[threadIdx];
+
+            for (size_t entryIdx = 0; entryIdx < thread->entryTotal; entryIdx++)
+            {
+                free((void *)thread->entryList[entryIdx].info.name);
+                free((void *)thread->entryList[entryIdx].info.linkDestination);
+            }
+
+            free(thread->entryList);
+        }
+
+        for (size_t cacheIdx = 0; cacheIdx < userCache.total; cacheIdx++)
+            free(userCache.list[cacheIdx].name);
+
+        for (size_t cacheIdx = 0; cacheIdx < groupCache.total; cacheIdx++)
+            free(groupCache.list[cacheIdx].name);
+
+        free(userCache.list);
+        free(groupCache.list);
+    }
+}
@@ -0,0 +1,47 @@
+/***********************************************************************************************************************************
+Posix Storage Manifest
+***********************************************************************************************************************************/
+#ifndef STORAGE_POSIX_MANIFEST_H
+#define STORAGE_POSIX_MANIFEST_H
+
+#include <sys/types.h>
+
+#include "common/type.h"
+
+/***********************************************************************************************************************************
+Types of entries that can be stored in a manifest
+***********************************************************************************************************************************/
+typedef enum
+{
+    storageManifestTypeFile = 'f',
+    storageManifestTypePath = 'd',
+    storageManifestTypeLink = 'l',
+} StorageManifestType;
+
+/***********************************************************************************************************************************
+Manifest entry passed to the callback
+
+The name is relative to the path passed to storagePosixManifest() and is "." for the path itself.  User and group are NULL when the
+id cannot be resolved to a name.  Mode is not set for links, and size and modification time are only set for files.
+***********************************************************************************************************************************/
+typedef struct StorageManifestInfo
+{
+    const char *name;
+    StorageManifestType type;
+    const char *user;
+    const char *group;
+    mode_t mode;
+    uint64 size;
+    int64 modificationTime;
+    const char *linkDestination;
+} StorageManifestInfo;
+
+typedef void (*StorageManifestCallback)(void *callbackData, const StorageManifestInfo *info);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+void storagePosixManifest(
+    const char *path, bool ignoreMissing, unsigned int threadTotal, StorageManifestCallback callback, void *callbackData);
+
+#endif
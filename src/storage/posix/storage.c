@@ -0,0 +1,191 @@
+/***********************************************************************************************************************************
+Posix Storage
+***********************************************************************************************************************************/
+#define _POSIX_C_SOURCE                                             200809L
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/error.h"
+#include "common/memContext.h"
+#include "storage/posix/storage.h"
+
+/***********************************************************************************************************************************
+Does a file or path exist?  Links are followed so a link to a missing destination does not exist.
+***********************************************************************************************************************************/
+bool
+storagePosixExists(const char *pathFile)
+{
+    struct stat statFile;
+
+    if (stat(pathFile, &statFile) == -1)
+    {
+        if (errno != ENOENT && errno != ENOTDIR)
+            ERROR_THROW(FileOpenError, "unable to stat '%s': %s", pathFile, strerror(errno));
+
+        return false;
+    }
+
+    return true;
+}
+
+/***********************************************************************************************************************************
+Read an entire file into a buffer allocated in the current memory context
+
+The buffer is terminated with a zero byte (not included in the size) so text files can be used as strings.  NULL is returned when
+the file is missing and ignoreMissing is set.  The size is optional.
+***********************************************************************************************************************************/
+unsigned char *
+storagePosixGet(const char *file, bool ignoreMissing, size_t *size)
+{
+    unsigned char *volatile result = NULL;
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        if (errno == ENOENT && ignoreMissing)
+            return NULL;
+
+        ERROR_THROW(
+            *(errno == ENOENT ? &FileMissingError : &FileOpenError), "unable to open '%s' for read: %s", file, strerror(errno));
+    }
+
+    ERROR_TRY()
+    {
+        // Size the buffer from the file but keep reading until end of file in case it is growing
+        struct stat statFile;
+
+        if (fstat(fd, &statFile) == -1)
+            ERROR_THROW(FileOpenError, "unable to stat '%s': %s", file, strerror(errno));
+
+        size_t bufferSize = (size_t)statFile.st_size + 1;
+        size_t readSize = 0;
+        result = memNewRaw(bufferSize + 1);
+
+        while (true)
+        {
+            if (readSize == bufferSize)
+            {
+                unsigned char *resultOld = result;
+
+                bufferSize *= 2;
+                result = memNewRaw(bufferSize + 1);
+                memcpy(result, resultOld, readSize);
+                memFree(resultOld);
+            }
+
+            ssize_t actualSize = read(fd, result + readSize, bufferSize - readSize);
+
+            if (actualSize == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                ERROR_THROW(FileReadError, "unable to read '%s': %s", file, strerror(errno));
+            }
+
+            if (actualSize == 0)
+                break;
+
+            readSize += (size_t)actualSize;
+        }
+
+        result[readSize] = '\0';
+
+        if (size != NULL)
+            *size = readSize;
+    }
+    ERROR_FINALLY()
+    {
+        close(fd);
+    }
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Call the callback for each entry in a path (except . and ..) in the order they are read
+***********************************************************************************************************************************/
+void
+storagePosixList(const char *path, bool ignoreMissing, StorageListCallback callback, void *callbackData)
+{
+    DIR *dir = opendir(path);
+
+    if (dir == NULL)
+    {
+        if (errno == ENOENT && ignoreMissing)
+            return;
+
+        ERROR_THROW(
+            *(errno == ENOENT ? &PathMissingError : &PathOpenError), "unable to read path '%s': %s", path, strerror(errno));
+    }
+
+    ERROR_TRY()
+    {
+        while (true)
+        {
+            errno = 0;
+            struct dirent *entry = readdir(dir);
+
+            if (entry == NULL)
+            {
+                if (errno != 0)
+                    ERROR_THROW(PathOpenError, "unable to read path '%s': %s", path, strerror(errno));
+
+                break;
+            }
+
+            if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+                callback(callbackData, entry->d_name);
+        }
+    }
+    ERROR_FINALLY()
+    {
+        closedir(dir);
+    }
+}
+
+/***********************************************************************************************************************************
+Create a path, optionally creating missing parent paths with the same mode
+***********************************************************************************************************************************/
+void
+storagePosixPathCreate(const char *path, mode_t mode, bool ignoreExists, bool createParent)
+{
+    if (mkdir(path, mode) == -1)
+    {
+        if (errno == ENOENT && createParent)
+        {
+            // Create the parent path.  The path always has a parent here since / exists.
+            char *pathParent = memNewRaw(strlen(path) + 1);
+            strcpy(pathParent, path);
+
+            char *pathParentEnd = strrchr(pathParent, '/');
+
+            // Remove trailing slashes and the last path element
+            while (pathParentEnd != NULL && pathParentEnd[1] == '\0' && pathParentEnd != pathParent)
+            {
+                *pathParentEnd = '\0';
+                pathParentEnd = strrchr(pathParent, '/');
+            }
+
+            if (pathParentEnd == NULL)
+                ERROR_THROW(PathCreateError, "unable to create path '%s' because it has no parent", path);
+
+            pathParentEnd[pathParentEnd == pathParent ? 1 : 0] = '\0';
+
+            storagePosixPathCreate(pathParent, mode, true, true);
+            memFree(pathParent);
+
+            storagePosixPathCreate(path, mode, ignoreExists, false);
+        }
+        else if (errno != EEXIST || !ignoreExists)
+        {
+            ERROR_THROW(
+                *(errno == ENOENT ? &PathMissingError : &PathCreateError), "unable to create path '%s': %s", path, strerror(errno));
+        }
+    }
+}
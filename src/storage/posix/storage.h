@@ -0,0 +1,33 @@
+/***********************************************************************************************************************************
+Posix Storage
+***********************************************************************************************************************************/
+#ifndef STORAGE_POSIX_STORAGE_H
+#define STORAGE_POSIX_STORAGE_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "common/type.h"
+#include "version.h"
+
+/***********************************************************************************************************************************
+Default modes and the extension used for temp files written atomically -- these match the defaults in lib/pgBackRest/Storage
+***********************************************************************************************************************************/
+#define STORAGE_FILE_MODE_DEFAULT                                   0640
+#define STORAGE_PATH_MODE_DEFAULT                                   0750
+#define STORAGE_TEMP_EXT                                            PGBACKREST_BIN ".tmp"
+
+/***********************************************************************************************************************************
+Callback for each entry found by storagePosixList()
+***********************************************************************************************************************************/
+typedef void (*StorageListCallback)(void *callbackData, const char *name);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+bool storagePosixExists(const char *pathFile);
+unsigned char *storagePosixGet(const char *file, bool ignoreMissing, size_t *size);
+void storagePosixList(const char *path, bool ignoreMissing, StorageListCallback callback, void *callbackData);
+void storagePosixPathCreate(const char *path, mode_t mode, bool ignoreExists, bool createParent);
+
+#endif
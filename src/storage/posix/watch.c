@@ -0,0 +1,129 @@
+/***********************************************************************************************************************************
+Posix Storage Watch
+
+Report files that are added to or removed from a path without reading the path.  Files are added when they are closed after writing
+or moved into the path, so a file is not reported while it is still being written.  This is only implemented on Linux (inotify) --
+on other platforms storagePosixWatchNew() throws an error and the caller should read the path instead.
+***********************************************************************************************************************************/
+#define _POSIX_C_SOURCE                                             200809L
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+    #include <poll.h>
+    #include <sys/inotify.h>
+#endif
+
+#include "common/error.h"
+#include "storage/posix/watch.h"
+
+/***********************************************************************************************************************************
+Size of the buffer used to read events -- enough for a few hundred events with typical file names
+***********************************************************************************************************************************/
+#define STORAGE_WATCH_BUFFER_SIZE                                   65536
+
+/***********************************************************************************************************************************
+Start watching a path and return the watch descriptor
+***********************************************************************************************************************************/
+int
+storagePosixWatchNew(const char *path)
+{
+#ifdef __linux__
+    // The descriptor is not inherited by child processes and reads do not block so all queued events can be read without polling
+    int watch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (watch == -1)
+        ERROR_THROW(FileOpenError, "unable to watch '%s': %s", path, strerror(errno));
+
+    if (inotify_add_watch(watch, path, IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_ONLYDIR) == -1)
+    {
+        int errNo = errno;
+        close(watch);
+
+        ERROR_THROW(
+            *(errNo == ENOENT ? &FileMissingError : &FileOpenError), "unable to watch '%s': %s", path, strerror(errNo));
+    }
+
+    return watch;
+#else
+    ERROR_THROW(FeatureNotSupportedError, "unable to watch '%s': not supported on this platform", path);
+#endif
+}
+
+/***********************************************************************************************************************************
+Wait up to waitMs for events and then pass all queued events to the callback in the order they occurred
+
+Returns the number of events.  A wait of zero returns immediately when no events are queued.
+***********************************************************************************************************************************/
+unsigned int
+storagePosixWatchRead(int watch, unsigned int waitMs, StorageWatchCallback callback, void *callbackData)
+{
+    unsigned int result = 0;
+
+#ifdef __linux__
+    struct pollfd pollData = {.fd = watch, .events = POLLIN};
+
+    if (poll(&pollData, 1, (int)waitMs) == -1 && errno != EINTR)
+        ERROR_THROW(FileReadError, "unable to wait for watch events: %s", strerror(errno));
+
+    // Events are always whole and aligned for struct inotify_event
+    char buffer[STORAGE_WATCH_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    while (true)
+    {
+        ssize_t bufferSize = read(watch, buffer, sizeof(buffer));
+
+        if (bufferSize == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            // No more events queued
+            if (errno == EAGAIN)
+                break;
+
+            ERROR_THROW(FileReadError, "unable to read watch events: %s", strerror(errno));
+        }
+
+        for (char *eventPtr = buffer; eventPtr < buffer + bufferSize;)
+        {
+            const struct inotify_event *event = (const struct inotify_event *)eventPtr;
+            eventPtr += sizeof(struct inotify_event) + event->len;
+
+            // The queue overflowed or the watch was removed because the path is gone
+            if (event->mask & (IN_Q_OVERFLOW | IN_IGNORED))
+                callback(callbackData, storageWatchEventOverflow, NULL);
+            // Skip events without a name, e.g. for the path itself
+            else if (event->len == 0)
+                continue;
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                callback(callbackData, storageWatchEventAdd, event->name);
+            else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                callback(callbackData, storageWatchEventRemove, event->name);
+            else
+                continue;
+
+            result++;
+        }
+    }
+#else
+    (void)watch;
+    (void)waitMs;
+    (void)callback;
+    (void)callbackData;
+#endif
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Stop watching
+***********************************************************************************************************************************/
+void
+storagePosixWatchFree(int watch)
+{
+    if (watch != -1)
+        close(watch);
+}
@@ -0,0 +1,31 @@
+/***********************************************************************************************************************************
+Posix Storage Watch
+***********************************************************************************************************************************/
+#ifndef STORAGE_POSIX_WATCH_H
+#define STORAGE_POSIX_WATCH_H
+
+#include "common/type.h"
+
+/***********************************************************************************************************************************
+Types of events passed to the callback
+
+Overflow means that events were lost (or the watch was removed) and the caller must read the path again to know what is in it.  The
+name is NULL for overflow events.
+***********************************************************************************************************************************/
+typedef enum
+{
+    storageWatchEventAdd = 'a',
+    storageWatchEventRemove = 'r',
+    storageWatchEventOverflow = 'o',
+} StorageWatchEventType;
+
+typedef void (*StorageWatchCallback)(void *callbackData, StorageWatchEventType type, const char *name);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+int storagePosixWatchNew(const char *path);
+unsigned int storagePosixWatchRead(int watch, unsigned int waitMs, StorageWatchCallback callback, void *callbackData);
+void storagePosixWatchFree(int watch);
+
+#endif
@@ -0,0 +1,29 @@
+/***********************************************************************************************************************************
+Version Numbers and Names
+
+These must match the constants in lib/pgBackRest/Version.pm -- test.pl errors when they do not.
+***********************************************************************************************************************************/
+#ifndef VERSION_H
+#define VERSION_H
+
+/***********************************************************************************************************************************
+Official name of the project
+***********************************************************************************************************************************/
+#define PGBACKREST_NAME                                             "pgBackRest"
+
+/***********************************************************************************************************************************
+Standard binary name
+***********************************************************************************************************************************/
+#define PGBACKREST_BIN                                              "pgbackrest"
+
+/***********************************************************************************************************************************
+Format number -- defines format for info and manifest files as well as on-disk structure
+***********************************************************************************************************************************/
+#define PGBACKREST_FORMAT                                           5
+
+/***********************************************************************************************************************************
+Software version -- tracks features but does not affect what repositories or manifests can be read
+***********************************************************************************************************************************/
+#define PGBACKREST_VERSION                                          "1.26dev"
+
+#endif
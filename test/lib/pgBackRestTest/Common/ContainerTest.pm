@@ -324,7 +324,7 @@ sub containerBuild
                 "    yum -y update && \\\n" .
                 "    yum -y install openssh-server openssh-clients wget sudo python-pip build-essential git \\\n" .
                 "        perl perl-Digest-SHA perl-DBD-Pg perl-XML-LibXML perl-IO-Socket-SSL \\\n" .
-                "        gcc make perl-ExtUtils-MakeMaker perl-Test-Simple";
+                "        gcc make perl-ExtUtils-MakeMaker perl-Test-Simple openssl-devel zlib-devel";
 
             if ($strOS eq VM_CO6)
             {
@@ -343,7 +343,7 @@ sub containerBuild
                 "    wget --no-check-certificate -O /root/get-pip.py https://bootstrap.pypa.io/get-pip.py && \\\n" .
                 "    python /root/get-pip.py && \\\n" .
                 "    apt-get -y install openssh-server wget sudo python-pip build-essential git \\\n" .
-                "        libdbd-pg-perl libhtml-parser-perl libio-socket-ssl-perl libxml-libxml-perl";
+                "        libdbd-pg-perl libhtml-parser-perl libio-socket-ssl-perl libxml-libxml-perl libssl-dev zlib1g-dev";
 
             if ($strOS eq VM_U14)
             {
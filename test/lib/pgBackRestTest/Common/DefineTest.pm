@@ -73,6 +73,8 @@ use constant TESTDEF_MODULE_COMMON                                  => 'Common';
     push @EXPORT, qw(TESTDEF_MODULE_COMMON);
 use constant TESTDEF_MODULE_COMMON_INI                              => TESTDEF_MODULE_COMMON . '/Ini';
     push @EXPORT, qw(TESTDEF_MODULE_COMMON_INI);
+use constant TESTDEF_MODULE_COMMON_INI_BINARY                       => TESTDEF_MODULE_COMMON . '/IniBinary';
+    push @EXPORT, qw(TESTDEF_MODULE_COMMON_INI_BINARY);
 
 use constant TESTDEF_MODULE_INFO                                    => 'Info';
     push @EXPORT, qw(TESTDEF_MODULE_INFO);
@@ -139,6 +141,26 @@ my $oTestDef =
                         'common/encode/base64' => TESTDEF_COVERAGE_FULL,
                     },
                 },
+                {
+                    &TESTDEF_NAME => 'ini-c',
+                    &TESTDEF_TOTAL => 2,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'common/ini' => TESTDEF_COVERAGE_FULL,
+                    },
+                },
+                {
+                    &TESTDEF_NAME => 'log-c',
+                    &TESTDEF_TOTAL => 3,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'common/log' => TESTDEF_COVERAGE_FULL,
+                    },
+                },
                 {
                     &TESTDEF_NAME => 'encode-perl',
                     &TESTDEF_TOTAL => 1,
@@ -155,13 +177,22 @@ my $oTestDef =
                 },
                 {
                     &TESTDEF_NAME => 'ini',
-                    &TESTDEF_TOTAL => 10,
+                    &TESTDEF_TOTAL => 13,
 
                     &TESTDEF_COVERAGE =>
                     {
                         &TESTDEF_MODULE_COMMON_INI => TESTDEF_COVERAGE_PARTIAL,
                     },
                 },
+                {
+                    &TESTDEF_NAME => 'ini-binary',
+                    &TESTDEF_TOTAL => 1,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        &TESTDEF_MODULE_COMMON_INI_BINARY => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
                 {
                     &TESTDEF_NAME => 'io-handle',
                     &TESTDEF_TOTAL => 6,
@@ -198,6 +229,15 @@ my $oTestDef =
                         'Common/Log' => TESTDEF_COVERAGE_PARTIAL,
                     },
                 },
+                {
+                    &TESTDEF_NAME => 'limit',
+                    &TESTDEF_TOTAL => 3,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'Common/Limit' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
             ]
         },
         # PostgreSQL tests
@@ -217,6 +257,35 @@ my $oTestDef =
                         'postgres/pageChecksum' => TESTDEF_COVERAGE_FULL,
                     },
                 },
+                {
+                    &TESTDEF_NAME => 'wal',
+                    &TESTDEF_TOTAL => 2,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'postgres/wal' => TESTDEF_COVERAGE_FULL,
+                    },
+                },
+            ]
+        },
+        # Crypto tests
+        {
+            &TESTDEF_NAME => 'crypto',
+            &TESTDEF_CONTAINER => true,
+
+            &TESTDEF_TEST =>
+            [
+                {
+                    &TESTDEF_NAME => 'hash',
+                    &TESTDEF_TOTAL => 1,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'crypto/hash' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
             ]
         },
         # Help tests
@@ -247,12 +316,23 @@ my $oTestDef =
 
                     &TESTDEF_COVERAGE =>
                     {
-                        'config/config' => TESTDEF_COVERAGE_NOCODE,
+                        'config/config' => TESTDEF_COVERAGE_FULL,
                         'config/config.auto' => TESTDEF_COVERAGE_FULL,
                         'config/configRule' => TESTDEF_COVERAGE_FULL,
                         'config/configRule.auto' => TESTDEF_COVERAGE_FULL,
                     },
                 },
+                {
+                    &TESTDEF_NAME => 'parse',
+                    &TESTDEF_TOTAL => 3,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'config/config' => TESTDEF_COVERAGE_FULL,
+                        'config/parse' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
                 {
                     &TESTDEF_NAME => 'unit',
                     &TESTDEF_TOTAL => 1,
@@ -274,6 +354,37 @@ my $oTestDef =
 
             &TESTDEF_TEST =>
             [
+                {
+                    &TESTDEF_NAME => 'posix-manifest',
+                    &TESTDEF_TOTAL => 1,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'storage/posix/manifest' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
+                {
+                    &TESTDEF_NAME => 'posix-watch',
+                    &TESTDEF_TOTAL => 1,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'storage/posix/watch' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
+                {
+                    &TESTDEF_NAME => 'posix-storage',
+                    &TESTDEF_TOTAL => 3,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'storage/posix/storage' => TESTDEF_COVERAGE_PARTIAL,
+                        'storage/posix/fileWrite' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
                 {
                     &TESTDEF_NAME => 'filter-gzip',
                     &TESTDEF_TOTAL => 3,
@@ -292,6 +403,15 @@ my $oTestDef =
                         'Storage/Filter/Sha' => TESTDEF_COVERAGE_FULL,
                     },
                 },
+                {
+                    &TESTDEF_NAME => 'filter-zero',
+                    &TESTDEF_TOTAL => 1,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'Storage/Filter/Zero' => TESTDEF_COVERAGE_FULL,
+                    },
+                },
                 {
                     &TESTDEF_NAME => 'posix',
                     &TESTDEF_TOTAL => 9,
@@ -367,10 +487,12 @@ my $oTestDef =
             [
                 {
                     &TESTDEF_NAME => 'common-minion',
-                    &TESTDEF_TOTAL => 1,
+                    &TESTDEF_TOTAL => 4,
 
                     &TESTDEF_COVERAGE =>
                     {
+                        'Protocol/Base/Frame' => TESTDEF_COVERAGE_PARTIAL,
+                        'Protocol/Base/Master' => TESTDEF_COVERAGE_PARTIAL,
                         'Protocol/Base/Minion' => TESTDEF_COVERAGE_PARTIAL,
                     },
                 },
@@ -383,6 +505,24 @@ my $oTestDef =
                         'Protocol/Helper' => TESTDEF_COVERAGE_PARTIAL,
                     },
                 },
+                {
+                    &TESTDEF_NAME => 'stats',
+                    &TESTDEF_TOTAL => 2,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'Protocol/Base/Stats' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
+                {
+                    &TESTDEF_NAME => 'local-process',
+                    &TESTDEF_TOTAL => 3,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'Protocol/Local/Process' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
             ]
         },
         # Info tests
@@ -403,6 +543,26 @@ my $oTestDef =
                 },
             ]
         },
+        # Command tests
+        {
+            &TESTDEF_NAME => 'command',
+            &TESTDEF_CONTAINER => true,
+
+            &TESTDEF_TEST =>
+            [
+                {
+                    &TESTDEF_NAME => 'archive-push',
+                    &TESTDEF_TOTAL => 3,
+                    &TESTDEF_C => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'command/command' => TESTDEF_COVERAGE_FULL,
+                        'command/archive/push/push' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
+            ]
+        },
         # Archive tests
         {
             &TESTDEF_NAME => 'archive',
@@ -411,7 +571,7 @@ my $oTestDef =
             [
                 {
                     &TESTDEF_NAME => 'common',
-                    &TESTDEF_TOTAL => 4,
+                    &TESTDEF_TOTAL => 6,
                     &TESTDEF_CONTAINER => true,
 
                     &TESTDEF_COVERAGE =>
@@ -419,9 +579,21 @@ my $oTestDef =
                         'Archive/Common' => TESTDEF_COVERAGE_PARTIAL,
                     },
                 },
+                {
+                    &TESTDEF_NAME => 'get',
+                    &TESTDEF_TOTAL => 3,
+                    &TESTDEF_CONTAINER => true,
+
+                    &TESTDEF_COVERAGE =>
+                    {
+                        'Archive/Get/Async' => TESTDEF_COVERAGE_PARTIAL,
+                        'Archive/Get/File' => TESTDEF_COVERAGE_PARTIAL,
+                        'Archive/Get/Get' => TESTDEF_COVERAGE_PARTIAL,
+                    },
+                },
                 {
                     &TESTDEF_NAME => 'push',
-                    &TESTDEF_TOTAL => 7,
+                    &TESTDEF_TOTAL => 8,
                     &TESTDEF_CONTAINER => true,
 
                     &TESTDEF_COVERAGE =>
@@ -455,7 +627,7 @@ my $oTestDef =
             [
                 {
                     &TESTDEF_NAME => 'unit',
-                    &TESTDEF_TOTAL => 3,
+                    &TESTDEF_TOTAL => 6,
                 },
                 {
                     &TESTDEF_NAME => 'info-unit',
@@ -550,7 +722,7 @@ my $oTestDef =
             [
                 {
                     &TESTDEF_NAME => 'archive',
-                    &TESTDEF_TOTAL => 1,
+                    &TESTDEF_TOTAL => 2,
                 },
                 {
                     &TESTDEF_NAME => 'io',
@@ -584,6 +756,13 @@ foreach my $hModule (@{$oTestDef->{&TESTDEF_MODULE}})
     {
         # Push the test on the order list
         my $strTest = $hModuleTest->{&TESTDEF_NAME};
+
+        # Test names must be unique in the module since tests are looked up by name
+        if (defined($hTestDefHash->{$strModule}{$strTest}))
+        {
+            confess &log(ASSERT, "test ${strTest} is defined more than once in module ${strModule}");
+        }
+
         push(@stryModuleTest, $strTest);
 
         # Resolve variables that can be set in the module or the test
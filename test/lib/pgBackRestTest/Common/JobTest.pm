@@ -60,6 +60,8 @@ sub new
         $self->{bShowOutputAsync},
         $self->{bNoCleanup},
         $self->{iRetry},
+        $self->{iScale},
+        $self->{fWalRate},
     ) =
         logDebugParam
         (
@@ -80,6 +82,8 @@ sub new
             {name => 'bShowOutputAsync'},
             {name => 'bNoCleanup'},
             {name => 'iRetry'},
+            {name => 'iScale'},
+            {name => 'fWalRate'},
         );
 
     # Set try to 0
@@ -219,7 +223,9 @@ sub run
                 ($self->{bLogForce} ? ' --log-force' : '') .
                 ($self->{bDryRun} ? ' --dry-run' : '') .
                 ($self->{bDryRun} ? ' --vm-out' : '') .
-                ($self->{bNoCleanup} ? " --no-cleanup" : '');
+                ($self->{bNoCleanup} ? " --no-cleanup" : '') .
+                ($self->{iScale} != 1 ? " --scale=$self->{iScale}" : '') .
+                ($self->{fWalRate} != 0 ? " --wal-rate=$self->{fWalRate}" : '');
         }
 
         &log(DETAIL, $strCommand);
@@ -246,6 +252,9 @@ sub run
                     # Skip all files except .c files (including .auto.c)
                     next if $strFile !~ /(?<!\.auto)\.c$/;
 
+                    # Skip main.c since the test harness has its own main()
+                    next if $strFile eq 'main.c';
+
                     if (!defined($hTestCoverage->{substr($strFile, 0, length($strFile) - 2)}))
                     {
                         push(@stryCFile, "${strCSrcPath}/${strFile}");
@@ -314,10 +323,11 @@ sub run
                 $self->{oStorageTest}->put("$self->{strGCovPath}/test.c", $strTestC);
 
                 my $strGccCommand =
-                    'gcc -std=c99 -fprofile-arcs -ftest-coverage -fPIC -O0 ' .
+                    'gcc -std=c99 -D_POSIX_C_SOURCE=200809L -fprofile-arcs -ftest-coverage -fPIC -O0 ' .
+                    '-Wall -Wextra -Werror -Wno-dangling-else ' .
                     "-I/$self->{strBackRestBase}/src -I/$self->{strBackRestBase}/test/src test.c " .
                     "/$self->{strBackRestBase}/test/src/common/harnessTest.c " .
-                    join(' ', @stryCFile) . ' -o test';
+                    join(' ', @stryCFile) . ' -lpthread -lcrypto -lz -o test';
 
                 executeTest(
                     'docker exec -i -u ' . TEST_USER . " ${strImage} bash -l -c '" .
@@ -125,6 +125,8 @@ sub process
         $self->{strPgUser},
         $self->{strBackRestUser},
         $self->{strGroup},
+        $self->{iScale},
+        $self->{fWalRate},
     ) =
         logDebugParam
         (
@@ -146,6 +148,8 @@ sub process
             {name => 'strPgUser'},
             {name => 'strBackRestUser'},
             {name => 'strGroup'},
+            {name => 'iScale'},
+            {name => 'fWalRate'},
         );
 
     # Init will only be run on first test, clean/init on subsequent tests
@@ -602,9 +606,11 @@ sub pgBinPath {return shift->{strPgBinPath}}
 sub pgUser {return shift->{strPgUser}}
 sub pgVersion {return shift->{strPgVersion}}
 sub runCurrent {return shift->{iRun}}
+sub scale {return shift->{iScale}}
 sub stanza {return 'db'}
 sub testPath {return shift->{strTestPath}}
 sub vm {return shift->{strVm}}
 sub vmId {return shift->{iVmId}}
+sub walRate {return shift->{fWalRate}}
 
 1;
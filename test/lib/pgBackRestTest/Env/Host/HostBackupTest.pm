@@ -494,7 +494,7 @@ sub backupCompare
 
     my $strTestPath = $self->testPath();
 
-    storageTest()->put("${strTestPath}/actual.manifest", iniRender($oActualManifest->{oContent}));
+    storageTest()->put("${strTestPath}/actual.manifest", iniRender($oActualManifest->content()));
     storageTest()->put("${strTestPath}/expected.manifest", iniRender($oExpectedManifest));
 
     executeTest("diff ${strTestPath}/expected.manifest ${strTestPath}/actual.manifest");
@@ -359,7 +359,7 @@ sub restore
                 STORAGE_REPO_BACKUP . qw{/} . ($strBackup eq 'latest' ? $oHostBackup->backupLast() : $strBackup) . qw{/} .
                     FILE_MANIFEST));
 
-        $oExpectedManifestRef = $oExpectedManifest->{oContent};
+        $oExpectedManifestRef = $oExpectedManifest->content();
 
         # Remap links in the expected manifest
         foreach my $strTarget (sort(keys(%{$self->{hLinkRemap}})))
@@ -710,7 +710,7 @@ sub restoreCompare
 
     $self->manifestDefault($oExpectedManifestRef);
 
-    storageTest()->put("${strTestPath}/actual.manifest", iniRender($oActualManifest->{oContent}));
+    storageTest()->put("${strTestPath}/actual.manifest", iniRender($oActualManifest->content()));
     storageTest()->put("${strTestPath}/expected.manifest", iniRender($oExpectedManifestRef));
 
     executeTest("diff ${strTestPath}/expected.manifest ${strTestPath}/actual.manifest");
@@ -17,6 +17,8 @@ use pgBackRest::Archive::Common;
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Log;
 use pgBackRest::Config::Config;
+use pgBackRest::DbVersion;
+use pgBackRest::Protocol::Local::Process;
 use pgBackRest::Protocol::Storage::Helper;
 
 use pgBackRestTest::Env::Host::HostBackupTest;
@@ -92,6 +94,26 @@ sub run
         $self->testResult(sub {walIsPartial($strWalSegment)}, true, "${strWalSegment} WAL is partial");
     }
 
+    ################################################################################################################################
+    if ($self->begin("${strModule}::walSegmentNext()"))
+    {
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {walSegmentNext('0000000200ABCDEF0000000A', PG_VERSION_96)}, '0000000200ABCDEF0000000B', 'next segment');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {walSegmentNext('0000000200ABCDEF000000FE', PG_VERSION_96)}, '0000000200ABCDEF000000FF', 'FF segment >= 9.3');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {walSegmentNext('0000000200ABCDEF000000FF', PG_VERSION_96)}, '0000000200ABCDF000000000', 'next major >= 9.3');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {walSegmentNext('0000000200ABCDEF000000FE', PG_VERSION_92)}, '0000000200ABCDF000000000', 'FF skipped < 9.3');
+    }
+
     ################################################################################################################################
     if ($self->begin("${strModule}::walSegmentFind()"))
     {
@@ -155,6 +177,121 @@ sub run
 
         $self->testResult(
             sub {walSegmentFind(storageRepo(), $strArchiveId, $strWalSegment)}, $strWalSegmentHash, "${strWalSegment} WAL found");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {walSegmentFind(storageRepo(), $strArchiveId, $strWalSegment, undef, {bCache => true})}, $strWalSegmentHash,
+            "${strWalSegment} WAL found and path cached");
+
+        my $strWalSegmentNext = '000000010000000100000002';
+        my $strWalSegmentNextHash = "${strWalSegmentNext}-a0b0d38b8aa263e25b8ff52a0a4ba85b6be97f9b.gz";
+        storageRepo()->put("${strWalMajorPath}/${strWalSegmentNextHash}");
+
+        $self->testResult(
+            sub {walSegmentFind(storageRepo(), $strArchiveId, $strWalSegmentNext, undef, {bCache => true})}, $strWalSegmentNextHash,
+            "${strWalSegmentNext} WAL found after cached path listed again");
+
+        storageRepo()->remove("${strWalMajorPath}/${strWalSegmentHash}");
+
+        $self->testResult(
+            sub {walSegmentFind(storageRepo(), $strArchiveId, $strWalSegment, undef, {bCache => true})}, $strWalSegmentHash,
+            "${strWalSegment} WAL found in cache after removal");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {walSegmentFind(storageRepo(), $strArchiveId, '000000010000000100000003', undef, {bCache => true})}, undef,
+            "000000010000000100000003 WAL not found");
+
+        $self->testResult(
+            sub {walSegmentFind(storageRepo(), $strArchiveId, $strWalSegment, undef, {bCache => true})}, undef,
+            "${strWalSegment} WAL not found after cached path listed again");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageRepo()->put("${strWalMajorPath}/${strWalSegmentHash}");
+        storageRepo()->put("${strWalMajorPath}/${strWalSegment}-53aa5d59515aa7288ae02ba414c009aed1ca73ad");
+
+        $self->testException(
+            sub {walSegmentFind(storageRepo(), $strArchiveId, $strWalSegment, undef, {bCache => true})}, ERROR_ARCHIVE_DUPLICATE,
+            "duplicates found in archive for WAL segment ${strWalSegment}: " .
+                "${strWalSegment}-53aa5d59515aa7288ae02ba414c009aed1ca73ad, ${strWalSegmentHash}" .
+            "\nHINT: are multiple primaries archiving to this stanza?");
+    }
+
+    ################################################################################################################################
+    if ($self->begin("${strModule}::walSegmentFindList()"))
+    {
+        $self->optionTestSet(CFGOPT_STANZA, $self->stanza());
+        $self->optionTestSet(CFGOPT_REPO_PATH, $self->testPath());
+        $self->configTestLoad(CFGCMD_ARCHIVE_PUSH);
+
+        my $strArchiveId = '9.4-1';
+        my $strArchivePath = storageRepo()->pathGet(STORAGE_REPO_ARCHIVE . "/${strArchiveId}");
+        my $stryWalSegment = ['0000000100000001000000FE', '0000000100000001000000FF', '000000010000000200000000'];
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testException(
+            sub {walSegmentFindList(storageRepo(), $strArchiveId, ['000000010000000100000001ZZ'])}, ERROR_ASSERT,
+            "000000010000000100000001ZZ is not a WAL segment");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {walSegmentFindList(storageRepo(), $strArchiveId, $stryWalSegment)}, '([undef], [undef], [undef])',
+            'no WAL found');
+
+        $self->testException(
+            sub {walSegmentFindList(storageRepo(), $strArchiveId, $stryWalSegment, .1)}, ERROR_ARCHIVE_TIMEOUT,
+            "could not find WAL segment ${$stryWalSegment}[0] after 0.1 second(s)");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $stryWalSegmentHash =
+        [
+            "${$stryWalSegment}[0]-53aa5d59515aa7288ae02ba414c009aed1ca73ad",
+            "${$stryWalSegment}[1]-a0b0d38b8aa263e25b8ff52a0a4ba85b6be97f9b.gz",
+            "${$stryWalSegment}[2]-996195c807713ef9262170043e7222cb150aef70",
+        ];
+
+        foreach my $strWalSegmentHash (@{$stryWalSegmentHash})
+        {
+            my $strWalMajorPath = "${strArchivePath}/" . substr($strWalSegmentHash, 0, 16);
+
+            storageRepo()->pathCreate($strWalMajorPath, {bCreateParent => true, bIgnoreExists => true});
+            storageRepo()->put("${strWalMajorPath}/${strWalSegmentHash}");
+        }
+
+        storageRepo()->remove("${strArchivePath}/" . substr(${$stryWalSegmentHash}[1], 0, 16) . "/${$stryWalSegmentHash}[1]");
+
+        $self->testException(
+            sub {walSegmentFindList(storageRepo(), $strArchiveId, $stryWalSegment, .1)}, ERROR_ARCHIVE_TIMEOUT,
+            "could not find WAL segment ${$stryWalSegment}[1] after 0.1 second(s)");
+
+        $self->testResult(
+            sub {walSegmentFindList(storageRepo(), $strArchiveId, $stryWalSegment)},
+            "(${$stryWalSegmentHash}[0], [undef], ${$stryWalSegmentHash}[2])", 'missing WAL is undef');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageRepo()->put("${strArchivePath}/" . substr(${$stryWalSegmentHash}[1], 0, 16) . "/${$stryWalSegmentHash}[1]");
+
+        $self->testResult(
+            sub {walSegmentFindList(storageRepo(), $strArchiveId, $stryWalSegment, .1)},
+            '(' . join(', ', @{$stryWalSegmentHash}) . ')', 'all WAL found');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $oProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP, undef, $self->backrestExe());
+        $oProcess->hostAdd(1, 2);
+
+        $self->testResult(
+            sub {walSegmentFindList(storageRepo(), $strArchiveId, $stryWalSegment, .1, {oProcess => $oProcess})},
+            '(' . join(', ', @{$stryWalSegmentHash}) . ')', 'all WAL found with local processes');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $strWalSegmentDup = "${$stryWalSegment}[2]-53aa5d59515aa7288ae02ba414c009aed1ca73ad.gz";
+        storageRepo()->put("${strArchivePath}/" . substr($strWalSegmentDup, 0, 16) . "/${strWalSegmentDup}");
+
+        $self->testException(
+            sub {walSegmentFindList(storageRepo(), $strArchiveId, $stryWalSegment, undef, {oProcess => $oProcess})},
+            ERROR_ARCHIVE_DUPLICATE,
+            "duplicates found in archive for WAL segment ${$stryWalSegment}[2]: ${strWalSegmentDup}, ${$stryWalSegmentHash}[2]" .
+            "\nHINT: are multiple primaries archiving to this stanza?");
     }
 }
 
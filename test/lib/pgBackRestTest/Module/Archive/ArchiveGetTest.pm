@@ -0,0 +1,312 @@
+####################################################################################################################################
+# Archive Get Tests
+####################################################################################################################################
+package pgBackRestTest::Module::Archive::ArchiveGetTest;
+use parent 'pgBackRestTest::Env::HostEnvTest';
+
+####################################################################################################################################
+# Perl includes
+####################################################################################################################################
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use pgBackRest::Archive::Common;
+use pgBackRest::Archive::Get::Async;
+use pgBackRest::Archive::Get::File;
+use pgBackRest::Archive::Get::Get;
+use pgBackRest::Archive::Info;
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Log;
+use pgBackRest::Common::Wait;
+use pgBackRest::Config::Config;
+use pgBackRest::DbVersion;
+use pgBackRest::Manifest;
+use pgBackRest::Protocol::Storage::Helper;
+use pgBackRest::Storage::Base;
+use pgBackRest::Storage::Filter::Gzip;
+use pgBackRest::Storage::Helper;
+
+use pgBackRestTest::Env::HostEnvTest;
+use pgBackRestTest::Common::RunTest;
+
+####################################################################################################################################
+# initModule
+####################################################################################################################################
+sub initModule
+{
+    my $self = shift;
+
+    $self->{strDbPath} = $self->testPath() . '/db';
+    $self->{strWalPath} = "$self->{strDbPath}/pg_xlog";
+    $self->{strRepoPath} = $self->testPath() . '/repo';
+    $self->{strArchivePath} = "$self->{strRepoPath}/archive/" . $self->stanza();
+    $self->{strSpoolPath} = "$self->{strArchivePath}/in";
+}
+
+####################################################################################################################################
+# initTest
+####################################################################################################################################
+sub initTest
+{
+    my $self = shift;
+
+    # Create WAL path and pg_control so the database version and system id can be read
+    storageTest()->pathCreate($self->{strWalPath}, {bIgnoreExists => true, bCreateParent => true});
+    storageTest()->pathCreate($self->{strDbPath} . '/' . DB_PATH_GLOBAL, {bIgnoreExists => true});
+    storageTest()->copy(
+        $self->dataPath() . '/backup.pg_control_' . WAL_VERSION_94 . '.bin', "$self->{strDbPath}/" . DB_FILE_PGCONTROL);
+
+    # Create archive info
+    storageTest()->pathCreate($self->{strArchivePath}, {bIgnoreExists => true, bCreateParent => true});
+
+    $self->optionTestSet(CFGOPT_STANZA, $self->stanza());
+    $self->optionTestSet(CFGOPT_DB_PATH, $self->{strDbPath});
+    $self->optionTestSet(CFGOPT_REPO_PATH, $self->{strRepoPath});
+    $self->optionTestSet(CFGOPT_LOG_PATH, $self->testPath());
+    $self->optionTestSetBool(CFGOPT_ARCHIVE_ASYNC, true);
+    $self->optionTestSet(CFGOPT_SPOOL_PATH, $self->{strRepoPath});
+    $self->optionTestSet(CFGOPT_ARCHIVE_GET_QUEUE_MAX, PG_WAL_SIZE * 3);
+
+    $self->optionTestSet(CFGOPT_DB_TIMEOUT, 5);
+    $self->optionTestSet(CFGOPT_PROTOCOL_TIMEOUT, 6);
+    $self->optionTestSet(CFGOPT_ARCHIVE_TIMEOUT, 5);
+
+    $self->configTestLoad(CFGCMD_ARCHIVE_GET);
+
+    my $oArchiveInfo = new pgBackRest::Archive::Info($self->{strArchivePath}, false, {bIgnoreMissing => true});
+    $oArchiveInfo->create(PG_VERSION_94, WAL_VERSION_94_SYS_ID, true);
+
+    $self->{strArchiveId} = $oArchiveInfo->archiveId();
+}
+
+####################################################################################################################################
+# walPut
+#
+# Store a WAL segment in the repo with a bogus checksum.  When compressed the original size can be stored in the gzip header.
+####################################################################################################################################
+sub walPut
+{
+    my $self = shift;
+    my $strSegment = shift;
+    my $bCompress = shift;
+    my $strChecksum = shift;
+    my $lOriginalSize = shift;
+
+    my $strFile =
+        STORAGE_REPO_ARCHIVE . "/$self->{strArchiveId}/" . substr($strSegment, 0, 16) . "/${strSegment}-" .
+        (defined($strChecksum) ? $strChecksum : ('1' x 40)) . ($bCompress ? '.' . COMPRESS_EXT : '');
+
+    storageRepo()->put(
+        storageRepo()->openWrite(
+            $strFile,
+            {bPathCreate => true,
+                rhyFilter => $bCompress ? [{strClass => STORAGE_FILTER_GZIP, rxyParam => [{lOriginalSize => $lOriginalSize}]}] :
+                    undef}),
+        $strSegment);
+}
+
+####################################################################################################################################
+# run
+####################################################################################################################################
+sub run
+{
+    my $self = shift;
+
+    my $strSegment1 = $self->walSegment(1, 1, 1);
+    my $strSegment2 = $self->walSegment(1, 1, 2);
+    my $strSegment3 = $self->walSegment(1, 1, 3);
+    my $strSegment4 = $self->walSegment(1, 1, 4);
+
+    ################################################################################################################################
+    if ($self->begin("ArchiveGetFile::archiveGetFile()"))
+    {
+        my $strDestination = "$self->{strSpoolPath}/${strSegment1}";
+
+        storageTest()->pathCreate($self->{strSpoolPath}, {bCreateParent => true});
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {archiveGetFile($self->{strArchiveId}, $strSegment1, $strDestination)}, false, "${strSegment1} not in archive");
+        $self->testResult(sub {storageSpool()->list($self->{strSpoolPath})}, '[undef]', '    nothing written to spool');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->walPut($strSegment1);
+
+        $self->testResult(
+            sub {archiveGetFile($self->{strArchiveId}, $strSegment1, $strDestination)}, true, "${strSegment1} in archive");
+        $self->testResult(sub {${storageTest()->get($strDestination)}}, $strSegment1, '    check segment in spool');
+        $self->testResult(sub {storageSpool()->list($self->{strSpoolPath})}, $strSegment1, '    no temp file left in spool');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $strDestination = "$self->{strSpoolPath}/${strSegment2}";
+        $self->walPut($strSegment2, true);
+
+        $self->testResult(
+            sub {archiveGetFile($self->{strArchiveId}, $strSegment2, $strDestination)}, true,
+            "${strSegment2} compressed in archive");
+        $self->testResult(sub {${storageTest()->get($strDestination)}}, $strSegment2, '    segment decompressed without padding');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $strDestination = "$self->{strSpoolPath}/${strSegment3}";
+        $self->walPut($strSegment3, true, undef, PG_WAL_SEGMENT_SIZE);
+
+        $self->testResult(
+            sub {archiveGetFile($self->{strArchiveId}, $strSegment3, $strDestination)}, true,
+            "${strSegment3} compressed with original size in archive");
+        $self->testResult(
+            sub {storageTest()->info($strDestination)->size()}, PG_WAL_SEGMENT_SIZE, '    segment decompressed and padded');
+        $self->testResult(
+            sub {${storageTest()->get($strDestination)}}, $strSegment3 . ("\0" x (PG_WAL_SEGMENT_SIZE - length($strSegment3))),
+            '    check segment in spool');
+    }
+
+    ################################################################################################################################
+    if ($self->begin("ArchiveGetAsync->processServer()"))
+    {
+        my $oGetAsync = new pgBackRest::Archive::Get::Async($self->{strSpoolPath}, $strSegment1, $self->backrestExe());
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$oGetAsync->queueTotal()}, 3, 'queue total from archive-get-queue-max');
+
+        $self->optionTestSet(CFGOPT_ARCHIVE_GET_QUEUE_MAX, PG_WAL_SIZE - 1);
+        $self->configTestLoad(CFGCMD_ARCHIVE_GET);
+
+        $self->testResult(sub {$oGetAsync->queueTotal()}, 1, '    requested segment always queued');
+
+        $self->optionTestSet(CFGOPT_ARCHIVE_GET_QUEUE_MAX, PG_WAL_SIZE * 3);
+        $self->configTestLoad(CFGCMD_ARCHIVE_GET);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageTest()->pathCreate($self->{strSpoolPath}, {bCreateParent => true});
+        storageTest()->put("$self->{strSpoolPath}/" . $self->walSegment(1, 1, 0));
+        storageTest()->put("$self->{strSpoolPath}/${strSegment2}");
+        storageTest()->put("$self->{strSpoolPath}/${strSegment3}.ok");
+
+        $self->testResult(
+            sub {$oGetAsync->queueList(PG_VERSION_94)}, "(${strSegment1}, ${strSegment3})", 'queue skips segments in spool');
+        $self->testResult(
+            sub {storageSpool()->list($self->{strSpoolPath})}, $strSegment2, '    old segments and status files removed');
+
+        storageTest()->remove("$self->{strSpoolPath}/${strSegment2}");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->walPut($strSegment1);
+        $self->walPut($strSegment3, true);
+
+        $self->testResult(sub {$oGetAsync->processServer()}, undef, "get ${strSegment1}...${strSegment3}");
+        $self->testResult(
+            sub {storageSpool()->list($self->{strSpoolPath})}, "(${strSegment1}, ${strSegment2}.ok, ${strSegment3})",
+            "    ${strSegment1}, ${strSegment3} in spool, ${strSegment2} not found");
+        $self->testResult(sub {${storageSpool()->get("$self->{strSpoolPath}/${strSegment2}.ok")}}, undef, '    check ok file');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->walPut($strSegment2);
+        $self->walPut($strSegment2, true, '2' x 40);
+
+        $self->testResult(sub {$oGetAsync->processQueue()}, '(1, 0, 0, 1)', "get ${strSegment2} with duplicates in archive");
+        $self->testResult(
+            sub {storageSpool()->list($self->{strSpoolPath})}, "(${strSegment1}, ${strSegment2}.error, ${strSegment3})",
+            "    ${strSegment2} errored");
+        $self->testResult(
+            sub {${storageSpool()->get("$self->{strSpoolPath}/${strSegment2}.error")}},
+            ERROR_ARCHIVE_DUPLICATE . "\nraised from local-1 process: duplicates found in archive for WAL segment " .
+                "${strSegment2}: ${strSegment2}-" . ('1' x 40) . ", ${strSegment2}-" . ('2' x 40) . '.' . COMPRESS_EXT .
+                "\nHINT: are multiple primaries archiving to this stanza?",
+            '    check error file');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageTest()->copy(
+            $self->dataPath() . '/backup.pg_control_' . WAL_VERSION_95 . '.bin', "$self->{strDbPath}/" . DB_FILE_PGCONTROL);
+
+        $oGetAsync = new pgBackRest::Archive::Get::Async($self->{strSpoolPath}, $strSegment4, $self->backrestExe());
+
+        $self->testResult(sub {$oGetAsync->processServer()}, undef, "get ${strSegment4} with database mismatch");
+        $self->testResult(
+            sub {(split("\n", ${storageSpool()->get("$self->{strSpoolPath}/${strSegment4}.error")}))[0]}, ERROR_ARCHIVE_MISMATCH,
+            "    ${strSegment4} errored so the client does not wait");
+    }
+
+    ################################################################################################################################
+    if ($self->begin("ArchiveGet->getAsync()"))
+    {
+        my $oGet = new pgBackRest::Archive::Get::Get($self->backrestExe());
+        my $iProcessId = $PID;
+
+        storageTest()->pathCreate($self->{strSpoolPath}, {bCreateParent => true});
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageTest()->put("$self->{strSpoolPath}/${strSegment1}.ok");
+        utime(time() + 60, time() + 60, "$self->{strSpoolPath}/${strSegment1}.ok");
+
+        $self->testResult(
+            sub {$oGet->getAsync($strSegment1, "$self->{strWalPath}/RECOVERYXLOG")}, 1, "${strSegment1} not found by async process",
+            {strLogExpect => "INFO: unable to find ${strSegment1} in the archive asynchronously", strLogLevel => INFO});
+        $self->testResult(sub {storageSpool()->list($self->{strSpoolPath})}, '[undef]', '    ok file removed');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageTest()->put("$self->{strSpoolPath}/${strSegment1}.error", ERROR_ARCHIVE_DUPLICATE . "\ntest error\nline 2");
+
+        $self->testException(
+            sub {$oGet->getAsync($strSegment1, "$self->{strWalPath}/RECOVERYXLOG")}, ERROR_ARCHIVE_DUPLICATE,
+            "test error\nline 2");
+        $self->testResult(sub {storageSpool()->list($self->{strSpoolPath})}, '[undef]', '    error file removed');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->optionTestSet(CFGOPT_ARCHIVE_GET_QUEUE_MAX, PG_WAL_SIZE * 4);
+        $self->configTestLoad(CFGCMD_ARCHIVE_GET);
+
+        $self->walPut($strSegment1);
+        $self->walPut($strSegment2);
+        $self->walPut($strSegment3);
+        $self->walPut($strSegment4);
+
+        # Stale ok file is ignored and the async process is started
+        storageTest()->put("$self->{strSpoolPath}/${strSegment1}.ok");
+        utime(time() - 60, time() - 60, "$self->{strSpoolPath}/${strSegment1}.ok");
+
+        $self->testResult(
+            sub {$oGet->getAsync($strSegment1, "pg_xlog/RECOVERYXLOG")}, 0, "${strSegment1} fetched by async process");
+        exit if ($iProcessId != $PID);
+
+        waitpid(-1, 0);
+
+        $self->testResult(
+            sub {${storageTest()->get("$self->{strWalPath}/RECOVERYXLOG")}}, $strSegment1, "    check ${strSegment1}");
+        $self->testResult(
+            sub {storageSpool()->list($self->{strSpoolPath})}, "(${strSegment2}, ${strSegment3}, ${strSegment4})",
+            "    ${strSegment2}...${strSegment4} prefetched");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {$oGet->getAsync($strSegment2, "pg_xlog/RECOVERYXLOG")}, 0, "${strSegment2} from spool with half the queue left",
+            {strLogExpect => "INFO: got WAL segment ${strSegment2} asynchronously", strLogLevel => INFO});
+        exit if ($iProcessId != $PID);
+
+        $self->testResult(
+            sub {${storageTest()->get("$self->{strWalPath}/RECOVERYXLOG")}}, $strSegment2, "    check ${strSegment2}");
+        $self->testResult(
+            sub {storageSpool()->list($self->{strSpoolPath})}, "(${strSegment3}, ${strSegment4})", '    async process not started');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $strSegment5 = $self->walSegment(1, 1, 5);
+        $self->walPut($strSegment5);
+
+        $self->testResult(
+            sub {$oGet->getAsync($strSegment3, "pg_xlog/RECOVERYXLOG")}, 0,
+            "${strSegment3} from spool with less than half the queue left");
+        exit if ($iProcessId != $PID);
+
+        waitpid(-1, 0);
+
+        $self->testResult(
+            sub {${storageTest()->get("$self->{strWalPath}/RECOVERYXLOG")}}, $strSegment3, "    check ${strSegment3}");
+        $self->testResult(
+            sub {storageSpool()->list($self->{strSpoolPath})},
+            "(${strSegment4}, ${strSegment5}, " . $self->walSegment(1, 1, 6) . '.ok, ' . $self->walSegment(1, 1, 7) . '.ok)',
+            "    async process started after ${strSegment3} to fetch ${strSegment5} and the segments that follow");
+    }
+}
+
+1;
@@ -14,16 +14,20 @@ use English '-no_match_vars';
 
 use File::Basename qw(dirname);
 use Storable qw(dclone);
+use Time::HiRes qw(gettimeofday);
 
 use pgBackRest::Archive::Common;
+use pgBackRest::Archive::Info;
 use pgBackRest::Archive::Push::Push;
 use pgBackRest::Archive::Push::Async;
 use pgBackRest::Archive::Push::File;
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Lock;
 use pgBackRest::Common::Log;
+use pgBackRest::Common::Wait;
 use pgBackRest::Config::Config;
 use pgBackRest::DbVersion;
+use pgBackRest::LibCLoad;
 use pgBackRest::Protocol::Helper;
 use pgBackRest::Protocol::Storage::Helper;
 use pgBackRest::Storage::Helper;
@@ -183,6 +187,58 @@ sub run
         my $iWalMajor = 1;
         my $iWalMinor = 1;
 
+        #---------------------------------------------------------------------------------------------------------------------------
+        # Push a group to the local repo with two new segments and a missing segment
+        my $strSegmentGroup1 = $self->walSegment($iWalTimeline, 2, 1);
+        my $strSegmentGroup2 = $self->walSegment($iWalTimeline, 2, 2);
+        my $strSegmentGroup3 = $self->walSegment($iWalTimeline, 2, 3);
+
+        $self->walGenerate($self->{strWalPath}, WAL_VERSION_94, 1, $strSegmentGroup1);
+        $self->walGenerate($self->{strWalPath}, WAL_VERSION_94, 1, $strSegmentGroup2);
+
+        $self->testResult(
+            sub {join(', ', map {defined($_->{iErrorCode}) ? $_->{iErrorCode} : (defined($_->{strWarning}) ? 'warn' : 'ok')}
+                @{archivePushFileGroup(
+                    $self->{strWalPath}, [$strSegmentGroup1, $strSegmentGroup2, $strSegmentGroup3], false, false)})},
+            'ok, ok, ' . ERROR_FILE_OPEN, "group of WAL segments to local");
+
+        $self->testResult(
+            sub {storageRepo()->list(STORAGE_REPO_ARCHIVE . "/$self->{strArchiveId}/" . substr($strSegmentGroup1, 0, 16))},
+            "(${strSegmentGroup1}-$self->{strWalHash}, ${strSegmentGroup2}-$self->{strWalHash})", "segments in archive");
+
+        # Segments already in the archive are found even though the group does not list the archive path again
+        $self->testResult(
+            sub {join(', ', map {defined($_->{iErrorCode}) ? $_->{iErrorCode} : (defined($_->{strWarning}) ? 'warn' : 'ok')}
+                @{archivePushFileGroup($self->{strWalPath}, [$strSegmentGroup1, $strSegmentGroup2], false, false)})},
+            'warn, warn', "duplicate group of WAL segments to local");
+
+        # An error loading archive.info errors every file in the group
+        storageTest()->move("$self->{strArchivePath}", "$self->{strArchivePath}.save");
+
+        $self->testResult(
+            sub {join(', ', map {$_->{iErrorCode}}
+                @{archivePushFileGroup($self->{strWalPath}, [$strSegmentGroup1, $strSegmentGroup2], false, false)})},
+            ERROR_FILE_MISSING . ', ' . ERROR_FILE_MISSING, "group errors when archive.info is missing");
+
+        storageTest()->move("$self->{strArchivePath}.save", "$self->{strArchivePath}");
+
+        $self->walRemove($self->{strWalPath}, $strSegmentGroup1);
+        $self->walRemove($self->{strWalPath}, $strSegmentGroup2);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        # Archive info is only loaded again when the file changes
+        my $oArchiveInfo = archivePushInfo();
+
+        $self->testResult(sub {archivePushInfo() == $oArchiveInfo ? true : false}, true, 'archive info is cached');
+
+        storageTest()->copy(
+            "$self->{strArchivePath}/" . ARCHIVE_INFO_FILE, "$self->{strArchivePath}/" . ARCHIVE_INFO_FILE . '.tmp');
+        storageTest()->move(
+            "$self->{strArchivePath}/" . ARCHIVE_INFO_FILE . '.tmp', "$self->{strArchivePath}/" . ARCHIVE_INFO_FILE);
+
+        $self->testResult(sub {archivePushInfo() == $oArchiveInfo ? true : false}, false, 'archive info is loaded when changed');
+
+        #---------------------------------------------------------------------------------------------------------------------------
         $self->optionTestSet(CFGOPT_BACKUP_HOST, 'localhost');
         $self->optionTestSet(CFGOPT_BACKUP_USER, $self->pgUser());
         $self->configTestLoad(CFGCMD_ARCHIVE_PUSH);
@@ -203,6 +259,22 @@ sub run
                 'HINT: this is valid in some recovery scenarios but may also indicate a problem.',
             "${strSegment} WAL duplicate segment to remote");
 
+        #---------------------------------------------------------------------------------------------------------------------------
+        # Push a group with a duplicate, a new segment, and a missing segment
+        my $strSegmentNew = $self->walSegment($iWalTimeline, $iWalMajor, $iWalMinor++);
+        $self->walGenerate($self->{strWalPath}, WAL_VERSION_94, 1, $strSegmentNew);
+
+        my $strSegmentMissing = $self->walSegment($iWalTimeline, $iWalMajor, $iWalMinor++);
+
+        $self->testResult(
+            sub {join(', ', map {defined($_->{iErrorCode}) ? $_->{iErrorCode} : (defined($_->{strWarning}) ? 'warn' : 'ok')}
+                @{archivePushFileGroup($self->{strWalPath}, [$strSegment, $strSegmentNew, $strSegmentMissing], false, false)})},
+            'warn, ok, ' . ERROR_FILE_OPEN, "group of WAL segments to remote");
+
+        $self->testResult(
+            sub {walSegmentFind(storageRepo(), $self->{strArchiveId}, $strSegmentNew)}, "${strSegmentNew}-$self->{strWalHash}",
+            "${strSegmentNew} WAL in archive");
+
         # Destroy protocol object
         protocolDestroy();
 
@@ -287,6 +359,37 @@ sub run
         $self->testResult(
             sub {storageTest()->exists("$self->{strWalStatusPath}/00000002.history.ready")}, false,
             '00000002.history.ok is removed');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {defined($oPushAsync->{iReadyWatch}) ? true : false}, libC() ? true : false, 'archive status path is watched');
+
+        storageTest()->put("$self->{strWalStatusPath}/00000002.history.ready");
+        storageTest()->put("$self->{strWalStatusPath}/00000002.history.tmp");
+        $oPushAsync->readyWatchInit();
+
+        $self->testResult(
+            sub {$oPushAsync->readyList()}, '(00000002.history)', 'path is read when watch is started again');
+
+        storageTest()->move(
+            "$self->{strWalStatusPath}/00000002.history.tmp", "$self->{strWalStatusPath}/000000020000000100000002.ready");
+        storageTest()->move(
+            "$self->{strWalStatusPath}/00000002.history.ready", "$self->{strWalStatusPath}/00000002.history.done");
+
+        $self->testResult(
+            sub {$oPushAsync->readyList()}, '(000000020000000100000002)', '.ready files moved in and out are found');
+
+        $oPushAsync->readyWatchFree();
+
+        $self->testResult(
+            sub {$oPushAsync->readyList()}, '(000000020000000100000002)', 'path is read when not watched');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $oPushAsyncMissing = new pgBackRest::Archive::Push::Async("$self->{strWalPath}/missing", $self->{strSpoolPath});
+        $oPushAsyncMissing->readyWatchInit();
+
+        $self->testResult(
+            sub {defined($oPushAsyncMissing->{iReadyWatch}) ? true : false}, false, 'missing archive status path is not watched');
     }
 
     ################################################################################################################################
@@ -618,6 +721,54 @@ sub run
         $self->testResult(sub {storageSpool()->list($self->{strSpoolPath})}, "[undef]", "ok files removed");
     }
 
+    ################################################################################################################################
+    if ($self->begin("ArchivePushAsync->processServer()"))
+    {
+        # Linger for one second after the last WAL was pushed
+        my $oPushAsync = new pgBackRest::Archive::Push::Async(
+            $self->{strWalPath}, $self->{strSpoolPath}, $self->backrestExe(), 1);
+
+        $self->optionTestSetBool(CFGOPT_ARCHIVE_ASYNC, true);
+        $self->optionTestSet(CFGOPT_SPOOL_PATH, $self->{strRepoPath});
+        $self->configTestLoad(CFGCMD_ARCHIVE_PUSH);
+
+        my $strSegment1 = $self->walSegment(1, 1, 1);
+        my $strSegment2 = $self->walSegment(1, 1, 2);
+
+        $self->walGenerate($self->{strWalPath}, WAL_VERSION_94, 1, $strSegment1);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        # Write the second segment while the async process is lingering
+        my $iProcessId = $PID;
+
+        if (fork() == 0)
+        {
+            waitHiRes(.5);
+            $self->walGenerate($self->{strWalPath}, WAL_VERSION_94, 1, $strSegment2);
+            exit 0;
+        }
+
+        my $fTimeBegin = gettimeofday();
+
+        $self->testResult(sub {$oPushAsync->processServer()}, undef, 'process until linger expires');
+        exit if ($iProcessId != $PID);
+
+        waitpid(-1, 0);
+
+        $self->testResult(
+            sub {storageSpool()->list($self->{strSpoolPath})}, "(${strSegment1}.ok, ${strSegment2}.ok)",
+            "${strSegment1} pushed, ${strSegment2} pushed while lingering");
+
+        $self->testResult(
+            sub {gettimeofday() - $fTimeBegin >= 1.5}, true, '    linger restarted after WAL was pushed while lingering');
+
+        $self->testResult(
+            sub {keys(%{$oPushAsync->{oArchiveProcess}{hLocalPool}})}, '[undef]', '    local processes closed after linger');
+
+        $self->walRemove($self->{strWalPath}, $strSegment1);
+        $self->walRemove($self->{strWalPath}, $strSegment2);
+    }
+
     ################################################################################################################################
     if ($self->begin("ArchivePush->process()"))
     {
@@ -15,17 +15,22 @@ use File::Basename qw(dirname);
 use Storable qw(dclone);
 
 use pgBackRest::Backup::Common;
+use pgBackRest::Backup::File;
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::String;
 use pgBackRest::Common::Wait;
 use pgBackRest::Config::Config;
+use pgBackRest::DbVersion;
 use pgBackRest::Manifest;
 use pgBackRest::Protocol::Helper;
 use pgBackRest::Protocol::Storage::Helper;
+use pgBackRest::Storage::Base;
+use pgBackRest::Storage::Filter::Gzip;
 use pgBackRest::Storage::Helper;
 
 use pgBackRestTest::Common::ExecuteTest;
+use pgBackRestTest::Common::RunTest;
 use pgBackRestTest::Env::Host::HostBackupTest;
 
 ####################################################################################################################################
@@ -186,6 +191,213 @@ sub run
 
         $self->testResult(sub {$strDiffLabel eq $strNewDiffLabel}, true, 'new diff label in future');
     }
+
+    ################################################################################################################################
+    if ($self->begin('Manifest->journalWrite() & Manifest->journalReplay()'))
+    {
+        $self->optionTestSet(CFGOPT_STANZA, $self->stanza());
+        $self->optionTestSet(CFGOPT_REPO_PATH, $self->testPath() . '/repo');
+        $self->configTestLoad(CFGCMD_ARCHIVE_PUSH);
+
+        my $strManifestFile = $self->testPath() . '/' . FILE_MANIFEST;
+
+        my $oManifest = new pgBackRest::Manifest(
+            $strManifestFile, {bLoad => false, strDbVersion => PG_VERSION_94, oStorage => storageTest()});
+
+        $oManifest->set(MANIFEST_SECTION_TARGET_FILE, 'pg_data/PG_VERSION', MANIFEST_SUBKEY_SIZE, 3);
+        $oManifest->set(MANIFEST_SECTION_TARGET_FILE, 'pg_data/base/1', MANIFEST_SUBKEY_SIZE, 8192);
+        $oManifest->set(MANIFEST_SECTION_TARGET_FILE, 'pg_data/base/2', MANIFEST_SUBKEY_SIZE, 8192);
+        $oManifest->save();
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$oManifest->journalReplay()}, 0, 'replay missing journal');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oManifest->journalOpen();
+        $self->testResult(sub {$oManifest->journalOpened()}, true, 'journal is open');
+
+        $oManifest->set(MANIFEST_SECTION_TARGET_FILE, 'pg_data/base/1', MANIFEST_SUBKEY_CHECKSUM, BOGUS);
+        $oManifest->journalWrite('pg_data/base/1');
+        $oManifest->remove(MANIFEST_SECTION_TARGET_FILE, 'pg_data/base/2');
+        $oManifest->journalWrite('pg_data/base/2');
+        $oManifest->journalSync();
+        $oManifest->journalClose();
+
+        $self->testResult(sub {$oManifest->journalOpened()}, false, 'journal is closed');
+
+        # Simulate a record that was only partially written when the backup was aborted
+        storageTest()->put(
+            $strManifestFile . MANIFEST_JOURNAL_EXT,
+            ${storageTest()->get($strManifestFile . MANIFEST_JOURNAL_EXT)} . '"pg_data/PG_VERSION"={"size"');
+
+        my $oManifestResume = new pgBackRest::Manifest($strManifestFile, {oStorage => storageTest()});
+
+        $self->testResult(sub {$oManifestResume->journalReplay()}, 2, 'replay journal');
+        $self->testResult(
+            sub {$oManifestResume->get(MANIFEST_SECTION_TARGET_FILE, 'pg_data/base/1', MANIFEST_SUBKEY_CHECKSUM)}, BOGUS,
+            '    updated file');
+        $self->testResult(
+            sub {$oManifestResume->test(MANIFEST_SECTION_TARGET_FILE, 'pg_data/base/2')}, false, '    removed file');
+        $self->testResult(
+            sub {$oManifestResume->test(MANIFEST_SECTION_TARGET_FILE, 'pg_data/PG_VERSION', MANIFEST_SUBKEY_CHECKSUM)}, false,
+            '    partial record ignored');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageTest()->put($strManifestFile . MANIFEST_JOURNAL_EXT, "pg_data/base/1={}\n");
+
+        $self->testException(
+            sub {$oManifestResume->journalReplay()}, ERROR_FORMAT,
+            "invalid record 'pg_data/base/1={}' in journal for '${strManifestFile}'");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oManifest->save();
+
+        $self->testResult(sub {storageTest()->exists($strManifestFile . MANIFEST_JOURNAL_EXT)}, false, 'journal removed on save');
+    }
+
+    ################################################################################################################################
+    if ($self->begin('Manifest->fileDevice()'))
+    {
+        my $strDbPath = $self->testPath() . '/db';
+        my $strLinkPath = $self->testPath() . '/link';
+
+        $self->optionTestSet(CFGOPT_STANZA, $self->stanza());
+        $self->optionTestSet(CFGOPT_DB_PATH, $strDbPath);
+        $self->optionTestSet(CFGOPT_REPO_PATH, $self->testPath() . '/repo');
+        $self->configTestLoad(CFGCMD_ARCHIVE_PUSH);
+
+        storageTest()->pathCreate("${strDbPath}/base/1", {bCreateParent => true});
+        storageTest()->pathCreate("${strDbPath}/pg_stat_tmp");
+        storageTest()->put("${strDbPath}/" . DB_FILE_PGVERSION, PG_VERSION_94);
+        storageTest()->put("${strDbPath}/base/1/1");
+        storageTest()->put("${strDbPath}/pg_stat_tmp/1");
+        storageTest()->pathCreate($strLinkPath);
+        storageTest()->put("${strLinkPath}/1");
+        symlink($strLinkPath, "${strDbPath}/pg_stat")
+            or confess &log(ERROR, "unable to create symlink '${strDbPath}/pg_stat'");
+
+        my $oManifest = new pgBackRest::Manifest(
+            $self->testPath() . '/' . FILE_MANIFEST, {bLoad => false, strDbVersion => PG_VERSION_94, oStorage => storageTest()});
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$oManifest->fileDevice(MANIFEST_TARGET_PGDATA . '/base/1/1')}, undef, 'no device before build');
+
+        $oManifest->build(storageDb(), $strDbPath, undef, true);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {$oManifest->fileDevice(MANIFEST_TARGET_PGDATA . '/base/1/1')}, (stat($strDbPath))[0], 'file in pg_data');
+        $self->testResult(
+            sub {$oManifest->fileDevice(MANIFEST_TARGET_PGDATA . '/pg_stat/1')}, (stat($strLinkPath))[0],
+            'file in link target uses link device');
+        $self->testResult(
+            sub {$oManifest->fileDevice(MANIFEST_TARGET_PGDATA . '/pg_stat_tmp/1')}, (stat($strDbPath))[0],
+            'file in path with link name prefix uses pg_data device');
+        $self->testResult(sub {$oManifest->fileDevice('pg_tblspc/1/PG_9.4_201409291/1')}, undef, 'file not in a target');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        # Check that the most specific target is used rather than the first one found
+        $oManifest->{hTargetDevice}{MANIFEST_TARGET_PGDATA . '/pg_stat'} = BOGUS;
+
+        $self->testResult(
+            sub {$oManifest->fileDevice(MANIFEST_TARGET_PGDATA . '/pg_stat/1')}, BOGUS, 'link target found before pg_data');
+        $self->testResult(
+            sub {$oManifest->fileDevice(MANIFEST_TARGET_PGDATA . '/pg_stat')}, BOGUS, 'link target itself');
+    }
+
+    ################################################################################################################################
+    if ($self->begin('backupFile() & backupFileAssemble()'))
+    {
+        $self->optionTestSet(CFGOPT_STANZA, $self->stanza());
+        $self->optionTestSet(CFGOPT_REPO_PATH, $self->testPath() . '/repo');
+        $self->optionTestSet(CFGOPT_DB_PATH, $self->testPath() . '/db');
+        $self->configTestLoad(CFGCMD_BACKUP);
+
+        my $strBackupLabel = '20170101-010101F';
+        my $strRepoFile = MANIFEST_TARGET_PGDATA . '/base/1/16384';
+        my $strDbFile = $self->testPath() . '/db/base/1/16384';
+        my $hExtraParam = {iWalId => 0xFFFFFFFF, iWalOffset => 0xFFFFFFFF};
+
+        # Pages 1 and 2 have invalid checksums and are on either side of the part boundary
+        storageTest()->pathCreate($self->testPath() . '/db/base/1', {bCreateParent => true});
+        storageTest()->put(
+            $strDbFile, (chr(0) x PG_PAGE_SIZE) . ('X' x (PG_PAGE_SIZE * 2)) . (chr(0) x PG_PAGE_SIZE) . ('X' x PG_PAGE_SIZE));
+
+        my @xyParam = ($strDbFile, $strRepoFile, PG_PAGE_SIZE * 5, undef, true, $strBackupLabel, true, 3, 1111111111, true,
+            $hExtraParam);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my ($iCopyResult, $lCopySize, $lRepoSize, $strCopyChecksum, $rExtra) = backupFile(@xyParam);
+
+        $self->testResult($iCopyResult, BACKUP_FILE_COPY, 'copy entire file');
+        $self->testResult($rExtra, '{bAlign => 1, bValid => 0, iyPageError => ((1, 2), 4)}', '    page errors');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $hyPart = [];
+
+        foreach my $hPart ({lOffset => PG_PAGE_SIZE * 2, lLength => undef}, {lOffset => 0, lLength => PG_PAGE_SIZE * 2})
+        {
+            my @xyResult = backupFile(@xyParam, $hPart->{lOffset}, $hPart->{lLength});
+            $hPart->{rResult} = \@xyResult;
+
+            push(@{$hyPart}, $hPart);
+        }
+
+        $self->testResult($hyPart->[0]{rResult}[1], PG_PAGE_SIZE * 3, 'copy last part');
+        $self->testResult($hyPart->[0]{rResult}[4], '{bAlign => 1, bValid => 0, iyPageError => (2, 4)}', '    page errors');
+        $self->testResult(
+            sub {storageRepo()->exists(
+                STORAGE_REPO_BACKUP . "/${strBackupLabel}/" . backupFilePart($strRepoFile, PG_PAGE_SIZE * 2) . '.' . COMPRESS_EXT)},
+            true, '    part exists');
+        $self->testResult($hyPart->[1]{rResult}[4], '{bAlign => 1, bValid => 0, iyPageError => (1)}', 'copy first part');
+
+        # Parts are concatenated as stored so the repo size is the total of the parts
+        $self->testResult(
+            sub {backupFileAssemble(@xyParam, $hyPart)},
+            "(${iCopyResult}, ${lCopySize}, " . ($hyPart->[0]{rResult}[2] + $hyPart->[1]{rResult}[2]) . ", ${strCopyChecksum}, " .
+                '{bAlign => 1, bValid => 0, iyPageError => ((1, 2), 4)})',
+            'assemble parts');
+        $self->testResult(
+            sub {storageRepo()->exists(
+                STORAGE_REPO_BACKUP . "/${strBackupLabel}/" . backupFilePart($strRepoFile, PG_PAGE_SIZE * 2) . '.' . COMPRESS_EXT)},
+            false, '    part removed');
+        $self->testResult(
+            sub {storageRepo()->hashSize(storageRepo()->openRead(
+                STORAGE_REPO_BACKUP . "/${strBackupLabel}/${strRepoFile}." . COMPRESS_EXT,
+                {rhyFilter => [{strClass => STORAGE_FILTER_GZIP, rxyParam => [{strCompressType => STORAGE_DECOMPRESS}]}]}))},
+            "(${strCopyChecksum}, ${lCopySize})", '    decompressed file matches');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        foreach my $hPart (@{$hyPart})
+        {
+            my @xyResult = backupFile(@xyParam, $hPart->{lOffset}, $hPart->{lLength});
+            $hPart->{rResult} = \@xyResult;
+        }
+
+        storageRepo()->put(
+            STORAGE_REPO_BACKUP . "/${strBackupLabel}/" . backupFilePart($strRepoFile, 0) . '.' . COMPRESS_EXT,
+            ${storageRepo()->get(
+                STORAGE_REPO_BACKUP . "/${strBackupLabel}/" . backupFilePart($strRepoFile, PG_PAGE_SIZE * 2) . '.' .
+                    COMPRESS_EXT)});
+
+        $self->testException(
+            sub {backupFileAssemble(@xyParam, $hyPart)}, ERROR_CHECKSUM,
+            "part of ${strRepoFile} at offset 0 should have checksum $hyPart->[1]{rResult}[3] and size " . PG_PAGE_SIZE * 2 .
+                " but actually has checksum $hyPart->[0]{rResult}[3] and size " . PG_PAGE_SIZE * 3);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $hyPart->[1]{rResult}[1] = PG_PAGE_SIZE;
+
+        $self->testResult(
+            sub {backupFileAssemble(@xyParam, $hyPart)},
+            "(${iCopyResult}, ${lCopySize}, ${lRepoSize}, ${strCopyChecksum}, " .
+                '{bAlign => 1, bValid => 0, iyPageError => ((1, 2), 4)})',
+            'file changed size during copy so copy entire file');
+        $self->testResult(
+            sub {storageRepo()->exists(
+                STORAGE_REPO_BACKUP . "/${strBackupLabel}/" . backupFilePart($strRepoFile, 0) . '.' . COMPRESS_EXT)},
+            false, '    part removed');
+    }
 }
 
 1;
@@ -0,0 +1,137 @@
+####################################################################################################################################
+# CommonIniBinaryTest.pm - Unit tests for IniBinary module
+####################################################################################################################################
+package pgBackRestTest::Module::Common::CommonIniBinaryTest;
+use parent 'pgBackRestTest::Common::RunTest';
+
+####################################################################################################################################
+# Perl includes
+####################################################################################################################################
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Ini;
+use pgBackRest::Common::IniBinary;
+use pgBackRest::Common::Log;
+
+use pgBackRestTest::Common::RunTest;
+
+####################################################################################################################################
+# iniBinaryParse - parse all sections of a binary ini
+####################################################################################################################################
+sub iniBinaryParse
+{
+    my $self = shift;
+    my $strContent = shift;
+
+    my $hIndex = iniBinaryIndex(\$strContent);
+    my $hContent = {};
+
+    foreach my $strSection (iniBinarySectionList($hIndex))
+    {
+        $hContent->{$strSection} = iniBinarySectionParse(\$strContent, $hIndex, $strSection);
+    }
+
+    return $hContent;
+}
+
+####################################################################################################################################
+# run
+####################################################################################################################################
+sub run
+{
+    my $self = shift;
+
+    ################################################################################################################################
+    if ($self->begin("iniBinaryRender() & iniBinaryIndex() & iniBinarySectionParse()"))
+    {
+        my $strIni =
+            "[backrest]\n" .
+            "backrest-format=5\n" .
+            "backrest-version=\"1.26dev\"\n" .
+            "\n" .
+            "[db]\n" .
+            "key=[1,\"value\",{\"subkey\":null}]\n" .
+            "key\"2=\"\\\"quoted\\\"\\nvalue\"\n" .
+            "\n" .
+            "[target:file]\n" .
+            "pg_data/base/1={\"checksum\":\"c0f5e6d5e7c1e2e4c94b1a6c4e0f8f5a5b0e9d8c\",\"master\":false,\"size\":8192," .
+                "\"timestamp\":1500000000,\"user\":\"postgres\"}\n" .
+            "pg_data/base/2={\"checksum\":\"0\",\"group\":\"postgres\",\"master\":true,\"size\":\"8192\",\"timestamp\":0," .
+                "\"user\":null}\n" .
+            "pg_data/base/3={}\n" .
+            "pg_data/base/4={\"group\":[\"postgres\"],\"master\":1,\"size\":-1,\"timestamp\":1000000000000000000}\n" .
+            "\n" .
+            "[target:file:default]\n" .
+            "group=\"postgres\"\n" .
+            "master=false\n";
+
+        my $hIni = iniParse($strIni);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $strBinary = iniBinaryRender($hIni);
+
+        $self->testResult(sub {iniRender($self->iniBinaryParse($strBinary))}, iniRender($hIni), 'round trip mixed content');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $hIniColumn = {'target:file' => {}};
+
+        for (my $iFileIdx = 0; $iFileIdx < 100; $iFileIdx++)
+        {
+            $hIniColumn->{'target:file'}{"pg_data/base/${iFileIdx}"} =
+                {checksum => '1e34fa1c833090d94b9bb14f2a8d3153dca6ea27', master => INI_FALSE, reference => '20170101-000000F',
+                 size => 8192 * $iFileIdx, timestamp => 1500000000 + $iFileIdx};
+        }
+
+        my $strBinaryColumn = iniBinaryRender($hIniColumn);
+
+        $self->testResult(
+            sub {iniRender($self->iniBinaryParse($strBinaryColumn))}, iniRender($hIniColumn), 'round trip typed columns');
+        $self->testResult(
+            length($strBinaryColumn) < length(iniRender($hIniColumn)) / 3, true, '    binary is smaller than ini');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $hIndex = iniBinaryIndex(\$strBinary);
+
+        $self->testResult(sub {join(',', sort(iniBinarySectionList($hIndex)))}, 'backrest,db,target:file,target:file:default',
+            'section list');
+        $self->testResult(
+            sub {iniRender({'target:file:default' => iniBinarySectionParse(\$strBinary, $hIndex, 'target:file:default')})},
+            "[target:file:default]\ngroup=\"postgres\"\nmaster=false\n", 'parse single section');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testException(
+            sub {iniBinaryRender({section => {"\x{263a}" => true}})}, ERROR_FORMAT,
+            'unable to store wide character string in binary ini');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testException(sub {iniBinaryIndex(\'PGBR')}, ERROR_FORMAT, 'binary ini header is truncated');
+        $self->testResult(sub {iniBinaryIndex(\'PGBR', {bIgnoreInvalid => true})}, '[undef]', 'ignore truncated header');
+
+        my $strInvalid = BOGUS . substr($strBinary, length(BOGUS));
+        $self->testException(sub {iniBinaryIndex(\$strInvalid)}, ERROR_FORMAT, 'binary ini header is invalid');
+
+        $strInvalid = substr($strBinary, 0, 8) . pack('N', 2) . substr($strBinary, 12);
+        $self->testException(
+            sub {iniBinaryIndex(\$strInvalid)}, ERROR_FORMAT, 'expected binary ini format ' . INI_BINARY_FORMAT . ' but found 2');
+
+        $strInvalid = substr($strBinary, 0, 30) . 'X' . substr($strBinary, 31);
+        $self->testException(sub {iniBinaryIndex(\$strInvalid)}, ERROR_CHECKSUM, 'binary ini header checksum is invalid');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $strInvalid = substr($strBinary, 0, length($strBinary) - 1) . 'X';
+        $hIndex = iniBinaryIndex(\$strInvalid);
+
+        $self->testResult(
+            sub {iniBinarySectionParse(\$strInvalid, $hIndex, 'backrest')}, '{backrest-format => 5, backrest-version => 1.26dev}',
+            'parse valid section');
+        $self->testException(
+            sub {iniBinarySectionParse(\$strInvalid, $hIndex, 'target:file:default')}, ERROR_CHECKSUM,
+            "binary ini section 'target:file:default' checksum is invalid");
+    }
+}
+
+1;
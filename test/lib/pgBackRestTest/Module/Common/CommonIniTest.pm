@@ -12,8 +12,12 @@ use warnings FATAL => qw(all);
 use Carp qw(confess);
 use English '-no_match_vars';
 
+use Digest::SHA qw(sha1_hex);
+use JSON::PP;
+
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Ini;
+use pgBackRest::Common::IniBinary;
 use pgBackRest::Common::Log;
 use pgBackRest::Version;
 
@@ -40,6 +44,22 @@ sub iniHeader
         "\n";
 }
 
+####################################################################################################################################
+# iniChecksum - calculate the expected checksum independently of Ini->hash() by encoding the entire content at once
+####################################################################################################################################
+sub iniChecksum
+{
+    my $self = shift;
+    my $hContent = shift;
+
+    # Copy the header section so the checksum can be excluded without modifying the content
+    my $hChecksumContent = {%{$hContent}};
+    $hChecksumContent->{&INI_SECTION_BACKREST} = {%{$hContent->{&INI_SECTION_BACKREST}}};
+    delete($hChecksumContent->{&INI_SECTION_BACKREST}{&INI_KEY_CHECKSUM});
+
+    return sha1_hex(JSON::PP->new()->canonical()->allow_nonref()->encode($hChecksumContent));
+}
+
 ####################################################################################################################################
 # run
 ####################################################################################################################################
@@ -510,6 +530,189 @@ sub run
 
         $self->testException(sub {sort($oIni->keys($strSection, BOGUS))}, ERROR_ASSERT, "invalid strSortOrder '" . BOGUS . "'");
     }
+
+    ################################################################################################################################
+    if ($self->begin("Ini->render()"))
+    {
+        my $oIni = new pgBackRest::Common::Ini($strTestFile, {bLoad => false});
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$oIni->render() eq iniRender($oIni->{oContent})}, true, 'render header only');
+        $self->testResult(
+            sub {$oIni->get(INI_SECTION_BACKREST, INI_KEY_CHECKSUM)}, $self->iniChecksum($oIni->{oContent}),
+            '    checksum matches content');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oIni->set('archive', $strKey, undef, "\"quoted\"\nvalue");
+        $oIni->{oContent}{'empty'} = {};
+        $oIni->numericSet($strSection, "pg_data/${strKey}", 'size', 8192);
+        $oIni->boolSet($strSection, "pg_data/${strKey}", 'master', true);
+        $oIni->set($strSection, "pg_data/${strKey}", 'reference', undef);
+        $oIni->set($strSection, "${strKey}\"2", undef, [1, $strValue, {$strSubKey => undef}]);
+
+        $self->testResult(sub {$oIni->render() eq iniRender($oIni->{oContent})}, true, 'render mixed content');
+        $self->testResult(
+            sub {$oIni->get(INI_SECTION_BACKREST, INI_KEY_CHECKSUM)}, $self->iniChecksum($oIni->{oContent}),
+            '    checksum matches content');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        delete($oIni->{oContent}{'empty'});
+        $oIni->save();
+
+        $self->testResult(
+            sub {${storageTest()->get($strTestFile)}}, ${storageTest()->get($strTestFileCopy)}, 'saved main and copy match');
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile))->get($strSection, "pg_data/${strKey}", 'size')}, 8192,
+            '    load saved file');
+    }
+
+    ################################################################################################################################
+    if ($self->begin("Ini->save() & Ini->load() binary"))
+    {
+        my $oIni = new pgBackRest::Common::Ini($strTestFile, {bLoad => false});
+        $oIni->numericSet($strSection, "pg_data/${strKey}", 'size', 8192);
+        $oIni->set($strSection, "pg_data/${strKey}", 'user', $strValue);
+        $oIni->set('archive', $strKey, undef, $strValue);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oIni->save(true);
+
+        $self->testResult(
+            sub {storageTest()->list($self->testPath())}, '(test.ini, test.ini.bin, test.ini.copy)', 'binary is saved');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile))->{hBinarySection}}, '[undef]', 'binary not loaded by default');
+
+        $oIni = new pgBackRest::Common::Ini($strTestFile, {bBinary => true});
+
+        $self->testResult(sub {join(',', sort(keys(%{$oIni->{hBinarySection}})))}, "archive,${strSection}", 'sections not decoded');
+        $self->testResult(sub {$oIni->get($strSection, "pg_data/${strKey}", 'size')}, 8192, '    get value');
+        $self->testResult(sub {join(',', sort(keys(%{$oIni->{hBinarySection}})))}, 'archive', '    section decoded on get');
+        $self->testResult(
+            sub {$oIni->render()}, ${storageTest()->get($strTestFile)}, '    render decodes remaining sections');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oIni->set('archive', $strKey, undef, BOGUS);
+        $oIni->save();
+
+        $self->testResult(
+            sub {storageTest()->list($self->testPath())}, '(test.ini, test.ini.copy)', 'binary is removed on save without binary');
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile, {bBinary => true}))->get('archive', $strKey)}, BOGUS,
+            '    load without binary');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oIni->set('archive', $strKey, undef, $strValue);
+        $oIni->save(true);
+
+        my $oIniNoBinary = new pgBackRest::Common::Ini($strTestFile);
+        $oIniNoBinary->set('archive', $strKey, undef, BOGUS);
+        $oIniNoBinary->save();
+
+        $self->testResult(
+            sub {storageTest()->list($self->testPath())}, '(test.ini, test.ini.bin, test.ini.copy)',
+            'binary is not removed on save by ini loaded without binary');
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile, {bBinary => true}))->get('archive', $strKey)}, BOGUS,
+            '    stale binary is ignored');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oIni = new pgBackRest::Common::Ini($strTestFile, {bBinary => true});
+        $oIni->set('archive', $strKey, undef, $strValue);
+        $oIni->save(true);
+
+        my $tBinary = ${storageTest()->get($strTestFile . INI_BINARY_EXT)};
+
+        $oIni->set('archive', $strKey, undef, BOGUS);
+        $oIni->save(true);
+        storageTest()->put($strTestFile . INI_BINARY_EXT, $tBinary);
+
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile, {bBinary => true}))->get('archive', $strKey)}, BOGUS,
+            'binary from an incomplete save is ignored');
+
+        storageTest()->remove($strTestFile);
+
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile, {bBinary => true}))->get('archive', $strKey)}, BOGUS,
+            '    binary checked against copy when main is missing');
+
+        $oIni->set('archive', $strKey, undef, $strValue);
+        $oIni->save(true);
+        $oIni = new pgBackRest::Common::Ini($strTestFile, {bBinary => true});
+
+        $self->testResult(sub {defined($oIni->{hBinarySection}) ? true : false}, true, 'binary that matches ini is loaded');
+        $self->testResult(sub {$oIni->get('archive', $strKey)}, $strValue, '    get value');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageTest()->put($strTestFile . INI_BINARY_EXT, BOGUS);
+
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile, {bBinary => true}))->get('archive', $strKey)}, $strValue,
+            'invalid binary is ignored');
+    }
+
+    ################################################################################################################################
+    if ($self->begin("Ini->new() packed sections"))
+    {
+        my $strChecksum = '1e34fa1c833090d94b9bb14f2a8d3153dca6ea27';
+        my $oIni = new pgBackRest::Common::Ini($strTestFile, {bLoad => false, stryPackSection => [$strSection]});
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oIni->set($strSection, "pg_data/${strKey}", 'checksum', $strChecksum);
+        $oIni->numericSet($strSection, "pg_data/${strKey}", 'size', 8192);
+        $oIni->numericSet($strSection, "pg_data/${strKey}", 'timestamp', 1500000000);
+        $oIni->boolSet($strSection, "pg_data/${strKey}", 'master', false);
+        $oIni->set($strSection, "pg_data/${strKey}", 'user', $strValue);
+        $oIni->set($strSection, "pg_data/${strKey}", 'mode', '0600');
+        $oIni->set($strSection, "pg_data/${strKey}", 'reference', undef);
+        $oIni->set($strSection, "pg_data/${strKey}2", undef, {checksum => '0', size => -1, user => $strValue, error => [1, 2]});
+        $oIni->set('archive', $strKey, undef, {size => 8192});
+
+        $self->testResult(sub {ref($oIni->{oContent}{$strSection}{"pg_data/${strKey}"})}, '', 'value is packed');
+        $self->testResult(sub {ref($oIni->{oContent}{archive}{$strKey})}, 'HASH', '    value in other section is not packed');
+        $self->testResult(sub {scalar(@{$oIni->{stryPackString}})}, 11, '    strings are interned');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$oIni->get($strSection, "pg_data/${strKey}", 'checksum')}, $strChecksum, 'get checksum');
+        $self->testResult(sub {$oIni->numericGet($strSection, "pg_data/${strKey}", 'size')}, 8192, 'get size');
+        $self->testResult(sub {$oIni->boolGet($strSection, "pg_data/${strKey}", 'master')}, false, 'get master');
+        $self->testResult(sub {$oIni->get($strSection, "pg_data/${strKey}", 'reference', false)}, '[undef]', 'get undef');
+        $self->testResult(sub {$oIni->test($strSection, "pg_data/${strKey}", 'mode', '0600')}, true, 'test mode');
+        $self->testResult(
+            sub {$oIni->get($strSection, "pg_data/${strKey}2")}, '{checksum => 0, error => (1, 2), size => -1, user => test-value}',
+            'get entry');
+        $self->testResult(sub {$oIni->keys($strSection)}, "(pg_data/${strKey}, pg_data/${strKey}2)", 'keys');
+        $self->testResult(sub {$oIni->test($strSection)}, true, 'test section');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$oIni->set($strSection, "pg_data/${strKey}", 'user', $strValue)}, false, 'set unchanged value');
+        $self->testResult(sub {$oIni->set($strSection, "pg_data/${strKey}", 'user', BOGUS)}, true, 'set changed value');
+        $self->testResult(sub {$oIni->remove($strSection, "pg_data/${strKey}", 'user')}, true, 'remove subkey');
+        $self->testResult(sub {$oIni->test($strSection, "pg_data/${strKey}", 'user')}, false, '    subkey is removed');
+        $self->testResult(sub {$oIni->test($strSection, "pg_data/${strKey}", 'size', 8192)}, true, '    other subkeys remain');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $strContent = $oIni->render();
+        $self->testResult(sub {iniRender($oIni->content())}, $strContent, 'render matches unpacked content');
+        $self->testResult(
+            sub {$oIni->get(INI_SECTION_BACKREST, INI_KEY_CHECKSUM)}, $self->iniChecksum($oIni->content()),
+            '    checksum matches unpacked content');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oIni->save(true);
+
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile, {stryPackSection => [$strSection]}))->render()}, $strContent,
+            'load and render');
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile, {bBinary => true, stryPackSection => [$strSection]}))->render()},
+            $strContent, 'load binary and render');
+        $self->testResult(
+            sub {(new pgBackRest::Common::Ini($strTestFile, {stryPackSection => [$strSection]}))->get(
+                $strSection, "pg_data/${strKey}", 'timestamp')}, 1500000000, '    get timestamp');
+    }
 }
 
 1;
@@ -0,0 +1,223 @@
+####################################################################################################################################
+# CommonLimitTest.pm - Unit tests for Limit module
+####################################################################################################################################
+package pgBackRestTest::Module::Common::CommonLimitTest;
+use parent 'pgBackRestTest::Env::ConfigEnvTest';
+
+####################################################################################################################################
+# Perl includes
+####################################################################################################################################
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use Time::HiRes qw(gettimeofday);
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Exit;
+use pgBackRest::Common::Limit;
+use pgBackRest::Common::Log;
+use pgBackRest::Config::Config;
+use pgBackRest::Storage::Helper;
+
+use pgBackRestTest::Common::RunTest;
+
+####################################################################################################################################
+# initTest
+####################################################################################################################################
+sub initTest
+{
+    my $self = shift;
+
+    $self->{strLimitFile} = $self->testPath() . '/' . $self->stanza() . '_backup.limit';
+
+    $self->optionTestSet(CFGOPT_STANZA, $self->stanza());
+    $self->optionTestSet(CFGOPT_DB_PATH, $self->testPath() . '/db');
+    $self->optionTestSet(CFGOPT_REPO_PATH, $self->testPath() . '/repo');
+    $self->optionTestSet(CFGOPT_LOCK_PATH, $self->testPath());
+}
+
+####################################################################################################################################
+# limitFile - get the limits and next read times from the limit file with the times rounded to the nearest second
+####################################################################################################################################
+sub limitFile
+{
+    my $self = shift;
+
+    my $fTime = gettimeofday();
+    my ($strRate, @stryNext) = split("\n", ${storageTest()->get($self->{strLimitFile})});
+
+    return join(
+        ', ', $strRate, map {my ($strKey, $fNext) = split(' '); "${strKey}=" . abs(sprintf('%.0f', $fNext - $fTime))} @stryNext);
+}
+
+####################################################################################################################################
+# limitTakeTime - take from the limit and return the time slept rounded to the nearest tenth of a second
+####################################################################################################################################
+sub limitTakeTime
+{
+    my $self = shift;
+    my $lSize = shift;
+    my $strDevice = shift;
+
+    my $fTimeBegin = gettimeofday();
+
+    limitTake($lSize, $strDevice);
+
+    return sprintf('%.1f', gettimeofday() - $fTimeBegin);
+}
+
+####################################################################################################################################
+# run
+####################################################################################################################################
+sub run
+{
+    my $self = shift;
+
+    ################################################################################################################################
+    if ($self->begin('limitActive()'))
+    {
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->configTestLoad(CFGCMD_BACKUP);
+
+        storageTest()->put($self->{strLimitFile}, "1024 0\n");
+
+        $self->testResult(sub {limitActive()}, false, 'limit file ignored without rate options');
+        $self->testResult(sub {$self->limitTakeTime(1048576)}, '0.0', '    take does not sleep');
+        $self->testResult(sub {$self->limitFile()}, '1024 0', '    limit file not updated');
+
+        limitRemove();
+
+        $self->testResult(sub {storageTest()->exists($self->{strLimitFile})}, true, '    limit file not removed by reader');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->optionTestSet(CFGOPT_RATE_MAX, 1048576);
+        $self->configTestLoad(CFGCMD_BACKUP);
+
+        $self->testResult(
+            sub {cfgCommandWrite(CFGCMD_LOCAL, true, '', false) =~ /--rate-max=1048576/ ? true : false}, true,
+            'rate option passed to locals');
+
+        storageTest()->remove($self->{strLimitFile});
+
+        $self->testException(
+            sub {limitActive()}, ERROR_FILE_OPEN, "unable to open limit file $self->{strLimitFile}");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageTest()->put($self->{strLimitFile}, "2097152 0\n");
+
+        $self->testResult(sub {limitActive()}, true, 'limit file shared by main process is active');
+        $self->testResult(sub {$self->limitTakeTime(4194304)}, '1.0', '    take sleeps for reads over the burst');
+        $self->testResult(sub {$self->limitFile()}, '2097152 0, total=1', '    next read time updated');
+
+        limitRemove();
+
+        $self->testResult(sub {storageTest()->exists($self->{strLimitFile})}, true, '    limit file not removed by reader');
+
+        $self->optionTestClear(CFGOPT_RATE_MAX);
+    }
+
+    ################################################################################################################################
+    if ($self->begin('limitTake()'))
+    {
+        $self->optionTestSet(CFGOPT_RATE_DEVICE_MAX, 1048576);
+        $self->configTestLoad(CFGCMD_BACKUP);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {limitCreate(1048576, 0)}, undef, 'create total limit');
+        $self->testResult(sub {$self->limitFile()}, '1048576 0', '    check limit file');
+
+        $self->testResult(sub {$self->limitTakeTime(0)}, '0.0', '    empty read does not take');
+        $self->testResult(sub {$self->limitFile()}, '1048576 0', '    check limit file');
+
+        $self->testResult(sub {$self->limitTakeTime(524288)}, '0.0', '    take within burst');
+        $self->testResult(sub {$self->limitTakeTime(524288)}, '0.0', '    take to end of burst');
+        $self->testResult(sub {$self->limitTakeTime(524288)}, '0.5', '    take past burst sleeps');
+        $self->testResult(sub {$self->limitFile()}, '1048576 0, total=1', '    check limit file');
+
+        $self->testResult(sub {limitRemove()}, undef, '    remove limit');
+        $self->testResult(sub {storageTest()->exists($self->{strLimitFile})}, false, '    limit file removed');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {limitCreate(0, 1048576)}, undef, 'create device limit');
+
+        $self->testResult(sub {$self->limitTakeTime(2097152)}, '0.0', '    unknown device does not take');
+        $self->testResult(sub {$self->limitTakeTime(1048576, 'dev1')}, '0.0', '    take dev1 within burst');
+        $self->testResult(sub {$self->limitTakeTime(1048576, 'dev2')}, '0.0', '    take dev2 within burst');
+        $self->testResult(sub {$self->limitTakeTime(1048576, 'dev1')}, '1.0', '    take dev1 past burst sleeps');
+        $self->testResult(sub {$self->limitFile()}, '0 1048576, dev1=1, dev2=0', '    check limit file');
+
+        limitRemove();
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {limitCreate(1048576, 1048576)}, undef, 'create total and device limit');
+
+        $self->testResult(sub {$self->limitTakeTime(1048576, 'dev1')}, '0.0', '    take dev1 within burst');
+        $self->testResult(sub {$self->limitTakeTime(1048576, 'dev2')}, '1.0', '    take dev2 past total burst sleeps');
+        $self->testResult(sub {$self->limitFile()}, '1048576 1048576, dev1=0, dev2=0, total=1', '    check limit file');
+
+        limitRemove();
+
+        $self->optionTestClear(CFGOPT_RATE_DEVICE_MAX);
+    }
+
+    ################################################################################################################################
+    if ($self->begin('limitScale()'))
+    {
+        $self->optionTestSet(CFGOPT_RATE_MAX, 1048576);
+        $self->configTestLoad(CFGCMD_BACKUP);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        limitCreate(1048576, 3);
+
+        $self->testResult(
+            sub {kill('USR1', $PID)}, 1, 'halve limits with SIGUSR1',
+            {strLogExpect => 'INFO: rate limit changed to 524288B/s total, 1B/s per device', strLogLevel => INFO});
+        $self->testResult(sub {$self->limitFile()}, '524288 1', '    check limit file');
+
+        $self->testResult(
+            sub {kill('USR1', $PID)}, 1, 'limits are never less than one',
+            {strLogExpect => 'INFO: rate limit changed to 262144B/s total, 1B/s per device', strLogLevel => INFO});
+        $self->testResult(sub {$self->limitFile()}, '262144 1', '    check limit file');
+
+        $self->testResult(
+            sub {kill('USR2', $PID)}, 1, 'double limits with SIGUSR2',
+            {strLogExpect => 'INFO: rate limit changed to 524288B/s total, 2B/s per device', strLogLevel => INFO});
+        $self->testResult(sub {$self->limitFile()}, '524288 2', '    check limit file');
+
+        limitRemove();
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        limitCreate(1048576, 0);
+
+        $self->testResult(sub {$self->limitTakeTime(1048576)}, '0.0', 'take to end of burst');
+        $self->testResult(
+            sub {kill('USR2', $PID)}, 1, 'double limit with no device limit',
+            {strLogExpect => 'INFO: rate limit changed to 2097152B/s total, none per device', strLogLevel => INFO});
+        $self->testResult(sub {$self->limitFile()}, '2097152 0, total=1', '    next read time is kept');
+
+        limitRemove();
+
+        $self->testResult(sub {$SIG{USR1}}, 'DEFAULT', '    SIGUSR1 handler reset');
+        $self->testResult(sub {$SIG{USR2}}, 'DEFAULT', '    SIGUSR2 handler reset');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $iPid = fork();
+
+        if ($iPid == 0)
+        {
+            limitCreate(1048576, 0);
+            exitSafe(ERROR_TERM, undef, 'TERM');
+        }
+
+        waitpid($iPid, 0);
+
+        $self->testResult(sub {$? >> 8}, ERROR_TERM, 'main process exits on error');
+        $self->testResult(sub {storageTest()->exists($self->{strLimitFile})}, false, '    limit file removed');
+
+        $self->optionTestClear(CFGOPT_RATE_MAX);
+    }
+}
+
+1;
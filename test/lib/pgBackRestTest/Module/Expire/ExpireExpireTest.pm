@@ -271,6 +271,36 @@ sub run
 
         # Restore the info file
         $oHostBackup->infoRestore(storageRepo()->pathGet(STORAGE_REPO_ARCHIVE . qw{/} . ARCHIVE_INFO_FILE));
+
+        #-----------------------------------------------------------------------------------------------------------------------
+        $self->optionTestSet(CFGOPT_PROCESS_MAX, 2);
+        $self->configTestLoad(CFGCMD_EXPIRE);
+
+        my $strArchivePath = STORAGE_REPO_ARCHIVE . '/9.9-9';
+        my @stryArchiveFile =
+        (
+            '000000010000000100000001-53aa5d59515aa7288ae02ba414c009aed1ca73ad',
+            '000000010000000200000001-a0b0d38b8aa263e25b8ff52a0a4ba85b6be97f9b.gz',
+            '000000010000000200000002-996195c807713ef9262170043e7222cb150aef70',
+        );
+
+        foreach my $strArchiveFile (@stryArchiveFile)
+        {
+            storageRepo()->pathCreate(
+                "${strArchivePath}/" . substr($strArchiveFile, 0, 16), {bCreateParent => true, bIgnoreExists => true});
+            storageRepo()->put("${strArchivePath}/${strArchiveFile}");
+        }
+
+        $self->testResult(
+            sub {$oExpire->archiveRemove(
+                [storageRepo()->pathGet("${strArchivePath}/0000000100000001")],
+                ["${strArchivePath}/$stryArchiveFile[1]", "${strArchivePath}/$stryArchiveFile[2]"])},
+            undef, 'remove archive path and files in parallel');
+
+        $self->testResult(sub {storageRepo()->list("${strArchivePath}/0000000100000002")}, '[undef]', 'archive files removed');
+        $self->testResult(sub {storageRepo()->list($strArchivePath)}, '0000000100000002', 'archive path removed');
+
+        $self->optionTestClear(CFGOPT_PROCESS_MAX);
     }
 }
 
@@ -2,7 +2,7 @@
 # Archive Performance Tests
 ####################################################################################################################################
 package pgBackRestTest::Module::Performance::PerformanceArchiveTest;
-use parent 'pgBackRestTest::Common::RunTest';
+use parent 'pgBackRestTest::Env::ConfigEnvTest';
 
 ####################################################################################################################################
 # Perl includes
@@ -12,14 +12,36 @@ use warnings FATAL => qw(all);
 use Carp qw(confess);
 use English '-no_match_vars';
 
+use File::Basename qw(dirname);
+use JSON::PP;
+use POSIX qw(ceil);
 use Storable qw(dclone);
 use Time::HiRes qw(gettimeofday);
 
+use pgBackRest::Archive::Common;
+use pgBackRest::Archive::Info;
+use pgBackRest::Common::Ini;
 use pgBackRest::Common::Log;
+use pgBackRest::Common::Wait;
 use pgBackRest::Config::Config;
+use pgBackRest::DbVersion;
+use pgBackRest::Version;
 
 use pgBackRestTest::Common::ExecuteTest;
 use pgBackRestTest::Common::RunTest;
+use pgBackRestTest::Env::HostEnvTest;
+
+####################################################################################################################################
+# Benchmark constants
+####################################################################################################################################
+# Segments pushed for each configuration at scale 1
+use constant ARCHIVE_BENCH_SEGMENT_TOTAL                            => 8;
+
+# Max segments that can be ready at once so the test path does not fill up when WAL is generated faster than it can be pushed
+use constant ARCHIVE_BENCH_READY_MAX                                => 16;
+
+# WAL magic for PostgreSQL 9.4, which is the version of the synthetic WAL
+use constant ARCHIVE_BENCH_WAL_MAGIC                                => hex('0xD07E');
 
 ####################################################################################################################################
 # initModule
@@ -42,6 +64,186 @@ sub initTest
     storageTest()->pathCreate($self->{strSpoolPath}, {bIgnoreExists => true, bCreateParent => true});
 }
 
+####################################################################################################################################
+# cpuTime
+#
+# Get the CPU time (in seconds) used by the host.  The async process is detached and the remote is started by sshd so neither can be
+# measured as a child of the test, which means CPU must be measured for the whole host and the benchmark should be run on an
+# otherwise idle host.
+####################################################################################################################################
+sub cpuTime
+{
+    my $self = shift;
+
+    my ($strCpu) = ${storageTest()->get('/proc/stat')} =~ /^cpu +([0-9 ]+)$/m;
+
+    if (!defined($strCpu))
+    {
+        confess &log(ASSERT, 'unable to find cpu in /proc/stat');
+    }
+
+    # Add user, nice, system, irq, softirq, and steal (but not idle or iowait)
+    my @iyCpu = split(' ', $strCpu);
+
+    return ($iyCpu[0] + $iyCpu[1] + $iyCpu[2] + $iyCpu[5] + $iyCpu[6] + (defined($iyCpu[7]) ? $iyCpu[7] : 0)) /
+        POSIX::sysconf(&POSIX::_SC_CLK_TCK);
+}
+
+####################################################################################################################################
+# archiveBenchmark
+#
+# Push synthetic WAL with the pgbackrest executable the way the archiver calls archive_command: one segment at a time, oldest first,
+# and only after the prior segment was pushed.  Segments are made ready at the WAL rate, or as fast as they are pushed (up to
+# ARCHIVE_BENCH_READY_MAX ahead) when the rate is 0.  The C executable is used when bNative is set, otherwise the Perl executable.
+####################################################################################################################################
+sub archiveBenchmark
+{
+    my $self = shift;
+    my $strWalTemplate = shift;
+    my $iSegmentTotal = shift;
+    my $bAsync = shift;
+    my $bRemote = shift;
+    my $bNative = shift;
+
+    my $strName = ($bAsync ? 'async' : 'sync') . '-' . ($bRemote ? 'remote' : 'local') . ($bNative ? '-c' : '');
+    my $strBenchPath = $self->testPath() . "/${strName}";
+    my $strWalPath = "${strBenchPath}/db/pg_xlog";
+
+    storageTest()->pathCreate("${strWalPath}/archive_status", {bCreateParent => true});
+
+    # Create the config.  The lock path is not shared between configurations so a lingering async process cannot interfere.
+    my $strConfigFile = "${strBenchPath}/pgbackrest.conf";
+    my $rhConfig;
+
+    $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_LOG_PATH)} = "${strBenchPath}/log";
+    $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_LOCK_PATH)} = "${strBenchPath}/lock";
+    $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_LOG_LEVEL_CONSOLE)} = lc(OFF);
+    $rhConfig->{$self->stanza()}{cfgOptionName(CFGOPT_DB_PATH)} = "${strBenchPath}/db";
+
+    if ($bAsync)
+    {
+        $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_ARCHIVE_ASYNC)} = 'y';
+        $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_SPOOL_PATH)} = "${strBenchPath}/spool";
+    }
+
+    # The remote repo is on this host but is reached with ssh so the protocol is the same as a real repo host
+    if ($bRemote)
+    {
+        my $strConfigRepoFile = "${strBenchPath}/pgbackrest-repo.conf";
+        my $rhConfigRepo;
+
+        $rhConfigRepo->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_REPO_PATH)} = $self->{strRepoPath};
+        $rhConfigRepo->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_LOG_PATH)} = "${strBenchPath}/log";
+        $rhConfigRepo->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_LOCK_PATH)} = "${strBenchPath}/lock-repo";
+
+        storageTest()->put($strConfigRepoFile, iniRender($rhConfigRepo, true));
+
+        $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_BACKUP_HOST)} = 'localhost';
+        $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_BACKUP_USER)} = $self->pgUser();
+        $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_BACKUP_CMD)} = $self->backrestExeOriginal();
+        $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_BACKUP_CONFIG)} = $strConfigRepoFile;
+    }
+    else
+    {
+        $rhConfig->{&CFGDEF_SECTION_GLOBAL}{cfgOptionName(CFGOPT_REPO_PATH)} = $self->{strRepoPath};
+    }
+
+    storageTest()->put($strConfigFile, iniRender($rhConfig, true));
+
+    # Use the original Perl executable since coverage would make the timings meaningless
+    my $strCommand =
+        ($bNative ? $self->{strBackRestExeC} : $self->backrestExeOriginal()) . " --config=${strConfigFile} --" .
+        cfgOptionName(CFGOPT_STANZA) . '=' . $self->stanza();
+
+    # Make segments ready and push them
+    my $fWalRate = $self->walRate();
+    my $iReadyTotal = 0;
+    my $iPushTotal = 0;
+    my @fyLatency;
+
+    my $fCpuBegin = $self->cpuTime();
+    my $fTimeBegin = gettimeofday();
+
+    while ($iPushTotal < $iSegmentTotal)
+    {
+        # Make segments ready that are due
+        while ($iReadyTotal < $iSegmentTotal && $iReadyTotal - $iPushTotal < ARCHIVE_BENCH_READY_MAX &&
+               ($fWalRate == 0 || gettimeofday() >= $fTimeBegin + $iReadyTotal / $fWalRate))
+        {
+            my $strSegment = sprintf('%08X%08X%08X', 1, int($iReadyTotal / 256) + 1, $iReadyTotal % 256);
+
+            # A hard link is used so making the segment ready costs about as little as it does for PostgreSQL
+            link($strWalTemplate, "${strWalPath}/${strSegment}")
+                or confess &log(ERROR, "unable to link ${strWalPath}/${strSegment}: $OS_ERROR");
+
+            storageTest()->put("${strWalPath}/archive_status/${strSegment}.ready");
+            $iReadyTotal++;
+        }
+
+        # Push the oldest ready segment
+        if ($iPushTotal < $iReadyTotal)
+        {
+            my $strSegment = sprintf('%08X%08X%08X', 1, int($iPushTotal / 256) + 1, $iPushTotal % 256);
+            my $fPushBegin = gettimeofday();
+
+            if (system("${strCommand} " . cfgCommandName(CFGCMD_ARCHIVE_PUSH) . " ${strWalPath}/${strSegment}") != 0)
+            {
+                confess &log(ERROR, "unable to push ${strSegment} (exit status " . ($CHILD_ERROR >> 8) . ')');
+            }
+
+            push(@fyLatency, gettimeofday() - $fPushBegin);
+
+            # Remove the segment as PostgreSQL would once it has been archived
+            storageTest()->remove("${strWalPath}/archive_status/${strSegment}.ready");
+            storageTest()->remove("${strWalPath}/${strSegment}");
+            $iPushTotal++;
+        }
+        # Else wait until the next segment is due
+        else
+        {
+            my $fWait = $fTimeBegin + $iReadyTotal / $fWalRate - gettimeofday();
+            waitHiRes($fWait) if $fWait > 0;
+        }
+    }
+
+    my $fTime = gettimeofday() - $fTimeBegin;
+    my $fCpu = $self->cpuTime() - $fCpuBegin;
+
+    # Stop the async process rather than letting it linger so it does not use CPU during the next configuration
+    if ($bAsync)
+    {
+        executeTest("${strCommand} --force " . cfgCommandName(CFGCMD_STOP));
+    }
+
+    # Remove WAL from the repo so the next configuration starts with an empty archive
+    executeTest("sudo rm -rf $self->{strArchivePath}/$self->{strArchiveId}");
+
+    # Calculate results (times are in milliseconds)
+    @fyLatency = sort {$a <=> $b} @fyLatency;
+
+    my $rhResult =
+    {
+        'mode' => $bAsync ? 'async' : 'sync',
+        'repo' => $bRemote ? 'remote' : 'local',
+        'exe' => $bNative ? 'c' : 'perl',
+        'segment-per-sec' => sprintf('%.2f', $iSegmentTotal / $fTime) + 0,
+        'latency-ms' =>
+        {
+            'p50' => sprintf('%.3f', $fyLatency[ceil(@fyLatency * 0.50) - 1] * 1000) + 0,
+            'p99' => sprintf('%.3f', $fyLatency[ceil(@fyLatency * 0.99) - 1] * 1000) + 0,
+            'max' => sprintf('%.3f', $fyLatency[-1] * 1000) + 0,
+        },
+        'cpu-ms-per-segment' => sprintf('%.3f', $fCpu * 1000 / $iSegmentTotal) + 0,
+    };
+
+    &log(INFO,
+        "${strName}: $rhResult->{'segment-per-sec'} seg/s, latency p50 $rhResult->{'latency-ms'}{p50}ms" .
+        ", p99 $rhResult->{'latency-ms'}{p99}ms, max $rhResult->{'latency-ms'}{max}ms" .
+        ", cpu $rhResult->{'cpu-ms-per-segment'}ms/seg");
+
+    return $rhResult;
+}
+
 ####################################################################################################################################
 # run
 ####################################################################################################################################
@@ -72,6 +274,84 @@ sub run
 
         &log(INFO, 'time per execution: ' . ((gettimeofday() - $lTimeBegin) / $iRunTotal));
     }
+
+    ################################################################################################################################
+    if ($self->begin("archive-push benchmark"))
+    {
+        # Create the repo and archive info
+        $self->{strRepoPath} = $self->testPath() . '/repo';
+        $self->{strArchivePath} = "$self->{strRepoPath}/archive/" . $self->stanza();
+
+        storageTest()->pathCreate($self->{strArchivePath}, {bCreateParent => true});
+
+        $self->optionTestSet(CFGOPT_STANZA, $self->stanza());
+        $self->optionTestSet(CFGOPT_REPO_PATH, $self->{strRepoPath});
+        $self->configTestLoad(CFGCMD_ARCHIVE_PUSH);
+
+        my $oArchiveInfo = new pgBackRest::Archive::Info($self->{strArchivePath}, false, {bIgnoreMissing => true});
+        $oArchiveInfo->create(PG_VERSION_94, WAL_VERSION_94_SYS_ID, true);
+        $self->{strArchiveId} = $oArchiveInfo->archiveId();
+
+        # Build a synthetic WAL segment from table pages so compression and checksums do about as much work as they would for real
+        # WAL.  Only the long page header at the start of the segment needs to be valid to pass the checks in archive-push.
+        my $strWalTemplate = $self->testPath() . '/wal-template';
+        my $tTable = ${storageTest()->get($self->dataPath() . '/filecopy.table.bin')};
+        my $tWal = '';
+
+        while (length($tWal) < PG_WAL_SIZE)
+        {
+            $tWal .= substr($tTable, 0, PG_WAL_SIZE - length($tWal));
+        }
+
+        substr($tWal, 0, 4 + PG_WAL_SYSTEM_ID_OFFSET_GTE_93 + 8) =
+            pack('SSx' . PG_WAL_SYSTEM_ID_OFFSET_GTE_93 . 'Q', ARCHIVE_BENCH_WAL_MAGIC, 2, WAL_VERSION_94_SYS_ID);
+
+        storageTest()->put($strWalTemplate, $tWal);
+
+        # Run the benchmark for each configuration
+        my $iSegmentTotal = int(ARCHIVE_BENCH_SEGMENT_TOTAL * $self->scale());
+
+        my $rhReport =
+        {
+            'version' => BACKREST_VERSION,
+            'segment-size' => PG_WAL_SIZE,
+            'segment-total' => $iSegmentTotal + 0,
+            'wal-rate' => $self->walRate() + 0,
+        };
+
+        &log(INFO,
+            "${iSegmentTotal} segment(s) per configuration at " .
+                ($self->walRate() == 0 ? 'max rate' : $self->walRate() . ' segment(s)/sec'));
+
+        foreach my $bAsync (false, true)
+        {
+            foreach my $bRemote (false, true)
+            {
+                push(
+                    @{$rhReport->{result}}, $self->archiveBenchmark($strWalTemplate, $iSegmentTotal, $bAsync, $bRemote, false));
+            }
+        }
+
+        # Build the C executable outside the repo and benchmark it.  Only synchronous push to a local repo runs in C (everything
+        # else is passed to the Perl executable) so that is the only configuration where it differs from Perl.
+        my $strBuildPath = $self->testPath() . '/src';
+
+        executeTest('cp -r ' . $self->basePath() . "/src ${strBuildPath}");
+        executeTest(
+            "make --silent --directory ${strBuildPath} PERL_BIN=" . $self->backrestExeOriginal(), {bSuppressStdErr => true});
+
+        $self->{strBackRestExeC} = "${strBuildPath}/pgbackrest";
+
+        push(@{$rhReport->{result}}, $self->archiveBenchmark($strWalTemplate, $iSegmentTotal, false, false, true));
+
+        # Write the report so results can be compared between releases
+        my $strReportFile = $self->basePath() . '/test/benchmark/archive.json';
+
+        storageTest()->pathCreate(dirname($strReportFile), {bIgnoreExists => true, bCreateParent => true});
+        storageTest()->put($strReportFile, JSON::PP->new()->canonical()->pretty()->indent_length(4)->encode($rhReport));
+
+        &log(INFO, "report written to ${strReportFile}");
+    }
 }
 
 1;
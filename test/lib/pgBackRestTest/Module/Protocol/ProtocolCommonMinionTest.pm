@@ -13,13 +13,17 @@ use Carp qw(confess);
 use English '-no_match_vars';
 
 use IO::Socket::UNIX;
+use JSON::PP;
 use Time::HiRes qw(usleep);
 
 use pgBackRest::Common::Exception;
 use pgBackRest::Common::Io::Buffered;
 use pgBackRest::Common::Log;
 use pgBackRest::Common::Wait;
+use pgBackRest::Protocol::Base::Frame;
+use pgBackRest::Protocol::Base::Master;
 use pgBackRest::Protocol::Base::Minion;
+use pgBackRest::Protocol::Command::Master;
 use pgBackRest::Version;
 
 use pgBackRestTest::Common::ExecuteTest;
@@ -113,7 +117,9 @@ sub run
 
         $self->testResult(
             sub {$oIoBuffered->readLine()},
-            '{"name":"' . BACKREST_NAME . '","service":"test","version":"' . BACKREST_VERSION . '"}', 'read greeting');
+            '{"frame":"' . PROTOCOL_FRAME_BINARY . '","name":"' . BACKREST_NAME . '","service":"test","version":"' .
+                BACKREST_VERSION . '"}',
+            'read greeting');
 
         #---------------------------------------------------------------------------------------------------------------------------
         $self->testResult(
@@ -123,10 +129,134 @@ sub run
 
         #---------------------------------------------------------------------------------------------------------------------------
         $self->testResult(
-            sub {$oIoBuffered->writeLine('{"cmd":"exit"}')}, 15, 'write exit');
+            sub {$oIoBuffered->writeLine('{"cmd":"frame","param":["bogus"]}')}, 34, 'write frame with invalid format');
+        $self->testResult(
+            sub {JSON::PP->new()->decode($oIoBuffered->readLine())},
+            '{err => ' . ERROR_PROTOCOL . ", out => unsupported protocol frame format 'bogus'}", 'read error');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {$oIoBuffered->writeLine('{"cmd":"frame","param":["' . PROTOCOL_FRAME_BINARY . '"]}')},
+            length(PROTOCOL_FRAME_BINARY) + 29, 'write frame');
+        $self->testResult(sub {$oIoBuffered->readLine()}, '{"out":[]}', 'read output');
+
+        protocolMessageWrite($oIoBuffered, PROTOCOL_FRAME_TYPE_COMMAND, {cmd => 'noop'});
+
+        $self->testResult(
+            sub {protocolMessageRead($oIoBuffered, PROTOCOL_FRAME_TYPE_OUTPUT)}, '{out => ()}', 'read binary output');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        protocolMessageWrite($oIoBuffered, PROTOCOL_FRAME_TYPE_COMMAND, {cmd => 'exit'});
+
         $self->testResult(
             sub {$oIoBuffered->readLine(true)}, undef, 'read EOF');
     }
+
+    ################################################################################################################################
+    if ($self->begin('protocolMessageWrite() & protocolMessageRead() & protocolBlockWrite() & protocolBlockRead()'))
+    {
+        pipe(my $fhRead, my $fhWrite);
+        my $oIoBuffered = new pgBackRest::Common::Io::Buffered(
+            new pgBackRest::Common::Io::Handle('pipe', $fhRead, $fhWrite), 5, 4096);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        protocolMessageWrite($oIoBuffered, PROTOCOL_FRAME_TYPE_OUTPUT, {out => [1, "line1\nline2", undef, {key => 'value'}]});
+
+        $self->testResult(
+            sub {protocolMessageRead($oIoBuffered, PROTOCOL_FRAME_TYPE_OUTPUT)},
+            '{out => (1, line1' . "\n" . 'line2, [undef], {key => value})}', 'message round trip');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $tBlock = "BLOCK\n\0DATA";
+        protocolBlockWrite($oIoBuffered, \$tBlock);
+        protocolBlockWrite($oIoBuffered);
+
+        my $tBuffer = '';
+        $self->testResult(sub {protocolBlockRead($oIoBuffered, \$tBuffer)}, length($tBlock), 'read block');
+        $self->testResult($tBuffer, $tBlock, '    check block');
+        $self->testResult(sub {protocolBlockRead($oIoBuffered, \$tBuffer)}, 0, '    read end of data');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        protocolMessageWrite($oIoBuffered, PROTOCOL_FRAME_TYPE_COMMAND, {cmd => 'noop'});
+
+        $self->testException(
+            sub {protocolMessageRead($oIoBuffered, PROTOCOL_FRAME_TYPE_OUTPUT)}, ERROR_PROTOCOL,
+            "expected protocol frame type '" . PROTOCOL_FRAME_TYPE_OUTPUT . "' but found '" . PROTOCOL_FRAME_TYPE_COMMAND . "'");
+    }
+
+    ################################################################################################################################
+    if ($self->begin('Master->new() binary frames'))
+    {
+        my $oMaster = $self->testResult(
+            sub {new pgBackRest::Protocol::Command::Master(
+                'test', 'test-id',
+                'perl -I' . $self->basePath() . '/lib -e \'' .
+                    'use pgBackRest::Common::Io::Buffered; use pgBackRest::Protocol::Base::Minion;' .
+                    '(new pgBackRest::Protocol::Base::Minion("test", new pgBackRest::Common::Io::Buffered(' .
+                    'new pgBackRest::Common::Io::Handle("stdio", *STDIN, *STDOUT), 5, 4096)))->process()\'',
+                4096, 3, 3, 5)},
+            '[object]', 'master negotiates binary frames');
+
+        $self->testResult(sub {$oMaster->frame()}, true, '    binary frames enabled');
+        $self->testResult(sub {$oMaster->cmdExecute(OP_NOOP)}, '[undef]', '    noop');
+        $self->testResult(sub {$oMaster->close()}, 0, '    close');
+    }
+
+    ################################################################################################################################
+    if ($self->begin('Master->cmdSubmit() & Master->cmdResult()'))
+    {
+        my $oMaster = new pgBackRest::Protocol::Command::Master(
+            'test', 'test-id',
+            'perl -I' . $self->basePath() . '/lib -e \'' .
+                'package TestMinion; use parent q{pgBackRest::Protocol::Base::Minion};' .
+                'use Carp qw(confess); use pgBackRest::Common::Exception; use pgBackRest::Common::Log;' .
+                'sub init {{echo => sub {shift->[0]}, error => sub {confess &log(ERROR, q{test error}, ERROR_FILE_MISSING)}}}' .
+                'package main; use pgBackRest::Common::Io::Buffered;' .
+                '(new TestMinion("test", new pgBackRest::Common::Io::Buffered(' .
+                'new pgBackRest::Common::Io::Handle("stdio", *STDIN, *STDOUT), 5, 4096)))->process()\'',
+            4096, 3, 3, 5);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $iEchoA = $oMaster->cmdSubmit('echo', ['a']);
+        my $iError = $oMaster->cmdSubmit('error');
+        my $iEchoB = $oMaster->cmdSubmit('echo', ['b']);
+
+        $self->testResult(sub {$oMaster->cmdResult($iEchoB)}, 'b', 'result of last command submitted');
+        $self->testException(
+            sub {$oMaster->cmdResult($iError)}, ERROR_FILE_MISSING, 'raised from test-id: test error');
+        $self->testResult(sub {$oMaster->cmdResult($iEchoA)}, 'a', 'result of first command submitted');
+        $self->testException(
+            sub {$oMaster->cmdResult($iEchoA)}, ERROR_ASSERT,
+            "command id ${iEchoA} has not been submitted or the result has already been read");
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my @iyCommandId;
+
+        for (my $iIdx = 0; $iIdx < PROTOCOL_COMMAND_PENDING_MAX * 2; $iIdx++)
+        {
+            push(@iyCommandId, $oMaster->cmdSubmit('echo', [$iIdx]));
+        }
+
+        my $strResult = '';
+
+        for (my $iIdx = PROTOCOL_COMMAND_PENDING_MAX * 2 - 1; $iIdx >= 0; $iIdx--)
+        {
+            $strResult .= $oMaster->cmdResult($iyCommandId[$iIdx], true) . ' ';
+        }
+
+        $self->testResult(
+            $strResult, join(' ', reverse(0 .. PROTOCOL_COMMAND_PENDING_MAX * 2 - 1)) . ' ',
+            'results in reverse order with more commands than can be pending');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $iEchoC = $oMaster->cmdSubmit('echo', ['c']);
+
+        $oMaster->cmdWrite('echo', ['d']);
+        $self->testResult(sub {$oMaster->outputRead(true)}, 'd', 'cmdWrite() receives pending output first');
+        $self->testResult(sub {$oMaster->cmdResult($iEchoC)}, 'c', '    pending result');
+
+        $self->testResult(sub {$oMaster->close()}, 0, 'close');
+    }
 }
 
 1;
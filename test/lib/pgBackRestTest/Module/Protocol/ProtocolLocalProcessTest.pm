@@ -0,0 +1,375 @@
+####################################################################################################################################
+# Protocol Local Process Tests
+####################################################################################################################################
+package pgBackRestTest::Module::Protocol::ProtocolLocalProcessTest;
+use parent 'pgBackRestTest::Env::HostEnvTest';
+
+####################################################################################################################################
+# Perl includes
+####################################################################################################################################
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Log;
+use pgBackRest::Config::Config;
+use pgBackRest::Protocol::Helper;
+use pgBackRest::Protocol::Local::Process;
+use pgBackRest::Protocol::Storage::Helper;
+
+use pgBackRestTest::Env::HostEnvTest;
+use pgBackRestTest::Common::RunTest;
+
+####################################################################################################################################
+# Archive id used for path list jobs
+####################################################################################################################################
+use constant ARCHIVE_ID                                             => '9.4-1';
+
+####################################################################################################################################
+# initTest
+####################################################################################################################################
+sub initTest
+{
+    my $self = shift;
+
+    $self->optionTestSet(CFGOPT_STANZA, $self->stanza());
+    $self->optionTestSet(CFGOPT_REPO_PATH, $self->testPath());
+    $self->configTestLoad(CFGCMD_ARCHIVE_PUSH);
+
+    # Create an archive path with a segment so path list jobs have something to return
+    my $strWalPath = STORAGE_REPO_ARCHIVE . '/' . ARCHIVE_ID . '/0000000100000001';
+
+    storageRepo()->pathCreate($strWalPath, {bCreateParent => true});
+    storageRepo()->put("${strWalPath}/000000010000000100000001-" . ('0' x 40));
+}
+
+####################################################################################################################################
+# processRun
+#
+# Queue a path list job for each WAL path, run the jobs, and return a sorted list of the results.
+####################################################################################################################################
+sub processRun
+{
+    my $self = shift;
+    my $oProcess = shift;
+    my $stryWalPath = shift;
+
+    foreach my $strWalPath (@{$stryWalPath})
+    {
+        $oProcess->queueJob(1, 'default', $strWalPath, OP_ARCHIVE_PATH_LIST, [ARCHIVE_ID, $strWalPath]);
+    }
+
+    my @stryResult;
+
+    while (my $hyJob = $oProcess->process())
+    {
+        foreach my $hJob (@{$hyJob})
+        {
+            push(@stryResult, "$hJob->{strKey}:" . join('|', sort(keys(%{$hJob->{rResult}[0]}))));
+        }
+    }
+
+    return sort(@stryResult);
+}
+
+####################################################################################################################################
+# processDeviceRun
+#
+# Queue path list jobs on devices, run them, and return the jobs running on each device after the first jobs were assigned, the most
+# jobs that ran on each device at once, and the total jobs completed.
+####################################################################################################################################
+sub processDeviceRun
+{
+    my $self = shift;
+    my $oProcess = shift;
+    my $hJobQueue = shift;
+
+    foreach my $strQueue (sort(keys(%{$hJobQueue})))
+    {
+        foreach my $hJob (@{$hJobQueue->{$strQueue}})
+        {
+            $oProcess->queueJob(
+                1, $strQueue, $hJob->{strWalPath}, OP_ARCHIVE_PATH_LIST, [ARCHIVE_ID, $hJob->{strWalPath}], $hJob->{lSize},
+                false, $hJob->{strDevice});
+        }
+    }
+
+    my $strDeviceFirst;
+    my $hDeviceRunningMax = {};
+    my $iJobTotal = 0;
+
+    while (my $hyJob = $oProcess->process())
+    {
+        my $hDeviceRunning = $oProcess->{hyHost}[0]{hDeviceRunning};
+
+        # Store the devices of the jobs assigned by the first call
+        if (!defined($strDeviceFirst))
+        {
+            $strDeviceFirst = join(', ', map {"$_=$hDeviceRunning->{$_}"} sort(keys(%{$hDeviceRunning})));
+        }
+
+        foreach my $strDevice (keys(%{$hDeviceRunning}))
+        {
+            if (!defined($hDeviceRunningMax->{$strDevice}) || $hDeviceRunning->{$strDevice} > $hDeviceRunningMax->{$strDevice})
+            {
+                $hDeviceRunningMax->{$strDevice} = $hDeviceRunning->{$strDevice};
+            }
+        }
+
+        $iJobTotal += @{$hyJob};
+    }
+
+    return
+        $strDeviceFirst, join(', ', map {"$_=$hDeviceRunningMax->{$_}"} sort(keys(%{$hDeviceRunningMax}))), $iJobTotal;
+}
+
+####################################################################################################################################
+# processAutoStep
+#
+# Spread bytes read over the running local processes, advance the clock by one auto interval, and process once.  Returns the process
+# target, the running process total, the running process ids, and the number of jobs completed.
+####################################################################################################################################
+sub processAutoStep
+{
+    my $self = shift;
+    my $oProcess = shift;
+    my $hRead = shift;
+    my $rfTime = shift;
+    my $lSize = shift;
+
+    my @hyLocal = grep {defined($_)} @{$oProcess->{hyLocal}};
+
+    foreach my $hLocal (@hyLocal)
+    {
+        $hRead->{$hLocal->{oLocal}->io()->processId()} += $lSize / @hyLocal;
+    }
+
+    $$rfTime += pgBackRest::Protocol::Local::Process::PROCESS_AUTO_INTERVAL;
+
+    my $hyJob = $oProcess->process();
+    my $hHost = $oProcess->{hyHost}[0];
+
+    return
+        $hHost->{iProcessTarget}, $hHost->{iProcessTotal},
+        join('|', sort(map {$_->{iProcessId}} grep {defined($_)} @{$oProcess->{hyLocal}})), scalar(@{$hyJob});
+}
+
+####################################################################################################################################
+# localPoolPid
+#
+# Return the system process id of each pooled local process keyed by local process id.
+####################################################################################################################################
+sub localPoolPid
+{
+    my $self = shift;
+    my $oProcess = shift;
+
+    my $hPid = {};
+
+    foreach my $iProcessId (keys(%{$oProcess->{hLocalPool}}))
+    {
+        $hPid->{$iProcessId} = $oProcess->{hLocalPool}{$iProcessId}{oLocal}->io()->processId();
+    }
+
+    return $hPid;
+}
+
+####################################################################################################################################
+# run
+####################################################################################################################################
+sub run
+{
+    my $self = shift;
+
+    my $stryWalPath = ['0000000100000001', '0000000100000002', '0000000100000003', '0000000100000004'];
+    my $strResult =
+        '(0000000100000001:000000010000000100000001, 0000000100000002:, 0000000100000003:, 0000000100000004:)';
+
+    ################################################################################################################################
+    if ($self->begin('Process->localPoolGet(), keepAlive(), close()'))
+    {
+        my $oProcess = new pgBackRest::Protocol::Local::Process(
+            CFGOPTVAL_LOCAL_TYPE_BACKUP, undef, $self->backrestExe(), true, true);
+        $oProcess->hostAdd(1, 2);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$self->processRun($oProcess, $stryWalPath)}, $strResult, 'first run');
+        $self->testResult(sub {sort(keys(%{$oProcess->{hLocalPool}}))}, '(1, 2)', '    locals returned to pool');
+
+        my $hPid = $self->localPoolPid($oProcess);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {$oProcess->keepAlive(); sort(keys(%{$oProcess->{hLocalPool}}))}, '(1, 2)', 'keep alive pooled locals');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$self->processRun($oProcess, $stryWalPath)}, $strResult, 'second run');
+        $self->testResult(sub {$self->localPoolPid($oProcess)->{1}}, $hPid->{1}, '    local 1 reused');
+        $self->testResult(sub {$self->localPoolPid($oProcess)->{2}}, $hPid->{2}, '    local 2 reused');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        kill('KILL', $hPid->{1});
+
+        $self->testResult(sub {$self->processRun($oProcess, $stryWalPath)}, $strResult, 'run after local 1 was killed');
+        $self->testResult(
+            sub {$self->localPoolPid($oProcess)->{1} != $hPid->{1}}, true, '    local 1 replaced with a new process');
+        $self->testResult(sub {$self->localPoolPid($oProcess)->{2}}, $hPid->{2}, '    local 2 reused');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {$oProcess->close()}, undef, 'close pooled locals');
+        $self->testResult(sub {keys(%{$oProcess->{hLocalPool}})}, '[undef]', '    pool is empty');
+        $self->testResult(sub {kill(0, $hPid->{2})}, 0, '    local 2 has exited');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP, undef, $self->backrestExe());
+        $oProcess->hostAdd(1, 2);
+
+        $self->testResult(sub {$self->processRun($oProcess, $stryWalPath)}, $strResult, 'run without persist');
+        $self->testResult(sub {keys(%{$oProcess->{hLocalPool}})}, '[undef]', '    locals are not pooled');
+    }
+
+    ################################################################################################################################
+    if ($self->begin('Process->process() with devices'))
+    {
+        # Two queues read from device a and one from device b.  The largest job is in the second queue.
+        my $hJobQueue =
+        {
+            'queue1' =>
+            [
+                {strWalPath => '0000000100000001', lSize => 2, strDevice => 'a'},
+                {strWalPath => '0000000100000002', lSize => 1, strDevice => 'a'},
+            ],
+            'queue2' =>
+            [
+                {strWalPath => '0000000100000003', lSize => 3, strDevice => 'a'},
+                {strWalPath => '0000000100000004', lSize => 1, strDevice => 'a'},
+            ],
+            'queue3' =>
+            [
+                {strWalPath => '0000000100000005', lSize => 1, strDevice => 'b'},
+                {strWalPath => '0000000100000006', lSize => 1, strDevice => 'b'},
+            ],
+        };
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $oProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP, undef, $self->backrestExe());
+        $oProcess->hostAdd(1, 2);
+
+        $self->testResult(
+            sub {($self->processDeviceRun($oProcess, $hJobQueue))[0, 2]}, '(a=1, b=1, 6)',
+            'second local reads from the idle device rather than the largest job');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP, undef, $self->backrestExe());
+        $oProcess->hostAdd(1, 3, 1);
+
+        $self->testResult(
+            sub {$self->processDeviceRun($oProcess, $hJobQueue)}, '(a=1, b=1, a=1, b=1, 6)',
+            'device max limits jobs running on each device');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP, undef, $self->backrestExe());
+        $oProcess->hostAdd(1, 3, 2);
+
+        $self->testResult(
+            sub {($self->processDeviceRun($oProcess, $hJobQueue))[0, 2]}, '(a=2, b=1, 6)',
+            'third local reads the largest job on a device below the device max');
+    }
+
+    ################################################################################################################################
+    if ($self->begin('Process->processAuto()'))
+    {
+        my $fTime = 0;
+        my $fLoad = 0;
+        my $hRead = {};
+        my $iJobTotal = 40;
+        my $iJobComplete = 0;
+
+        my $oProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP, undef, $self->backrestExe());
+        $oProcess->hostAdd(
+            1, 3, undef,
+            {
+                fLoadMax => 2,
+                fnLoad => sub {$fLoad},
+                fnTime => sub {$fTime},
+                fnRead => sub {my $iPid = shift; defined($hRead->{$iPid}) ? $hRead->{$iPid} : 0},
+            });
+
+        for (my $iJobIdx = 0; $iJobIdx < $iJobTotal; $iJobIdx++)
+        {
+            my $strWalPath = sprintf('%016X', $iJobIdx);
+            $oProcess->queueJob(1, 'default', $strWalPath, OP_ARCHIVE_PATH_LIST, [ARCHIVE_ID, $strWalPath], 1);
+        }
+
+        # Returns a list of the process target, running process total, running process ids, and jobs completed
+        my $fnStep = sub
+        {
+            my @stryResult = $self->processAutoStep($oProcess, $hRead, \$fTime, shift);
+            $iJobComplete += $stryResult[3];
+
+            return @stryResult;
+        };
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {@{$oProcess->process()}}, '[undef]', 'start with one local process');
+        $self->testResult(sub {$oProcess->{hyHost}[0]{iProcessTotal}}, 1, '    one local process running');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {($fnStep->(100))[0, 1, 2]}, '(2, 2, 1|2)', 'add second process after first measurement');
+        $self->testResult(sub {($fnStep->(300))[0, 1, 2]}, '(3, 3, 1|2|3)', 'add third process when throughput improves');
+        $self->testResult(sub {($fnStep->(310))[0, 1]}, '(2, 2)', 'remove third process when throughput does not improve');
+        $self->testResult(sub {$oProcess->{hyHost}[0]{bAutoGrow}}, false, '    growth stopped');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {($fnStep->(300))[0, 1]}, '(2, 2)', 'measure throughput of remaining processes');
+        $self->testResult(sub {($fnStep->(310))[0, 1]}, '(2, 2)', 'small change in throughput does not restart growth');
+        $self->testResult(
+            sub {($fnStep->(400))[0, 1, 2]}, '(3, 3, 1|2|3)', 'large change in throughput restarts growth and reuses process id');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $fLoad = 3;
+
+        $self->testResult(sub {($fnStep->(400))[0, 1]}, '(2, 2)', 'remove process when load is above max');
+
+        $fLoad = 1;
+
+        $self->testResult(
+            sub {($fnStep->(400))[0, 1, 2]}, '(3, 3, 1|2|3)', 'add process when load is below max and reuse process id');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {while (my $hyJob = $oProcess->process()) {$iJobComplete += @{$hyJob}}; $iJobComplete}, $iJobTotal,
+            'all jobs complete');
+        $self->testResult(
+            sub {map {$_->{iProcessId}} @{$oProcess->processTime()}}, '(1, 2, 3)', '    process time recorded once per process id');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oProcess = new pgBackRest::Protocol::Local::Process(CFGOPTVAL_LOCAL_TYPE_BACKUP, undef, $self->backrestExe());
+        $oProcess->hostAdd(1, 3, undef, {fnTime => sub {$fTime}, fnRead => sub {undef}});
+
+        for (my $iJobIdx = 0; $iJobIdx < $iJobTotal; $iJobIdx++)
+        {
+            my $strWalPath = sprintf('%016X', $iJobIdx);
+            $oProcess->queueJob(1, 'default', $strWalPath, OP_ARCHIVE_PATH_LIST, [ARCHIVE_ID, $strWalPath], 1);
+        }
+
+        $oProcess->process();
+
+        $self->testResult(
+            sub {($self->processAutoStep($oProcess, $hRead, \$fTime, 0))[0, 1]}, '(2, 2)',
+            'add process using the size of completed jobs when bytes read are not available');
+        $self->testResult(sub {$oProcess->{hyHost}[0]{bAutoRead}}, false, '    bytes read not used');
+
+        while ($oProcess->process()) {};
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {pgBackRest::Protocol::Local::Process::processRead($PID) > 0}, true, 'bytes read by this process');
+        $self->testResult(
+            sub {pgBackRest::Protocol::Local::Process::processRead(undef)}, undef, 'no bytes read without process id');
+    }
+}
+
+1;
@@ -0,0 +1,189 @@
+####################################################################################################################################
+# ProtocolStatsTest.pm - tests for Protocol::Base::Stats module
+####################################################################################################################################
+package pgBackRestTest::Module::Protocol::ProtocolStatsTest;
+use parent 'pgBackRestTest::Common::RunTest';
+
+####################################################################################################################################
+# Perl includes
+####################################################################################################################################
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Log;
+use pgBackRest::Protocol::Base::Master;
+use pgBackRest::Protocol::Base::Stats;
+use pgBackRest::Protocol::Command::Master;
+
+use pgBackRestTest::Common::RunTest;
+
+####################################################################################################################################
+# statsReport - get a command from the stats report with the times rounded and the histogram flattened so it can be compared
+####################################################################################################################################
+sub statsReport
+{
+    my $self = shift;
+    my $strService = shift;
+    my $strCommand = shift;
+    my $strSide = shift;
+
+    my $hCommand = protocolStatsReport()->{$strService}{$strCommand}{$strSide};
+
+    return if (!defined($hCommand));
+
+    return
+        "count=$hCommand->{count}, bytesOut=$hCommand->{bytesOut}, bytesIn=$hCommand->{bytesIn}, " .
+        join(', ', map {"${_}=" . sprintf('%.4f', $hCommand->{$_})} qw(time timeMax timeP50 timeP90 timeP99)) . ', histogram=' .
+        join('|', map {"${_}:$hCommand->{histogram}{$_}"} sort {$a <=> $b} keys(%{$hCommand->{histogram}}));
+}
+
+####################################################################################################################################
+# minionCommand - command to start a minion with an echo command, optionally with stats enabled
+####################################################################################################################################
+sub minionCommand
+{
+    my $self = shift;
+    my $strService = shift;
+    my $bStats = shift;
+
+    return
+        'perl -I' . $self->basePath() . '/lib -e \'' .
+            'package TestMinion; use parent q{pgBackRest::Protocol::Base::Minion};' .
+            'sub init {{echo => sub {shift->[0]}}}' .
+            'package main; use pgBackRest::Common::Io::Buffered; use pgBackRest::Protocol::Base::Stats;' .
+            ($bStats ? 'protocolStatsEnable();' : '') .
+            '(new TestMinion("' . $strService . '", new pgBackRest::Common::Io::Buffered(' .
+            'new pgBackRest::Common::Io::Handle("stdio", *STDIN, *STDOUT), 5, 4096)))->process()\'';
+}
+
+####################################################################################################################################
+# run
+####################################################################################################################################
+sub run
+{
+    my $self = shift;
+
+    ################################################################################################################################
+    if ($self->begin('protocolStatsAdd() & protocolStatsReport() & protocolStatsMerge()'))
+    {
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(sub {protocolStatsEnabled()}, false, 'stats disabled by default');
+
+        protocolStatsAdd('test', 'noop', PROTOCOL_STATS_MASTER, .01, 10, 20);
+
+        $self->testResult(sub {scalar(keys(%{protocolStatsGet()}))}, 0, '    nothing recorded while disabled');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        protocolStatsEnable();
+
+        $self->testResult(sub {protocolStatsEnabled()}, true, 'enable stats');
+
+        protocolStatsAdd('test', 'noop', PROTOCOL_STATS_MASTER, .00005, 10, 20) for (1 .. 5);
+        protocolStatsAdd('test', 'noop', PROTOCOL_STATS_MASTER, .0001, 10, 20);
+        protocolStatsAdd('test', 'noop', PROTOCOL_STATS_MASTER, .00035, 10, 20) for (1 .. 3);
+        protocolStatsAdd('test', 'noop', PROTOCOL_STATS_MASTER, .01, 10, 20);
+
+        $self->testResult(
+            sub {$self->statsReport('test', 'noop', PROTOCOL_STATS_MASTER)},
+            'count=10, bytesOut=100, bytesIn=200, time=0.0114, timeMax=0.0100, timeP50=0.0001, timeP90=0.0004, timeP99=0.0100, ' .
+                'histogram=0.0001:6|0.0004:3|0.0128:1',
+            '    buckets and percentiles (p99 limited by max)');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        protocolStatsAdd('test', PROTOCOL_STATS_BLOCK, PROTOCOL_STATS_MINION, 0, 4096, 0);
+
+        $self->testResult(
+            sub {$self->statsReport('test', PROTOCOL_STATS_BLOCK, PROTOCOL_STATS_MINION)},
+            'count=1, bytesOut=4096, bytesIn=0, time=0.0000, timeMax=0.0000, timeP50=0.0000, timeP90=0.0000, timeP99=0.0000, ' .
+                'histogram=0.0001:1',
+            'zero time in first bucket');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        protocolStatsMerge(
+        {
+            test =>
+            {
+                noop =>
+                {
+                    &PROTOCOL_STATS_MASTER =>
+                    {
+                        iCount => 2, lBytesOut => 1, lBytesIn => 2, fTime => .1, fTimeMax => .09, iyBucket => [1, undef, 1],
+                    },
+                    &PROTOCOL_STATS_MINION =>
+                    {
+                        iCount => 1, lBytesOut => 5, lBytesIn => 6, fTime => .0002, fTimeMax => .0002, iyBucket => [undef, 1],
+                    },
+                },
+            },
+        });
+
+        $self->testResult(
+            sub {$self->statsReport('test', 'noop', PROTOCOL_STATS_MASTER)},
+            'count=12, bytesOut=101, bytesIn=202, time=0.1114, timeMax=0.0900, timeP50=0.0001, timeP90=0.0004, timeP99=0.0128, ' .
+                'histogram=0.0001:7|0.0004:4|0.0128:1',
+            'merge into existing command');
+        $self->testResult(
+            sub {$self->statsReport('test', 'noop', PROTOCOL_STATS_MINION)},
+            'count=1, bytesOut=5, bytesIn=6, time=0.0002, timeMax=0.0002, timeP50=0.0002, timeP90=0.0002, timeP99=0.0002, ' .
+                'histogram=0.0002:1',
+            'merge new side');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $self->testResult(
+            sub {protocolStatsLog()}, '', 'log stats',
+            {strLogLevel => DETAIL, strLogExpect =>
+                "DETAIL: protocol test block (minion): 1 calls, 4096B out, 0B in, avg 0.00ms, p50 0.00ms, p90 0.00ms, p99 0.00ms," .
+                    " max 0.00ms\n" .
+                "DETAIL: protocol test noop (master): 12 calls, 101B out, 202B in, avg 9.28ms, p50 0.10ms, p90 0.40ms," .
+                    " p99 12.80ms, max 90.00ms\n" .
+                "DETAIL: protocol test noop (minion): 1 calls, 5B out, 6B in, avg 0.20ms, p50 0.20ms, p90 0.20ms, p99 0.20ms," .
+                    " max 0.20ms"});
+    }
+
+    ################################################################################################################################
+    if ($self->begin('Master->statsCollect()'))
+    {
+        protocolStatsEnable();
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $oMaster = new pgBackRest::Protocol::Command::Master(
+            'test-stats', 'test-id', $self->minionCommand('test-stats', true), 4096, 3, 3, 5);
+
+        $self->testResult(sub {$oMaster->cmdExecute('echo', ['abc'])}, 'abc', 'echo');
+        $self->testResult(sub {$oMaster->cmdExecute('echo', ['def'])}, 'def', 'echo');
+
+        $oMaster->statsCollect();
+        $oMaster->statsCollect();
+
+        $self->testResult(
+            sub {$self->statsReport('test-stats', 'echo', PROTOCOL_STATS_MASTER) =~ /^(count=2, bytesOut=[0-9]+, bytesIn=[0-9]+),/},
+            'count=2, bytesOut=106, bytesIn=76', 'master stats recorded');
+        $self->testResult(
+            sub {$self->statsReport('test-stats', 'echo', PROTOCOL_STATS_MINION) =~ /^(count=2, bytesOut=[0-9]+, bytesIn=[0-9]+),/},
+            'count=2, bytesOut=76, bytesIn=106', 'minion stats collected once');
+        $self->testResult(
+            sub {defined(protocolStatsReport()->{'test-stats'}{&OP_STATS}) ? true : false}, false,
+            '    stats command not recorded');
+
+        $self->testResult(sub {$oMaster->close()}, 0, 'close');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oMaster = new pgBackRest::Protocol::Command::Master(
+            'test-nostats', 'test-id', $self->minionCommand('test-nostats', false), 4096, 3, 3, 5);
+
+        $self->testResult(sub {$oMaster->cmdExecute('echo', ['abc'])}, 'abc', 'echo');
+        $self->testResult(sub {$oMaster->close()}, 0, 'close collects stats');
+
+        $self->testResult(
+            sub {defined($self->statsReport('test-nostats', 'echo', PROTOCOL_STATS_MASTER)) ? true : false}, true,
+            '    master stats recorded');
+        $self->testResult(
+            sub {defined($self->statsReport('test-nostats', 'echo', PROTOCOL_STATS_MINION)) ? true : false}, false,
+            '    minion did not record stats while disabled');
+    }
+}
+
+1;
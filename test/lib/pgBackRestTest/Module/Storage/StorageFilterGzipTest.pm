@@ -97,6 +97,66 @@ sub run
 
         $self->testResult(sub {${storageTest()->get($strFile)}}, $strFileContent, '    check content');
 
+        #---------------------------------------------------------------------------------------------------------------------------
+        executeTest("gzip -c ${strFile} > ${strFileGz} && gzip -c ${strFile} >> ${strFileGz}");
+        $tFile = ${storageTest()->get($strFileGz)};
+
+        $oGzipIo = $self->testResult(
+            sub {new pgBackRest::Storage::Filter::Gzip(
+                $oDriver->openWrite($strFile), {strCompressType => STORAGE_DECOMPRESS})},
+            '[object]', 'new write decompress members');
+
+        $tBuffer = substr($tFile, 0, length($tFile) / 2);
+        $self->testResult(sub {$oGzipIo->write(\$tBuffer)}, length($tFile) / 2, '     write first member');
+        $tBuffer = substr($tFile, length($tFile) / 2);
+        $self->testResult(sub {$oGzipIo->write(\$tBuffer)}, length($tFile) / 2, '     write second member');
+        $self->testResult(sub {$oGzipIo->close()}, true, '    close');
+
+        $self->testResult(sub {${storageTest()->get($strFile)}}, $strFileContent x 2, '    check content');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oGzipIo = $self->testResult(
+            sub {new pgBackRest::Storage::Filter::Gzip($oDriver->openWrite($strFileGz), {lOriginalSize => $iFileLength + 4})},
+            '[object]', 'new write compress with original size');
+
+        $tBuffer = $strFileContent;
+        $self->testResult(sub {$oGzipIo->write(\$tBuffer)}, $iFileLength, '    write');
+        $self->testResult(sub {$oGzipIo->close()}, true, '    close');
+
+        $tFile = ${storageTest()->get($strFileGz)};
+        $self->testResult(
+            sub {unpack('H*', substr($tFile, 0, 20))}, '1f8b08040000000000030800704204000c000000', '    check header');
+
+        executeTest("gzip -dc ${strFileGz} > ${strFile}");
+        $self->testResult(sub {${storageTest()->get($strFile)}}, $strFileContent, '    gzip decompresses without zeros');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oGzipIo = $self->testResult(
+            sub {new pgBackRest::Storage::Filter::Gzip(
+                $oDriver->openWrite($strFile), {strCompressType => STORAGE_DECOMPRESS})},
+            '[object]', 'new write decompress with original size');
+
+        $tBuffer = substr($tFile, 0, 20);
+        $self->testResult(sub {$oGzipIo->write(\$tBuffer)}, 20, '     write header');
+        $tBuffer = substr($tFile, 20);
+        $self->testResult(sub {$oGzipIo->write(\$tBuffer)}, length($tFile) - 20, '     write bytes');
+        $self->testResult(sub {$oGzipIo->close()}, true, '    close');
+
+        $self->testResult(sub {${storageTest()->get($strFile)}}, "${strFileContent}\0\0\0\0", '    check content extended');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $oGzipIo = new pgBackRest::Storage::Filter::Gzip($oDriver->openWrite($strFileGz), {lOriginalSize => 0});
+
+        $tBuffer = '';
+        $oGzipIo->write(\$tBuffer);
+        $oGzipIo->close();
+
+        $oGzipIo = new pgBackRest::Storage::Filter::Gzip($oDriver->openWrite($strFile), {strCompressType => STORAGE_DECOMPRESS});
+
+        $tBuffer = ${storageTest()->get($strFileGz)};
+        $self->testResult(sub {$oGzipIo->write(\$tBuffer)}, length($tBuffer), 'write decompress empty with original size');
+        $self->testResult(sub {$oGzipIo->close()}, true, '    close');
+        $self->testResult(sub {${storageTest()->get($strFile)}}, undef, '    check content not extended');
     }
 
     ################################################################################################################################
@@ -168,6 +228,30 @@ sub run
         #---------------------------------------------------------------------------------------------------------------------------
         $tBuffer = undef;
 
+        storageTest()->put($strFile, $strFileContent);
+        executeTest(
+            "gzip -c ${strFile} > ${strFileGz} && gzip -c ${strFile} >> ${strFileGz} && printf '' | gzip -c >> ${strFileGz}");
+
+        # A small buffer makes the first member end exactly at the end of a read
+        my $lMemberSize = length(${storageTest()->get($strFileGz)}) / 2 - 10;
+
+        $oGzipIo = $self->testResult(
+            sub {new pgBackRest::Storage::Filter::Gzip(
+                $oDriver->openRead($strFileGz), {lCompressBufferMax => $lMemberSize, strCompressType => STORAGE_DECOMPRESS})},
+            '[object]', 'new read decompress members');
+
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 4)}, 4, '    read 4 bytes');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 8)}, 8, '    read 8 bytes across members');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 8)}, 4, '    read 4 bytes');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 8)}, 0, '    read 0 bytes');
+        $self->testResult(sub {$oGzipIo->close()}, true, '    close');
+        $self->testResult($tBuffer, $strFileContent x 2, '    check content');
+
+        storageTest()->remove($strFileGz);
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $tBuffer = undef;
+
         executeTest('cp ' . $self->dataPath() . "/filecopy.archive2.bin ${strFile}");
 
         $oGzipIo = $self->testResult(
@@ -204,6 +288,50 @@ sub run
         $self->testResult(
             sub {${storageTest()->get($strFile)}}, $strFileContent, '    check content');
 
+        #---------------------------------------------------------------------------------------------------------------------------
+        $tBuffer = undef;
+        storageTest()->put($strFile, $strFileContent);
+
+        $oGzipIo = $self->testResult(
+            sub {new pgBackRest::Storage::Filter::Gzip($oDriver->openRead($strFile), {lOriginalSize => 32})},
+            '[object]', 'new read compress with original size');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 2)}, 20, '    read 20 bytes (request 2)');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 2)}, 18, '    read 18 bytes (request 2)');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 2)}, 0, '    read 0 bytes (request 2)');
+        $self->testResult(sub {$oGzipIo->close()}, true, '    close');
+
+        $self->testResult(sub {storageTest()->put($strFileGz, $tBuffer)}, 38, '    put content');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $tBuffer = undef;
+
+        $oGzipIo = $self->testResult(
+            sub {new pgBackRest::Storage::Filter::Gzip($oDriver->openRead($strFileGz), {strCompressType => STORAGE_DECOMPRESS})},
+            '[object]', 'new read decompress with original size');
+
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 4)}, 4, '    read 4 bytes');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 8)}, 4, '    read 4 bytes');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 16)}, 16, '    read 16 zero bytes');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 16)}, 8, '    read 8 zero bytes');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 16)}, 0, '    read 0 bytes');
+        $self->testResult(sub {$oGzipIo->close()}, true, '    close');
+        $self->testResult($tBuffer, $strFileContent . ("\0" x 24), '    check content extended');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $tBuffer = undef;
+        executeTest("printf 'xx' | gzip -c > ${strFileGz}");
+
+        # An extra field without the original size is skipped
+        storageTest()->put(
+            $strFileGz,
+            pack('H*', '1f8b080400000000000308007878040000000000') . substr(${storageTest()->get($strFileGz)}, 10));
+
+        $oGzipIo = new pgBackRest::Storage::Filter::Gzip($oDriver->openRead($strFileGz), {strCompressType => STORAGE_DECOMPRESS});
+
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 16)}, 2, 'read decompress with other extra field');
+        $self->testResult(sub {$oGzipIo->read(\$tBuffer, 16)}, 0, '    read 0 bytes');
+        $self->testResult($tBuffer, 'xx', '    check content not extended');
+
         #---------------------------------------------------------------------------------------------------------------------------
         storageTest()->put($strFileGz, $strFileContent);
 
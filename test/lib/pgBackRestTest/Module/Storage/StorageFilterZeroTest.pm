@@ -0,0 +1,66 @@
+####################################################################################################################################
+# StorageFilterZeroTest.pm - Tests for StorageFilterZero module.
+####################################################################################################################################
+package pgBackRestTest::Module::Storage::StorageFilterZeroTest;
+use parent 'pgBackRestTest::Common::RunTest';
+
+####################################################################################################################################
+# Perl includes
+####################################################################################################################################
+use strict;
+use warnings FATAL => qw(all);
+use Carp qw(confess);
+use English '-no_match_vars';
+
+use pgBackRest::Common::Exception;
+use pgBackRest::Common::Log;
+use pgBackRest::Storage::Base;
+use pgBackRest::Storage::Filter::Zero;
+use pgBackRest::Storage::Posix::Driver;
+
+use pgBackRestTest::Common::ExecuteTest;
+use pgBackRestTest::Common::RunTest;
+
+####################################################################################################################################
+# run
+####################################################################################################################################
+sub run
+{
+    my $self = shift;
+
+    # Test data
+    my $strFile = $self->testPath() . qw{/} . 'file.bin';
+    my $strFileContent = "\0\0TEST\0\0DATA" . ("\0" x 20);
+    my $oDriver = new pgBackRest::Storage::Posix::Driver();
+
+    ################################################################################################################################
+    if ($self->begin('read()'))
+    {
+        my $tBuffer;
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        storageTest()->put($strFile, $strFileContent);
+
+        my $oFileIo = $self->testResult(sub {$oDriver->openRead($strFile)}, '[object]', 'open read');
+        my $oZeroIo = $self->testResult(sub {new pgBackRest::Storage::Filter::Zero($oFileIo)}, '[object]', 'new read');
+
+        $self->testResult(sub {$oZeroIo->read(\$tBuffer, 4)}, 4, 'read zeros and data');
+        $self->testResult(sub {$oZeroIo->read(\$tBuffer, 4)}, 2, 'read data and hold back zeros');
+        $self->testResult(sub {$oZeroIo->read(\$tBuffer, 4)}, 6, 'read zeros held back with data');
+        $self->testResult(sub {$oZeroIo->read(\$tBuffer, 4)}, 0, 'zeros at end are not read');
+        $self->testResult(sub {$oZeroIo->close()}, true, 'close');
+
+        $self->testResult($tBuffer, "\0\0TEST\0\0DATA", 'check content');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $tBuffer = undef;
+        storageTest()->put($strFile, "\0" x 20);
+
+        $oZeroIo = new pgBackRest::Storage::Filter::Zero($oDriver->openRead($strFile));
+
+        $self->testResult(sub {$oZeroIo->read(\$tBuffer, 4)}, 0, 'file of zeros is empty');
+        $self->testResult(defined($tBuffer) ? true : false, false, 'check content is undefined');
+    }
+}
+
+1;
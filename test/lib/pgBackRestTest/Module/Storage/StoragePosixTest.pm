@@ -207,7 +207,8 @@ sub run
 
         $self->testResult(
             sub {$oPosix->manifest($self->testPath())},
-            '{. => {group => ' . $self->group() . ', mode => 0770, type => d, user => ' . $self->pgUser() . '}, ' .
+            '{. => {device => ' . (stat($self->testPath()))[0] . ', group => ' . $self->group() . ', mode => 0770, type => d, ' .
+                'user => ' . $self->pgUser() . '}, ' .
             'sub1 => {group => ' . $self->group() . ', mode => 0750, type => d, user => ' . $self->pgUser() . '}, ' .
             'sub1/sub2 => {group => ' . $self->group() . ', mode => 0750, type => d, user => ' . $self->pgUser() . '}, ' .
             'sub1/sub2/test => {group => ' . $self->group() . ', link_destination => ../.., type => l, user => ' .
@@ -243,6 +244,22 @@ sub run
 
         $self->testResult(
             sub {$oPosix->openRead($strFile)}, '[object]', 'open read');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        my $tBuffer;
+        my $oFileIo = $self->testResult(
+            sub {$oPosix->openRead($strFile, {lOffset => 2, lLimit => $iFileLengthHalf})}, '[object]', 'open read range');
+
+        $self->testResult(sub {$oFileIo->read(\$tBuffer, $iFileLength)}, $iFileLengthHalf, '    read to limit');
+        $self->testResult(sub {$oFileIo->read(\$tBuffer, $iFileLength)}, 0, '    read nothing past limit');
+        $self->testResult($tBuffer, substr($strFileContent, 2, $iFileLengthHalf), '    check content');
+
+        #---------------------------------------------------------------------------------------------------------------------------
+        $tBuffer = undef;
+        $oFileIo = $self->testResult(sub {$oPosix->openRead($strFile, {lOffset => 2})}, '[object]', 'open read from offset');
+
+        $self->testResult(sub {$oFileIo->read(\$tBuffer, $iFileLength)}, $iFileLength - 2, '    read to end of file');
+        $self->testResult($tBuffer, substr($strFileContent, 2), '    check content');
     }
 
     ################################################################################################################################
@@ -153,6 +153,9 @@ sub run
 
         $self->testResult(sub {$oStorage->info($strFile)->size()}, 8, 'file size');
         $self->testResult(sub {$oStorage->info("/path/to/${strFile}2")->size()}, 9, 'file 2 size');
+        $self->testResult(
+            sub {$oStorage->info($strFile)->etag() ne $oStorage->info("${strFile}2")->etag() ? true : false}, true,
+            'file etags differ');
     }
 
     ################################################################################################################################
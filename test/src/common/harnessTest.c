@@ -26,6 +26,14 @@ testAdd - add a new test
 void
 testAdd(int run, bool selected)
 {
+    // Tests must be added in order
+    if (run != testTotal + 1)
+    {
+        fprintf(stderr, "ERROR: test run %d added out of order\n", run);
+        fflush(stderr);
+        exit(255);
+    }
+
     testList[testTotal].selected = selected;
     testTotal++;
 }
@@ -48,6 +56,8 @@ testBegin(const char *name)
         printf("run %03d - %s\n", testRun, name);
         fflush(stdout);
     }
+
+    return testList[testRun - 1].selected;
 }
 
 /***********************************************************************************************************************************
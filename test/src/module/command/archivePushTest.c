@@ -0,0 +1,323 @@
+/***********************************************************************************************************************************
+Test Archive Push Command
+***********************************************************************************************************************************/
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "config/parse.h"
+
+/***********************************************************************************************************************************
+Paths and files used for testing
+***********************************************************************************************************************************/
+#define TEST_PATH                                                   "test-push"
+#define TEST_PATH_REPO                                              TEST_PATH "/repo"
+#define TEST_PATH_ARCHIVE                                           TEST_PATH_REPO "/archive/db"
+#define TEST_PATH_DB                                                TEST_PATH "/db"
+#define TEST_PATH_LOCK                                              TEST_PATH "/lock"
+#define TEST_FILE_STDOUT                                            TEST_PATH "/stdout"
+
+#define TEST_SEGMENT                                                "000000010000000100000001"
+#define TEST_SEGMENT_PATH                                           TEST_PATH_ARCHIVE "/9.4-1/0000000100000001"
+
+/***********************************************************************************************************************************
+Archive info written by the Perl code for a 9.4 cluster
+***********************************************************************************************************************************/
+#define TEST_ARCHIVE_INFO                                                                                                          \
+    "[backrest]\n"                                                                                                                 \
+    "backrest-checksum=\"2e274ecdfc81f9aff78464c658deb2ab986d9359\"\n"                                                             \
+    "backrest-format=5\n"                                                                                                          \
+    "backrest-version=\"1.26dev\"\n"                                                                                               \
+    "\n"                                                                                                                           \
+    "[db]\n"                                                                                                                       \
+    "db-id=1\n"                                                                                                                    \
+    "db-system-id=6569239123849665679\n"                                                                                           \
+    "db-version=\"9.4\"\n"                                                                                                         \
+    "\n"                                                                                                                           \
+    "[db:history]\n"                                                                                                               \
+    "1={\"db-id\":6569239123849665679,\"db-version\":\"9.4\"}\n"
+
+/***********************************************************************************************************************************
+Write content to a file
+***********************************************************************************************************************************/
+static void
+testFile(const char *file, const unsigned char *content, size_t size)
+{
+    FILE *fileHandle = fopen(file, "w");
+
+    if (fileHandle == NULL)
+        ERROR_THROW(AssertError, "unable to create '%s'", file);
+
+    fwrite(content, 1, size, fileHandle);
+    fclose(fileHandle);
+}
+
+/***********************************************************************************************************************************
+Write a WAL segment with a long header for 9.4
+***********************************************************************************************************************************/
+static void
+testSegment(const char *file, uint64 systemId)
+{
+    unsigned char *walBuffer = memNewRaw(PG_WAL_SEGMENT_SIZE);
+    uint16 magic = 0xD07E;
+    uint16 flag = 2;
+
+    memset(walBuffer, 0, PG_WAL_SEGMENT_SIZE);
+    memcpy(walBuffer, &magic, sizeof(magic));
+    memcpy(walBuffer + 2, &flag, sizeof(flag));
+    memcpy(walBuffer + 24, &systemId, sizeof(systemId));
+
+    for (unsigned int walIdx = 0; walIdx < 100000; walIdx++)
+        walBuffer[100 + walIdx] = (unsigned char)(walIdx % 251);
+
+    testFile(file, walBuffer, PG_WAL_SEGMENT_SIZE);
+    memFree(walBuffer);
+}
+
+/***********************************************************************************************************************************
+Parse a NULL-terminated argument list and push.  Output to stdout is captured so it can be checked.
+***********************************************************************************************************************************/
+static char testStdOut[4096];
+
+static bool
+testPush(const char *arg, ...)
+{
+    const char *argList[64] = {"pgbackrest"};
+    unsigned int argListSize = 1;
+
+    va_list argumentList;
+    va_start(argumentList, arg);
+
+    for (const char *argNext = arg; argNext != NULL; argNext = va_arg(argumentList, const char *))
+        argList[argListSize++] = argNext;
+
+    va_end(argumentList);
+
+    if (!configParse(argListSize, argList))
+        ERROR_THROW(AssertError, "unable to parse command line");
+
+    // Capture stdout
+    fflush(stdout);
+    int stdOutSave = dup(STDOUT_FILENO);
+    dup2(open(TEST_FILE_STDOUT, O_WRONLY | O_CREAT | O_TRUNC, 0640), STDOUT_FILENO);
+
+    bool result = false;
+
+    ERROR_TRY()
+    {
+        result = cmdArchivePush();
+    }
+    ERROR_FINALLY()
+    {
+        dup2(stdOutSave, STDOUT_FILENO);
+        close(stdOutSave);
+
+        // Restore the log defaults
+        logInit(logLevelOff, logLevelWarn, logLevelOff, true);
+    }
+
+    size_t size = 0;
+    unsigned char *content = storagePosixGet(TEST_FILE_STDOUT, false, &size);
+
+    memcpy(testStdOut, content, size + 1);
+    memFree(content);
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Options that are common to most tests
+***********************************************************************************************************************************/
+#define TEST_OPTION_BASE                                                                                                           \
+    "--no-config", "--stanza=db", "--repo-path=" TEST_PATH_REPO, "--db-path=" TEST_PATH_DB, "--lock-path=" TEST_PATH_LOCK,        \
+    "--log-level-console=info", "--no-log-timestamp"
+#define TEST_OPTION                                                                                                                \
+    TEST_OPTION_BASE, "--log-level-file=off"
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    if (system("rm -rf " TEST_PATH " && mkdir -p " TEST_PATH_ARCHIVE " " TEST_PATH_DB "/pg_xlog " TEST_PATH_LOCK) != 0)
+        ERROR_THROW(AssertError, "unable to create " TEST_PATH);
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("cmdBegin() and cmdEnd()"))
+    {
+        const char *argList[] =
+        {
+            "pgbackrest", "--no-config", "--stanza=db", "--no-compress", "--db-path=/path with space", "--repo-s3-key=secret",
+            "--repo-type=s3", "--repo-s3-bucket=bucket", "--repo-s3-endpoint=endpoint", "--repo-s3-region=region",
+            "--repo-s3-key-secret=secret", "--log-timestamp", "backup"
+        };
+
+        TEST_RESULT_BOOL(configParse(sizeof(argList) / sizeof(char *), argList), true, "parse backup");
+
+        logInit(logLevelInfo, logLevelOff, logLevelOff, false);
+
+        fflush(stdout);
+        int stdOutSave = dup(STDOUT_FILENO);
+        dup2(open(TEST_FILE_STDOUT, O_WRONLY | O_CREAT | O_TRUNC, 0640), STDOUT_FILENO);
+
+        cmdBegin();
+        cmdEnd(0);
+        cmdEnd(25);
+
+        logInit(logLevelOff, logLevelOff, logLevelOff, false);
+        cmdBegin();
+
+        dup2(stdOutSave, STDOUT_FILENO);
+        close(stdOutSave);
+
+        logInit(logLevelOff, logLevelWarn, logLevelOff, true);
+
+        TEST_RESULT_STR(
+            (char *)storagePosixGet(TEST_FILE_STDOUT, false, NULL),
+            "P00   INFO: backup command begin " PGBACKREST_VERSION ": --no-compress \"--db1-path=/path with space\""
+                " --log-timestamp --repo-s3-bucket=bucket --repo-s3-endpoint=endpoint --repo-s3-key=<redacted>"
+                " --repo-s3-key-secret=<redacted> --repo-s3-region=region --repo-type=s3 --stanza=db\n"
+            "P00   INFO: backup command end: completed successfully\n"
+            "P00   INFO: backup command end: aborted with exception [025]\n",
+            "command begin and end");
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("cmdArchivePush() options"))
+    {
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "archive-push", NULL), false, "no segment");
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "archive-push", TEST_SEGMENT, TEST_SEGMENT, NULL), false, "two segments");
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "--backup-host=backup", "archive-push", TEST_SEGMENT, NULL), false, "backup host");
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "--db2-host=db2", "archive-push", TEST_SEGMENT, NULL), false, "db host");
+        TEST_RESULT_BOOL(
+            testPush(
+                TEST_OPTION, "--repo-type=s3", "--repo-s3-bucket=bucket", "--repo-s3-endpoint=endpoint", "--repo-s3-region=region",
+                "--repo-s3-key=key", "--repo-s3-key-secret=secret", "archive-push", TEST_SEGMENT, NULL),
+            false, "s3 repo");
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "--archive-async", "archive-push", TEST_SEGMENT, NULL), false, "async");
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "--archive-max-mb=1", "archive-push", TEST_SEGMENT, NULL), false, "archive-max-mb");
+        TEST_RESULT_BOOL(
+            testPush(TEST_OPTION, "--log-level-stderr=debug", "archive-push", TEST_SEGMENT, NULL), false, "debug logging");
+        TEST_RESULT_BOOL(
+            testPush(TEST_OPTION_BASE, "--log-level-file=debug", "archive-push", TEST_SEGMENT, NULL), false, "debug file logging");
+
+        TEST_RESULT_STR(testStdOut, "", "nothing logged");
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("cmdArchivePush()"))
+    {
+        // Cases that are left to Perl
+        testFile(TEST_PATH_LOCK "/db.stop", (unsigned char *)"", 0);
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "archive-push", TEST_SEGMENT, NULL), false, "stanza stop file");
+        unlink(TEST_PATH_LOCK "/db.stop");
+
+        testFile(TEST_PATH_LOCK "/all.stop", (unsigned char *)"", 0);
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "archive-push", TEST_SEGMENT, NULL), false, "all stop file");
+        unlink(TEST_PATH_LOCK "/all.stop");
+
+        TEST_RESULT_BOOL(
+            testPush(
+                "--no-config", "--stanza=db", "--repo-path=" TEST_PATH_REPO, "--lock-path=" TEST_PATH_LOCK, "archive-push",
+                "pg_xlog/" TEST_SEGMENT, NULL),
+            false, "relative path without db-path");
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "archive-push", "pg_xlog/00000002.history", NULL), false, "history file");
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "archive-push", "pg_xlog/" TEST_SEGMENT, NULL), false, "missing segment");
+
+        testSegment(TEST_PATH_DB "/pg_xlog/" TEST_SEGMENT, 6569239123849665679ULL);
+
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "archive-push", "pg_xlog/" TEST_SEGMENT, NULL), false, "missing archive.info");
+
+        testFile(TEST_PATH_ARCHIVE "/archive.info", (unsigned char *)"[backrest]\nbackrest-checksum", 28);
+        TEST_RESULT_BOOL(testPush(TEST_OPTION, "archive-push", "pg_xlog/" TEST_SEGMENT, NULL), false, "invalid archive.info");
+
+        testFile(TEST_PATH_ARCHIVE "/archive.info", (unsigned char *)"[backrest]\nbackrest-format=5\n", 29);
+        TEST_RESULT_BOOL(
+            testPush(TEST_OPTION, "archive-push", "pg_xlog/" TEST_SEGMENT, NULL), false, "archive.info without checksum");
+
+        // Info copy is used when archive.info is not valid
+        testFile(TEST_PATH_ARCHIVE "/archive.info.copy", (unsigned char *)TEST_ARCHIVE_INFO, strlen(TEST_ARCHIVE_INFO));
+
+        TEST_RESULT_BOOL(
+            testPush(TEST_OPTION, "--no-compress", "archive-push", "pg_xlog/" TEST_SEGMENT, NULL), true, "push from copy");
+
+        TEST_RESULT_STR(
+            testStdOut,
+            "P00   INFO: archive-push command begin " PGBACKREST_VERSION ": --no-compress --db1-path=" TEST_PATH_DB
+                " --lock-path=" TEST_PATH_LOCK " --log-level-console=info --log-level-file=off --no-log-timestamp"
+                " --repo-path=" TEST_PATH_REPO " --stanza=db\n"
+            "P00   INFO: pushed WAL segment " TEST_SEGMENT "\n"
+            "P00   INFO: archive-push command end: completed successfully\n",
+            "push log");
+
+        size_t size = 0;
+
+        TEST_RESULT_PTR_NE(
+            storagePosixGet(
+                TEST_SEGMENT_PATH "/" TEST_SEGMENT "-b4a8fe1dd638951d10c2e0d9fda5cbfcd2dea8f1", false, &size),
+            NULL, "segment pushed");
+        TEST_RESULT_INT(size, PG_WAL_SEGMENT_SIZE, "segment size");
+
+        // A segment that already exists is left to Perl
+        TEST_RESULT_BOOL(
+            testPush(TEST_OPTION, "archive-push", "pg_xlog/" TEST_SEGMENT, NULL), false, "segment exists");
+
+        unlink(TEST_SEGMENT_PATH "/" TEST_SEGMENT "-b4a8fe1dd638951d10c2e0d9fda5cbfcd2dea8f1");
+
+        // Push compressed with an absolute path
+        testFile(TEST_PATH_ARCHIVE "/archive.info", (unsigned char *)TEST_ARCHIVE_INFO, strlen(TEST_ARCHIVE_INFO));
+
+        char cwd[1024];
+        char walFile[2048];
+
+        if (getcwd(cwd, sizeof(cwd)) == NULL)
+            ERROR_THROW(AssertError, "unable to get cwd");
+
+        snprintf(walFile, sizeof(walFile), "%s/" TEST_PATH_DB "/pg_xlog/" TEST_SEGMENT, cwd);
+
+        TEST_RESULT_BOOL(
+            testPush(TEST_OPTION_BASE, "--log-path=" TEST_PATH "/log", "archive-push", walFile, NULL), true,
+            "push compressed with file logging");
+
+        TEST_RESULT_STR(
+            (char *)storagePosixGet(TEST_PATH "/log/db-archive-push.log", false, NULL),
+            "-------------------PROCESS START-------------------\n"
+            "P00   INFO: archive-push command begin " PGBACKREST_VERSION ": --db1-path=" TEST_PATH_DB " --lock-path=" TEST_PATH_LOCK
+                " --log-level-console=info --log-path=" TEST_PATH "/log --no-log-timestamp --repo-path=" TEST_PATH_REPO
+                " --stanza=db\n"
+            "P00   INFO: pushed WAL segment " TEST_SEGMENT "\n"
+            "P00   INFO: archive-push command end: completed successfully\n",
+            "file log");
+
+        unsigned char *compressed = NULL;
+
+        TEST_RESULT_PTR_NE(
+            compressed = storagePosixGet(
+                TEST_SEGMENT_PATH "/" TEST_SEGMENT "-b4a8fe1dd638951d10c2e0d9fda5cbfcd2dea8f1." COMPRESS_EXT, false, &size),
+            NULL, "segment pushed");
+        TEST_RESULT_INT(size, 753, "compressed segment size");
+
+        // The segment size is stored in the gzip header extra field
+        TEST_RESULT_INT(compressed[3] & 4, 4, "extra field flag set");
+        TEST_RESULT_INT(memcmp(compressed + 10, "\x08\x00pB\x04\x00\x00\x00\x00\x01", 10), 0, "extra field has segment size");
+
+        memFree(compressed);
+
+        // Zeros at the end of the segment are not compressed
+        TEST_RESULT_BOOL(
+            system(
+                "gzip -dc " TEST_SEGMENT_PATH "/" TEST_SEGMENT "-b4a8fe1dd638951d10c2e0d9fda5cbfcd2dea8f1." COMPRESS_EXT
+                " > " TEST_PATH "/segment && test $(wc -c < " TEST_PATH "/segment) -eq 100100 && head -c 100100 " TEST_PATH_DB
+                "/pg_xlog/" TEST_SEGMENT " | cmp -s - " TEST_PATH "/segment") == 0,
+            true, "decompressed segment matches without trailing zeros");
+
+        // Segment from another cluster is left to Perl
+        testSegment(TEST_PATH_DB "/pg_xlog/000000010000000100000002", 1);
+
+        TEST_RESULT_BOOL(
+            testPush(TEST_OPTION, "archive-push", "pg_xlog/000000010000000100000002", NULL), false, "system id mismatch");
+    }
+}
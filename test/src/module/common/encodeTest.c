@@ -13,31 +13,32 @@ void testRun()
         char *source = "string_to_encode\r\n";
         unsigned char destination[256];
 
-        encodeToStr(encodeBase64, source, 1, destination);
+        encodeToStr(encodeBase64, (unsigned char *)source, 1, (char *)destination);
         TEST_RESULT_STR(destination, "c3==", "1 character encode");
-        TEST_RESULT_INT(encodeToStrSize(encodeBase64, 1), strlen(destination), "check size");
+        TEST_RESULT_INT(encodeToStrSize(encodeBase64, 1), strlen((char *)destination), "check size");
 
-        encodeToStr(encodeBase64, source, 2, destination);
+        encodeToStr(encodeBase64, (unsigned char *)source, 2, (char *)destination);
         TEST_RESULT_STR(destination, "c3R=", "2 character encode");
-        TEST_RESULT_INT(encodeToStrSize(encodeBase64, 2), strlen(destination), "check size");
+        TEST_RESULT_INT(encodeToStrSize(encodeBase64, 2), strlen((char *)destination), "check size");
 
-        encodeToStr(encodeBase64, source, 3, destination);
+        encodeToStr(encodeBase64, (unsigned char *)source, 3, (char *)destination);
         TEST_RESULT_STR(destination, "c3Ry", "3 character encode");
-        TEST_RESULT_INT(encodeToStrSize(encodeBase64, 3), strlen(destination), "check size");
+        TEST_RESULT_INT(encodeToStrSize(encodeBase64, 3), strlen((char *)destination), "check size");
 
-        encodeToStr(encodeBase64, source, strlen(source) - 2, destination);
+        encodeToStr(encodeBase64, (unsigned char *)source, strlen(source) - 2, (char *)destination);
         TEST_RESULT_STR(destination, "c3RyaW5nX3RvX2VuY29kZQ==", "encode full string");
-        TEST_RESULT_INT(encodeToStrSize(encodeBase64, strlen(source) - 2), strlen(destination), "check size");
+        TEST_RESULT_INT(encodeToStrSize(encodeBase64, strlen(source) - 2), strlen((char *)destination), "check size");
 
-        encodeToStr(encodeBase64, source, strlen(source), destination);
+        encodeToStr(encodeBase64, (unsigned char *)source, strlen(source), (char *)destination);
         TEST_RESULT_STR(destination, "c3RyaW5nX3RvX2VuY29kZQ0K", "encode full string with \\r\\n");
-        TEST_RESULT_INT(encodeToStrSize(encodeBase64, strlen(source)), strlen(destination), "check size");
+        TEST_RESULT_INT(encodeToStrSize(encodeBase64, strlen(source)), strlen((char *)destination), "check size");
 
-        encodeToStr(encodeBase64, source, strlen(source) + 1, destination);
+        encodeToStr(encodeBase64, (unsigned char *)source, strlen(source) + 1, (char *)destination);
         TEST_RESULT_STR(destination, "c3RyaW5nX3RvX2VuY29kZQ0KAG==", "encode full string with \\r\\n and null");
-        TEST_RESULT_INT(encodeToStrSize(encodeBase64, strlen(source) + 1), strlen(destination), "check size");
+        TEST_RESULT_INT(encodeToStrSize(encodeBase64, strlen(source) + 1), strlen((char *)destination), "check size");
 
-        TEST_ERROR(encodeToStr(999, source, strlen(source), destination), AssertError, "invalid encode type 999");
+        TEST_ERROR(
+            encodeToStr(999, (unsigned char *)source, strlen(source), (char *)destination), AssertError, "invalid encode type 999");
         TEST_ERROR(encodeToStrSize(999, strlen(source)), AssertError, "invalid encode type 999");
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,102 @@
+/***********************************************************************************************************************************
+Test Ini Handler
+***********************************************************************************************************************************/
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("iniNew(), iniGet(), iniKeyValue(), iniKeyValueTotal(), and iniFree()"))
+    {
+        Ini *ini = NULL;
+
+        TEST_RESULT_PTR_NE(ini = iniNew(""), NULL, "empty ini");
+        TEST_RESULT_INT(iniKeyValueTotal(ini), 0, "no key/value pairs");
+        TEST_RESULT_STR(iniGet(ini, "section", "key"), NULL, "missing key");
+        TEST_ERROR(iniKeyValue(ini, 0), AssertError, "key/value index 0 is out of bounds");
+        iniFree(ini);
+
+        TEST_ERROR(iniNew("key=value"), FormatError, "key/value pair 'key=value' found outside of a section");
+        TEST_ERROR(iniNew("[section]\nkey"), FormatError, "unable to find '=' in 'key'");
+
+        TEST_RESULT_PTR_NE(
+            ini = iniNew(
+                "# comment\n"
+                "\n"
+                "[section1]\n"
+                "  key1=value1  \n"
+                "key2 = value2\n"
+                "key3=\n"
+                "\n"
+                "[section 2]\n"
+                "key1=a=b\n"
+                "key1=c"),
+            NULL, "ini with content");
+
+        TEST_RESULT_INT(iniKeyValueTotal(ini), 5, "key/value total");
+        TEST_RESULT_STR(iniGet(ini, "section1", "key1"), "value1", "line is trimmed");
+        TEST_RESULT_STR(iniGet(ini, "section1", "key2 "), " value2", "key and value are not trimmed");
+        TEST_RESULT_STR(iniGet(ini, "section1", "key3"), "", "empty value");
+        TEST_RESULT_STR(iniGet(ini, "section1", "key4"), NULL, "missing key");
+        TEST_RESULT_STR(iniGet(ini, "section3", "key1"), NULL, "missing section");
+        TEST_ERROR(iniGet(ini, "section 2", "key1"), FormatError, "key 'key1' is duplicated in section 'section 2'");
+
+        TEST_RESULT_STR(iniKeyValue(ini, 3)->section, "section 2", "section by index");
+        TEST_RESULT_STR(iniKeyValue(ini, 3)->key, "key1", "key by index");
+        TEST_RESULT_STR(iniKeyValue(ini, 3)->value, "a=b", "value split on first =");
+        TEST_RESULT_STR(iniKeyValue(ini, 4)->value, "c", "last line without linefeed");
+
+        iniFree(ini);
+        iniFree(NULL);
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("iniChecksum()"))
+    {
+        char checksum[HASH_TYPE_HEX_SIZE_MAX];
+
+        // Checksum of an archive.info file written by the Perl code
+        Ini *ini = iniNew(
+            "[backrest]\n"
+            "backrest-checksum=\"2e274ecdfc81f9aff78464c658deb2ab986d9359\"\n"
+            "backrest-format=5\n"
+            "backrest-version=\"1.26dev\"\n"
+            "\n"
+            "[db]\n"
+            "db-id=1\n"
+            "db-system-id=6569239123849665679\n"
+            "db-version=\"9.4\"\n"
+            "\n"
+            "[db:history]\n"
+            "1={\"db-id\":6569239123849665679,\"db-version\":\"9.4\"}\n");
+
+        iniChecksum(ini, "backrest", "backrest-checksum", checksum);
+        TEST_RESULT_STR(checksum, "2e274ecdfc81f9aff78464c658deb2ab986d9359", "checksum matches Perl");
+
+        iniFree(ini);
+
+        // Empty content
+        ini = iniNew("");
+
+        iniChecksum(ini, "backrest", "backrest-checksum", checksum);
+        TEST_RESULT_STR(checksum, "bf21a9e8fbc5a3846fb05b4fa0859e0917b2202f", "checksum of {}");
+
+        iniFree(ini);
+
+        // Names that require escapes and duplicate keys are not supported
+        ini = iniNew("[section]\nkey\"=1");
+        TEST_ERROR(
+            iniChecksum(ini, "backrest", "backrest-checksum", checksum), FormatError,
+            "unable to checksum name 'key\"' that requires escapes");
+        iniFree(ini);
+
+        ini = iniNew("[section]\nkey=1\nkey=2");
+        TEST_ERROR(
+            iniChecksum(ini, "backrest", "backrest-checksum", checksum), FormatError,
+            "unable to checksum duplicate key 'key' in section 'section'");
+        iniFree(ini);
+    }
+}
@@ -0,0 +1,238 @@
+/***********************************************************************************************************************************
+Test Log Handler
+***********************************************************************************************************************************/
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************************
+Files where stdout and stderr are captured
+***********************************************************************************************************************************/
+#define TEST_FILE_STDOUT                                            "test-log-stdout"
+#define TEST_FILE_STDERR                                            "test-log-stderr"
+#define TEST_FILE_LOG                                               "test-log-file"
+
+static int testStdOutSave;
+static int testStdErrSave;
+
+/***********************************************************************************************************************************
+Redirect stdout and stderr to files so log output can be checked
+***********************************************************************************************************************************/
+static void
+testLogCapture()
+{
+    fflush(stdout);
+
+    testStdOutSave = dup(STDOUT_FILENO);
+    testStdErrSave = dup(STDERR_FILENO);
+
+    dup2(open(TEST_FILE_STDOUT, O_WRONLY | O_CREAT | O_TRUNC, 0640), STDOUT_FILENO);
+    dup2(open(TEST_FILE_STDERR, O_WRONLY | O_CREAT | O_TRUNC, 0640), STDERR_FILENO);
+}
+
+/***********************************************************************************************************************************
+Restore stdout and stderr and load what was captured
+***********************************************************************************************************************************/
+static char testStdOut[4096];
+static char testStdErr[4096];
+
+static void
+testLogLoad(const char *file, char *buffer)
+{
+    FILE *fileHandle = fopen(file, "r");
+
+    if (fileHandle == NULL)
+        ERROR_THROW(AssertError, "unable to open '%s'", file);
+
+    size_t size = fread(buffer, 1, 4095, fileHandle);
+    buffer[size] = '\0';
+
+    fclose(fileHandle);
+    unlink(file);
+}
+
+static void
+testLogRestore()
+{
+    dup2(testStdOutSave, STDOUT_FILENO);
+    dup2(testStdErrSave, STDERR_FILENO);
+    close(testStdOutSave);
+    close(testStdErrSave);
+
+    testLogLoad(TEST_FILE_STDOUT, testStdOut);
+    testLogLoad(TEST_FILE_STDERR, testStdErr);
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("logLevelEnum(), logLevelStr(), and logWill()"))
+    {
+        TEST_RESULT_INT(logLevelEnum("off"), logLevelOff, "off level");
+        TEST_RESULT_INT(logLevelEnum("INFO"), logLevelInfo, "info level");
+        TEST_RESULT_INT(logLevelEnum("Trace"), logLevelTrace, "trace level");
+        TEST_ERROR(logLevelEnum(BOGUS_STR), AssertError, "log level 'BOGUS' does not exist");
+
+        TEST_RESULT_STR(logLevelStr(logLevelOff), "OFF", "off string");
+        TEST_RESULT_STR(logLevelStr(logLevelDetail), "DETAIL", "detail string");
+        TEST_ERROR(logLevelStr(999), AssertError, "invalid log level '999'");
+
+        // Defaults match the Perl logger before config is loaded
+        TEST_RESULT_BOOL(logWill(logLevelWarn), true, "warn is output to stderr by default");
+        TEST_RESULT_BOOL(logWill(logLevelInfo), false, "info is not output by default");
+
+        logInit(logLevelInfo, logLevelOff, logLevelOff, true);
+        TEST_RESULT_BOOL(logWill(logLevelInfo), true, "info is output to console");
+        TEST_RESULT_BOOL(logWill(logLevelDetail), false, "detail is not output");
+
+        logInit(logLevelOff, logLevelDetail, logLevelOff, true);
+        TEST_RESULT_BOOL(logWill(logLevelDetail), true, "detail is output to stderr");
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("logInternal()"))
+    {
+        // Nothing is output when the level is not included
+        logInit(logLevelWarn, logLevelError, logLevelOff, false);
+
+        testLogCapture();
+        LOG_INFO("not output");
+        testLogRestore();
+
+        TEST_RESULT_STR(testStdOut, "", "no stdout");
+        TEST_RESULT_STR(testStdErr, "", "no stderr");
+
+        // Output to console without timestamp and with multiple lines
+        testLogCapture();
+        LOG_WARN("message %d\nsecond line", 1);
+        logInternal(logLevelWarn, 25, "message with code");
+        testLogRestore();
+
+        TEST_RESULT_STR(
+            testStdOut,
+            "P00   WARN: message 1\n"
+            "            second line\n"
+            "P00   WARN: [025]: message with code\n",
+            "console output");
+        TEST_RESULT_STR(testStdErr, "", "no stderr");
+
+        // Output to console with timestamp
+        logInit(logLevelInfo, logLevelOff, logLevelOff, true);
+
+        testLogCapture();
+        LOG_INFO("message\nsecond line");
+        testLogRestore();
+
+        TEST_RESULT_INT(strlen(testStdOut), 24 + 12 + 8 + 40 + 12, "console output size with timestamp");
+        TEST_RESULT_STR(strstr(testStdOut, " P00   INFO: message\n"), testStdOut + 23, "console output with timestamp");
+        TEST_RESULT_STR(strstr(testStdOut, "\n" LOG_INDENT_TIMESTAMP "second line\n"), testStdOut + 43, "second line indent");
+
+        // Output to stderr takes precedence over console
+        logInit(logLevelInfo, logLevelWarn, logLevelOff, true);
+
+        testLogCapture();
+        LOG_WARN("message");
+        logInternal(logLevelError, 25, "message with code");
+        testLogRestore();
+
+        TEST_RESULT_STR(testStdOut, "", "no stdout");
+        TEST_RESULT_STR(testStdErr, "WARN: message\nERROR [025]: : message with code\n", "stderr output");
+
+        // Protocol level on stderr outputs only the message
+        logInit(logLevelOff, logLevelProtocol, logLevelOff, true);
+
+        testLogCapture();
+        logInternal(logLevelError, 25, "message");
+        testLogRestore();
+
+        TEST_RESULT_STR(testStdErr, "message\n", "stderr protocol output");
+
+        // Errors writing are ignored
+        int stdOutSave = dup(STDOUT_FILENO);
+        close(STDOUT_FILENO);
+
+        logInit(logLevelInfo, logLevelOff, logLevelOff, false);
+        LOG_INFO("not written");
+
+        dup2(stdOutSave, STDOUT_FILENO);
+        close(stdOutSave);
+
+        // Restore the defaults
+        logInit(logLevelOff, logLevelWarn, logLevelOff, true);
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("logFileSet()"))
+    {
+        unlink(TEST_FILE_LOG);
+
+        // The file is not opened when file logging is off
+        logInit(logLevelOff, logLevelOff, logLevelOff, false);
+        logFileSet(TEST_FILE_LOG);
+
+        TEST_RESULT_INT(access(TEST_FILE_LOG, F_OK), -1, "file not created when file logging is off");
+        TEST_RESULT_BOOL(logWill(logLevelError), false, "error is not output");
+
+        // The banner is written before the first message
+        logInit(logLevelOff, logLevelOff, logLevelInfo, false);
+        TEST_RESULT_BOOL(logWill(logLevelInfo), false, "info is not output before the file is set");
+
+        logFileSet(TEST_FILE_LOG);
+        TEST_RESULT_BOOL(logWill(logLevelInfo), true, "info is output to file");
+        TEST_RESULT_BOOL(logWill(logLevelDetail), false, "detail is not output to file");
+
+        testLogCapture();
+        LOG_INFO("message\nsecond line");
+        LOG_WARN("warning");
+        testLogRestore();
+
+        TEST_RESULT_STR(testStdOut, "", "no stdout");
+        TEST_RESULT_STR(testStdErr, "", "no stderr");
+
+        // A file that exists gets a blank line before the banner.  Messages output to stderr are also written to the file.
+        logInit(logLevelOff, logLevelWarn, logLevelInfo, false);
+        logFileSet(TEST_FILE_LOG);
+
+        testLogCapture();
+        logInternal(logLevelWarn, 25, "warning with code");
+        testLogRestore();
+
+        TEST_RESULT_STR(testStdErr, "WARN [025]: : warning with code\n", "stderr output");
+
+        // Console and file output are the same
+        logInit(logLevelInfo, logLevelOff, logLevelInfo, false);
+
+        testLogCapture();
+        LOG_INFO("console and file");
+        testLogRestore();
+
+        TEST_RESULT_STR(testStdOut, "P00   INFO: console and file\n", "console output");
+
+        testLogLoad(TEST_FILE_LOG, testStdOut);
+
+        TEST_RESULT_STR(
+            testStdOut,
+            "-------------------PROCESS START-------------------\n"
+            "P00   INFO: message\n"
+            "            second line\n"
+            "P00   WARN: warning\n"
+            "\n"
+            "-------------------PROCESS START-------------------\n"
+            "P00   WARN: [025]: warning with code\n"
+            "P00   INFO: console and file\n",
+            "file output");
+
+        // Error opening the file
+        TEST_ERROR(
+            logFileSet(TEST_FILE_LOG "/bogus"), FileOpenError,
+            "unable to open log file '" TEST_FILE_LOG "/bogus': No such file or directory");
+
+        // Restore the defaults
+        logInit(logLevelOff, logLevelWarn, logLevelOff, true);
+        logFileSet(TEST_FILE_LOG);
+    }
+}
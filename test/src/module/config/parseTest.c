@@ -0,0 +1,301 @@
+/***********************************************************************************************************************************
+Test Parse Command Line and Config File
+***********************************************************************************************************************************/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************************
+Config file used for testing
+***********************************************************************************************************************************/
+#define TEST_CONFIG                                                 "test-parse.conf"
+
+static void
+testConfig(const char *content)
+{
+    FILE *fileHandle = fopen(TEST_CONFIG, "w");
+
+    if (fileHandle == NULL)
+        ERROR_THROW(AssertError, "unable to create '" TEST_CONFIG "'");
+
+    fputs(content, fileHandle);
+    fclose(fileHandle);
+}
+
+/***********************************************************************************************************************************
+Parse a NULL-terminated argument list
+***********************************************************************************************************************************/
+static bool
+testParse(const char *arg, ...)
+{
+    const char *argList[64] = {"pgbackrest"};
+    unsigned int argListSize = 1;
+
+    va_list argumentList;
+    va_start(argumentList, arg);
+
+    for (const char *argNext = arg; argNext != NULL; argNext = va_arg(argumentList, const char *))
+        argList[argListSize++] = argNext;
+
+    va_end(argumentList);
+
+    return configParse(argListSize, argList);
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("cfgInit(), cfgCommand*(), and cfgOption*()"))
+    {
+        const char *paramList[] = {"param1", "param2"};
+
+        TEST_ERROR(cfgCommandParamSet(2, paramList), AssertError, "configuration is not initialized");
+        TEST_ERROR(cfgOptionSet(CFGOPT_STANZA, cfgSourceParam, "db"), AssertError, "configuration is not initialized");
+
+        cfgInit();
+
+        TEST_RESULT_INT(cfgCommand(), -1, "no command");
+        TEST_ERROR(cfgCommandSet(-1), AssertError, "command id -1 is invalid");
+        cfgCommandSet(CFGCMD_ARCHIVE_PUSH);
+        TEST_RESULT_INT(cfgCommand(), CFGCMD_ARCHIVE_PUSH, "command set");
+
+        TEST_RESULT_INT(cfgCommandParamTotal(), 0, "no params");
+        cfgCommandParamSet(2, paramList);
+        TEST_RESULT_INT(cfgCommandParamTotal(), 2, "param total");
+        TEST_RESULT_STR(cfgCommandParam(1), "param2", "param");
+        TEST_ERROR(cfgCommandParam(2), AssertError, "command parameter 2 does not exist");
+
+        TEST_ERROR(cfgOptionValid(-1), AssertError, "option id -1 is invalid");
+        TEST_ERROR(cfgOptionValid(CFGOPTDEF_TOTAL), AssertError, "option id 145 is invalid");
+        TEST_RESULT_BOOL(cfgOptionValid(CFGOPT_STANZA), false, "option not valid");
+        TEST_ERROR(cfgOption(CFGOPT_STANZA), AssertError, "option 'stanza' is not valid for the current command");
+        TEST_RESULT_BOOL(cfgOptionTest(CFGOPT_STANZA), false, "option not valid so not set");
+
+        cfgOptionValidSet(CFGOPT_STANZA, true);
+        TEST_RESULT_BOOL(cfgOptionTest(CFGOPT_STANZA), false, "option not set");
+        TEST_RESULT_STR(cfgOption(CFGOPT_STANZA), NULL, "option has no value");
+
+        char value[] = "db";
+        cfgOptionSet(CFGOPT_STANZA, cfgSourceConfig, value);
+        value[0] = 'x';
+
+        TEST_RESULT_BOOL(cfgOptionTest(CFGOPT_STANZA), true, "option set");
+        TEST_RESULT_STR(cfgOption(CFGOPT_STANZA), "db", "option value is copied");
+        TEST_RESULT_INT(cfgOptionSource(CFGOPT_STANZA), cfgSourceConfig, "option source");
+
+        cfgOptionValidSet(CFGOPT_COMPRESS, true);
+        TEST_RESULT_BOOL(cfgOptionBool(CFGOPT_COMPRESS), false, "boolean not set");
+        cfgOptionSet(CFGOPT_COMPRESS, cfgSourceParam, CFGOPTVAL_TRUE);
+        TEST_RESULT_BOOL(cfgOptionBool(CFGOPT_COMPRESS), true, "boolean true");
+        cfgOptionSet(CFGOPT_COMPRESS, cfgSourceParam, CFGOPTVAL_FALSE);
+        TEST_RESULT_BOOL(cfgOptionBool(CFGOPT_COMPRESS), false, "boolean false");
+
+        cfgOptionValidSet(CFGOPT_COMPRESS_LEVEL, true);
+        TEST_ERROR(cfgOptionInt64(CFGOPT_COMPRESS_LEVEL), AssertError, "option 'compress-level' is required");
+        cfgOptionSet(CFGOPT_COMPRESS_LEVEL, cfgSourceDefault, "6");
+        TEST_RESULT_INT(cfgOptionInt64(CFGOPT_COMPRESS_LEVEL), 6, "integer");
+
+        // Reinitialize clears everything
+        cfgInit();
+
+        TEST_RESULT_INT(cfgCommand(), -1, "no command");
+        TEST_RESULT_INT(cfgCommandParamTotal(), 0, "no params");
+        TEST_RESULT_BOOL(cfgOptionValid(CFGOPT_STANZA), false, "option not valid");
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("configParse() command line"))
+    {
+        unsetenv("POSIXLY_CORRECT");
+
+        // Anything that might not be parsed exactly as Perl parses it is left to Perl
+        setenv("POSIXLY_CORRECT", "1", true);
+        TEST_RESULT_BOOL(testParse("--stanza=db", "archive-push", NULL), false, "POSIXLY_CORRECT");
+        unsetenv("POSIXLY_CORRECT");
+
+        TEST_RESULT_BOOL(testParse(NULL), false, "no command");
+        TEST_RESULT_BOOL(testParse(BOGUS_STR, NULL), false, "invalid command");
+        TEST_RESULT_BOOL(testParse("help", "archive-push", NULL), false, "help command");
+        TEST_RESULT_BOOL(testParse("-s", "db", "version", NULL), false, "short option");
+        TEST_RESULT_BOOL(testParse("--", "version", NULL), false, "end of options");
+        TEST_RESULT_BOOL(testParse("--stanz=db", "version", NULL), false, "abbreviated option");
+        TEST_RESULT_BOOL(testParse("--stanza=db", "--stanza=db", "archive-push", NULL), false, "repeated option");
+        TEST_RESULT_BOOL(testParse("--db-include=db1", "restore", NULL), false, "list option");
+        TEST_RESULT_BOOL(testParse("--recovery-option=a=b", "restore", NULL), false, "hash option");
+        TEST_RESULT_BOOL(testParse("--compress=y", "archive-push", NULL), false, "boolean with value");
+        TEST_RESULT_BOOL(testParse("--no-compress=y", "archive-push", NULL), false, "negated with value");
+        TEST_RESULT_BOOL(testParse("--no-stanza", "archive-push", NULL), false, "negated option that cannot be negated");
+        TEST_RESULT_BOOL(testParse("--no-db-path", "archive-push", NULL), false, "negated alt name");
+        TEST_RESULT_BOOL(testParse("--stanza=", "archive-push", NULL), false, "empty value");
+        TEST_RESULT_BOOL(testParse("archive-push", "--stanza", NULL), false, "missing value");
+        TEST_RESULT_BOOL(testParse("--stanza", "--compress", "archive-push", NULL), false, "value is an option");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--type=full", "archive-push", NULL), false, "option not valid for command");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--db-path=/db", "--type=bogus", "backup", NULL), false,
+            "value not in allow list");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--compress-level=10", "archive-push", NULL), false, "value out of range");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--compress-level=01", "archive-push", NULL), false,
+            "integer with leading zero");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--compress-level=-0", "archive-push", NULL), false, "integer negative zero");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--compress-level=1.0", "archive-push", NULL), false, "integer with decimal");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--process-max=1234567890123456", "archive-push", NULL), false,
+            "integer with too many digits");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--db-timeout=1.", "archive-push", NULL), false, "float without decimals");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--db-timeout=x", "archive-push", NULL), false, "float not a number");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--db-timeout=1x", "archive-push", NULL), false,
+            "float with trailing characters");
+        TEST_RESULT_BOOL(testParse("--no-config", "archive-push", NULL), false, "required option missing");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--backup-user=x", "archive-push", NULL), false, "depend option not resolved");
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--db-timeout=1830", "archive-push", NULL), false,
+            "protocol-timeout <= db-timeout");
+
+        // Successful parse
+        TEST_RESULT_BOOL(
+            testParse(
+                "--no-config", "--stanza", "db", "--db-timeout=1.5", "--no-compress", "--db-path=/db", "--log-timestamp",
+                "--compress-level=0", "archive-push", "param1", "param2", NULL),
+            true, "parse archive-push");
+
+        TEST_RESULT_INT(cfgCommand(), CFGCMD_ARCHIVE_PUSH, "command");
+        TEST_RESULT_INT(cfgCommandParamTotal(), 2, "param total");
+        TEST_RESULT_STR(cfgCommandParam(0), "param1", "param 1");
+        TEST_RESULT_STR(cfgCommandParam(1), "param2", "param 2");
+
+        TEST_RESULT_STR(cfgOption(CFGOPT_CONFIG), NULL, "config negated");
+        TEST_RESULT_INT(cfgOptionSource(CFGOPT_CONFIG), cfgSourceDefault, "config source");
+        TEST_RESULT_STR(cfgOption(CFGOPT_STANZA), "db", "stanza");
+        TEST_RESULT_INT(cfgOptionSource(CFGOPT_STANZA), cfgSourceParam, "stanza source");
+        TEST_RESULT_STR(cfgOption(CFGOPT_DB_TIMEOUT), "1.5", "db-timeout");
+        TEST_RESULT_STR(cfgOption(CFGOPT_COMPRESS), CFGOPTVAL_FALSE, "compress negated");
+        TEST_RESULT_INT(cfgOptionSource(CFGOPT_COMPRESS), cfgSourceParam, "compress source");
+        TEST_RESULT_STR(cfgOption(CFGOPT_LOG_TIMESTAMP), CFGOPTVAL_TRUE, "log-timestamp");
+        TEST_RESULT_STR(cfgOption(CFGOPT_DB1_PATH), "/db", "db-path by alt name");
+        TEST_RESULT_STR(cfgOption(CFGOPT_REPO_PATH), "/var/lib/pgbackrest", "repo-path default");
+        TEST_RESULT_INT(cfgOptionSource(CFGOPT_REPO_PATH), cfgSourceDefault, "repo-path source");
+        TEST_RESULT_BOOL(cfgOptionValid(CFGOPT_TYPE), false, "type not valid");
+
+        TEST_RESULT_BOOL(
+            testParse("--no-config", "--stanza=db", "--db-path=/db", "--db-host=db", "--db-user=x", "backup", NULL), true,
+            "parse backup with dependency");
+        TEST_RESULT_STR(cfgOption(CFGOPT_DB1_USER), "x", "db-user");
+        TEST_RESULT_STR(cfgOption(CFGOPT_DB2_USER), NULL, "db2-user not set");
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("configParse() config file"))
+    {
+        unlink(TEST_CONFIG);
+
+        TEST_RESULT_BOOL(
+            testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), true, "missing config file");
+        TEST_RESULT_STR(cfgOption(CFGOPT_COMPRESS), CFGOPTVAL_TRUE, "compress default");
+
+        testConfig("key=value");
+        TEST_ERROR(
+            testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), FormatError,
+            "key/value pair 'key=value' found outside of a section");
+
+        testConfig(
+            "[global]\n"
+            "repo-path=/repo\n"
+            "compress=n\n"
+            "compress-level=3\n"
+            "log-timestamp=\n"
+            "\n"
+            "[global:archive-push]\n"
+            "compress-level=4\n"
+            "\n"
+            "[db:archive-push]\n"
+            "compress-level=5\n"
+            "\n"
+            "[db]\n"
+            "db-path=/db\n"
+            "db2-host=db2\n");
+
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), true, "parse with config");
+        TEST_RESULT_STR(cfgOption(CFGOPT_REPO_PATH), "/repo", "repo-path from global");
+        TEST_RESULT_INT(cfgOptionSource(CFGOPT_REPO_PATH), cfgSourceConfig, "repo-path source");
+        TEST_RESULT_STR(cfgOption(CFGOPT_COMPRESS), CFGOPTVAL_FALSE, "compress from global");
+        TEST_RESULT_STR(cfgOption(CFGOPT_COMPRESS_LEVEL), "5", "compress-level from stanza command section");
+        TEST_RESULT_STR(cfgOption(CFGOPT_LOG_TIMESTAMP), CFGOPTVAL_TRUE, "empty value is not set");
+        TEST_RESULT_STR(cfgOption(CFGOPT_DB1_PATH), "/db", "db-path by alt name");
+        TEST_RESULT_STR(cfgOption(CFGOPT_DB2_HOST), "db2", "db2-host");
+
+        TEST_RESULT_BOOL(
+            testParse("--config=" TEST_CONFIG, "--stanza=db", "--compress-level=1", "--compress", "archive-push", NULL), true,
+            "command line overrides config");
+        TEST_RESULT_STR(cfgOption(CFGOPT_COMPRESS_LEVEL), "1", "compress-level from command line");
+        TEST_RESULT_STR(cfgOption(CFGOPT_COMPRESS), CFGOPTVAL_TRUE, "compress from command line");
+
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=other", "archive-get", NULL), true, "parse other stanza");
+        TEST_RESULT_STR(cfgOption(CFGOPT_COMPRESS_LEVEL), "3", "compress-level from global");
+        TEST_RESULT_STR(cfgOption(CFGOPT_DB1_PATH), NULL, "db-path not set");
+
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "info", NULL), true, "parse without stanza");
+        TEST_RESULT_STR(cfgOption(CFGOPT_REPO_PATH), "/repo", "repo-path from global");
+
+        // Config files that Perl would warn about or error on are left to Perl
+        testConfig("[global]\ncompress=x\n");
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), false, "invalid boolean");
+
+        testConfig("[global]\ncompress=y\ncompress=n\n");
+        TEST_ERROR(
+            testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), FormatError,
+            "key 'compress' is duplicated in section 'global'");
+
+        testConfig("[db]\ndb-path=/db\ndb1-path=/db\n");
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), false, "option and alt name");
+
+        testConfig("[db]\ndb-include=db1\n");
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=db", "restore", NULL), false, "list option");
+
+        testConfig("[global]\nbogus=x\n");
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), false, "invalid option");
+
+        testConfig("[global]\nstanza=db\n");
+        TEST_RESULT_BOOL(
+            testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), false, "command line only option");
+
+        testConfig("[global:bogus]\ncompress=y\n");
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), false, "invalid command");
+
+        testConfig("[global:archive-push]\nretention-full=1\n");
+        TEST_RESULT_BOOL(
+            testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), false, "option not valid for command section");
+
+        testConfig("[global]\ndb-path=/db\n");
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), false, "stanza option in global");
+
+        testConfig("[global:archive-push]\ndb-path=/db\n");
+        TEST_RESULT_BOOL(
+            testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), false, "stanza option in global command");
+
+        testConfig("[db:]\ncompress=y\n");
+        TEST_RESULT_BOOL(testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), true, "empty command section");
+
+        testConfig("[global]\nbackup-user=x\ncompress=y\n");
+        TEST_RESULT_BOOL(
+            testParse("--config=" TEST_CONFIG, "--stanza=db", "archive-push", NULL), true,
+            "option with unresolved dependency is not read");
+        TEST_RESULT_STR(cfgOption(CFGOPT_BACKUP_USER), NULL, "backup-user not set");
+        TEST_RESULT_STR(cfgOption(CFGOPT_COMPRESS), CFGOPTVAL_TRUE, "compress from global");
+
+        unlink(TEST_CONFIG);
+    }
+}
@@ -0,0 +1,27 @@
+/***********************************************************************************************************************************
+Test Cryptographic Hashes
+***********************************************************************************************************************************/
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("cryptoHashOne()"))
+    {
+        char hashHex[HASH_TYPE_HEX_SIZE_MAX];
+
+        TEST_ERROR(cryptoHashOne(BOGUS_STR, (unsigned char *)"", 0, hashHex), AssertError, "unable to load hash 'BOGUS'");
+
+        cryptoHashOne(HASH_TYPE_SHA1, (unsigned char *)"", 0, hashHex);
+        TEST_RESULT_STR(hashHex, "da39a3ee5e6b4b0d3255bfef95601890afd80709", "sha1 of empty buffer");
+
+        cryptoHashOne(HASH_TYPE_SHA1, (unsigned char *)"12345", 5, hashHex);
+        TEST_RESULT_STR(hashHex, "8cb2237d0679ca88db6464eac60da96345513964", "sha1 of buffer");
+
+        cryptoHashOne("sha256", (unsigned char *)"12345", 5, hashHex);
+        TEST_RESULT_STR(hashHex, "5994471abb01112afcc18159f6cc74b4f511b99806da59b3caf5a9c173cacfc5", "sha256 of buffer");
+    }
+}
@@ -0,0 +1,70 @@
+/***********************************************************************************************************************************
+Test WAL Segment Functions
+***********************************************************************************************************************************/
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("walIsSegment() and walIsPartial()"))
+    {
+        TEST_RESULT_BOOL(walIsSegment("000000010000000100000001"), true, "segment");
+        TEST_RESULT_BOOL(walIsSegment("0000000A00000001000000FE.partial"), true, "partial segment");
+        TEST_RESULT_BOOL(walIsSegment("0000000100000001000000"), false, "segment too short");
+        TEST_RESULT_BOOL(walIsSegment("00000001000000010000000a"), false, "lower-case segment");
+        TEST_RESULT_BOOL(walIsSegment("000000010000000100000001.backup"), false, "backup file");
+        TEST_RESULT_BOOL(walIsSegment("00000002.history"), false, "history file");
+
+        TEST_RESULT_BOOL(walIsPartial("000000010000000100000001"), false, "segment is not partial");
+        TEST_RESULT_BOOL(walIsPartial("000000010000000100000001.partial"), true, "partial segment");
+        TEST_RESULT_BOOL(walIsPartial("00000002.history"), false, "history file is not partial");
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("walInfo()"))
+    {
+        unsigned char walBuffer[32] = {0};
+        uint16 magic = 0xD07E;
+        uint16 flag = 2;
+        uint64 systemId = 0xFACEFACEFACEFACE;
+
+        TEST_ERROR(walInfo(walBuffer, 1), FileReadError, "unable to read wal magic");
+        TEST_ERROR(
+            walInfo(walBuffer, sizeof(walBuffer)), VersionNotSupportedError,
+            "unexpected WAL magic 0x0\nHINT: is this version of PostgreSQL supported?");
+
+        memcpy(walBuffer, &magic, sizeof(magic));
+
+        TEST_ERROR(walInfo(walBuffer, 3), FileReadError, "unable to read wal info");
+        TEST_ERROR(walInfo(walBuffer, sizeof(walBuffer)), FormatError, "expected long header in flags 0");
+
+        memcpy(walBuffer + 2, &flag, sizeof(flag));
+
+        TEST_ERROR(walInfo(walBuffer, 31), FileReadError, "unable to read database system identifier");
+
+        // Version >= 9.3
+        memcpy(walBuffer + PG_WAL_SYSTEM_ID_OFFSET_GTE_93, &systemId, sizeof(systemId));
+
+        TEST_RESULT_STR(walInfo(walBuffer, sizeof(walBuffer)).version, "9.4", "version");
+        TEST_RESULT_BOOL(walInfo(walBuffer, sizeof(walBuffer)).systemId == systemId, true, "system id");
+
+        // Version < 9.3
+        memset(walBuffer, 0, sizeof(walBuffer));
+        magic = 0xD071;
+
+        memcpy(walBuffer, &magic, sizeof(magic));
+        memcpy(walBuffer + 2, &flag, sizeof(flag));
+        memcpy(walBuffer + PG_WAL_SYSTEM_ID_OFFSET_LT_93, &systemId, sizeof(systemId));
+
+        TEST_RESULT_STR(walInfo(walBuffer, sizeof(walBuffer)).version, "9.2", "version");
+        TEST_RESULT_BOOL(walInfo(walBuffer, sizeof(walBuffer)).systemId == systemId, true, "system id");
+
+        magic = 0xD062;
+        memcpy(walBuffer, &magic, sizeof(magic));
+
+        TEST_RESULT_STR(walInfo(walBuffer, sizeof(walBuffer)).version, "8.3", "version");
+    }
+}
@@ -0,0 +1,185 @@
+/***********************************************************************************************************************************
+Test Posix Storage Manifest
+***********************************************************************************************************************************/
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************************
+Path where test files are created
+***********************************************************************************************************************************/
+#define TEST_PATH                                                   "test-manifest"
+
+/***********************************************************************************************************************************
+Collect manifest entries as strings so they can be sorted and compared
+***********************************************************************************************************************************/
+#define TEST_ENTRY_MAX                                              2048
+#define TEST_ENTRY_SIZE                                             256
+
+static char testEntryList[TEST_ENTRY_MAX][TEST_ENTRY_SIZE];
+static int testEntryTotal = 0;
+static char testManifest[TEST_ENTRY_MAX * TEST_ENTRY_SIZE];
+
+static void
+testManifestCallback(void *callbackData, const StorageManifestInfo *info)
+{
+    (void)callbackData;
+
+    if (testEntryTotal == TEST_ENTRY_MAX)
+        ERROR_THROW(AssertError, "too many manifest entries");
+
+    if (info->type == storageManifestTypeFile)
+    {
+        snprintf(
+            testEntryList[testEntryTotal], TEST_ENTRY_SIZE, "%s {type: f, mode: %04o, size: %llu, time: %lld}", info->name,
+            (unsigned int)info->mode, (unsigned long long)info->size, (long long)info->modificationTime);
+    }
+    else if (info->type == storageManifestTypePath)
+        snprintf(testEntryList[testEntryTotal], TEST_ENTRY_SIZE, "%s {type: d, mode: %04o}", info->name, (unsigned int)info->mode);
+    else
+        snprintf(testEntryList[testEntryTotal], TEST_ENTRY_SIZE, "%s {type: l, dest: %s}", info->name, info->linkDestination);
+
+    if (info->user == NULL || info->group == NULL)
+        ERROR_THROW(AssertError, "user/group not resolved for '%s'", info->name);
+
+    testEntryTotal++;
+}
+
+static int
+testEntryCompare(const void *entry1, const void *entry2)
+{
+    return strcmp((const char *)entry1, (const char *)entry2);
+}
+
+static const char *
+testManifestRender(const char *path, bool ignoreMissing, unsigned int threadTotal)
+{
+    testEntryTotal = 0;
+    testManifest[0] = '\0';
+
+    storagePosixManifest(path, ignoreMissing, threadTotal, testManifestCallback, NULL);
+
+    qsort(testEntryList, testEntryTotal, TEST_ENTRY_SIZE, testEntryCompare);
+
+    for (int entryIdx = 0; entryIdx < testEntryTotal; entryIdx++)
+    {
+        strcat(testManifest, testEntryList[entryIdx]);
+        strcat(testManifest, "\n");
+    }
+
+    return testManifest;
+}
+
+static void
+testFile(const char *file, mode_t mode, const char *content)
+{
+    FILE *fileHandle = fopen(file, "w");
+
+    if (fileHandle == NULL)
+        ERROR_THROW(AssertError, "unable to create '%s'", file);
+
+    fputs(content, fileHandle);
+    fclose(fileHandle);
+
+    chmod(file, mode);
+
+    struct timespec time[2] = {{.tv_sec = 1111111111}, {.tv_sec = 1111111111}};
+    utimensat(AT_FDCWD, file, time, AT_SYMLINK_NOFOLLOW);
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("storagePosixManifest()"))
+    {
+        umask(0);
+
+        if (system("rm -rf " TEST_PATH) != 0)
+            ERROR_THROW(AssertError, "unable to remove " TEST_PATH);
+
+        TEST_ERROR(
+            storagePosixManifest(TEST_PATH, false, 0, testManifestCallback, NULL), AssertError,
+            "thread total must be between 1 and 64");
+
+        // Missing path
+        TEST_RESULT_STR(testManifestRender(TEST_PATH, true, 1), "", "ignore missing path");
+        TEST_ERROR(
+            testManifestRender(TEST_PATH, false, 1), FileMissingError,
+            "unable to stat '" TEST_PATH "': No such file or directory");
+
+        // Empty path
+        mkdir(TEST_PATH, 0750);
+        TEST_RESULT_STR(testManifestRender(TEST_PATH, false, 4), ". {type: d, mode: 0750}\n", "empty path");
+
+        // Single file
+        testFile(TEST_PATH "/test.txt", 01640, "TESTDATA\n");
+
+        TEST_RESULT_STR(
+            testManifestRender(TEST_PATH "/test.txt", false, 4), "test.txt {type: f, mode: 1640, size: 9, time: 1111111111}\n",
+            "single file");
+
+        // Paths, files, and links
+        mkdir(TEST_PATH "/sub1", 0750);
+        mkdir(TEST_PATH "/sub1/sub2", 0700);
+        testFile(TEST_PATH "/sub1/test-sub1.txt", 0646, "TESTDATA_\n");
+        testFile(TEST_PATH "/sub1/sub2/test-sub2.txt", 0600, "TESTDATA__\n");
+
+        if (symlink("..", TEST_PATH "/sub1/test") != 0 || symlink("../..", TEST_PATH "/sub1/sub2/test") != 0)
+            ERROR_THROW(AssertError, "unable to create links");
+
+        const char *manifestExpected =
+            ". {type: d, mode: 0750}\n"
+            "sub1 {type: d, mode: 0750}\n"
+            "sub1/sub2 {type: d, mode: 0700}\n"
+            "sub1/sub2/test {type: l, dest: ../..}\n"
+            "sub1/sub2/test-sub2.txt {type: f, mode: 0600, size: 11, time: 1111111111}\n"
+            "sub1/test {type: l, dest: ..}\n"
+            "sub1/test-sub1.txt {type: f, mode: 0646, size: 10, time: 1111111111}\n"
+            "test.txt {type: f, mode: 1640, size: 9, time: 1111111111}\n";
+
+        TEST_RESULT_STR(testManifestRender(TEST_PATH, false, 1), manifestExpected, "complete manifest with one thread");
+        TEST_RESULT_STR(testManifestRender(TEST_PATH, false, 8), manifestExpected, "complete manifest with eight threads");
+        TEST_RESULT_STR(
+            testManifestRender(TEST_PATH "/sub1/test", false, 1), "test {type: l, dest: ..}\n",
+            "link at top level is not followed");
+
+        // Many paths are split between threads
+        for (int pathIdx = 0; pathIdx < 100; pathIdx++)
+        {
+            char name[64];
+
+            snprintf(name, sizeof(name), TEST_PATH "/many/%03d", pathIdx);
+            mkdir(TEST_PATH "/many", 0700);
+            mkdir(name, 0700);
+
+            for (int fileIdx = 0; fileIdx < 10; fileIdx++)
+            {
+                snprintf(name, sizeof(name), TEST_PATH "/many/%03d/%d", pathIdx, fileIdx);
+                testFile(name, 0600, "");
+            }
+        }
+
+        testManifestRender(TEST_PATH "/many", false, 16);
+        TEST_RESULT_INT(testEntryTotal, 1101, "many paths with sixteen threads");
+        TEST_RESULT_STR(testEntryList[1], "000 {type: d, mode: 0700}", "    first path");
+        TEST_RESULT_STR(testEntryList[1100], "099/9 {type: f, mode: 0600, size: 0, time: 1111111111}", "    last file");
+
+        // Invalid file type
+        if (mkfifo(TEST_PATH "/sub1/sub2/fifo", 0600) != 0)
+            ERROR_THROW(AssertError, "unable to create fifo");
+
+        TEST_ERROR(
+            testManifestRender(TEST_PATH, false, 4), FileInvalidError,
+            TEST_PATH "/sub1/sub2/fifo is not of type directory, file, or link");
+        TEST_ERROR(
+            testManifestRender(TEST_PATH "/sub1/sub2/fifo", false, 4), FileInvalidError,
+            TEST_PATH "/sub1/sub2/fifo is not of type directory, file, or link");
+
+        if (system("rm -rf " TEST_PATH) != 0)
+            ERROR_THROW(AssertError, "unable to remove " TEST_PATH);
+    }
+}
@@ -0,0 +1,188 @@
+/***********************************************************************************************************************************
+Test Posix Storage
+***********************************************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************************
+Path where test files are created
+***********************************************************************************************************************************/
+#define TEST_PATH                                                   "test-storage"
+
+/***********************************************************************************************************************************
+Collect list entries as a string so they can be compared
+***********************************************************************************************************************************/
+static char testList[4096];
+
+static void
+testListCallback(void *callbackData, const char *name)
+{
+    (*(unsigned int *)callbackData)++;
+
+    strcat(testList, name);
+    strcat(testList, "\n");
+}
+
+static const char *
+testListRender(const char *path, bool ignoreMissing)
+{
+    unsigned int total = 0;
+    testList[0] = '\0';
+
+    storagePosixList(path, ignoreMissing, testListCallback, &total);
+
+    return testList;
+}
+
+/***********************************************************************************************************************************
+Get the mode of a file
+***********************************************************************************************************************************/
+static int
+testMode(const char *file)
+{
+    struct stat statFile;
+
+    if (stat(file, &statFile) == -1)
+        ERROR_THROW(AssertError, "unable to stat '%s'", file);
+
+    return (int)(statFile.st_mode & 0777);
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    if (system("rm -rf " TEST_PATH) != 0)
+        ERROR_THROW(AssertError, "unable to remove " TEST_PATH);
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("storagePosixExists(), storagePosixPathCreate(), and storagePosixList()"))
+    {
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH), false, "path does not exist");
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/sub"), false, "subpath does not exist");
+
+        TEST_ERROR(
+            storagePosixPathCreate(TEST_PATH "/sub", 0750, false, false), PathMissingError,
+            "unable to create path '" TEST_PATH "/sub': No such file or directory");
+
+        storagePosixPathCreate(TEST_PATH "/sub1/sub2//", 0750, false, true);
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/sub1/sub2"), true, "path and parent created");
+        TEST_RESULT_INT(testMode(TEST_PATH "/sub1"), 0750, "parent path mode");
+
+        TEST_ERROR(
+            storagePosixPathCreate(TEST_PATH "/sub1", 0750, false, false), PathCreateError,
+            "unable to create path '" TEST_PATH "/sub1': File exists");
+        storagePosixPathCreate(TEST_PATH "/sub1", 0750, true, false);
+
+        if (system("touch " TEST_PATH "/file && ln -s loop " TEST_PATH "/loop") != 0)
+            ERROR_THROW(AssertError, "unable to create file and link");
+
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/file/sub"), false, "subpath of file does not exist");
+        TEST_ERROR(
+            storagePosixExists(TEST_PATH "/loop"), FileOpenError,
+            "unable to stat '" TEST_PATH "/loop': Too many levels of symbolic links");
+
+        TEST_RESULT_STR(testListRender(TEST_PATH "/missing", true), "", "missing path ignored");
+        TEST_ERROR(
+            testListRender(TEST_PATH "/missing", false), PathMissingError,
+            "unable to read path '" TEST_PATH "/missing': No such file or directory");
+        TEST_ERROR(
+            testListRender(TEST_PATH "/file", false), PathOpenError,
+            "unable to read path '" TEST_PATH "/file': Not a directory");
+
+        TEST_RESULT_STR(testListRender(TEST_PATH "/sub1", false), "sub2\n", "list path");
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("storagePosixGet()"))
+    {
+        size_t size = 0;
+
+        TEST_RESULT_PTR(storagePosixGet(TEST_PATH "/missing", true, &size), NULL, "missing file ignored");
+        TEST_ERROR(
+            storagePosixGet(TEST_PATH "/missing", false, &size), FileMissingError,
+            "unable to open '" TEST_PATH "/missing' for read: No such file or directory");
+        TEST_ERROR(
+            storagePosixGet(TEST_PATH "/file/missing", false, &size), FileOpenError,
+            "unable to open '" TEST_PATH "/file/missing' for read: Not a directory");
+        TEST_ERROR(
+            storagePosixGet(TEST_PATH, false, &size), FileReadError,
+            "unable to read '" TEST_PATH "': Is a directory");
+
+        unsigned char *buffer = NULL;
+
+        TEST_RESULT_STR((char *)(buffer = storagePosixGet(TEST_PATH "/file", false, &size)), "", "empty file");
+        TEST_RESULT_INT(size, 0, "empty file size");
+        memFree(buffer);
+
+        // Files that do not report a size, e.g. in /proc, are read until end of file
+        TEST_RESULT_PTR_NE(buffer = storagePosixGet("/proc/self/status", false, NULL), NULL, "file without size");
+        TEST_RESULT_BOOL(strstr((char *)buffer, "Name:") == (char *)buffer, true, "file content");
+        memFree(buffer);
+    }
+
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("storagePosixFileWriteOpen(), storagePosixFileWrite(), storagePosixFileWriteClose(), and "
+                  "storagePosixFileWriteFree()"))
+    {
+        TEST_ERROR(
+            storagePosixFileWriteOpen(TEST_PATH "/sub3/file", 0640, 0750, false), PathMissingError,
+            "unable to open '" TEST_PATH "/sub3/file." STORAGE_TEMP_EXT "': No such file or directory");
+        TEST_ERROR(
+            storagePosixFileWriteOpen(TEST_PATH "/file/file", 0640, 0750, true), FileOpenError,
+            "unable to open '" TEST_PATH "/file/file." STORAGE_TEMP_EXT "': Not a directory");
+
+        // Write a file in a path that must be created
+        StorageFileWrite *file = NULL;
+
+        TEST_RESULT_PTR_NE(file = storagePosixFileWriteOpen(TEST_PATH "/sub3/sub4/file", 0600, 0700, true), NULL, "open file");
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/sub3/sub4/file." STORAGE_TEMP_EXT), true, "temp file exists");
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/sub3/sub4/file"), false, "file does not exist");
+        TEST_RESULT_INT(testMode(TEST_PATH "/sub3"), 0700, "path mode");
+
+        storagePosixFileWrite(file, (unsigned char *)"ABC", 3);
+        storagePosixFileWrite(file, (unsigned char *)"DEF", 3);
+        storagePosixFileWriteClose(file);
+        storagePosixFileWriteFree(file);
+
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/sub3/sub4/file." STORAGE_TEMP_EXT), false, "temp file does not exist");
+        TEST_RESULT_STR((char *)storagePosixGet(TEST_PATH "/sub3/sub4/file", false, NULL), "ABCDEF", "file content");
+        TEST_RESULT_INT(testMode(TEST_PATH "/sub3/sub4/file"), 0600, "file mode");
+
+        // Temp file is removed when the file is freed without closing
+        TEST_RESULT_PTR_NE(file = storagePosixFileWriteOpen(TEST_PATH "/file2", 0640, 0750, true), NULL, "open file");
+        storagePosixFileWriteFree(file);
+        storagePosixFileWriteFree(NULL);
+
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/file2." STORAGE_TEMP_EXT), false, "temp file removed");
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/file2"), false, "file does not exist");
+
+        // Error on write after the handle is closed
+        TEST_RESULT_PTR_NE(file = storagePosixFileWriteOpen(TEST_PATH "/file2", 0640, 0750, true), NULL, "open file");
+        close(file->handle);
+
+        TEST_ERROR(
+            storagePosixFileWrite(file, (unsigned char *)"ABC", 3), FileWriteError,
+            "unable to write '" TEST_PATH "/file2." STORAGE_TEMP_EXT "': Bad file descriptor");
+        TEST_ERROR(
+            storagePosixFileWriteClose(file), FileSyncError,
+            "unable to sync '" TEST_PATH "/file2." STORAGE_TEMP_EXT "': Bad file descriptor");
+
+        file->handle = -1;
+        storagePosixFileWriteFree(file);
+
+        // Error on rename when the destination is a path
+        TEST_RESULT_PTR_NE(file = storagePosixFileWriteOpen(TEST_PATH "/sub1", 0640, 0750, true), NULL, "open file");
+
+        TEST_ERROR(
+            storagePosixFileWriteClose(file), FileMoveError,
+            "unable to move '" TEST_PATH "/sub1." STORAGE_TEMP_EXT "' to '" TEST_PATH "/sub1': Is a directory");
+
+        storagePosixFileWriteFree(file);
+        TEST_RESULT_BOOL(storagePosixExists(TEST_PATH "/sub1." STORAGE_TEMP_EXT), false, "temp file removed");
+    }
+}
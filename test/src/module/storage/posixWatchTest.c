@@ -0,0 +1,105 @@
+/***********************************************************************************************************************************
+Test Posix Storage Watch
+***********************************************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************************
+Path where test files are created
+***********************************************************************************************************************************/
+#define TEST_PATH                                                   "test-watch"
+
+/***********************************************************************************************************************************
+Collect events as a string so they can be compared
+***********************************************************************************************************************************/
+static char testEventList[4096];
+
+static void
+testWatchCallback(void *callbackData, StorageWatchEventType type, const char *name)
+{
+    (void)callbackData;
+
+    char event[256];
+    snprintf(event, sizeof(event), "%c %s\n", (char)type, name == NULL ? "[null]" : name);
+    strcat(testEventList, event);
+}
+
+static const char *
+testWatchRender(int watch, unsigned int waitMs)
+{
+    testEventList[0] = '\0';
+
+    storagePosixWatchRead(watch, waitMs, testWatchCallback, NULL);
+
+    return testEventList;
+}
+
+static void
+testFile(const char *file)
+{
+    FILE *fileHandle = fopen(file, "w");
+
+    if (fileHandle == NULL)
+        ERROR_THROW(AssertError, "unable to create '%s'", file);
+
+    fclose(fileHandle);
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+void
+testRun()
+{
+    // -----------------------------------------------------------------------------------------------------------------------------
+    if (testBegin("storagePosixWatchNew(), storagePosixWatchRead(), and storagePosixWatchFree()"))
+    {
+        if (system("rm -rf " TEST_PATH) != 0)
+            ERROR_THROW(AssertError, "unable to remove " TEST_PATH);
+
+        TEST_ERROR(
+            storagePosixWatchNew(TEST_PATH), FileMissingError, "unable to watch '" TEST_PATH "': No such file or directory");
+
+        mkdir(TEST_PATH, 0700);
+        testFile(TEST_PATH "/file");
+
+        TEST_ERROR(storagePosixWatchNew(TEST_PATH "/file"), FileOpenError, "unable to watch '" TEST_PATH "/file': Not a directory");
+
+        int watch = storagePosixWatchNew(TEST_PATH);
+
+        TEST_RESULT_STR(testWatchRender(watch, 0), "", "no events");
+
+        // Files are added when closed or moved in and removed when deleted or moved out
+        testFile(TEST_PATH "/000000010000000100000001.ready");
+        rename(TEST_PATH "/000000010000000100000001.ready", TEST_PATH "/000000010000000100000001.done");
+        unlink(TEST_PATH "/file");
+
+        TEST_RESULT_STR(
+            testWatchRender(watch, 0),
+            "a 000000010000000100000001.ready\n"
+            "r 000000010000000100000001.ready\n"
+            "a 000000010000000100000001.done\n"
+            "r file\n",
+            "add and remove events in order");
+
+        // Subpaths are not reported
+        mkdir(TEST_PATH "/sub", 0700);
+        testFile(TEST_PATH "/sub/file");
+
+        TEST_RESULT_STR(testWatchRender(watch, 0), "", "no events for subpaths");
+
+        // Removing the path ends the watch
+        unlink(TEST_PATH "/000000010000000100000001.done");
+        unlink(TEST_PATH "/sub/file");
+        rmdir(TEST_PATH "/sub");
+        rmdir(TEST_PATH);
+
+        TEST_RESULT_STR(
+            testWatchRender(watch, 1000), "r 000000010000000100000001.done\nr sub\no [null]\n", "overflow when path is removed");
+
+        storagePosixWatchFree(watch);
+        storagePosixWatchFree(-1);
+    }
+}
@@ -78,6 +78,8 @@ test.pl [options]
    --no-ci-config       don't overwrite the current continuous integration config
    --dev                --no-lint --smart --no-package
    --expect             --no-lint --smart --no-package --vm=co7 --db=9.6 --log-force
+   --scale              scale performance tests (defaults to 1)
+   --wal-rate           WAL segments/sec generated by performance tests (defaults to 0, as fast as possible)
 
  Configuration Options:
    --psql-bin           path to the psql executables (e.g. /usr/lib/postgresql/9.3/bin/)
@@ -130,6 +132,8 @@ my $bNoCiConfig = false;
 my $bDev = false;
 my $bExpect = false;
 my $iRetry = 0;
+my $iScale = 1;
+my $fWalRate = 0;
 
 GetOptions ('q|quiet' => \$bQuiet,
             'version' => \$bVersion,
@@ -160,7 +164,9 @@ GetOptions ('q|quiet' => \$bQuiet,
             'smart' => \$bSmart,
             'dev' => \$bDev,
             'expect' => \$bExpect,
-            'retry=s' => \$iRetry)
+            'retry=s' => \$iRetry,
+            'scale=s' => \$iScale,
+            'wal-rate=s' => \$fWalRate)
     or pod2usage(2);
 
 ####################################################################################################################################
@@ -319,6 +325,24 @@ eval
             confess 'unable to find version ' . BACKREST_VERSION . " as the most recent release in ${strReleaseFile}";
         }
 
+        # Make sure the C version constants match the Perl constants
+        my $strVersionC = ${$oStorageBackRest->get("${strBackRestBase}/src/version.h")};
+        my $hVersionC =
+        {
+            'PGBACKREST_NAME' => '"' . BACKREST_NAME . '"',
+            'PGBACKREST_BIN' => '"' . BACKREST_EXE . '"',
+            'PGBACKREST_FORMAT' => BACKREST_FORMAT,
+            'PGBACKREST_VERSION' => '"' . BACKREST_VERSION . '"',
+        };
+
+        foreach my $strConstant (sort(keys(%{$hVersionC})))
+        {
+            if ($strVersionC !~ /^\#define ${strConstant} +\Q$hVersionC->{$strConstant}\E$/m)
+            {
+                confess "${strConstant} in src/version.h must be $hVersionC->{$strConstant} to match lib/pgBackRest/Version.pm";
+            }
+        }
+
         # Clean up
         #---------------------------------------------------------------------------------------------------------------------------
         my $iTestFail = 0;
@@ -725,7 +749,8 @@ eval
                 {
                     my $oJob = new pgBackRestTest::Common::JobTest(
                         $oStorageTest, $strBackRestBase, $strTestPath, $strCoveragePath, $$oyTestRun[$iTestIdx], $bDryRun, $bVmOut,
-                        $iVmIdx, $iVmMax, $iTestIdx, $iTestMax, $strLogLevel, $bLogForce, $bShowOutputAsync, $bNoCleanup, $iRetry);
+                        $iVmIdx, $iVmMax, $iTestIdx, $iTestMax, $strLogLevel, $bLogForce, $bShowOutputAsync, $bNoCleanup, $iRetry,
+                        $iScale, $fWalRate);
                     $iTestIdx++;
 
                     if ($oJob->run())
@@ -948,7 +973,8 @@ eval
         $strDbVersion ne 'minimal' ? $strDbVersion: undef,          # Db version
         $stryModule[0], $stryModuleTest[0], \@iyModuleTestRun,      # Module info
         $bVmOut, $bDryRun, $bNoCleanup, $bLogForce,                 # Test options
-        TEST_USER, BACKREST_USER, TEST_GROUP);                      # User/group info
+        TEST_USER, BACKREST_USER, TEST_GROUP,                       # User/group info
+        $iScale, $fWalRate);                                        # Performance test options
 
     if (!$bNoCleanup)
     {